@@ -129,7 +129,7 @@ STATIC int usage(char **argv) {
         "\n"
         "Target specific options:\n"
         "-msmall-int-bits=number : set the maximum bits used to encode a small-int\n"
-        "-march=<arch> : set architecture for native emitter; x86, x64, armv6, armv6m, armv7m, armv7em, armv7emsp, armv7emdp, xtensa, xtensawin, m68k\n"
+        "-march=<arch> : set architecture for native emitter; x86, x64, armv6, armv6m, armv7m, armv7em, armv7emsp, armv7emdp, xtensa, xtensawin, m68k, m68k020, m68k020+fpu\n"
         "\n"
         "Implementation specific options:\n", argv[0]
         );
@@ -322,6 +322,14 @@ MP_NOINLINE int main_(int argc, char **argv) {
                     mp_dynamic_compiler.nlr_buf_num_regs = MICROPY_NLR_NUM_REGS_XTENSAWIN;
                 } else if (strcmp(arch, "m68k") == 0) {
                     mp_dynamic_compiler.native_arch = MP_NATIVE_ARCH_M68K;
+                    mp_dynamic_compiler.nlr_buf_num_regs = MICROPY_NLR_NUM_REGS_M68K_FP; // conservative, the runtime may be built for a 68881
+                } else if (strcmp(arch, "m68k020") == 0) {
+                    mp_dynamic_compiler.native_arch = MP_NATIVE_ARCH_M68K020;
+                    mp_dynamic_compiler.nlr_buf_num_regs = MICROPY_NLR_NUM_REGS_M68K_FP; // conservative, the runtime may be built for a 68881
+                } else if (strcmp(arch, "m68k020+fpu") == 0 || strcmp(arch, "m68k+fpu") == 0) {
+                    // coprocessor FPU instructions need a 68020 or later
+                    mp_dynamic_compiler.native_arch = MP_NATIVE_ARCH_M68K020FPU;
+                    mp_dynamic_compiler.nlr_buf_num_regs = MICROPY_NLR_NUM_REGS_M68K_FP; // conservative, the runtime may be built for a 68881
                 } else if (strcmp(arch, "host") == 0) {
                     #if defined(__i386__) || defined(_M_IX86)
                     mp_dynamic_compiler.native_arch = MP_NATIVE_ARCH_X86;
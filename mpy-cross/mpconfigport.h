@@ -49,6 +49,8 @@
 #define MICROPY_EMIT_M68K           (1)
 #define MICROPY_EMIT_INLINE_M68K    (1)
 #define MICROPY_SMALL_INT_MUL_HELPER    (1)
+#define MICROPY_NATIVE_FLOAT_HELPER     (1)
+#define MICROPY_NATIVE_DIRECT_CALL      (1)
 
 #define MICROPY_DYNAMIC_COMPILER    (1)
 #define MICROPY_COMP_CONST_FOLDING  (1)
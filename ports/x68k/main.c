@@ -33,6 +33,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <x68k/dos.h>
+#if MICROPY_X68K_HOST
+#include <sys/mman.h>
+#endif
 
 #include "py/builtin.h"
 #include "py/compile.h"
@@ -101,6 +104,53 @@ STATIC int handle_uncaught_exception(mp_obj_base_t *exc) {
     return 1;
 }
 
+// Called by pyexec_file() after running a script, to return the exit code of
+// the process: 0 on success, the value of SystemExit, or 1 for other
+// exceptions (which pyexec has already reported)
+void x68k_script_exit_code(void *ret_val, int *ret) {
+    mp_obj_base_t *exc = ret_val;
+    if (exc == NULL) {
+        *ret = 0;
+    } else if (mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(exc->type), MP_OBJ_FROM_PTR(&mp_type_SystemExit))) {
+        *ret = handle_uncaught_exception(exc) & 0xff;
+    } else {
+        *ret = 1;
+    }
+}
+
+// Run the script read from stdin when it is not a terminal, as in
+// "micropython < script.py" (tests/run-perfbench.py runs the benchmarks so)
+STATIC int execute_stdin(void) {
+    vstr_t vstr;
+    vstr_init(&vstr, 256);
+    char buf[256];
+    int n;
+    while ((n = read(STDIN_FILENO, buf, sizeof(buf))) > 0) {
+        vstr_add_strn(&vstr, buf, n);
+    }
+
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_lexer_t *lex = mp_lexer_new_from_str_len(MP_QSTR__lt_stdin_gt_, vstr.buf, vstr.len, 0);
+        qstr source_name = lex->source_name;
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        mp_obj_t module_fun = mp_compile(&parse_tree, source_name, false);
+        mp_hal_set_interrupt_char(CHAR_CTRL_C);
+        mp_call_function_0(module_fun);
+        mp_hal_set_interrupt_char(-1);
+        mp_handle_pending(true);
+        nlr_pop();
+        vstr_clear(&vstr);
+        return 0;
+    } else {
+        // uncaught exception
+        mp_hal_set_interrupt_char(-1);
+        mp_handle_pending(false);
+        vstr_clear(&vstr);
+        return handle_uncaught_exception(nlr.ret_val) & 0xff;
+    }
+}
+
 STATIC void print_help(char **argv) {
     printf(
         "usage: %s [<opts>] [-X <implopt>] [-m <module> | <filename>]\n"
@@ -123,6 +173,12 @@ STATIC void print_help(char **argv) {
         #endif
         );
     impl_opts_cnt++;
+    #if MICROPY_EMIT_M68K
+    printf(
+        "  cpu={68000,68010,68020,68030,68040,68060} -- set the CPU that native code is compiled for\n"
+        );
+    impl_opts_cnt++;
+    #endif
     #if MICROPY_ENABLE_GC
     printf(
         "  heapsize=<n>[w][K|M] -- set the heap size for the GC (default %ld)\n"
@@ -164,6 +220,14 @@ STATIC void pre_process_options(int argc, char **argv) {
                 } else if (strcmp(argv[a + 1], "emit=viper") == 0) {
                     emit_opt = MP_EMIT_OPT_VIPER;
                 #endif
+                #if MICROPY_EMIT_M68K
+                } else if (strncmp(argv[a + 1], "cpu=680", sizeof("cpu=680") - 1) == 0) {
+                    const char *cpu = argv[a + 1] + sizeof("cpu=680") - 1;
+                    if (cpu[0] < '0' || cpu[0] > '6' || cpu[0] == '5' || cpu[1] != '0' || cpu[2] != 0) {
+                        goto invalid_arg;
+                    }
+                    mp_hal_set_mpu_type(cpu[0] - '0');
+                #endif
                 #if MICROPY_ENABLE_GC
                 } else if (strncmp(argv[a + 1], "heapsize=", sizeof("heapsize=") - 1) == 0) {
                     char *end;
@@ -227,7 +291,16 @@ MP_NOINLINE int main_(int argc, char **argv) {
 
     #if MICROPY_ENABLE_GC
     #if !MICROPY_GC_SPLIT_HEAP
+    #if MICROPY_X68K_HOST
+    // native code runs from the heap, which must be executable on the host
+    char *heap = mmap(NULL, heap_size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (heap == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    #else
     char *heap = malloc(heap_size);
+    #endif
     gc_init(heap, heap + heap_size);
     #else
     assert(MICROPY_GC_SPLIT_HEAP_N_HEAPS > 0);
@@ -412,6 +485,9 @@ MP_NOINLINE int main_(int argc, char **argv) {
     if (inspect_env && inspect_env[0] != '\0') {
         inspect = true;
     }
+    if (ret == NOTHING_EXECUTED && !inspect && !isatty(STDIN_FILENO)) {
+        ret = execute_stdin();
+    }
     if (ret == NOTHING_EXECUTED || inspect) {
         prompt_read_history();
         mp_hal_setfnckey();
@@ -435,6 +511,8 @@ MP_NOINLINE int main_(int argc, char **argv) {
 
     extern void x68k_freefnc(void);
     x68k_freefnc();
+    extern void x68k_spr_deinit(void);
+    x68k_spr_deinit();
 
     #if MICROPY_PY_MICROPYTHON_MEM_INFO
     #if MICROPY_DEBUG_PRINTERS
@@ -454,7 +532,11 @@ MP_NOINLINE int main_(int argc, char **argv) {
     // We don't really need to free memory since we are about to exit the
     // process, but doing so helps to find memory leaks.
     #if !MICROPY_GC_SPLIT_HEAP
+    #if MICROPY_X68K_HOST
+    munmap(heap, heap_size);
+    #else
     free(heap);
+    #endif
     #else
     for (size_t i = 0; i < MICROPY_GC_SPLIT_HEAP_N_HEAPS; i++) {
         free(heaps[i]);
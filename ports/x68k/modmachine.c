@@ -33,6 +33,21 @@ extern const mp_obj_type_t machine_pin_type;
 
 #if MICROPY_PY_MACHINE
 
+#if MICROPY_X68K_HOST
+#include "modx68k.h"
+
+uintptr_t x68k_host_mem_get_addr(mp_obj_t addr_o, unsigned int align) {
+    uintptr_t addr = mp_obj_get_int_truncated(addr_o);
+    if ((addr & (align - 1)) != 0) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("address %08x is not aligned to %d bytes"), addr, align);
+    }
+    if (addr < X68K_HOST_MEM_BASE || addr > X68K_HOST_MEM_BASE + X68K_HOST_MEM_SIZE - align) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("address %08x is not in the hardware area"), addr);
+    }
+    return (uintptr_t)X68K_ADDR(addr);
+}
+#endif
+
 STATIC const mp_rom_map_elem_t machine_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__),    MP_ROM_QSTR(MP_QSTR_machine) },
 
@@ -32,6 +32,8 @@
 #include "py/mphal.h"
 #include "py/obj.h"
 #include "py/objarray.h"
+#include "py/objmodule.h"
+#include "py/persistentcode.h"
 #include "modx68k.h"
 
 /****************************************************************************/
@@ -39,7 +41,7 @@
 bool x68k_super_mode = false;
 STATIC int super_ssp;
 
-STATIC bool to_super(bool mode) {
+bool x68k_to_super(bool mode) {
     if (mode && !x68k_super_mode) {
         super_ssp = _iocs_b_super(0);
         if (super_ssp < 0) {
@@ -65,13 +67,13 @@ typedef struct _mp_obj_x68k_super_t {
 STATIC mp_obj_t x68k_super_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 0, 0, false);
     mp_obj_x68k_super_t *self = mp_obj_malloc(mp_obj_x68k_super_t, type);
-    self->oldstat = to_super(true);
+    self->oldstat = x68k_to_super(true);
     return MP_OBJ_FROM_PTR(self);
 }
 
 STATIC mp_obj_t x68k_super___exit__(size_t n_args, const mp_obj_t *args) {
     mp_obj_x68k_super_t *self = MP_OBJ_TO_PTR(args[0]);
-    to_super(self->oldstat);
+    x68k_to_super(self->oldstat);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_super___exit___obj, 4, 4, x68k_super___exit__);
@@ -95,7 +97,7 @@ STATIC mp_obj_t x68k_super(size_t n_args, const mp_obj_t *args) {
     if (n_args > 0) {
         mode = mp_obj_is_true(args[0]);
     }
-    return to_super(mode) ? mp_const_true : mp_const_false;
+    return x68k_to_super(mode) ? mp_const_true : mp_const_false;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_super_obj, 0, 1, x68k_super);
 
@@ -108,10 +110,48 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_issuper_obj, x68k_issuper);
 
 STATIC mp_obj_t x68k_mpyaddr(void) {
     extern char _start;
-    return MP_OBJ_NEW_SMALL_INT((int)&_start);
+    return MP_OBJ_NEW_SMALL_INT((mp_int_t)&_start);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_mpyaddr_obj, x68k_mpyaddr);
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// Import a module from a .mpy image at a fixed address (high memory, ROM etc.)
+// that is used in place, so the image must stay there while the module is used.
+STATIC mp_obj_t x68k_mpyimport(mp_obj_t name_in, mp_obj_t addr_in, mp_obj_t size_in) {
+    qstr name = mp_obj_str_get_qstr(name_in);
+    const byte *addr = (const byte *)mp_obj_get_int_truncated(addr_in);
+    size_t size = mp_obj_get_int(size_in);
+
+    mp_map_t *modules = &MP_STATE_VM(mp_loaded_modules_dict).map;
+    mp_obj_t module_obj = mp_obj_new_module(name);
+    mp_module_context_t *context = MP_OBJ_TO_PTR(module_obj);
+
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_compiled_module_t cm;
+        cm.context = context;
+        mp_raw_code_load_rom(addr, size, &cm);
+
+        // execute the module in its context, as import does
+        nlr_jump_callback_node_globals_locals_t ctx;
+        ctx.globals = mp_globals_get();
+        ctx.locals = mp_locals_get();
+        mp_globals_set(context->module.globals);
+        mp_locals_set(context->module.globals);
+        nlr_push_jump_callback(&ctx.callback, mp_globals_locals_set_from_nlr_jump_callback);
+        mp_call_function_0(mp_make_function_from_raw_code(cm.rc, context, NULL));
+        nlr_pop_jump_callback(true);
+        nlr_pop();
+    } else {
+        // a module that failed to load is not left in sys.modules
+        mp_map_lookup(modules, MP_OBJ_NEW_QSTR(name), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+        nlr_jump(nlr.ret_val);
+    }
+    return module_obj;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(x68k_mpyimport_obj, x68k_mpyimport);
+#endif
+
 /****************************************************************************/
 
 STATIC mp_obj_t x68k_crtmod(size_t n_args, const mp_obj_t *args) {
@@ -125,6 +165,9 @@ STATIC mp_obj_t x68k_crtmod(size_t n_args, const mp_obj_t *args) {
     if (clron) {
         _iocs_g_clr_on();
     }
+    #if MICROPY_X68K_GVRAM_DIRECT
+    x68k_gvram_reset();
+    #endif
 
     return mp_const_none;
 }
@@ -144,16 +187,25 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_curoff_obj, x68k_curoff);
 
 #define REG_GPIP        (0xE88001)
 
-STATIC mp_obj_t x68k_vsync(void) {
-    int oldstat = to_super(true);
+void x68k_wait_vblank(void) {
+    #if MICROPY_X68K_HOST
+    // no display to wait for: run the handlers of one frame at once
+    x68k_host_vsync();
+    MICROPY_EVENT_POLL_HOOK
+    #else
     while ((*(volatile uint8_t *)REG_GPIP & 0x10) == 0) {
         MICROPY_EVENT_POLL_HOOK
     }
     while ((*(volatile uint8_t *)REG_GPIP & 0x10) != 0) {
         MICROPY_EVENT_POLL_HOOK
     }
-    to_super(oldstat);
+    #endif
+}
 
+STATIC mp_obj_t x68k_vsync(void) {
+    int oldstat = x68k_to_super(true);
+    x68k_wait_vblank();
+    x68k_to_super(oldstat);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_vsync_obj, x68k_vsync);
@@ -161,7 +213,7 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_vsync_obj, x68k_vsync);
 /****************************************************************************/
 
 STATIC mp_obj_t x68k_fontrom(void) {
-    return mp_obj_new_memoryview('B', 0xc0000, (void *)0xf00000);
+    return mp_obj_new_memoryview('B', 0xc0000, X68K_ADDR(0xf00000));
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(x68k_fontrom_obj, x68k_fontrom);
 
@@ -183,6 +235,9 @@ STATIC const mp_rom_map_elem_t mp_module_x68k_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_intEnable), MP_ROM_PTR(&x68k_intenable_obj) },
 
     { MP_ROM_QSTR(MP_QSTR_mpyaddr), MP_ROM_PTR(&x68k_mpyaddr_obj) },
+    #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+    { MP_ROM_QSTR(MP_QSTR_mpyimport), MP_ROM_PTR(&x68k_mpyimport_obj) },
+    #endif
 
     { MP_ROM_QSTR(MP_QSTR_iocs), MP_ROM_PTR(&x68k_iocs_obj) },
     { MP_ROM_QSTR(MP_QSTR_i), MP_ROM_PTR(&x68k_i_obj_type) },
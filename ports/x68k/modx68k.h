@@ -30,7 +30,30 @@
 
 extern bool x68k_super_mode;
 
+// Switch to the supervisor mode or back to the user mode, and return the
+// previous mode
+bool x68k_to_super(bool mode);
+
+// Wait for the start of the next vertical blanking period.  Must be called in
+// the supervisor mode, as it reads the MFP.
+void x68k_wait_vblank(void);
+
+// Set a routine called at every VSYNC interrupt before the IntVSync callback,
+// or NULL to remove it.  The interrupt is kept registered while either is set.
+void x68k_intvsync_hook(void (*hook)(void));
+
+// Address of the X68000 hardware (VRAM, I/O registers etc.) at addr, which is
+// an array in the host variant
+#if MICROPY_X68K_HOST
+#include "x68khost.h"
+#define X68K_ADDR(addr) X68K_HOST_ADDR(addr)
+#else
+#define X68K_ADDR(addr) ((void *)(addr))
+#endif
+
 MP_DECLARE_CONST_FUN_OBJ_1(x68k_vpage_obj);
+// Forget the GVRAM layout and clipping window after the screen mode changes
+void x68k_gvram_reset(void);
 extern const mp_obj_type_t x68k_type_gvram;
 
 extern const mp_obj_type_t x68k_type_tvram;
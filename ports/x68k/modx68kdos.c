@@ -41,6 +41,10 @@ mp_obj_t x68k_dos(size_t n_args, const mp_obj_t *args) {
         mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
     }
 
+    #if MICROPY_X68K_HOST
+    (void)doscall;
+    result = x68k_host_doscall(mp_obj_get_int(args[0]), bufinfo.buf, bufinfo.len);
+    #else
     __asm volatile (
         "subal %1,%%sp\n"
         "moveal %%sp,%%a0\n"
@@ -59,6 +63,7 @@ mp_obj_t x68k_dos(size_t n_args, const mp_obj_t *args) {
           "a"(bufinfo.buf), "a"(&doscall)
         : "%%d0","%%a0","%%a1", "memory"
     );
+    #endif
 
     return mp_obj_new_int(result);
 }
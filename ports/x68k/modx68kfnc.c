@@ -32,12 +32,26 @@
 
 #include "py/runtime.h"
 #include "py/mphal.h"
+#include "py/mperrno.h"
 #include "py/obj.h"
 #include "modx68k.h"
 #include "modx68kxarray.h"
 
 #undef XFNC_DEBUG
 
+#if MICROPY_X68K_HOST
+
+// FNC files are X-BASIC extensions in 68000 code, which the host cannot run
+STATIC mp_obj_t x68k_loadfnc(size_t n_args, const mp_obj_t *args) {
+    mp_raise_OSError(MP_EOPNOTSUPP);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_loadfnc_obj, 1, 2, x68k_loadfnc);
+
+void x68k_freefnc(void) {
+}
+
+#else
+
 /* X-BASIC FNC file information table format */
 typedef struct _x68k_fnc_info_t {
     union {
@@ -392,3 +406,5 @@ void x68k_freefnc(void)
     }
     xfnc_list = NULL;
 }
+
+#endif // MICROPY_X68K_HOST
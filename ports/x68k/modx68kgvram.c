@@ -26,6 +26,9 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <x68k/iocs.h>
 
 #include "py/runtime.h"
@@ -60,6 +63,256 @@ STATIC void apage(mp_obj_x68k_gvram_t *self) {
     }
 }
 
+/****************************************************************************/
+// Direct GVRAM drawing
+//
+// The drawing methods write the pixels straight into the GVRAM in the
+// supervisor mode instead of calling the IOCS.  They use the GVRAM layout of
+// the screen mode and the clipping window set by GVRam.window(), which are
+// read again after x68k.crtmod() or when a GVRam object is constructed.
+
+#if MICROPY_X68K_GVRAM_DIRECT
+
+STATIC struct {
+    int mode;               // screen mode of the layout, -1 if not read yet
+    int shift;              // log2 of the pixels per line of the GVRAM
+    int pages;
+    uint16_t mask;          // bits of a pixel
+    int x1, y1, x2, y2;     // clipping window
+} gr = { -1 };
+
+void x68k_gvram_reset(void) {
+    gr.mode = -1;
+}
+
+STATIC void gr_setup(void) {
+    if (gr.mode >= 0) {
+        return;
+    }
+    int mode = _iocs_crtmod(-1) & 0xff;
+    gr.mode = mode;
+    if (mode < 4 || (mode >= 16 && mode < 20)) {
+        gr.shift = 10;
+        gr.mask = 0xf;
+        gr.pages = 1;
+    } else if (mode < 8) {
+        gr.shift = 9;
+        gr.mask = 0xf;
+        gr.pages = 4;
+    } else if (mode < 12 || (mode >= 20 && mode < 24)) {
+        gr.shift = 9;
+        gr.mask = 0xff;
+        gr.pages = 2;
+    } else {
+        gr.shift = 9;
+        gr.mask = 0xffff;
+        gr.pages = 1;
+    }
+    gr.x1 = gr.y1 = 0;
+    gr.x2 = gr.y2 = (1 << gr.shift) - 1;
+}
+
+typedef struct _gr_draw_t {
+    uint16_t *vram;         // top of the page
+    int shift;
+    uint16_t color;
+    bool oldstat;
+} gr_draw_t;
+
+// Start drawing on the page of self in the supervisor mode.  Returns false if
+// the page is not in the screen mode, leaving the call to the IOCS.
+STATIC bool gr_begin(mp_obj_x68k_gvram_t *self, gr_draw_t *d, mp_int_t color) {
+    gr_setup();
+    if (self->page < 0 || self->page >= gr.pages) {
+        return false;
+    }
+    d->vram = X68K_ADDR(0xc00000 + 0x80000 * self->page);
+    d->shift = gr.shift;
+    d->color = color & gr.mask;
+    d->oldstat = x68k_to_super(true);
+    return true;
+}
+
+STATIC void gr_end(gr_draw_t *d) {
+    x68k_to_super(d->oldstat);
+}
+
+static inline bool gr_inside(int x, int y) {
+    return x >= gr.x1 && x <= gr.x2 && y >= gr.y1 && y <= gr.y2;
+}
+
+static inline void gr_pset(gr_draw_t *d, int x, int y) {
+    if (gr_inside(x, y)) {
+        d->vram[(y << d->shift) + x] = d->color;
+    }
+}
+
+// Horizontal span from x1 to x2 (x1 <= x2)
+STATIC void gr_hspan(gr_draw_t *d, int x1, int x2, int y) {
+    if (y < gr.y1 || y > gr.y2) {
+        return;
+    }
+    x1 = MAX(x1, gr.x1);
+    x2 = MIN(x2, gr.x2);
+    int n = x2 - x1 + 1;
+    if (n <= 0) {
+        return;
+    }
+    uint16_t *p = &d->vram[(y << d->shift) + x1];
+    uint16_t c = d->color;
+    for (; n >= 8; n -= 8) {
+        p[0] = c;
+        p[1] = c;
+        p[2] = c;
+        p[3] = c;
+        p[4] = c;
+        p[5] = c;
+        p[6] = c;
+        p[7] = c;
+        p += 8;
+    }
+    while (n-- > 0) {
+        *p++ = c;
+    }
+}
+
+// Vertical span from y1 to y2 (y1 <= y2)
+STATIC void gr_vspan(gr_draw_t *d, int x, int y1, int y2) {
+    if (x < gr.x1 || x > gr.x2) {
+        return;
+    }
+    y1 = MAX(y1, gr.y1);
+    y2 = MIN(y2, gr.y2);
+    int n = y2 - y1 + 1;
+    if (n <= 0) {
+        return;
+    }
+    uint16_t *p = &d->vram[(y1 << d->shift) + x];
+    uint16_t c = d->color;
+    int stride = 1 << d->shift;
+    while (n-- > 0) {
+        *p = c;
+        p += stride;
+    }
+}
+
+// Bresenham line where bit 15 of the line style comes first, as the IOCS
+STATIC void gr_line(gr_draw_t *d, int x1, int y1, int x2, int y2, unsigned int style) {
+    style &= 0xffff;
+    if (style == 0xffff) {
+        if (y1 == y2) {
+            gr_hspan(d, MIN(x1, x2), MAX(x1, x2), y1);
+            return;
+        } else if (x1 == x2) {
+            gr_vspan(d, x1, MIN(y1, y2), MAX(y1, y2));
+            return;
+        }
+    }
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        style = ((style << 1) | (style >> 15)) & 0xffff;
+        if (style & 1) {
+            gr_pset(d, x1, y1);
+        }
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+STATIC void gr_box(gr_draw_t *d, int x1, int y1, int x2, int y2, unsigned int style) {
+    gr_line(d, x1, y1, x2, y1, style);
+    gr_line(d, x2, y1, x2, y2, style);
+    gr_line(d, x2, y2, x1, y2, style);
+    gr_line(d, x1, y2, x1, y1, style);
+}
+
+STATIC void gr_fill(gr_draw_t *d, int x1, int y1, int x2, int y2) {
+    if (x1 > x2) {
+        int t = x1;
+        x1 = x2;
+        x2 = t;
+    }
+    if (y1 > y2) {
+        int t = y1;
+        y1 = y2;
+        y2 = t;
+    }
+    y1 = MAX(y1, gr.y1);
+    y2 = MIN(y2, gr.y2);
+    for (int y = y1; y <= y2; y++) {
+        gr_hspan(d, x1, x2, y);
+    }
+}
+
+// The points (x, y) from the centre in the four quadrants, or the spans
+// between them when the ellipse is filled
+STATIC void gr_plot4(gr_draw_t *d, int cx, int cy, int x, int y, bool fill) {
+    if (fill) {
+        gr_hspan(d, cx - x, cx + x, cy - y);
+        if (y != 0) {
+            gr_hspan(d, cx - x, cx + x, cy + y);
+        }
+    } else {
+        gr_pset(d, cx + x, cy + y);
+        gr_pset(d, cx - x, cy + y);
+        gr_pset(d, cx + x, cy - y);
+        gr_pset(d, cx - x, cy - y);
+    }
+}
+
+// Midpoint ellipse with the radii rx, ry.  A filled ellipse draws each line
+// once, at the widest point of the outline on it.
+STATIC void gr_ellipse(gr_draw_t *d, int cx, int cy, int rx, int ry, bool fill) {
+    int64_t rx2 = (int64_t)rx * rx, ry2 = (int64_t)ry * ry;
+    int x = 0, y = ry;
+    int64_t px = 0, py = 2 * rx2 * y;
+    int64_t e = ry2 - rx2 * ry + rx2 / 4;
+    while (px < py) {
+        if (!fill) {
+            gr_plot4(d, cx, cy, x, y, false);
+        }
+        x++;
+        px += 2 * ry2;
+        if (e < 0) {
+            e += ry2 + px;
+        } else {
+            if (fill) {
+                gr_plot4(d, cx, cy, x - 1, y, true);
+            }
+            y--;
+            py -= 2 * rx2;
+            e += ry2 + px - py;
+        }
+    }
+    e = ry2 * (2 * x + 1) * (2 * x + 1) / 4 + rx2 * (y - 1) * (y - 1) - rx2 * ry2;
+    while (y >= 0) {
+        gr_plot4(d, cx, cy, x, y, fill);
+        y--;
+        py -= 2 * rx2;
+        if (e > 0) {
+            e += rx2 - py;
+        } else {
+            x++;
+            px += 2 * ry2;
+            e += rx2 - py + px;
+        }
+    }
+}
+
+#endif // MICROPY_X68K_GVRAM_DIRECT
+
 STATIC mp_obj_t x68k_gvram_palet(mp_obj_t self_in, mp_obj_t arg1, mp_obj_t arg2) {
     mp_int_t pal = mp_obj_get_int(arg1);
     mp_int_t col = mp_obj_get_int(arg2);
@@ -110,6 +363,15 @@ STATIC mp_obj_t x68k_gvram_window(size_t n_args, const mp_obj_t *pos_args, mp_ma
 
     int res = _iocs_window(args[ARG_x0].u_int, args[ARG_y0].u_int,
                            args[ARG_x1].u_int, args[ARG_y1].u_int);
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_setup();
+    if (res == 0) {
+        gr.x1 = args[ARG_x0].u_int;
+        gr.y1 = args[ARG_y0].u_int;
+        gr.x2 = args[ARG_x1].u_int;
+        gr.y2 = args[ARG_y1].u_int;
+    }
+    #endif
     return MP_OBJ_NEW_SMALL_INT(res);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_gvram_window_obj, 2, x68k_gvram_window);
@@ -137,6 +399,17 @@ STATIC mp_obj_t x68k_gvram_pset(size_t n_args, const mp_obj_t *pos_args, mp_map_
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    #if MICROPY_X68K_GVRAM_DIRECT
+    // switching to the supervisor mode costs more than the IOCS call itself,
+    // so a single point is drawn directly only within x68k.Super()
+    gr_draw_t d;
+    if (x68k_super_mode && gr_begin(self, &d, args[ARG_c].u_int)) {
+        gr_pset(&d, (int16_t)args[ARG_x].u_int, (int16_t)args[ARG_y].u_int);
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+
     struct iocs_psetptr p = { 
         args[ARG_x].u_int, args[ARG_y].u_int,
         args[ARG_c].u_int
@@ -146,6 +419,48 @@ STATIC mp_obj_t x68k_gvram_pset(size_t n_args, const mp_obj_t *pos_args, mp_map_
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_gvram_pset_obj, 1, x68k_gvram_pset);
 
+STATIC mp_obj_t x68k_gvram_plot(size_t n_args, const mp_obj_t *args) {
+    mp_obj_x68k_gvram_t *self = MP_OBJ_TO_PTR(args[0]);
+    apage(self);
+
+    // (x, y, c) records, or (x, y) when c is given
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
+    int step = n_args > 2 ? 2 : 3;
+    mp_int_t c = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    const int16_t *pt = bufinfo.buf;
+    size_t n = bufinfo.len / (step * sizeof(int16_t));
+
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_draw_t d;
+    if (gr_begin(self, &d, c)) {
+        if (step == 2) {
+            for (; n > 0; n--, pt += 2) {
+                gr_pset(&d, pt[0], pt[1]);
+            }
+        } else {
+            for (; n > 0; n--, pt += 3) {
+                d.color = pt[2] & gr.mask;
+                gr_pset(&d, pt[0], pt[1]);
+            }
+        }
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+
+    int res = 0;
+    for (; n > 0; n--, pt += step) {
+        struct iocs_psetptr p = { pt[0], pt[1], step == 2 ? c : pt[2] };
+        res = _iocs_pset(&p);
+        if (res < 0) {
+            break;
+        }
+    }
+    return MP_OBJ_NEW_SMALL_INT(res);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_gvram_plot_obj, 2, 3, x68k_gvram_plot);
+
 STATIC mp_obj_t x68k_gvram_point(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     enum { ARG_x, ARG_y };
     static const mp_arg_t allowed_args[] = {
@@ -160,6 +475,17 @@ STATIC mp_obj_t x68k_gvram_point(size_t n_args, const mp_obj_t *pos_args, mp_map
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_draw_t d;
+    if (x68k_super_mode && gr_begin(self, &d, 0)) {
+        int x = (int16_t)args[ARG_x].u_int;
+        int y = (int16_t)args[ARG_y].u_int;
+        mp_int_t res = gr_inside(x, y) ? d.vram[(y << d.shift) + x] : -1;
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(res);
+    }
+    #endif
+
     struct iocs_pointptr p = { 
         args[ARG_x].u_int, args[ARG_y].u_int,
         0
@@ -191,6 +517,16 @@ STATIC mp_obj_t x68k_gvram_line(size_t n_args, const mp_obj_t *pos_args, mp_map_
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_draw_t d;
+    if (gr_begin(self, &d, args[ARG_c].u_int)) {
+        gr_line(&d, (int16_t)args[ARG_x0].u_int, (int16_t)args[ARG_y0].u_int,
+                (int16_t)args[ARG_x1].u_int, (int16_t)args[ARG_y1].u_int, args[ARG_style].u_int);
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+
     struct iocs_lineptr p = { 
         args[ARG_x0].u_int, args[ARG_y0].u_int,
         args[ARG_x1].u_int, args[ARG_y1].u_int,
@@ -219,6 +555,16 @@ STATIC mp_obj_t x68k_gvram_box(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_draw_t d;
+    if (gr_begin(self, &d, args[ARG_c].u_int)) {
+        gr_box(&d, (int16_t)args[ARG_x0].u_int, (int16_t)args[ARG_y0].u_int,
+               (int16_t)args[ARG_x1].u_int, (int16_t)args[ARG_y1].u_int, args[ARG_style].u_int);
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+
     struct iocs_boxptr p = { 
         args[ARG_x0].u_int, args[ARG_y0].u_int,
         args[ARG_x1].u_int, args[ARG_y1].u_int,
@@ -246,6 +592,16 @@ STATIC mp_obj_t x68k_gvram_fill(size_t n_args, const mp_obj_t *pos_args, mp_map_
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    #if MICROPY_X68K_GVRAM_DIRECT
+    gr_draw_t d;
+    if (gr_begin(self, &d, args[ARG_c].u_int)) {
+        gr_fill(&d, (int16_t)args[ARG_x0].u_int, (int16_t)args[ARG_y0].u_int,
+                (int16_t)args[ARG_x1].u_int, (int16_t)args[ARG_y1].u_int);
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+
     struct iocs_fillptr p = { 
         args[ARG_x0].u_int, args[ARG_y0].u_int,
         args[ARG_x1].u_int, args[ARG_y1].u_int,
@@ -257,7 +613,7 @@ STATIC mp_obj_t x68k_gvram_fill(size_t n_args, const mp_obj_t *pos_args, mp_map_
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_gvram_fill_obj, 1, x68k_gvram_fill);
 
 STATIC mp_obj_t x68k_gvram_circle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_x, ARG_y, ARG_r, ARG_c, ARG_start, ARG_end, ARG_ratio };
+    enum { ARG_x, ARG_y, ARG_r, ARG_c, ARG_start, ARG_end, ARG_ratio, ARG_fill };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_x,     MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_y,     MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
@@ -266,6 +622,7 @@ STATIC mp_obj_t x68k_gvram_circle(size_t n_args, const mp_obj_t *pos_args, mp_ma
         { MP_QSTR_start, MP_ARG_INT, {.u_int = 0} },
         { MP_QSTR_end,   MP_ARG_INT, {.u_int = 360} },
         { MP_QSTR_ratio, MP_ARG_INT, {.u_int = 256} },
+        { MP_QSTR_fill,  MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
     };
 
     mp_obj_x68k_gvram_t *self = pos_args[0];
@@ -275,6 +632,31 @@ STATIC mp_obj_t x68k_gvram_circle(size_t n_args, const mp_obj_t *pos_args, mp_ma
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
                      MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
+    bool arc = args[ARG_start].u_int != 0 || args[ARG_end].u_int != 360;
+    if (args[ARG_fill].u_bool && arc) {
+        mp_raise_ValueError(MP_ERROR_TEXT("can't fill an arc"));
+    }
+
+    #if MICROPY_X68K_GVRAM_DIRECT
+    // arcs are left to the IOCS
+    gr_draw_t d;
+    if (!arc && gr_begin(self, &d, args[ARG_c].u_int)) {
+        int rx = (uint16_t)args[ARG_r].u_int, ry = rx;
+        unsigned int ratio = (uint16_t)args[ARG_ratio].u_int;
+        if (ratio < 256) {
+            ry = rx * ratio / 256;
+        } else if (ratio > 256) {
+            rx = ry * 256 / ratio;
+        }
+        gr_ellipse(&d, (int16_t)args[ARG_x].u_int, (int16_t)args[ARG_y].u_int, rx, ry, args[ARG_fill].u_bool);
+        gr_end(&d);
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    #endif
+    if (args[ARG_fill].u_bool) {
+        return MP_OBJ_NEW_SMALL_INT(-1);
+    }
+
     struct iocs_circleptr p = { 
         args[ARG_x].u_int, args[ARG_y].u_int,
         args[ARG_r].u_int, args[ARG_c].u_int,
@@ -422,6 +804,219 @@ STATIC mp_obj_t x68k_gvram_put(size_t n_args, const mp_obj_t *pos_args, mp_map_t
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_gvram_put_obj, 1, x68k_gvram_put);
 
+#if MICROPY_X68K_GVRAM_DIRECT
+
+enum { BLIT_COPY, BLIT_OR, BLIT_XOR, BLIT_AND };
+
+// Combine n pixels of the row s into the row d.  Pixels of s equal to key
+// are skipped, unless key is negative.
+STATIC void blit_row(uint16_t *d, const uint16_t *s, int n, int op, int key, uint16_t mask) {
+    if (key >= 0) {
+        for (; n > 0; n--, d++, s++) {
+            uint16_t c = *s;
+            if ((c & mask) == key) {
+                continue;
+            }
+            switch (op) {
+                case BLIT_COPY:
+                    *d = c;
+                    break;
+                case BLIT_OR:
+                    *d |= c;
+                    break;
+                case BLIT_XOR:
+                    *d ^= c;
+                    break;
+                default:
+                    *d &= c;
+                    break;
+            }
+        }
+        return;
+    }
+    switch (op) {
+        case BLIT_COPY:
+            // written with post-increments so that each copy can be a single
+            // move.w (a0)+,(a1)+
+            for (; n >= 8; n -= 8) {
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+                *d++ = *s++;
+            }
+            while (n-- > 0) {
+                *d++ = *s++;
+            }
+            break;
+        case BLIT_OR:
+            while (n-- > 0) {
+                *d++ |= *s++;
+            }
+            break;
+        case BLIT_XOR:
+            while (n-- > 0) {
+                *d++ ^= *s++;
+            }
+            break;
+        default:
+            while (n-- > 0) {
+                *d++ &= *s++;
+            }
+            break;
+    }
+}
+
+STATIC mp_obj_t x68k_gvram_blit(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_src, ARG_x, ARG_y, ARG_w, ARG_h, ARG_key, ARG_op, ARG_sx, ARG_sy, ARG_stride };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src,    MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_x,      MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_y,      MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_w,      MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_h,      MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_key,    MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_op,     MP_ARG_OBJ, {.u_rom_obj = MP_ROM_QSTR(MP_QSTR_copy)} },
+        { MP_QSTR_sx,     MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_sy,     MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_stride, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 0} },
+    };
+
+    mp_obj_x68k_gvram_t *self = pos_args[0];
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
+                     MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    int op;
+    switch (mp_obj_str_get_qstr(args[ARG_op].u_obj)) {
+        case MP_QSTR_copy:
+            op = BLIT_COPY;
+            break;
+        case MP_QSTR_or:
+            op = BLIT_OR;
+            break;
+        case MP_QSTR_xor:
+            op = BLIT_XOR;
+            break;
+        case MP_QSTR_and:
+            op = BLIT_AND;
+            break;
+        default:
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid op"));
+    }
+
+    gr_setup();
+    if (self->page < 0 || self->page >= gr.pages) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid page"));
+    }
+    int key = -1;
+    if (args[ARG_key].u_obj != mp_const_none) {
+        key = mp_obj_get_int(args[ARG_key].u_obj) & gr.mask;
+    }
+
+    // The source is a GVRAM page, or an image in a buffer with stride pixels
+    // per line, in the pixel format of GVRam.get()/put()
+    mp_obj_x68k_gvram_t *src = NULL;
+    mp_buffer_info_t bufinfo;
+    int width = 1 << gr.shift;
+    int bits = gr.mask == 0xf ? 4 : gr.mask == 0xff ? 8 : 16;
+    int x = args[ARG_x].u_int, y = args[ARG_y].u_int;
+    int w = args[ARG_w].u_int, h = args[ARG_h].u_int;
+    int sx = args[ARG_sx].u_int, sy = args[ARG_sy].u_int;
+    int sw, sh;
+    if (mp_obj_is_type(args[ARG_src].u_obj, &x68k_type_gvram)) {
+        src = MP_OBJ_TO_PTR(args[ARG_src].u_obj);
+        if (src->page < 0 || src->page >= gr.pages) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid page"));
+        }
+        sw = sh = width;
+    } else {
+        mp_get_buffer_raise(args[ARG_src].u_obj, &bufinfo, MP_BUFFER_READ);
+        sw = args[ARG_stride].u_int > 0 ? args[ARG_stride].u_int : w;
+        sh = INT_MAX;
+    }
+
+    // clip to the window and to the source
+    if (x < gr.x1) {
+        sx += gr.x1 - x;
+        w -= gr.x1 - x;
+        x = gr.x1;
+    }
+    if (y < gr.y1) {
+        sy += gr.y1 - y;
+        h -= gr.y1 - y;
+        y = gr.y1;
+    }
+    if (sx < 0) {
+        x -= sx;
+        w += sx;
+        sx = 0;
+    }
+    if (sy < 0) {
+        y -= sy;
+        h += sy;
+        sy = 0;
+    }
+    w = MIN(w, MIN(gr.x2 - x + 1, sw - sx));
+    h = MIN(h, MIN(gr.y2 - y + 1, sh - sy));
+    if (w <= 0 || h <= 0) {
+        return mp_const_none;
+    }
+    if (src == NULL) {
+        size_t end = ((size_t)(sy + h - 1) * sw + sx + w) * bits;
+        if ((end + 7) / 8 > bufinfo.len) {
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+        }
+    }
+
+    uint16_t line[1024];
+    bool oldstat = x68k_to_super(true);
+    uint16_t *dvram = X68K_ADDR(0xc00000 + 0x80000 * self->page);
+    uint16_t *svram = src ? X68K_ADDR(0xc00000 + 0x80000 * src->page) : NULL;
+    // copy from the bottom when the lines move down on the same page
+    bool up = src != NULL && src->page == self->page && y > sy;
+    for (int j = 0; j < h; j++) {
+        int row = up ? h - 1 - j : j;
+        uint16_t *d = &dvram[((y + row) << gr.shift) + x];
+        const uint16_t *s;
+        if (src != NULL) {
+            s = &svram[((sy + row) << gr.shift) + sx];
+            if (src->page == self->page) {
+                // the source and the destination may overlap on the line
+                memcpy(line, s, w * sizeof(uint16_t));
+                s = line;
+            }
+        } else {
+            size_t pos = (size_t)(sy + row) * sw + sx;
+            const uint8_t *b = bufinfo.buf;
+            if (bits == 16 && ((uintptr_t)b & 1) == 0) {
+                s = (const uint16_t *)b + pos;
+            } else {
+                for (int i = 0; i < w; i++, pos++) {
+                    if (bits == 4) {
+                        line[i] = (pos & 1) ? (b[pos / 2] & 0xf) : (b[pos / 2] >> 4);
+                    } else if (bits == 8) {
+                        line[i] = b[pos];
+                    } else {
+                        memcpy(&line[i], &b[pos * 2], sizeof(uint16_t));
+                    }
+                }
+                s = line;
+            }
+        }
+        blit_row(d, s, w, op, key, gr.mask);
+    }
+    x68k_to_super(oldstat);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_gvram_blit_obj, 1, x68k_gvram_blit);
+
+#endif // MICROPY_X68K_GVRAM_DIRECT
+
 STATIC mp_obj_t x68k_gvram_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 0, 1, false);
 
@@ -431,13 +1026,19 @@ STATIC mp_obj_t x68k_gvram_make_new(const mp_obj_type_t *type, size_t n_args, si
         o->page = mp_obj_get_int(args[0]);
     }
     if (o->page == 0) {
-        o->buf = (void *)0xc00000;
+        o->buf = X68K_ADDR(0xc00000);
         o->len = 0x200000;
     } else {
-        o->buf = (void *)(0xc00000 + 0x80000 * o->page);
+        o->buf = X68K_ADDR(0xc00000 + 0x80000 * o->page);
         o->len = 0x80000;
     }
     current_page = -1;
+    #if MICROPY_X68K_GVRAM_DIRECT
+    // the screen mode may have been changed by x68k.iocs()
+    if (gr.mode >= 0 && (_iocs_crtmod(-1) & 0xff) != gr.mode) {
+        x68k_gvram_reset();
+    }
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -492,6 +1093,7 @@ STATIC const mp_rom_map_elem_t x68k_gvram_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_window), MP_ROM_PTR(&x68k_gvram_window_obj) },
     { MP_ROM_QSTR(MP_QSTR_wipe),   MP_ROM_PTR(&x68k_gvram_wipe_obj) },
     { MP_ROM_QSTR(MP_QSTR_pset),   MP_ROM_PTR(&x68k_gvram_pset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_plot),   MP_ROM_PTR(&x68k_gvram_plot_obj) },
     { MP_ROM_QSTR(MP_QSTR_point),  MP_ROM_PTR(&x68k_gvram_point_obj) },
     { MP_ROM_QSTR(MP_QSTR_line),   MP_ROM_PTR(&x68k_gvram_line_obj) },
     { MP_ROM_QSTR(MP_QSTR_box),    MP_ROM_PTR(&x68k_gvram_box_obj) },
@@ -501,6 +1103,9 @@ STATIC const mp_rom_map_elem_t x68k_gvram_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_symbol), MP_ROM_PTR(&x68k_gvram_symbol_obj) },
     { MP_ROM_QSTR(MP_QSTR_get),    MP_ROM_PTR(&x68k_gvram_get_obj) },
     { MP_ROM_QSTR(MP_QSTR_put),    MP_ROM_PTR(&x68k_gvram_put_obj) },
+    #if MICROPY_X68K_GVRAM_DIRECT
+    { MP_ROM_QSTR(MP_QSTR_blit),   MP_ROM_PTR(&x68k_gvram_blit_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(x68k_gvram_locals_dict, x68k_gvram_locals_dict_table);
 
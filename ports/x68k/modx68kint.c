@@ -35,6 +35,14 @@
 #include "py/gc.h"
 #include "modx68k.h"
 
+// The handlers are called by the IOCS as interrupt routines, and by
+// x68k.vsync() as plain functions in the host variant
+#if MICROPY_X68K_HOST
+#define INTERRUPT_HANDLER
+#else
+#define INTERRUPT_HANDLER __attribute__((interrupt))
+#endif
+
 /****************************************************************************/
 
 typedef enum {
@@ -87,7 +95,7 @@ typedef struct _x68k_intopm_t {
     mp_obj_base_t base;
 } x68k_intopm_t;
 
-__attribute__((interrupt))
+INTERRUPT_HANDLER
 STATIC void handle_intopm(void) {
     int_helper(INT_OPMINT);
 }
@@ -193,7 +201,7 @@ typedef struct _x68k_inttimerd_t {
     mp_int_t cycle;
 } x68k_inttimerd_t;
 
-__attribute__((interrupt))
+INTERRUPT_HANDLER
 STATIC void handle_inttimerd(void) {
     int_helper(INT_TIMERD);
 }
@@ -301,9 +309,44 @@ typedef struct _x68k_intvsync_t {
     mp_int_t cycle;
 } x68k_intvsync_t;
 
-__attribute__((interrupt))
+// C routine run before the Python callback, for Sprite.update()
+STATIC void (*intvsync_hook)(void);
+STATIC mp_int_t intvsync_disp;
+STATIC mp_int_t intvsync_cycle = 1;
+STATIC volatile mp_int_t intvsync_count;
+
+INTERRUPT_HANDLER
 STATIC void handle_intvsync(void) {
-    int_helper(INT_VSYNC);
+    if (intvsync_hook != NULL) {
+        // the interrupt comes every frame, so count the callback's cycle here
+        intvsync_hook();
+        if (++intvsync_count < intvsync_cycle) {
+            return;
+        }
+        intvsync_count = 0;
+    }
+    if (x68k_int_data[INT_VSYNC].callback != MP_OBJ_NULL) {
+        int_helper(INT_VSYNC);
+    }
+}
+
+// Register the VSYNC interrupt while the callback or the hook is set.  The
+// hook must run in every vertical blanking period, so while it is set the
+// callback is called then too, whatever its disp.
+STATIC void intvsync_setup(void) {
+    mp_obj_t callback = x68k_int_data[INT_VSYNC].callback;
+    _iocs_vdispst(0, 0, 0);
+    intvsync_count = 0;
+    if (intvsync_hook != NULL) {
+        _iocs_vdispst(handle_intvsync, 0, 1);
+    } else if (callback != MP_OBJ_NULL && callback != mp_const_none) {
+        _iocs_vdispst(handle_intvsync, intvsync_disp, intvsync_cycle);
+    }
+}
+
+void x68k_intvsync_hook(void (*hook)(void)) {
+    intvsync_hook = hook;
+    intvsync_setup();
 }
 
 STATIC mp_obj_t x68k_intvsync_callback(size_t n_args, const mp_obj_t *args) {
@@ -313,12 +356,13 @@ STATIC mp_obj_t x68k_intvsync_callback(size_t n_args, const mp_obj_t *args) {
         callback = args[1];
     }
     if (callback == mp_const_none) {
-        _iocs_vdispst(0, 0, 0);
         x68k_int_data[INT_VSYNC].callback = mp_const_none;
+        intvsync_setup();
     } else if (mp_obj_is_callable(callback)) {
-        _iocs_vdispst(0, 0, 0);
         x68k_int_data[INT_VSYNC].callback = callback;
-        _iocs_vdispst(handle_intvsync, self->disp, self->cycle);
+        intvsync_disp = self->disp;
+        intvsync_cycle = self->cycle;
+        intvsync_setup();
     } else {
         mp_raise_ValueError(MP_ERROR_TEXT("callback must be None or a callable object"));
     }
@@ -358,8 +402,8 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_KW(x68k_intvsync_init_obj, 1, x68k_intvsync_init)
 STATIC mp_obj_t x68k_intvsync_deinit(mp_obj_t self_in) {
     x68k_intvsync_t *self = MP_OBJ_TO_PTR(self_in);
     (void)(self);
-    _iocs_vdispst(0, 0, 0);
     x68k_int_data[INT_VSYNC].callback = mp_const_none;
+    intvsync_setup();
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(x68k_intvsync_deinit_obj,x68k_intvsync_deinit);
@@ -377,8 +421,8 @@ STATIC mp_obj_t x68k_intvsync_make_new(const mp_obj_type_t *type, size_t n_args,
 STATIC mp_obj_t x68k_intvsync___exit__(size_t n_args, const mp_obj_t *args) {
     x68k_intvsync_t *self = MP_OBJ_TO_PTR(args[0]);
     (void)(self);
-    _iocs_vdispst(0, 0, 0);
     x68k_int_data[INT_VSYNC].callback = mp_const_none;
+    intvsync_setup();
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_intvsync___exit___obj, 4, 4, x68k_intvsync___exit__);
@@ -408,7 +452,7 @@ typedef struct _x68k_intraster_t {
     mp_int_t raster;
 } x68k_intraster_t;
 
-__attribute__((interrupt))
+INTERRUPT_HANDLER
 STATIC void handle_intraster(void) {
     int_helper(INT_CRTCRAS);
 }
@@ -507,6 +551,27 @@ MP_DEFINE_CONST_OBJ_TYPE(
 
 /****************************************************************************/
 
+// The status register, where interrupts can be masked in supervisor mode
+#if MICROPY_X68K_HOST
+static inline uint16_t get_sr(void) {
+    return x68k_super_mode ? 0x2000 : 0;
+}
+
+static inline void set_sr(uint16_t sr) {
+    (void)sr;
+}
+#else
+static inline uint16_t get_sr(void) {
+    uint16_t sr;
+    __asm__ volatile ("movew %%sr,%0" : "=d"(sr));
+    return sr;
+}
+
+static inline void set_sr(uint16_t sr) {
+    __asm__ volatile ("movew %0,%%sr" : : "d"(sr));
+}
+#endif
+
 typedef struct _x68k_intdisable_t {
     mp_obj_base_t base;
     uint16_t oldsr;
@@ -515,10 +580,10 @@ typedef struct _x68k_intdisable_t {
 STATIC mp_obj_t x68k_intdisable_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 0, 0, false);
     x68k_intdisable_t *self = mp_obj_malloc(x68k_intdisable_t, type);
-    __asm__ volatile ("movew %%sr,%0" : "=d"(self->oldsr));
+    self->oldsr = get_sr();
     if (self->oldsr & 0x2000) {
         /* disable interrupt only when in supervisor mode */
-        __asm__ volatile ("movew %0,%%sr" : : "d"(self->oldsr | 0x0700));
+        set_sr(self->oldsr | 0x0700);
     }
     return MP_OBJ_FROM_PTR(self);
 }
@@ -527,7 +592,7 @@ STATIC mp_obj_t x68k_intdisable___exit__(size_t n_args, const mp_obj_t *args) {
     x68k_intdisable_t *self = MP_OBJ_TO_PTR(args[0]);
     if (self->oldsr & 0x2000) {
         /* restore interrupt mask only when in supervisor mode */
-        __asm__ volatile ("movew %0,%%sr" : : "d"(self->oldsr));
+        set_sr(self->oldsr);
     }
     return mp_const_none;
 }
@@ -549,10 +614,10 @@ MP_DEFINE_CONST_OBJ_TYPE(
 
 STATIC mp_obj_t x68k_intdisable(void) {
     uint16_t oldsr;
-    __asm__ volatile ("movew %%sr,%0" : "=d"(oldsr));
+    oldsr = get_sr();
     if (oldsr & 0x2000) {
         /* disable interrupt only when in supervisor mode */
-        __asm__ volatile ("movew %0,%%sr" : : "d"(oldsr | 0x0700));
+        set_sr(oldsr | 0x0700);
     }
     return MP_OBJ_NEW_SMALL_INT(oldsr);
 }
@@ -562,7 +627,7 @@ STATIC mp_obj_t x68k_intenable(mp_obj_t self_in) {
     uint16_t oldsr = mp_obj_get_int(self_in);
     if (oldsr & 0x2000) {
         /* restore interrupt mask only when in supervisor mode */
-        __asm__ volatile ("movew %0,%%sr" : : "d"(oldsr));
+        set_sr(oldsr);
     }
     return mp_const_none;
 }
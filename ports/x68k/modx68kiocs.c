@@ -89,6 +89,9 @@ STATIC mp_obj_t x68k_iocs(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
         }
     }
 
+    #if MICROPY_X68K_HOST
+    x68k_host_trap15(regs);
+    #else
     __asm volatile (
         "moveml %0@, %%d0-%%d5/%%a1-%%a2\n"
         "trap #15\n"
@@ -96,6 +99,7 @@ STATIC mp_obj_t x68k_iocs(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
         : : "a"(regs)
         : "%%d0","%%d1","%%d2","%%d3","%%d4","%%d5","%%a1","%%a2", "memory"
     );
+    #endif
 
     if (rd + ra == 0) {
         return mp_obj_new_int(regs[0]);
@@ -131,6 +131,128 @@ STATIC mp_obj_t x68k_spr_set(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_spr_set_obj, 2, 7, x68k_spr_set);
 
+/****************************************************************************/
+
+// Sprite scroll registers: x, y, code and priority of the 128 sprites
+#define SPR_REG         (0xeb0000)
+#define SPR_NUM         (128)
+
+// Sprite.update() modes
+#define SPR_UPDATE_NOW      (0)     // write at once
+#define SPR_UPDATE_VSYNC    (1)     // wait for the vertical blanking and write
+#define SPR_UPDATE_DEFER    (2)     // written by the next VSYNC interrupt
+
+typedef struct _x68k_spr_reg_t {
+    uint16_t x;
+    uint16_t y;
+    uint16_t code;
+    uint16_t prio;
+} x68k_spr_reg_t;
+
+// Registers waiting for the VSYNC interrupt, and which of them are set
+STATIC volatile x68k_spr_reg_t spr_back[SPR_NUM];
+STATIC volatile uint32_t spr_dirty[SPR_NUM / 32];
+STATIC volatile bool spr_busy;
+STATIC bool spr_hooked;
+
+STATIC void spr_write(volatile x68k_spr_reg_t *reg, const volatile x68k_spr_reg_t *val) {
+    reg->x = val->x;
+    reg->y = val->y;
+    reg->code = val->code;
+    reg->prio = val->prio;
+}
+
+// Called at the VSYNC interrupt in the supervisor mode
+STATIC void spr_flush(void) {
+    if (spr_busy) {
+        // Sprite.update() is filling the back buffer: leave it to the next frame
+        return;
+    }
+    volatile x68k_spr_reg_t *reg = X68K_ADDR(SPR_REG);
+    for (int i = 0; i < SPR_NUM / 32; i++) {
+        uint32_t dirty = spr_dirty[i];
+        if (dirty == 0) {
+            continue;
+        }
+        spr_dirty[i] = 0;
+        for (int n = i * 32; dirty != 0; n++, dirty >>= 1) {
+            if (dirty & 1) {
+                spr_write(&reg[n], &spr_back[n]);
+            }
+        }
+    }
+}
+
+void x68k_spr_deinit(void) {
+    if (spr_hooked) {
+        x68k_intvsync_hook(NULL);
+        spr_hooked = false;
+    }
+}
+
+STATIC mp_obj_t x68k_spr_update(size_t n_args, const mp_obj_t *args) {
+    mp_int_t mode = SPR_UPDATE_VSYNC;
+    if (n_args > 2) {
+        mode = mp_obj_get_int(args[2]);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len % (5 * sizeof(int16_t)) != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer must hold (plane, x, y, code, prio) records"));
+    }
+    const int16_t *rec = bufinfo.buf;
+    size_t n = bufinfo.len / (5 * sizeof(int16_t));
+
+    // check all the records first so that an error leaves the sprites as they are
+    for (size_t i = 0; i < n; i++) {
+        if ((uint16_t)rec[i * 5] >= SPR_NUM) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid sprite plane"));
+        }
+    }
+
+    if (mode == SPR_UPDATE_DEFER) {
+        if (!spr_hooked) {
+            x68k_intvsync_hook(spr_flush);
+            spr_hooked = true;
+        }
+        spr_busy = true;
+        for (size_t i = 0; i < n; i++, rec += 5) {
+            volatile x68k_spr_reg_t *b = &spr_back[rec[0]];
+            b->x = rec[1] & 0x3ff;
+            b->y = rec[2] & 0x3ff;
+            b->code = rec[3] & 0xcfff;
+            b->prio = rec[4] & 3;
+            spr_dirty[rec[0] / 32] |= 1u << (rec[0] % 32);
+        }
+        spr_busy = false;
+        return mp_const_none;
+    }
+
+    // planes written here must not be overwritten later by a pending deferred
+    // update
+    spr_busy = true;
+    for (size_t i = 0; i < n; i++) {
+        spr_dirty[rec[i * 5] / 32] &= ~(1u << (rec[i * 5] % 32));
+    }
+    spr_busy = false;
+
+    int oldstat = x68k_to_super(true);
+    if (mode != SPR_UPDATE_NOW) {
+        x68k_wait_vblank();
+    }
+    volatile x68k_spr_reg_t *reg = X68K_ADDR(SPR_REG);
+    for (size_t i = 0; i < n; i++, rec += 5) {
+        volatile x68k_spr_reg_t *r = &reg[rec[0]];
+        r->x = rec[1] & 0x3ff;
+        r->y = rec[2] & 0x3ff;
+        r->code = rec[3] & 0xcfff;
+        r->prio = rec[4] & 3;
+    }
+    x68k_to_super(oldstat);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(x68k_spr_update_obj, 2, 3, x68k_spr_update);
+
 STATIC mp_obj_t x68k_spr_palet(size_t n_args, const mp_obj_t *args) {
     mp_int_t p = mp_obj_get_int(args[1]);
     mp_int_t pb = 1;
@@ -224,7 +346,7 @@ STATIC mp_obj_t x68k_sprite_make_new(const mp_obj_type_t *type, size_t n_args, s
     mp_arg_check_num(n_args, n_kw, 0, 0, false);
 
     mp_obj_x68k_sprite_t *o = mp_obj_malloc(mp_obj_x68k_sprite_t, type);
-    o->buf = (void *)0xeb8000;
+    o->buf = X68K_ADDR(0xeb8000);
     o->len = 0x8000;
     return MP_OBJ_FROM_PTR(o);
 }
@@ -280,6 +402,7 @@ STATIC const mp_rom_map_elem_t x68k_sprite_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_clr),    MP_ROM_PTR(&x68k_spr_clr_obj) },
     { MP_ROM_QSTR(MP_QSTR_defcg),  MP_ROM_PTR(&x68k_spr_defcg_obj) },
     { MP_ROM_QSTR(MP_QSTR_set),    MP_ROM_PTR(&x68k_spr_set_obj) },
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&x68k_spr_update_obj) },
     { MP_ROM_QSTR(MP_QSTR_palet),  MP_ROM_PTR(&x68k_spr_palet_obj) },
 
     { MP_ROM_QSTR(MP_QSTR_bgdisp), MP_ROM_PTR(&x68k_spr_bgdisp_obj) },
@@ -288,6 +411,10 @@ STATIC const mp_rom_map_elem_t x68k_sprite_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_bgset),  MP_ROM_PTR(&x68k_spr_bgset_obj) },
     { MP_ROM_QSTR(MP_QSTR_bgget),  MP_ROM_PTR(&x68k_spr_bgget_obj) },
     { MP_ROM_QSTR(MP_QSTR_bgscroll), MP_ROM_PTR(&x68k_spr_bgscroll_obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_NOW),    MP_ROM_INT(SPR_UPDATE_NOW) },
+    { MP_ROM_QSTR(MP_QSTR_VSYNC),  MP_ROM_INT(SPR_UPDATE_VSYNC) },
+    { MP_ROM_QSTR(MP_QSTR_DEFER),  MP_ROM_INT(SPR_UPDATE_DEFER) },
 };
 STATIC MP_DEFINE_CONST_DICT(x68k_sprite_locals_dict, x68k_sprite_locals_dict_table);
 
@@ -313,7 +313,7 @@ STATIC mp_obj_t x68k_tvram_make_new(const mp_obj_type_t *type, size_t n_args, si
     mp_arg_check_num(n_args, n_kw, 0, 0, false);
 
     mp_obj_x68k_tvram_t *o = mp_obj_malloc(mp_obj_x68k_tvram_t, type);
-    o->buf = (void *)0xe00000;
+    o->buf = X68K_ADDR(0xe00000);
     o->len = 0x80000;
     return MP_OBJ_FROM_PTR(o);
 }
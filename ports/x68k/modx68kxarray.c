@@ -84,6 +84,7 @@ STATIC mp_obj_x68k_xarray_t *xarray_new(char typecode, size_t dim1, size_t dim2)
     mp_obj_x68k_xarray_t *o = m_new_obj(mp_obj_x68k_xarray_t);
     o->base.type = &x68k_type_xarray;
     o->typecode = typecode;
+    o->rows = NULL;
     size_t bodysize;
     if (dim2 <= 0) {
         o->dim = 1;
@@ -242,50 +243,126 @@ STATIC mp_obj_t xarray_unary_op(mp_unary_op_t op, mp_obj_t o_in) {
     }
 }
 
-STATIC mp_obj_t xarray_get_val(mp_obj_x68k_xarray_t *o, size_t index) {
-    if (xarray_dim(o) > 1) {
-        // create new array object pointing to single column
-        index *= xarray_sub2(o);
-        if (index >= o->len) {
-            return MP_OBJ_SENTINEL;
-        }
+// Row view of a 2-dimension xarray: an array object sharing the row's items.
+// Views are made once per row and kept, so that a[i][j] in a loop allocates
+// nothing after the first pass.
+STATIC mp_obj_t xarray_get_row(mp_obj_x68k_xarray_t *o, size_t row) {
+    if (o->rows == NULL) {
+        o->rows = m_new0(mp_obj_t, xarray_sub1(o));
+    }
+    if (o->rows[row] == MP_OBJ_NULL) {
         mp_obj_array_t *col = m_new_obj(mp_obj_array_t);
         col->base.type = &mp_type_array;
         col->typecode = o->typecode;
         col->free = 0;
         col->len = xarray_sub2(o);
-        col->items = o->items + index * o->head->dim1.unitsz;
-        return MP_OBJ_FROM_PTR(col);
+        col->items = o->items + row * o->head->dim1sz;
+        o->rows[row] = MP_OBJ_FROM_PTR(col);
+    }
+    return o->rows[row];
+}
+
+STATIC mp_obj_t xarray_get_val(mp_obj_x68k_xarray_t *o, size_t index) {
+    if (xarray_dim(o) > 1) {
+        if (index >= xarray_sub1(o)) {
+            return MP_OBJ_SENTINEL;
+        }
+        return xarray_get_row(o, index);
     } else {
         return mp_binary_get_val_array(o->typecode & TYPECODE_MASK, o->items, index);
     }
 }
 
+// Whether items of typecode a can be copied as they are to items of typecode b:
+// both are floats of the same type, or integers of the same size
+STATIC bool xarray_same_type(int a, int b) {
+    if (a == 'f' || a == 'd' || b == 'f' || b == 'd') {
+        return a == b;
+    }
+    return mp_binary_get_size('@', a, NULL) == mp_binary_get_size('@', b, NULL);
+}
+
+// Store n elements from start with the items of src: a buffer of the same
+// item type is copied at once, other iterables item by item
+STATIC void xarray_store_items(mp_obj_x68k_xarray_t *o, size_t start, size_t n, mp_obj_t src) {
+    int typecode = o->typecode & TYPECODE_MASK;
+    size_t sz = o->head->dim1.unitsz;
+    mp_buffer_info_t bufinfo;
+    if (mp_get_buffer(src, &bufinfo, MP_BUFFER_READ)
+        && xarray_same_type(bufinfo.typecode, typecode)) {
+        if (bufinfo.len != n * sz) {
+            mp_raise_ValueError(MP_ERROR_TEXT("xarray size mismatch"));
+        }
+        memmove(o->items + start * sz, bufinfo.buf, bufinfo.len);
+        return;
+    }
+    if (mp_obj_is_int(src) || mp_obj_is_float(src)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("xarray row or slice requires a sequence"));
+    }
+    size_t len = MP_OBJ_SMALL_INT_VALUE(mp_obj_len(src));
+    if (len != n) {
+        mp_raise_ValueError(MP_ERROR_TEXT("xarray size mismatch"));
+    }
+    mp_obj_t iterable = mp_getiter(src, NULL);
+    mp_obj_t item;
+    for (size_t i = 0; i < n && (item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION; i++) {
+        mp_binary_set_val_array(typecode, o->items, start + i, item);
+    }
+}
+
 STATIC mp_obj_t xarray_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value) {
     if (value == MP_OBJ_NULL) {
         // delete item
         return MP_OBJ_NULL; // op not supported
-    } else {
-        mp_obj_x68k_xarray_t *o = MP_OBJ_TO_PTR(self_in);
-        {
-            size_t index = mp_get_index(o->base.type, o->len, index_in, false);
-            if (value == MP_OBJ_SENTINEL) {
-                // load
-                mp_obj_t res = xarray_get_val(o, index);
-                if (res == MP_OBJ_SENTINEL) {
-                    mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("xarray index out of range"));
-                }
-                return res;
-            } else {
-                // store
-                if (xarray_dim(o) > 1) {
-                    return MP_OBJ_NULL; // op not supported
-                }
-                mp_binary_set_val_array(o->typecode & TYPECODE_MASK, o->items, index, value);
-                return mp_const_none;
-            }
+    }
+    mp_obj_x68k_xarray_t *o = MP_OBJ_TO_PTR(self_in);
+    int typecode = o->typecode & TYPECODE_MASK;
+
+    if (mp_obj_is_type(index_in, &mp_type_tuple)) {
+        // a[i, j]: an element of a 2-dimension xarray, without a row view
+        size_t n;
+        mp_obj_t *idx;
+        mp_obj_tuple_get(index_in, &n, &idx);
+        if (n != 2 || xarray_dim(o) != 2) {
+            mp_raise_TypeError(MP_ERROR_TEXT("xarray index dimension mismatch"));
+        }
+        size_t i = mp_get_index(o->base.type, xarray_sub1(o), idx[0], false);
+        size_t j = mp_get_index(o->base.type, xarray_sub2(o), idx[1], false);
+        size_t index = i * xarray_sub2(o) + j;
+        if (value == MP_OBJ_SENTINEL) {
+            return mp_binary_get_val_array(typecode, o->items, index);
+        }
+        mp_binary_set_val_array(typecode, o->items, index, value);
+        return mp_const_none;
+    }
+
+    // rows of a 2-dimension xarray, elements of a 1-dimension one
+    size_t unit = xarray_dim(o) > 1 ? xarray_sub2(o) : 1;
+    #if MICROPY_PY_BUILTINS_SLICE
+    if (mp_obj_is_type(index_in, &mp_type_slice)) {
+        mp_bound_slice_t slice;
+        if (value == MP_OBJ_SENTINEL
+            || !mp_seq_get_fast_slice_indexes(xarray_sub1(o), index_in, &slice)) {
+            mp_raise_NotImplementedError(NULL);
         }
+        // a[i:j] = src: the elements do not move, so src must fill the slice
+        size_t n = slice.stop > slice.start ? slice.stop - slice.start : 0;
+        xarray_store_items(o, slice.start * unit, n * unit, value);
+        return mp_const_none;
     }
+    #endif
+
+    size_t index = mp_get_index(o->base.type, xarray_dim(o) > 1 ? xarray_sub1(o) : o->len, index_in, false);
+    if (value == MP_OBJ_SENTINEL) {
+        // load
+        return xarray_get_val(o, index);
+    } else if (xarray_dim(o) > 1) {
+        // store a whole row
+        xarray_store_items(o, index * unit, unit, value);
+    } else {
+        mp_binary_set_val_array(typecode, o->items, index, value);
+    }
+    return mp_const_none;
 }
 
 STATIC mp_int_t xarray_get_buffer(mp_obj_t o_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
@@ -334,9 +411,51 @@ STATIC mp_obj_t xarray_list(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(xarray_list_obj, 1, 2, xarray_list);
 
+// Set all elements to value: the first one is converted and then copied
+// over the whole buffer in doubling blocks
+STATIC mp_obj_t xarray_fill(mp_obj_t o_in, mp_obj_t value) {
+    mp_obj_x68k_xarray_t *o = MP_OBJ_TO_PTR(o_in);
+    size_t sz = o->head->dim1.unitsz;
+    size_t total = o->len * sz;
+    if (total == 0) {
+        return mp_const_none;
+    }
+    mp_binary_set_val_array(o->typecode & TYPECODE_MASK, o->items, 0, value);
+    byte *p = o->items;
+    if (sz == 1) {
+        memset(p + 1, p[0], total - 1);
+        return mp_const_none;
+    }
+    for (size_t done = sz; done < total; done *= 2) {
+        memcpy(p + done, p, MIN(done, total - done));
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(xarray_fill_obj, xarray_fill);
+
+// Copy all elements from src (a buffer of the same size, or a sequence of
+// len(a) items), regardless of the dimensions
+STATIC mp_obj_t xarray_copyfrom(mp_obj_t o_in, mp_obj_t src) {
+    mp_obj_x68k_xarray_t *o = MP_OBJ_TO_PTR(o_in);
+    mp_buffer_info_t bufinfo;
+    if (mp_get_buffer(src, &bufinfo, MP_BUFFER_READ)) {
+        // raw copy from any buffer, e.g. bytes read from a file
+        if (bufinfo.len != o->len * o->head->dim1.unitsz) {
+            mp_raise_ValueError(MP_ERROR_TEXT("xarray size mismatch"));
+        }
+        memmove(o->items, bufinfo.buf, bufinfo.len);
+    } else {
+        xarray_store_items(o, 0, o->len, src);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(xarray_copyfrom_obj, xarray_copyfrom);
+
 STATIC const mp_rom_map_elem_t xarray_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_shape), MP_ROM_PTR(&xarray_shape_obj) },
     { MP_ROM_QSTR(MP_QSTR_list), MP_ROM_PTR(&xarray_list_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&xarray_fill_obj) },
+    { MP_ROM_QSTR(MP_QSTR_copyfrom), MP_ROM_PTR(&xarray_copyfrom_obj) },
 };
 STATIC MP_DEFINE_CONST_DICT(xarray_locals_dict, xarray_locals_dict_table);
 
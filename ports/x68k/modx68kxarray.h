@@ -52,6 +52,7 @@ typedef struct _mp_obj_x68k_xarray_t {
     void *items;        // direct pointer to the xarray contents
     int dim;            // # of dimension
     x68k_xarray2_head_t *head;  // pointer to the xarray header
+    mp_obj_t *rows;     // row views of a 2-dimension xarray, made on first use
 } mp_obj_x68k_xarray_t;
 
 // Accessor macros
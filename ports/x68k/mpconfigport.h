@@ -28,6 +28,12 @@
 
 #include <stdint.h>
 
+// Build for the host machine with the stand-in IOCS/DOS library, see
+// variants/host.
+#ifndef MICROPY_X68K_HOST
+#define MICROPY_X68K_HOST (0)
+#endif
+
 // Set base feature level.
 #define MICROPY_CONFIG_ROM_LEVEL (MICROPY_CONFIG_ROM_LEVEL_EXTRA_FEATURES)
 
@@ -66,6 +72,19 @@
 // Allow loading of .mpy files.
 #define MICROPY_PERSISTENT_CODE_LOAD   (1)
 
+// Allow x68k.mpyimport() to run .mpy images in memory without copying them.
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (1)
+
+// Cache modules compiled at import in __pycache__, so that native code and
+// bytecode are not compiled again on the next run.  Saving native code needs
+// its qstrs looked up through the module's table, which takes one of the
+// registers otherwise given to local variables.  The host variant runs the
+// test suite, which must not leave caches behind in the test directories, so
+// there it saves caches only when a test sets sys.dont_write_bytecode = False.
+#define MICROPY_PERSISTENT_CODE_SAVE   (1)
+#define MICROPY_PERSISTENT_CODE_CACHE  (1)
+#define MICROPY_PERSISTENT_CODE_CACHE_DONT_WRITE (MICROPY_X68K_HOST)
+
 // Enable a small performance boost for the VM.
 #define MICROPY_OPT_COMPUTED_GOTO      (1)
 
@@ -97,6 +116,17 @@
 // Enable the "machine" module.
 #define MICROPY_PY_MACHINE             (1)
 #define MICROPY_PY_MACHINE_PIN_MAKE_NEW     mp_pin_make_new
+#if MICROPY_X68K_HOST
+// machine.mem8/16/32 access the hardware array of the host variant, see modmachine.c
+extern uintptr_t x68k_host_mem_get_addr(void *addr_o, unsigned int align);
+#define MICROPY_MACHINE_MEM_GET_READ_ADDR   x68k_host_mem_get_addr
+#define MICROPY_MACHINE_MEM_GET_WRITE_ADDR  x68k_host_mem_get_addr
+#endif
+
+// Draw with GVRam methods by writing into the GVRAM instead of the IOCS calls
+#ifndef MICROPY_X68K_GVRAM_DIRECT
+#define MICROPY_X68K_GVRAM_DIRECT      (1)
+#endif
 
 #ifndef MICROPY_PY_SYS_PATH_DEFAULT
 #define MICROPY_PY_SYS_PATH_DEFAULT ".frozen"
@@ -105,8 +135,18 @@
 #define MP_STATE_PORT MP_STATE_VM
 
 // Configure which emitter to use for this target.
+#if MICROPY_X68K_HOST
+#define MICROPY_EMIT_X64            (1)
+#else
 #define MICROPY_EMIT_INLINE_M68K    (1)
 #define MICROPY_EMIT_M68K           (1)
+// Native code uses 68020 instructions, and viper floats the FPU, when the CPU
+// has them, see mphalport.c
+extern int mp_hal_mpu_type(void);
+extern int mp_hal_has_fpu(void);
+#define MICROPY_EMIT_M68K_68020     (mp_hal_mpu_type() >= 2)
+#define MICROPY_EMIT_M68K_FPU       (mp_hal_has_fpu())
+#endif
 
 // Type definitions for the specific machine based on the word size.
 typedef intptr_t mp_int_t; // must be pointer size
@@ -155,6 +195,15 @@ extern const struct _mp_print_t mp_stderr_print;
 #define MICROPY_DEBUG_PRINTER (&mp_stderr_print)
 #define MICROPY_ERROR_PRINTER (&mp_stderr_print)
 
+// Exit code of a script run from the command line, see main.c
+extern void x68k_script_exit_code(void *ret_val, int *ret);
+#define MICROPY_BOARD_AFTER_PYTHON_EXEC(input_kind, exec_flags, ret_val, ret) \
+    do { \
+        if ((exec_flags) & EXEC_FLAG_SOURCE_IS_FILENAME) { \
+            x68k_script_exit_code(ret_val, ret); \
+        } \
+    } while (0)
+
 #ifndef MICROPY_EVENT_POLL_HOOK
 #define MICROPY_EVENT_POLL_HOOK \
     do { \
@@ -165,11 +214,13 @@ extern const struct _mp_print_t mp_stderr_print;
 
 // Python internal features.
 #define MICROPY_SMALL_INT_MUL_HELPER            (1)
+#define MICROPY_NATIVE_FLOAT_HELPER             (1)
+#define MICROPY_NATIVE_DIRECT_CALL              (1)
 
 #define MICROPY_SCHEDULER_STATIC_NODES          (1)
 
 #define MICROPY_PY_SELECT                       (0)
-#define MICROPY_PY_ASYNC_AWAIT                  (0)
+#define MICROPY_PY_ASYNC_AWAIT                  (1)
 #define MICROPY_PY_ASYNCIO                      (0)
 
 #define MICROPY_PY_BUILTINS_STR_UNICODE         (0)
@@ -181,4 +232,6 @@ extern const struct _mp_print_t mp_stderr_print;
 #define MICROPY_PY_RE_MATCH_SPAN_START_END      (1)
 #define MICROPY_PY_RE_SUB                       (1)
 
+#if !MICROPY_X68K_HOST
 #define MP_SSIZE_MAX (0x7fffffff)
+#endif
@@ -36,6 +36,7 @@
 #include "py/mphal.h"
 #include "py/mpconfig.h"
 #include "py/misc.h"
+#include "modx68k.h"
 
 // Receive single character
 int mp_hal_stdin_rx_chr(void) {
@@ -57,12 +58,31 @@ mp_uint_t mp_hal_ticks_ms(void) {
     return t.sec * 10;
 }
 
-mp_uint_t mp_hal_ticks_us(void) {
-    return mp_hal_ticks_ms() * 1000;
-}
+// MFP timer C counts down from 200 at 4MHz/200 = 20kHz and its 100Hz interrupt
+// advances the IOCS ONTIME counter, so the timer data register gives the position
+// within the current 10ms tick.
+#define MFP_TCDR            ((volatile uint8_t *)0xe88023)
+#define MFP_TIMERC_COUNT    (200)
 
+// Time since boot in units of 50us
 mp_uint_t mp_hal_ticks_cpu(void) {
-    return 0;
+    for (;;) {
+        int t0 = _iocs_ontime().sec;
+        #if MICROPY_X68K_HOST
+        int c = _iocs_b_bpeek(MFP_TCDR);
+        #else
+        int c = x68k_super_mode ? *MFP_TCDR : _iocs_b_bpeek(MFP_TCDR);
+        #endif
+        int t1 = _iocs_ontime().sec;
+        if (t0 == t1) {
+            return t0 * MFP_TIMERC_COUNT + (MFP_TIMERC_COUNT - c);
+        }
+        // timer C reloaded while reading, try again
+    }
+}
+
+mp_uint_t mp_hal_ticks_us(void) {
+    return mp_hal_ticks_cpu() * 50;
 }
 
 uint64_t mp_hal_time_ns(void) {
@@ -84,7 +104,57 @@ void mp_hal_delay_ms(mp_uint_t ms) {
 }
 
 void mp_hal_delay_us(mp_uint_t us) {
-    mp_hal_delay_ms(us / 1000);
+    if (us >= 10000) {
+        mp_hal_delay_ms(us / 1000);
+        us %= 1000;
+    }
+    mp_uint_t t0 = mp_hal_ticks_cpu();
+    while ((mp_hal_ticks_cpu() - t0) * 50 < us) {
+    }
+}
+
+// IOCS _SYS_STAT mode 0: bits 0-7 are the MPU type (0, 1, 2, 3, 4 or 6 for the
+// 68000 to 68060), bit 15 is set for an FPU.  IOCS without _SYS_STAT returns -1.
+STATIC int mp_hal_sys_stat(void) {
+    static int sys_stat = -2;
+    if (sys_stat == -2) {
+        #if MICROPY_X68K_HOST
+        sys_stat = -1;
+        #else
+        register int d0 __asm("d0") = 0xac;
+        register int d1 __asm("d1") = 0;
+        __asm volatile (
+            "trap #15\n"
+            : "+d"(d0), "+d"(d1)
+            :
+            : "d2", "a0", "a1", "memory"
+        );
+        sys_stat = d0;
+        #endif
+    }
+    return sys_stat;
+}
+
+// MPU type that native code is compiled for, overridden by -X cpu=
+STATIC int mpu_type = -1;
+
+int mp_hal_mpu_type(void) {
+    if (mpu_type < 0) {
+        int stat = mp_hal_sys_stat();
+        mpu_type = stat == -1 ? 0 : stat & 0xff;
+    }
+    return mpu_type;
+}
+
+void mp_hal_set_mpu_type(int type) {
+    mpu_type = type;
+}
+
+// Whether the FPU can be used with coprocessor instructions, which needs a 68020
+// or later: a 68881 on a 68000 board is only reachable through memory-mapped I/O
+int mp_hal_has_fpu(void) {
+    int stat = mp_hal_sys_stat();
+    return stat != -1 && (stat & 0x8000) != 0 && mp_hal_mpu_type() >= 2;
 }
 
 void mp_hal_set_interrupt_char(char c) {
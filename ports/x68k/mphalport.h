@@ -26,5 +26,8 @@
 
 void mp_hal_set_interrupt_char(char c);
 
+int mp_hal_mpu_type(void);
+void mp_hal_set_mpu_type(int type);
+
 void mp_hal_setfnckey(void);
 void mp_hal_restorefnckey(void);
@@ -48,8 +48,9 @@
 #define MICROPY_EMIT_M68K           (1)
 #define MICROPY_EMIT_INLINE_M68K    (1)
 #define MICROPY_SMALL_INT_MUL_HELPER    (1)
+#define MICROPY_NATIVE_FLOAT_HELPER     (1)
 #define MICROPY_MPYCROSS_DEFAULT_ARCH           MP_NATIVE_ARCH_M68K
-#define MICROPY_MPYCROSS_DEFAULT_NLR_NUM_REGS   (0)
+#define MICROPY_MPYCROSS_DEFAULT_NLR_NUM_REGS   (MICROPY_NLR_NUM_REGS_M68K_FP)
 
 #define MICROPY_DYNAMIC_COMPILER    (1)
 #define MICROPY_COMP_CONST_FOLDING  (1)
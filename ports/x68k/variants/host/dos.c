@@ -0,0 +1,305 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Human68k DOS calls of the host variant, mapped onto POSIX.  Errors are
+// returned as negative Human68k error codes, as DOS does.
+
+#include <dirent.h>
+#include <errno.h>
+#include <fnmatch.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include <x68k/dos.h>
+
+#include "x68khost.h"
+
+// Human68k error codes
+#define DOSE_ILGFNC     (-1)    // invalid function
+#define DOSE_NOENT      (-2)    // file not found
+#define DOSE_NODIR      (-3)    // directory not found
+#define DOSE_MFILE      (-4)    // too many open files
+#define DOSE_ISDIR      (-5)    // directory or volume label
+#define DOSE_NOMEM      (-8)    // out of memory
+#define DOSE_ILGFNAME   (-13)   // invalid file name
+#define DOSE_ILGPARM    (-14)   // invalid parameter
+#define DOSE_NOMORE     (-18)   // no more files
+#define DOSE_RDONLY     (-19)   // write protected
+#define DOSE_EXISTDIR   (-20)   // directory exists
+#define DOSE_NOTEMPTY   (-21)   // directory not empty
+#define DOSE_CANTREN    (-22)   // cannot rename
+#define DOSE_DISKFULL   (-23)   // disk full
+#define DOSE_EXISTFILE  (-80)   // file exists
+
+static const struct {
+    signed char doserr;
+    unsigned char err;
+} errtbl[] = {
+    { DOSE_ILGFNC, ENOSYS },
+    { DOSE_NOENT, ENOENT },
+    { DOSE_NODIR, ENOENT },
+    { DOSE_MFILE, EMFILE },
+    { DOSE_ISDIR, EISDIR },
+    { DOSE_NOMEM, ENOMEM },
+    { DOSE_ILGFNAME, EINVAL },
+    { DOSE_ILGPARM, EINVAL },
+    { DOSE_NOMORE, ENOENT },
+    { DOSE_RDONLY, EROFS },
+    { DOSE_EXISTDIR, EEXIST },
+    { DOSE_NOTEMPTY, ENOTEMPTY },
+    { DOSE_CANTREN, EACCES },
+    { DOSE_DISKFULL, ENOSPC },
+    { DOSE_EXISTFILE, EEXIST },
+};
+
+// Same as libx68k: the errno for a (positive) Human68k error code
+int __doserr2errno(int error) {
+    for (size_t i = 0; i < sizeof(errtbl) / sizeof(errtbl[0]); i++) {
+        if (errtbl[i].doserr == -error) {
+            return errtbl[i].err;
+        }
+    }
+    return EIO;
+}
+
+static int errno2doserr(int err) {
+    for (size_t i = 0; i < sizeof(errtbl) / sizeof(errtbl[0]); i++) {
+        if (errtbl[i].err == err) {
+            return errtbl[i].doserr;
+        }
+    }
+    return DOSE_ILGFNC;
+}
+
+/****************************************************************************/
+
+int _dos_inkey(void) {
+    unsigned char c;
+    if (read(STDIN_FILENO, &c, 1) != 1) {
+        return 0x04;    // end of input works as ^D
+    }
+    return c;
+}
+
+static int breakck_mode = 1;
+
+int _dos_breakck(int mode) {
+    int old = breakck_mode;
+    if (mode >= 0 && mode <= 2) {
+        breakck_mode = mode;
+    }
+    return old;
+}
+
+// Vectors 0xfff0-0xffff (_EXITVC, _CTRLVC, _ERRJVC, ...).  They are stored but
+// never called, as the host delivers ^C and errors by signals.
+static void (*dos_vectors[16])(void);
+
+void *_dos_intvcs(int intno, void (*jobadr)(void)) {
+    if (intno < 0xfff0 || intno > 0xffff) {
+        return NULL;
+    }
+    void (*old)(void) = dos_vectors[intno - 0xfff0];
+    dos_vectors[intno - 0xfff0] = jobadr;
+    return (void *)old;
+}
+
+// Function key definitions, 6 bytes each as in _FNCKEY for the cursor keys
+static char fnckeys[32][6];
+
+int _dos_fnckeygt(int fno, char *buf) {
+    if (fno < 1 || fno > 32) {
+        return DOSE_ILGPARM;
+    }
+    memcpy(buf, fnckeys[fno - 1], sizeof(fnckeys[0]));
+    return 0;
+}
+
+int _dos_fnckeyst(int fno, const char *buf) {
+    if (fno < 1 || fno > 32) {
+        return DOSE_ILGPARM;
+    }
+    strncpy(fnckeys[fno - 1], buf, sizeof(fnckeys[0]));
+    return 0;
+}
+
+/****************************************************************************/
+
+// Attributes of a file as in the Human68k directory entry
+static int file_atr(const char *path) {
+    struct stat st;
+    if (stat(path, &st) < 0) {
+        return -1;
+    }
+    int atr = S_ISDIR(st.st_mode) ? 0x10 : 0x20;
+    if (access(path, W_OK) < 0) {
+        atr |= 0x01;
+    }
+    return atr;
+}
+
+// Search the directory from the entry buf->pos for a name matching the pattern.
+// The directory is read again each time, so that an abandoned search (an
+// ilistdir() iterator not run to the end) holds no resources.
+static int files_next(struct dos_filbuf *buf) {
+    DIR *dir = opendir(buf->dir[0] ? buf->dir : ".");
+    if (dir == NULL) {
+        return DOSE_NODIR;
+    }
+    struct dirent *de;
+    int pos = 0;
+    int res = DOSE_NOMORE;
+    while ((de = readdir(dir)) != NULL) {
+        if (pos++ < buf->pos) {
+            continue;
+        }
+        // "*.*" matches every name, also the ones without an extension
+        if (strcmp(buf->pattern, "*.*") != 0 && fnmatch(buf->pattern, de->d_name, 0) != 0) {
+            continue;
+        }
+        char path[sizeof(buf->dir) + sizeof(buf->name) + 1];
+        snprintf(path, sizeof(path), "%s%s%s", buf->dir, buf->dir[0] ? "/" : "", de->d_name);
+        int atr = file_atr(path);
+        if (atr < 0 || (atr & buf->searchatr & 0x30) == 0) {
+            continue;
+        }
+        buf->atr = atr;
+        strncpy(buf->name, de->d_name, sizeof(buf->name) - 1);
+        buf->name[sizeof(buf->name) - 1] = '\0';
+        res = 0;
+        break;
+    }
+    buf->pos = pos;
+    closedir(dir);
+    return res;
+}
+
+int _dos_files(struct dos_filbuf *buf, const char *file, int atr) {
+    const char *sep = strrchr(file, '/');
+    size_t dirlen = sep ? (size_t)(sep - file) : 0;
+    const char *name = sep ? sep + 1 : file;
+    if (dirlen >= sizeof(buf->dir) || strlen(name) >= sizeof(buf->pattern)) {
+        return DOSE_ILGFNAME;
+    }
+    memset(buf, 0, sizeof(*buf));
+    memcpy(buf->dir, file, dirlen);
+    if (sep == file) {
+        strcpy(buf->dir, "/");
+    }
+    strcpy(buf->pattern, name);
+    buf->searchatr = atr;
+
+    if (strpbrk(name, "*?") == NULL) {
+        // a single file
+        int fatr = file_atr(file);
+        if (fatr < 0) {
+            return errno == ENOTDIR ? DOSE_NODIR : DOSE_NOENT;
+        }
+        if ((fatr & atr & 0x30) == 0) {
+            return DOSE_NOENT;
+        }
+        buf->atr = fatr;
+        strcpy(buf->name, name);
+        buf->pos = -1;
+        return 0;
+    }
+    return files_next(buf);
+}
+
+int _dos_nfiles(struct dos_filbuf *buf) {
+    if (buf->pos < 0) {
+        return DOSE_NOMORE;
+    }
+    return files_next(buf);
+}
+
+int _dos_rename(const char *oldname, const char *newname) {
+    if (access(newname, F_OK) == 0) {
+        return DOSE_EXISTFILE;
+    }
+    if (rename(oldname, newname) < 0) {
+        return errno2doserr(errno);
+    }
+    return 0;
+}
+
+#define CURDIR_MAX      (255)
+
+// The host file system is drive A:
+int _dos_curdrv(void) {
+    return 0;
+}
+
+int _dos_curdir(int drive, char *buf) {
+    // Human68k paths are up to 64 bytes, but the port passes a larger buffer
+    char cwd[CURDIR_MAX + 1];
+    if (drive > 1) {
+        return DOSE_ILGPARM;
+    }
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        return errno == ERANGE ? DOSE_ILGFNAME : errno2doserr(errno);
+    }
+    // the current directory without the leading separator
+    strcpy(buf, cwd + 1);
+    return 0;
+}
+
+int _dos_dskfre(int drive, struct dos_freeinf *buf) {
+    struct statvfs st;
+    if (drive > 1) {
+        return DOSE_ILGPARM;
+    }
+    if (statvfs(".", &st) < 0) {
+        return errno2doserr(errno);
+    }
+    // scale the cluster size so the cluster counts fit in 16 bits
+    unsigned long sec = 1;
+    while (st.f_blocks / sec > 0xffff && sec < 0x8000) {
+        sec *= 2;
+    }
+    buf->byte = st.f_frsize > 0xffff ? 0x8000 : st.f_frsize;
+    buf->sec = sec;
+    buf->max = st.f_blocks / sec > 0xffff ? 0xffff : st.f_blocks / sec;
+    buf->free = st.f_bavail / sec > 0xffff ? 0xffff : st.f_bavail / sec;
+    return (int)buf->free * buf->sec * buf->byte;
+}
+
+/****************************************************************************/
+
+int x68k_host_doscall(int callno, const uint8_t *args, size_t len) {
+    (void)args;
+    (void)len;
+    switch (callno & 0xffff) {
+        case 0xff19:    // _CURDRV
+            return _dos_curdrv();
+        case 0xff30:    // _VERNUM: "68" and Human68k 3.02
+            return 0x36380302;
+        default:
+            return DOSE_ILGFNC;
+    }
+}
@@ -0,0 +1,958 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// IOCS calls of the host variant.  The video RAM, palettes and sprite
+// registers are modelled in x68k_host_mem at their X68000 addresses, and the
+// drawing calls write there as the IOCS would, so that programs (and the port's
+// own direct VRAM access) see the same memory contents.  Nothing is displayed.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <x68k/iocs.h>
+
+#include "x68khost.h"
+
+uint8_t x68k_host_mem[X68K_HOST_MEM_SIZE] __attribute__((aligned(4)));
+
+#define GVRAM           (0xc00000)
+#define TVRAM           (0xe00000)
+#define TVRAM_PLANE     (0x20000)
+#define GPALET          (0xe82000)
+#define TPALET          (0xe82200)
+#define MFP_GPIP        (0xe88001)
+#define MFP_TCDR        (0xe88023)
+#define SPRITE_REG      (0xeb0000)
+#define BG_SCROLL       (0xeb0800)
+#define BG_CTRL         (0xeb0808)
+#define PCG             (0xeb8000)
+#define BG_TEXT         (0xebc000)
+
+#define MEM16(addr)     (*(uint16_t *)X68K_HOST_ADDR(addr))
+
+/****************************************************************************/
+// Graphic screen
+
+// Graphic screen layout of the current CRTMOD mode
+static int crt_mode = 16;
+static int gr_width;            // pixels per line of the GVRAM (512 or 1024)
+static int gr_colors;           // 16, 256 or 65536
+static int gr_pages;            // number of pages
+static int gr_page;             // active page for drawing
+static struct {
+    int x1, y1, x2, y2;
+} gr_window;
+
+static void gr_setup(void) {
+    int mode = crt_mode;
+    if (mode < 4 || (mode >= 16 && mode < 20)) {
+        gr_width = 1024;
+        gr_colors = 16;
+        gr_pages = 1;
+    } else if (mode < 8) {
+        gr_width = 512;
+        gr_colors = 16;
+        gr_pages = 4;
+    } else if (mode < 12 || (mode >= 20 && mode < 24)) {
+        gr_width = 512;
+        gr_colors = 256;
+        gr_pages = 2;
+    } else {
+        gr_width = 512;
+        gr_colors = 65536;
+        gr_pages = 1;
+    }
+    gr_page = 0;
+    gr_window.x1 = gr_window.y1 = 0;
+    gr_window.x2 = gr_window.y2 = gr_width - 1;
+}
+
+static uint16_t *gr_addr(int x, int y) {
+    return &MEM16(GVRAM + gr_page * 0x80000 + (y * gr_width + x) * 2);
+}
+
+static inline bool gr_inside(int x, int y) {
+    return x >= gr_window.x1 && x <= gr_window.x2 && y >= gr_window.y1 && y <= gr_window.y2;
+}
+
+static inline void gr_pset(int x, int y, int color) {
+    if (gr_inside(x, y)) {
+        *gr_addr(x, y) = color & (gr_colors - 1);
+    }
+}
+
+int _iocs_crtmod(int mode) {
+    if (mode < 0) {
+        return crt_mode;
+    }
+    if (mode > 27) {
+        return -1;
+    }
+    crt_mode = mode;
+    gr_setup();
+    return 0;
+}
+
+int _iocs_g_clr_on(void) {
+    memset(X68K_HOST_ADDR(GVRAM), 0, 0x200000);
+    gr_setup();
+    return 0;
+}
+
+int _iocs_apage(int page) {
+    if (gr_width == 0) {
+        gr_setup();
+    }
+    if (page < 0 || page >= gr_pages) {
+        return -1;
+    }
+    gr_page = page;
+    return 0;
+}
+
+static int gr_vpage = 0xf;
+static int gr_home[4][2];
+
+int _iocs_vpage(int page) {
+    gr_vpage = page;
+    return 0;
+}
+
+int _iocs_home(int page, int x, int y) {
+    for (int i = 0; i < 4; i++) {
+        if (page & (1 << i)) {
+            gr_home[i][0] = x;
+            gr_home[i][1] = y;
+        }
+    }
+    return 0;
+}
+
+int _iocs_window(int x1, int y1, int x2, int y2) {
+    if (gr_width == 0) {
+        gr_setup();
+    }
+    if (x1 < 0 || y1 < 0 || x2 >= gr_width || y2 >= gr_width || x1 > x2 || y1 > y2) {
+        return -1;
+    }
+    gr_window.x1 = x1;
+    gr_window.y1 = y1;
+    gr_window.x2 = x2;
+    gr_window.y2 = y2;
+    return 0;
+}
+
+int _iocs_wipe(void) {
+    memset(X68K_HOST_ADDR(GVRAM), 0, 0x200000);
+    return 0;
+}
+
+int _iocs_gpalet(int pal, int color) {
+    if (pal < 0 || pal > 255) {
+        return -1;
+    }
+    int old = MEM16(GPALET + pal * 2);
+    if (color >= 0) {
+        MEM16(GPALET + pal * 2) = color;
+    }
+    return old;
+}
+
+int _iocs_pset(const struct iocs_psetptr *p) {
+    gr_pset(p->x, p->y, p->color);
+    return 0;
+}
+
+int _iocs_point(struct iocs_pointptr *p) {
+    if (!gr_inside(p->x, p->y)) {
+        p->color = 0xffff;
+        return -1;
+    }
+    p->color = *gr_addr(p->x, p->y);
+    return 0;
+}
+
+// Bresenham line where bit 15 of the line style comes first
+static void gr_line(int x1, int y1, int x2, int y2, int color, unsigned int style) {
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        style = ((style << 1) | (style >> 15)) & 0xffff;
+        if (style & 1) {
+            gr_pset(x1, y1, color);
+        }
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+int _iocs_line(const struct iocs_lineptr *p) {
+    gr_line(p->x1, p->y1, p->x2, p->y2, p->color, p->linestyle);
+    return 0;
+}
+
+int _iocs_box(const struct iocs_boxptr *p) {
+    gr_line(p->x1, p->y1, p->x2, p->y1, p->color, p->linestyle);
+    gr_line(p->x2, p->y1, p->x2, p->y2, p->color, p->linestyle);
+    gr_line(p->x2, p->y2, p->x1, p->y2, p->color, p->linestyle);
+    gr_line(p->x1, p->y2, p->x1, p->y1, p->color, p->linestyle);
+    return 0;
+}
+
+int _iocs_fill(const struct iocs_fillptr *p) {
+    int x1 = p->x1 < p->x2 ? p->x1 : p->x2;
+    int x2 = p->x1 < p->x2 ? p->x2 : p->x1;
+    int y1 = p->y1 < p->y2 ? p->y1 : p->y2;
+    int y2 = p->y1 < p->y2 ? p->y2 : p->y1;
+    for (int y = y1; y <= y2; y++) {
+        for (int x = x1; x <= x2; x++) {
+            gr_pset(x, y, p->color);
+        }
+    }
+    return 0;
+}
+
+// Whether the point (dx, dy) from the centre is within the arc from start to
+// end degrees, counterclockwise from the right as the IOCS does
+static bool in_arc(int dx, int dy, int start, int end) {
+    if (start == 0 && end == 360) {
+        return true;
+    }
+    int deg = 0;
+    // angle in degrees without floating point: step the tangent
+    if (dx != 0 || dy != 0) {
+        int ax = abs(dx), ay = abs(dy);
+        // atan(ay/ax) by linear search over tan(deg) * 1000
+        static const int tan1000[] = {
+            0, 17, 35, 52, 70, 87, 105, 123, 141, 158, 176, 194, 213, 231, 249,
+            268, 287, 306, 325, 344, 364, 384, 404, 424, 445, 466, 488, 510, 532,
+            554, 577, 601, 625, 649, 675, 700, 727, 754, 781, 810, 839, 869, 900,
+            933, 966, 1000,
+        };
+        int a;
+        if (ay <= ax) {
+            for (a = 0; a < 45 && tan1000[a + 1] * ax <= ay * 1000; a++) {
+            }
+        } else {
+            for (a = 0; a < 45 && tan1000[a + 1] * ay <= ax * 1000; a++) {
+            }
+            a = 90 - a;
+        }
+        // screen y grows downwards
+        if (dx >= 0 && dy <= 0) {
+            deg = a;
+        } else if (dx < 0 && dy <= 0) {
+            deg = 180 - a;
+        } else if (dx < 0) {
+            deg = 180 + a;
+        } else {
+            deg = 360 - a;
+        }
+    }
+    if (start <= end) {
+        return deg >= start && deg <= end;
+    } else {
+        return deg >= start || deg <= end;
+    }
+}
+
+static void circle_plot4(const struct iocs_circleptr *p, int dx, int dy) {
+    static const int sign[4][2] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+    for (int i = 0; i < 4; i++) {
+        int x = dx * sign[i][0], y = dy * sign[i][1];
+        if (in_arc(x, y, p->start, p->end)) {
+            gr_pset(p->x + x, p->y + y, p->color);
+        }
+    }
+}
+
+// Midpoint ellipse; ratio is the vertical/horizontal ratio * 256
+int _iocs_circle(const struct iocs_circleptr *p) {
+    long rx = p->radius, ry = p->radius;
+    if (p->ratio < 256) {
+        ry = rx * p->ratio / 256;
+    } else if (p->ratio > 256) {
+        rx = ry * 256 / p->ratio;
+    }
+    long rx2 = rx * rx, ry2 = ry * ry;
+    long x = 0, y = ry;
+    long px = 0, py = 2 * rx2 * y;
+    long d = ry2 - rx2 * ry + rx2 / 4;
+    while (px < py) {
+        circle_plot4(p, x, y);
+        x++;
+        px += 2 * ry2;
+        if (d < 0) {
+            d += ry2 + px;
+        } else {
+            y--;
+            py -= 2 * rx2;
+            d += ry2 + px - py;
+        }
+    }
+    d = ry2 * (2 * x + 1) * (2 * x + 1) / 4 + rx2 * (y - 1) * (y - 1) - rx2 * ry2;
+    while (y >= 0) {
+        circle_plot4(p, x, y);
+        y--;
+        py -= 2 * rx2;
+        if (d > 0) {
+            d += rx2 - py;
+        } else {
+            x++;
+            px += 2 * ry2;
+            d += rx2 - py + px;
+        }
+    }
+    return 0;
+}
+
+// Fill the area around (x, y) bounded by pixels of the paint color, with a
+// scanline seed fill that keeps its seeds in the caller's work buffer
+int _iocs_paint(struct iocs_paintptr *p) {
+    int color = p->color & (gr_colors - 1);
+    if (!gr_inside(p->x, p->y)) {
+        return -1;
+    }
+    int16_t *sp = p->buf_start;
+    int16_t *end = (int16_t *)p->buf_end - 1;
+    if (sp >= end) {
+        return -1;
+    }
+    *sp++ = p->x;
+    *sp++ = p->y;
+    while (sp > (int16_t *)p->buf_start) {
+        int y = *--sp;
+        int x = *--sp;
+        if (*gr_addr(x, y) == color) {
+            continue;
+        }
+        int x1 = x, x2 = x;
+        while (x1 > gr_window.x1 && *gr_addr(x1 - 1, y) != color) {
+            x1--;
+        }
+        while (x2 < gr_window.x2 && *gr_addr(x2 + 1, y) != color) {
+            x2++;
+        }
+        for (x = x1; x <= x2; x++) {
+            *gr_addr(x, y) = color;
+        }
+        for (int ny = y - 1; ny <= y + 1; ny += 2) {
+            if (ny < gr_window.y1 || ny > gr_window.y2) {
+                continue;
+            }
+            bool seed = false;
+            for (x = x1; x <= x2; x++) {
+                bool open = *gr_addr(x, ny) != color;
+                if (open && !seed) {
+                    if (sp >= end) {
+                        return -1;
+                    }
+                    *sp++ = x;
+                    *sp++ = ny;
+                }
+                seed = open;
+            }
+        }
+    }
+    return 0;
+}
+
+// Characters are drawn from the font ROM, which the host does not have (it
+// reads as blank), so nothing is drawn
+int _iocs_symbol(const struct iocs_symbolptr *p) {
+    (void)p;
+    return 0;
+}
+
+// GETGRM/PUTGRM pack the pixels as 4, 8 or 16 bits by the color mode
+static size_t grm_size(int x1, int y1, int x2, int y2) {
+    size_t n = (size_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+    return gr_colors == 16 ? (n + 1) / 2 : gr_colors == 256 ? n : n * 2;
+}
+
+int _iocs_getgrm(struct iocs_getptr *p) {
+    if (p->x1 > p->x2 || p->y1 > p->y2 || !gr_inside(p->x1, p->y1) || !gr_inside(p->x2, p->y2)) {
+        return -1;
+    }
+    if (grm_size(p->x1, p->y1, p->x2, p->y2) > (size_t)((uint8_t *)p->buf_end - (uint8_t *)p->buf_start)) {
+        return -1;
+    }
+    uint8_t *b = p->buf_start;
+    size_t i = 0;
+    for (int y = p->y1; y <= p->y2; y++) {
+        for (int x = p->x1; x <= p->x2; x++, i++) {
+            uint16_t c = *gr_addr(x, y);
+            if (gr_colors == 16) {
+                b[i / 2] = (i & 1) ? (b[i / 2] | c) : (c << 4);
+            } else if (gr_colors == 256) {
+                b[i] = c;
+            } else {
+                ((uint16_t *)b)[i] = c;
+            }
+        }
+    }
+    return 0;
+}
+
+int _iocs_putgrm(const struct iocs_putptr *p) {
+    if (p->x1 > p->x2 || p->y1 > p->y2) {
+        return -1;
+    }
+    if (grm_size(p->x1, p->y1, p->x2, p->y2) > (size_t)((const uint8_t *)p->buf_end - (const uint8_t *)p->buf_start)) {
+        return -1;
+    }
+    const uint8_t *b = p->buf_start;
+    size_t i = 0;
+    for (int y = p->y1; y <= p->y2; y++) {
+        for (int x = p->x1; x <= p->x2; x++, i++) {
+            int c;
+            if (gr_colors == 16) {
+                c = (i & 1) ? (b[i / 2] & 0xf) : (b[i / 2] >> 4);
+            } else if (gr_colors == 256) {
+                c = b[i];
+            } else {
+                c = ((const uint16_t *)b)[i];
+            }
+            gr_pset(x, y, c);
+        }
+    }
+    return 0;
+}
+
+/****************************************************************************/
+// Text screen: 4 planes of 1024x1024 dots, the MSB is the leftmost dot
+
+static int tx_color = 0xf;
+
+static inline void tx_pset(int plane, int x, int y, bool on) {
+    if (x < 0 || x >= 1024 || y < 0 || y >= 1024) {
+        return;
+    }
+    uint8_t *b = X68K_HOST_ADDR(TVRAM + plane * TVRAM_PLANE + y * 128 + x / 8);
+    if (on) {
+        *b |= 0x80 >> (x & 7);
+    } else {
+        *b &= ~(0x80 >> (x & 7));
+    }
+}
+
+static inline bool tx_point(int plane, int x, int y) {
+    if (x < 0 || x >= 1024 || y < 0 || y >= 1024) {
+        return false;
+    }
+    return *(uint8_t *)X68K_HOST_ADDR(TVRAM + plane * TVRAM_PLANE + y * 128 + x / 8) & (0x80 >> (x & 7));
+}
+
+static inline bool style_bit(unsigned int style, int i) {
+    return style & (0x8000 >> (i & 15));
+}
+
+int _iocs_tpalet(int pal, int color) {
+    if (pal < 0 || pal > 15) {
+        return -1;
+    }
+    int old = MEM16(TPALET + pal * 2);
+    if (color >= 0) {
+        MEM16(TPALET + pal * 2) = color;
+    }
+    return old;
+}
+
+int _iocs_tpalet2(int pal, int color) {
+    return _iocs_tpalet(pal, color);
+}
+
+void _iocs_tcolor(int plane) {
+    tx_color = plane;
+}
+
+void _iocs_txxline(const struct iocs_xlineptr *p) {
+    int x = p->x1 < 0 ? p->x + p->x1 : p->x;
+    int len = abs(p->x1);
+    for (int i = 0; i < len; i++) {
+        tx_pset(p->vram_page, x + i, p->y, style_bit(p->line_style, i));
+    }
+}
+
+void _iocs_txyline(const struct iocs_ylineptr *p) {
+    int y = p->y1 < 0 ? p->y + p->y1 : p->y;
+    int len = abs(p->y1);
+    for (int i = 0; i < len; i++) {
+        tx_pset(p->vram_page, p->x, y + i, style_bit(p->line_style, i));
+    }
+}
+
+void _iocs_txline(const struct iocs_tlineptr *p) {
+    int x1 = p->x, y1 = p->y, x2 = p->x + p->x1, y2 = p->y + p->y1;
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+    for (int i = 0;; i++) {
+        tx_pset(p->vram_page, x1, y1, style_bit(p->line_style, i));
+        if (x1 == x2 && y1 == y2) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void _iocs_txbox(const struct iocs_tboxptr *p) {
+    struct iocs_xlineptr xl = { p->vram_page, p->x, p->y, p->x1, p->line_style };
+    struct iocs_ylineptr yl = { p->vram_page, p->x, p->y, p->y1, p->line_style };
+    _iocs_txxline(&xl);
+    _iocs_txyline(&yl);
+    xl.y = p->y + p->y1 - 1;
+    yl.x = p->x + p->x1 - 1;
+    _iocs_txxline(&xl);
+    _iocs_txyline(&yl);
+}
+
+void _iocs_txfill(const struct iocs_txfillptr *p) {
+    for (int y = 0; y < p->y1; y++) {
+        for (int x = 0; x < p->x1; x++) {
+            tx_pset(p->vram_page, p->x + x, p->y + y, style_bit(p->fill_patn, p->x + x));
+        }
+    }
+}
+
+void _iocs_txrev(const struct iocs_trevptr *p) {
+    for (int y = 0; y < p->y1; y++) {
+        for (int x = 0; x < p->x1; x++) {
+            tx_pset(p->vram_page, p->x + x, p->y + y, !tx_point(p->vram_page, p->x + x, p->y + y));
+        }
+    }
+}
+
+// Copy rasters of 4 lines (512 bytes): from raster >> 8 to raster & 0xff, n
+// rasters, downwards unless mode bits 8-15 are set, in the planes of mode & 0xf
+void _iocs_txrascpy(int raster, int n, int mode) {
+    int src = (raster >> 8) & 0xff, dst = raster & 0xff;
+    int step = (mode & 0xff00) ? -1 : 1;
+    for (int i = 0; i < n; i++, src = (src + step) & 0xff, dst = (dst + step) & 0xff) {
+        for (int plane = 0; plane < 4; plane++) {
+            if (mode & (1 << plane)) {
+                memmove(X68K_HOST_ADDR(TVRAM + plane * TVRAM_PLANE + dst * 512),
+                    X68K_HOST_ADDR(TVRAM + plane * TVRAM_PLANE + src * 512), 512);
+            }
+        }
+    }
+}
+
+// Patterns of TEXTGET/TEXTPUT: width and height in dots (big-endian words as
+// on the X68000), then the dots of each line, MSB first
+static void tx_put(int x, int y, const uint8_t *buf, int xs, int ys, int xe, int ye) {
+    int w = buf[0] << 8 | buf[1];
+    int h = buf[2] << 8 | buf[3];
+    const uint8_t *d = buf + 4;
+    int bpl = (w + 7) / 8;
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            int px = x + i, py = y + j;
+            if (px < xs || px > xe || py < ys || py > ye) {
+                continue;
+            }
+            bool on = d[j * bpl + i / 8] & (0x80 >> (i & 7));
+            for (int plane = 0; plane < 4; plane++) {
+                if (tx_color & (1 << plane)) {
+                    tx_pset(plane, px, py, on);
+                }
+            }
+        }
+    }
+}
+
+void _iocs_textput(int x, int y, const void *buf) {
+    tx_put(x, y, buf, 0, 0, 1023, 1023);
+}
+
+void _iocs_clipput(int x, int y, const void *buf, const struct iocs_clipxy *clip) {
+    tx_put(x, y, buf, clip->xs, clip->ys, clip->xe, clip->ye);
+}
+
+void _iocs_textget(int x, int y, void *buf) {
+    uint8_t *b = buf;
+    int w = b[0] << 8 | b[1];
+    int h = b[2] << 8 | b[3];
+    int bpl = (w + 7) / 8;
+    int plane = 0;
+    while (plane < 3 && !(tx_color & (1 << plane))) {
+        plane++;
+    }
+    memset(b + 4, 0, bpl * h);
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            if (tx_point(plane, x + i, y + j)) {
+                b[4 + j * bpl + i / 8] |= 0x80 >> (i & 7);
+            }
+        }
+    }
+}
+
+void _iocs_os_curon(void) {
+}
+
+void _iocs_os_curof(void) {
+}
+
+/****************************************************************************/
+// Sprites and BG
+
+int _iocs_sp_init(void) {
+    memset(X68K_HOST_ADDR(SPRITE_REG), 0, 128 * 8);
+    MEM16(BG_CTRL) = 0;
+    return 0;
+}
+
+int _iocs_sp_on(void) {
+    MEM16(BG_CTRL) |= 0x0200;
+    return 0;
+}
+
+void _iocs_sp_off(void) {
+    MEM16(BG_CTRL) &= ~0x0200;
+}
+
+int _iocs_sp_cgclr(int code) {
+    if (code < 0 || code > 255) {
+        return -1;
+    }
+    memset(X68K_HOST_ADDR(PCG + code * 128), 0, 128);
+    return 0;
+}
+
+int _iocs_sp_defcg(int code, int size, const void *buf) {
+    if (size) {
+        if (code < 0 || code > 255) {
+            return -1;
+        }
+        memcpy(X68K_HOST_ADDR(PCG + code * 128), buf, 128);
+    } else {
+        if (code < 0 || code > 1023) {
+            return -1;
+        }
+        memcpy(X68K_HOST_ADDR(PCG + code * 32), buf, 32);
+    }
+    return 0;
+}
+
+// The values go to the registers as they are, a negative one is not changed.
+// Bit 31 of mode is "don't wait for vsync"; the host never waits.
+int _iocs_sp_regst(int spno, int mode, int x, int y, int code, int prio) {
+    (void)mode;
+    spno &= 0x7fffffff;
+    if (spno > 127) {
+        return -1;
+    }
+    uint16_t *reg = &MEM16(SPRITE_REG + spno * 8);
+    if (x >= 0) {
+        reg[0] = x & 0x3ff;
+    }
+    if (y >= 0) {
+        reg[1] = y & 0x3ff;
+    }
+    if (code >= 0) {
+        reg[2] = code & 0xcfff;
+    }
+    if (prio >= 0) {
+        reg[3] = prio & 3;
+    }
+    return 0;
+}
+
+int _iocs_spalet(int pal, int block, int color) {
+    pal &= 0x7fffffff;
+    if (pal > 15 || block < 1 || block > 15) {
+        return -1;
+    }
+    uint16_t *p = &MEM16(TPALET + block * 32 + pal * 2);
+    int old = *p;
+    if (color >= 0) {
+        *p = color;
+    }
+    return old;
+}
+
+int _iocs_bgctrlst(int bg, int text, int disp) {
+    if (bg < 0 || bg > 1) {
+        return -1;
+    }
+    int shift = bg * 3;
+    uint16_t c = MEM16(BG_CTRL) & ~(7 << shift);
+    MEM16(BG_CTRL) = c | ((text & 1) << (shift + 1)) | ((disp & 1) << shift);
+    return 0;
+}
+
+static uint16_t *bg_addr(int text, int x, int y) {
+    return &MEM16(BG_TEXT + text * 0x2000 + ((y & 63) * 64 + (x & 63)) * 2);
+}
+
+int _iocs_bgtextcl(int text, int code) {
+    if (text < 0 || text > 1) {
+        return -1;
+    }
+    for (int i = 0; i < 64 * 64; i++) {
+        *bg_addr(text, i, i / 64) = code;
+    }
+    return 0;
+}
+
+int _iocs_bgtextst(int text, int x, int y, int code) {
+    if (text < 0 || text > 1) {
+        return -1;
+    }
+    *bg_addr(text, x, y) = code;
+    return 0;
+}
+
+int _iocs_bgtextgt(int text, int x, int y) {
+    if (text < 0 || text > 1) {
+        return -1;
+    }
+    return *bg_addr(text, x, y);
+}
+
+int _iocs_bgscrlst(int bg, int x, int y) {
+    bg &= 0x7fffffff;
+    if (bg > 1) {
+        return -1;
+    }
+    MEM16(BG_SCROLL + bg * 4) = x & 0x3ff;
+    MEM16(BG_SCROLL + bg * 4 + 2) = y & 0x3ff;
+    return 0;
+}
+
+/****************************************************************************/
+// Interrupts: only the per-frame ones are delivered, by x68k_host_vsync()
+
+static void (*int_opm)(void);
+static void (*int_timerd)(void);
+static void (*int_vdisp)(void);
+static int vdisp_cycle, vdisp_count;
+static void (*int_crtcras)(void);
+
+int _iocs_opmintst(void (*addr)(void)) {
+    if (addr != NULL && int_opm != NULL) {
+        return 1;
+    }
+    int_opm = addr;
+    return 0;
+}
+
+int _iocs_timerdst(void (*addr)(void), int unit, int cycle) {
+    (void)unit;
+    (void)cycle;
+    if (addr != NULL && int_timerd != NULL) {
+        return 1;
+    }
+    int_timerd = addr;
+    return 0;
+}
+
+int _iocs_vdispst(void (*addr)(void), int disp, int cycle) {
+    (void)disp;
+    if (addr != NULL && int_vdisp != NULL) {
+        return 1;
+    }
+    int_vdisp = addr;
+    vdisp_cycle = cycle > 0 ? cycle : 1;
+    vdisp_count = 0;
+    return 0;
+}
+
+int _iocs_crtcras(void (*addr)(void), int raster) {
+    (void)raster;
+    if (addr != NULL && int_crtcras != NULL) {
+        return 1;
+    }
+    int_crtcras = addr;
+    return 0;
+}
+
+void x68k_host_vsync(void) {
+    // the vertical display bit of the MFP GPIP goes off in the blanking period
+    x68k_host_mem[MFP_GPIP - X68K_HOST_MEM_BASE] &= ~0x10;
+    if (int_crtcras != NULL) {
+        int_crtcras();
+    }
+    if (int_vdisp != NULL && ++vdisp_count >= vdisp_cycle) {
+        vdisp_count = 0;
+        int_vdisp();
+    }
+    x68k_host_mem[MFP_GPIP - X68K_HOST_MEM_BASE] |= 0x10;
+}
+
+/****************************************************************************/
+// System
+
+static bool super_mode;
+
+int _iocs_b_super(int stack) {
+    if (stack == 0) {
+        if (super_mode) {
+            return -1;
+        }
+        super_mode = true;
+        return 0x2000;      // any non-zero value for the saved SSP
+    }
+    super_mode = false;
+    return 0;
+}
+
+// 1/100 seconds of the ONTIME counter
+static unsigned long long ontime_10ms(struct timespec *ts) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    return ts->tv_sec * 100ULL + ts->tv_nsec / 10000000;
+}
+
+struct iocs_time _iocs_ontime(void) {
+    struct timespec ts;
+    unsigned long long t = ontime_10ms(&ts);
+    struct iocs_time res = { t % 8640000, t / 8640000 };
+    return res;
+}
+
+// MFP timer C counts down from 200 to 1 at 20kHz, in step with ONTIME
+static int mfp_tcdr(void) {
+    struct timespec ts;
+    ontime_10ms(&ts);
+    return 200 - (ts.tv_nsec % 10000000) / 50000;
+}
+
+int _iocs_b_bpeek(const volatile void *addr) {
+    uintptr_t a = (uintptr_t)addr;
+    if (a == MFP_TCDR) {
+        return mfp_tcdr();
+    } else if (a >= X68K_HOST_MEM_BASE && a < X68K_HOST_MEM_BASE + X68K_HOST_MEM_SIZE) {
+        return x68k_host_mem[a - X68K_HOST_MEM_BASE];
+    }
+    return *(const volatile uint8_t *)addr;
+}
+
+static int led_stat;
+
+int _iocs_ledmod(int code, int onoff) {
+    if (code < 0 || code > 6) {
+        return -1;
+    }
+    if (onoff) {
+        led_stat |= 1 << code;
+    } else {
+        led_stat &= ~(1 << code);
+    }
+    return 0;
+}
+
+/****************************************************************************/
+
+void x68k_host_trap15(intptr_t *regs) {
+    intptr_t *d = regs;
+    intptr_t res;
+    switch (d[0] & 0xff) {
+        case 0x0d:  // LEDMOD
+            res = _iocs_ledmod(d[1], d[2]);
+            break;
+        case 0x10:  // CRTMOD
+            res = _iocs_crtmod((int16_t)d[1]);
+            break;
+        case 0x13:  // TPALET
+            res = _iocs_tpalet(d[1], d[2]);
+            break;
+        case 0x7f: {  // ONTIME
+            struct iocs_time t = _iocs_ontime();
+            res = t.sec;
+            d[1] = t.day;
+            break;
+        }
+        case 0x81:  // B_SUPER
+            res = _iocs_b_super(regs[6]);
+            break;
+        case 0x82:  // B_BPEEK
+            res = _iocs_b_bpeek((const void *)regs[6]);
+            regs[6]++;
+            break;
+        case 0x90:  // G_CLR_ON
+            res = _iocs_g_clr_on();
+            break;
+        case 0x94:  // GPALET
+            res = _iocs_gpalet(d[1], d[2]);
+            break;
+        case 0xac:  // SYS_STAT: not supported
+            res = -1;
+            break;
+        case 0xb1:  // APAGE
+            res = _iocs_apage(d[1]);
+            break;
+        case 0xb2:  // VPAGE
+            res = _iocs_vpage(d[1]);
+            break;
+        case 0xb4:  // WINDOW
+            res = _iocs_window(d[1], d[2], d[3], d[4]);
+            break;
+        case 0xb5:  // WIPE
+            res = _iocs_wipe();
+            break;
+        case 0xc0:  // SP_INIT
+            res = _iocs_sp_init();
+            break;
+        case 0xc1:  // SP_ON
+            res = _iocs_sp_on();
+            break;
+        case 0xc2:  // SP_OFF
+            _iocs_sp_off();
+            res = 0;
+            break;
+        case 0xc6:  // SP_REGST
+            res = _iocs_sp_regst(d[1], d[1] & 0x80000000 ? -1 : 0, d[2], d[3], d[4], d[5]);
+            break;
+        case 0xcf:  // SPALET
+            res = _iocs_spalet(d[1], d[2], d[3]);
+            break;
+        default:
+            res = -1;
+            break;
+    }
+    d[0] = res;
+}
@@ -0,0 +1,16 @@
+# Build for the host machine with the stand-in IOCS/DOS library in this
+# directory instead of libx68k.  Native code is compiled for x86-64.
+
+CROSS = 0
+
+CFLAGS += -DMICROPY_X68K_HOST=1
+# Human68k open() flags that POSIX does not have
+CFLAGS += -DO_BINARY=0 -DO_TEXT=0
+
+INC += -I$(VARIANT_DIR)
+
+SRC_C_VARIANT = \
+	$(VARIANT_DIR)/iocs.c \
+	$(VARIANT_DIR)/dos.c
+
+MPY_CROSS_ARCH = x64
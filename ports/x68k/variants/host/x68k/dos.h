@@ -0,0 +1,65 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-in for the libx68k <x68k/dos.h> in the host variant.  Only the calls
+// used by the port are declared, and they are mapped onto POSIX.
+
+#ifndef _X68K_DOS_H_
+#define _X68K_DOS_H_
+
+struct dos_filbuf {
+    unsigned char searchatr;
+    unsigned char atr;
+    unsigned short time;
+    unsigned short date;
+    unsigned int filelen;
+    char name[256];
+    // host only: where _dos_nfiles() continues the search
+    char dir[256];
+    char pattern[256];
+    int pos;
+};
+
+struct dos_freeinf {
+    unsigned short free;
+    unsigned short max;
+    unsigned short sec;
+    unsigned short byte;
+};
+
+int _dos_inkey(void);
+int _dos_breakck(int mode);
+void *_dos_intvcs(int intno, void (*jobadr)(void));
+int _dos_fnckeygt(int fno, char *buf);
+int _dos_fnckeyst(int fno, const char *buf);
+int _dos_files(struct dos_filbuf *buf, const char *file, int atr);
+int _dos_nfiles(struct dos_filbuf *buf);
+int _dos_rename(const char *oldname, const char *newname);
+int _dos_curdrv(void);
+int _dos_curdir(int drive, char *buf);
+int _dos_dskfre(int drive, struct dos_freeinf *buf);
+
+#endif // _X68K_DOS_H_
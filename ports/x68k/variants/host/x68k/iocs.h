@@ -0,0 +1,209 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// Stand-in for the libx68k <x68k/iocs.h> in the host variant.  Only the calls
+// used by the port are declared, with the same names and structures.
+
+#ifndef _X68K_IOCS_H_
+#define _X68K_IOCS_H_
+
+struct iocs_time {
+    int sec;            // 1/100 seconds since the start of the day
+    int day;
+};
+
+struct iocs_psetptr {
+    short x, y;
+    unsigned short color;
+};
+
+struct iocs_pointptr {
+    short x, y;
+    unsigned short color;
+};
+
+struct iocs_lineptr {
+    short x1, y1, x2, y2;
+    unsigned short color;
+    unsigned short linestyle;
+};
+
+struct iocs_boxptr {
+    short x1, y1, x2, y2;
+    unsigned short color;
+    unsigned short linestyle;
+};
+
+struct iocs_fillptr {
+    short x1, y1, x2, y2;
+    unsigned short color;
+};
+
+struct iocs_circleptr {
+    short x, y;
+    unsigned short radius;
+    unsigned short color;
+    short start, end;
+    unsigned short ratio;
+};
+
+struct iocs_paintptr {
+    short x, y;
+    unsigned short color;
+    void *buf_start;
+    void *buf_end;
+};
+
+struct iocs_symbolptr {
+    short x1, y1;
+    const unsigned char *string_address;
+    unsigned char mag_x, mag_y;
+    unsigned short color;
+    unsigned char font_type;
+    unsigned char angle;
+};
+
+struct iocs_getptr {
+    short x1, y1, x2, y2;
+    void *buf_start;
+    void *buf_end;
+};
+
+struct iocs_putptr {
+    short x1, y1, x2, y2;
+    const void *buf_start;
+    const void *buf_end;
+};
+
+struct iocs_xlineptr {
+    unsigned short vram_page;
+    short x, y;
+    short x1;
+    unsigned short line_style;
+};
+
+struct iocs_ylineptr {
+    unsigned short vram_page;
+    short x, y;
+    short y1;
+    unsigned short line_style;
+};
+
+struct iocs_tlineptr {
+    unsigned short vram_page;
+    short x, y;
+    short x1, y1;
+    unsigned short line_style;
+};
+
+struct iocs_tboxptr {
+    unsigned short vram_page;
+    short x, y;
+    short x1, y1;
+    unsigned short line_style;
+};
+
+struct iocs_txfillptr {
+    unsigned short vram_page;
+    short x, y;
+    short x1, y1;
+    unsigned short fill_patn;
+};
+
+struct iocs_trevptr {
+    unsigned short vram_page;
+    short x, y;
+    short x1, y1;
+};
+
+struct iocs_clipxy {
+    short xs, ys, xe, ye;
+};
+
+// Screen modes and graphics
+int _iocs_crtmod(int mode);
+int _iocs_g_clr_on(void);
+int _iocs_apage(int page);
+int _iocs_vpage(int page);
+int _iocs_home(int page, int x, int y);
+int _iocs_window(int x1, int y1, int x2, int y2);
+int _iocs_wipe(void);
+int _iocs_gpalet(int pal, int color);
+int _iocs_pset(const struct iocs_psetptr *p);
+int _iocs_point(struct iocs_pointptr *p);
+int _iocs_line(const struct iocs_lineptr *p);
+int _iocs_box(const struct iocs_boxptr *p);
+int _iocs_fill(const struct iocs_fillptr *p);
+int _iocs_circle(const struct iocs_circleptr *p);
+int _iocs_paint(struct iocs_paintptr *p);
+int _iocs_symbol(const struct iocs_symbolptr *p);
+int _iocs_getgrm(struct iocs_getptr *p);
+int _iocs_putgrm(const struct iocs_putptr *p);
+
+// Text screen
+int _iocs_tpalet(int pal, int color);
+int _iocs_tpalet2(int pal, int color);
+void _iocs_tcolor(int plane);
+void _iocs_txxline(const struct iocs_xlineptr *p);
+void _iocs_txyline(const struct iocs_ylineptr *p);
+void _iocs_txline(const struct iocs_tlineptr *p);
+void _iocs_txbox(const struct iocs_tboxptr *p);
+void _iocs_txfill(const struct iocs_txfillptr *p);
+void _iocs_txrev(const struct iocs_trevptr *p);
+void _iocs_txrascpy(int raster, int n, int mode);
+void _iocs_textget(int x, int y, void *buf);
+void _iocs_textput(int x, int y, const void *buf);
+void _iocs_clipput(int x, int y, const void *buf, const struct iocs_clipxy *clip);
+void _iocs_os_curon(void);
+void _iocs_os_curof(void);
+
+// Sprites and BG
+int _iocs_sp_init(void);
+int _iocs_sp_on(void);
+void _iocs_sp_off(void);
+int _iocs_sp_cgclr(int code);
+int _iocs_sp_defcg(int code, int size, const void *buf);
+int _iocs_sp_regst(int spno, int mode, int x, int y, int code, int prio);
+int _iocs_spalet(int pal, int block, int color);
+int _iocs_bgctrlst(int bg, int text, int disp);
+int _iocs_bgtextcl(int text, int code);
+int _iocs_bgtextst(int text, int x, int y, int code);
+int _iocs_bgtextgt(int text, int x, int y);
+int _iocs_bgscrlst(int bg, int x, int y);
+
+// Interrupts
+int _iocs_opmintst(void (*addr)(void));
+int _iocs_timerdst(void (*addr)(void), int unit, int cycle);
+int _iocs_vdispst(void (*addr)(void), int disp, int cycle);
+int _iocs_crtcras(void (*addr)(void), int raster);
+
+// System
+int _iocs_b_super(int stack);
+int _iocs_b_bpeek(const volatile void *addr);
+struct iocs_time _iocs_ontime(void);
+int _iocs_ledmod(int code, int onoff);
+
+#endif // _X68K_IOCS_H_
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_X68KHOST_H
+#define MICROPY_INCLUDED_X68KHOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The host variant has no X68000 hardware: the 4MB from 0xc00000 (GVRAM,
+// TVRAM, I/O area, sprites and font ROM) is an array, and the stand-in IOCS
+// draws into it.  Words there are in host byte order.
+#define X68K_HOST_MEM_BASE  (0xc00000)
+#define X68K_HOST_MEM_SIZE  (0x400000)
+
+extern uint8_t x68k_host_mem[X68K_HOST_MEM_SIZE];
+
+// Address in x68k_host_mem of an X68000 address from 0xc00000
+#define X68K_HOST_ADDR(addr) ((void *)&x68k_host_mem[(uintptr_t)(addr) - X68K_HOST_MEM_BASE])
+
+// Simulate one vertical sync: call the VDISPST and CRTCRAS handlers as the
+// hardware would do once per frame
+void x68k_host_vsync(void);
+
+// IOCS call by trap #15 with d0-d5/a1-a2 in regs[0..7], for x68k.iocs().
+// Calls that only take and return values in registers are supported.
+void x68k_host_trap15(intptr_t *regs);
+
+// DOS call with its arguments on the stack, as in args[0..len-1], for x68k.dos()
+int x68k_host_doscall(int callno, const uint8_t *args, size_t len);
+
+#endif // MICROPY_INCLUDED_X68KHOST_H
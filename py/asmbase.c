@@ -57,6 +57,7 @@ void mp_asm_base_start_pass(mp_asm_base_t *as, int pass) {
     as->pass = pass;
     as->suppress = false;
     as->code_offset = 0;
+    as->last_label_offset = (size_t)-1;
 }
 
 // all functions must go through this one to emit bytes
@@ -83,6 +84,7 @@ void mp_asm_base_label_assign(mp_asm_base_t *as, size_t label) {
     // Assigning a label ends any dead-code region, and all following machine
     // code should be emitted (until another mp_asm_base_suppress_code() call).
     as->suppress = false;
+    as->last_label_offset = as->code_offset;
 
     if (as->pass < MP_ASM_PASS_EMIT) {
         // assign label offset
@@ -42,6 +42,9 @@ typedef struct _mp_asm_base_t {
 
     size_t code_offset;
     size_t code_size;
+    // Offset of the most recently assigned label in this pass, so that the
+    // assembler can tell whether the code it is about to emit is a jump target.
+    size_t last_label_offset;
     uint8_t *code_base;
 
     size_t max_num_labels;
@@ -44,27 +44,236 @@
 #include "py/mpstate.h"
 #include "py/asmm68k.h"
 
+// Whether to use the instructions of the 68020 and later
+#if MICROPY_DYNAMIC_COMPILER
+#define ASM_M68K_CPU020 (mp_dynamic_compiler.native_arch == MP_NATIVE_ARCH_M68K020 \
+    || mp_dynamic_compiler.native_arch == MP_NATIVE_ARCH_M68K020FPU)
+#else
+#define ASM_M68K_CPU020 (MICROPY_EMIT_M68K_68020)
+#endif
+
 static inline byte *asm_m68k_get_cur_to_write_bytes(asm_m68k_t *as, int n) {
     return mp_asm_base_get_cur_to_write_bytes(&as->base, n);
 }
 
-void asm_m68k_entry(asm_m68k_t *as, int num_locals) {
-    DEBUG_printf("locals=%d\n", num_locals);
-    assert(num_locals >= 0 && num_locals <= (0x8000 / 4));
+static void asm_m68k_entry_init(asm_m68k_t *as, int num_locals, uint out_args) {
     as->stack_adjust = num_locals * 4;
-    asm_m68k_op16(as, 0x4e56);  //  link    a6,#0
-    asm_m68k_op16(as, -as->stack_adjust);
-    asm_m68k_op16(as, 0x48e7);  //  movem.l d2-d7/a2-a5,-(sp)
-    asm_m68k_op16(as, 0x3f3c);
+    as->out_args = out_args;
+    as->cpu020 = ASM_M68K_CPU020;
+    if (as->base.pass < MP_ASM_PASS_EMIT) {
+        as->branch_len = 0;
+    }
+    as->branch_cur = 0;
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    as->peep_kind = ASM_M68K_PEEP_NONE;
+    as->peep_saved = 0;
+    #endif
+}
+
+// Number of the lowest register in a register list (bit 0 = d0 ... bit 15 = a7)
+static uint asm_m68k_lowest_reg(uint regs) {
+    uint r = 0;
+    while (!(regs & (1 << r))) {
+        r++;
+    }
+    return r;
+}
+
+// Set up the frame of a function, with room for the locals and out_args
+STATIC void asm_m68k_entry_frame(asm_m68k_t *as) {
+    uint out_args = as->out_args;
+    if (out_args == 0) {
+        asm_m68k_op16(as, 0x4e56);  //  link    a6,#-stack_adjust
+        asm_m68k_op16(as, -as->stack_adjust);
+        asm_m68k_op16(as, 0x48e7);  //  movem.l d2-d7/a2-a5,-(sp)
+        asm_m68k_op16(as, 0x3f3c);
+    } else {
+        // Reserve the outgoing argument area below the saved registers, so
+        // that it is at the top of the stack for the whole function.
+        asm_m68k_op16(as, 0x4e56);  //  link    a6,#-(stack_adjust+40+out_args)
+        asm_m68k_op16(as, -(as->stack_adjust + 40 + out_args));
+        asm_m68k_op16(as, 0x48ef);  //  movem.l d2-d7/a2-a5,out_args(sp)
+        asm_m68k_op16(as, 0x3cfc);
+        asm_m68k_op16(as, out_args);
+    }
+}
+
+void asm_m68k_entry(asm_m68k_t *as, int num_locals, uint out_args) {
+    DEBUG_printf("locals=%d\n", num_locals);
+    assert(num_locals >= 0 && (uint)num_locals <= ((0x8000 - 40 - out_args) / 4));
+    asm_m68k_entry_init(as, num_locals, out_args);
+    asm_m68k_entry_frame(as);
 }
 
 void asm_m68k_exit(asm_m68k_t *as) {
-    asm_m68k_op16(as, 0x4cdf);  //  movem.l (sp)+,d2-d7/a2-a5
-    asm_m68k_op16(as, 0x3cfc);
+    if (as->out_args == 0) {
+        asm_m68k_op16(as, 0x4cdf);  //  movem.l (sp)+,d2-d7/a2-a5
+        asm_m68k_op16(as, 0x3cfc);
+    } else {
+        asm_m68k_op16(as, 0x4cef);  //  movem.l out_args(sp),d2-d7/a2-a5
+        asm_m68k_op16(as, 0x3cfc);
+        asm_m68k_op16(as, as->out_args);
+    }
     asm_m68k_op16(as, 0x4e5e);  //  unlk    a6
     asm_m68k_op16(as, 0x4e75);  //  rts
 }
 
+// Entry and exit of an inline assembler function that saves only the registers
+// in save_regs (bit 0 = d0 ... bit 15 = a7), and optionally skips the a6 frame
+// and loads its arguments from the stack into the data registers in arg_regs.
+void asm_m68k_entry_inline(asm_m68k_t *as, uint save_regs, bool link, uint arg_regs) {
+    asm_m68k_entry_init(as, 0, 0);
+    if (link) {
+        asm_m68k_op16(as, 0x4e56);  //  link    a6,#0
+        asm_m68k_op16(as, 0);
+    }
+    uint n_saved = 0;
+    uint rev = 0;
+    for (uint i = 0; i < 16; i++) {
+        if (save_regs & (1 << i)) {
+            n_saved++;
+            rev |= 0x8000 >> i;
+        }
+    }
+    if (n_saved == 1) {
+        uint r = asm_m68k_lowest_reg(save_regs);
+        asm_m68k_op16(as, 0x2f00 | r);  //  move.l Rn,-(sp)
+    } else if (n_saved > 1) {
+        asm_m68k_op16(as, 0x48e7);  //  movem.l <save_regs>,-(sp)
+        asm_m68k_op16(as, rev);
+    }
+    if (arg_regs != 0) {
+        // the return address, and the frame pointer if linked, are below the arguments
+        uint disp = 4 + 4 * n_saved + (link ? 4 : 0);
+        if ((arg_regs & (arg_regs - 1)) == 0) {
+            asm_m68k_op16(as, 0x202f | (asm_m68k_lowest_reg(arg_regs) << 9)); // move.l disp(sp),Dn
+            asm_m68k_op16(as, disp);
+        } else {
+            asm_m68k_op16(as, 0x4cef);  //  movem.l disp(sp),<arg_regs>
+            asm_m68k_op16(as, arg_regs);
+            asm_m68k_op16(as, disp);
+        }
+    }
+}
+
+void asm_m68k_exit_inline(asm_m68k_t *as, uint save_regs, bool link) {
+    if ((save_regs & (save_regs - 1)) == 0) {
+        if (save_regs != 0) {
+            uint r = asm_m68k_lowest_reg(save_regs);
+            asm_m68k_op16(as, 0x201f | ((r & 7) << 9) | ((r & 8) << 3)); // move.l (sp)+,Rn
+        }
+    } else {
+        asm_m68k_op16(as, 0x4cdf);  //  movem.l (sp)+,<save_regs>
+        asm_m68k_op16(as, save_regs);
+    }
+    if (link) {
+        asm_m68k_op16(as, 0x4e5e);  //  unlk    a6
+    }
+    asm_m68k_op16(as, 0x4e75);  //  rts
+}
+
+// Branches to labels are relaxed: each one is recorded in the compute pass
+// with a worst-case sized placeholder, and at the end of that pass, once all
+// the label offsets are known, gets the smallest of the bcc.s, bcc.w and long
+// forms that reaches its target.  The label offsets and code size are then
+// moved down to match, so the emit pass produces exactly the layout computed.
+
+#define ASM_M68K_IS_DBRA(op) (((op) & 0xfff8) == 0x51c8)
+
+// Size of the long form of a branch, see asm_m68k_jump_cond
+static inline uint asm_m68k_branch_long_size(asm_m68k_t *as, uint op) {
+    if (as->cpu020) {
+        return ASM_M68K_IS_DBRA(op) ? 12 : 6;
+    }
+    if (ASM_M68K_IS_DBRA(op)) {
+        return 16;
+    }
+    return op == 0x6000 ? 10 : 12;
+}
+
+// Map an offset in the compute pass to its offset after relaxation
+size_t asm_m68k_relaxed_pos(asm_m68k_t *as, size_t pos) {
+    // find the first branch at or after pos
+    size_t lo = 0;
+    size_t hi = as->branch_len;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (as->branch[mid].pos < pos) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < as->branch_len) {
+        return pos - as->branch[lo].saved_before;
+    } else {
+        return pos - as->branch_saved;
+    }
+}
+
+STATIC void asm_m68k_relax_branches(asm_m68k_t *as) {
+    if (as->branch_len == 0) {
+        return;
+    }
+
+    // Start with every branch short and grow them until they all reach their
+    // targets; sizes only ever grow so this terminates.
+    for (size_t i = 0; i < as->branch_len; ++i) {
+        asm_m68k_branch_t *b = &as->branch[i];
+        b->size = b->max_size == 0 ? 0 : b->min_size;
+    }
+    bool changed;
+    do {
+        changed = false;
+        size_t saved = 0;
+        for (size_t i = 0; i < as->branch_len; ++i) {
+            asm_m68k_branch_t *b = &as->branch[i];
+            b->saved_before = saved;
+            saved += b->max_size - b->size;
+        }
+        as->branch_saved = saved;
+        for (size_t i = 0; i < as->branch_len; ++i) {
+            asm_m68k_branch_t *b = &as->branch[i];
+            size_t dest = as->base.label_offsets[b->label];
+            if (b->size == b->max_size || dest == (size_t)-1) {
+                continue;
+            }
+            mp_int_t rel = asm_m68k_relaxed_pos(as, dest) - (b->pos - b->saved_before) - 2;
+            uint size;
+            if (rel >= -0x80 && rel < 0x80) {
+                size = b->min_size;
+            } else if (rel >= -0x8000 && rel < 0x8000) {
+                size = 4;
+            } else {
+                size = b->max_size;
+            }
+            if (size > b->size) {
+                b->size = size;
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    for (size_t i = 0; i < as->base.max_num_labels; ++i) {
+        if (as->base.label_offsets[i] != (size_t)-1) {
+            as->base.label_offsets[i] = asm_m68k_relaxed_pos(as, as->base.label_offsets[i]);
+        }
+    }
+    as->base.code_offset -= as->branch_saved;
+}
+
+void asm_m68k_end_pass(asm_m68k_t *as) {
+    if (as->base.pass < MP_ASM_PASS_EMIT) {
+        asm_m68k_relax_branches(as);
+    }
+    #if MICROPY_EMIT_M68K_PEEPHOLE_DEBUG
+    if (as->base.pass == MP_ASM_PASS_EMIT) {
+        printf("asmm68k: peephole saved %u of %u bytes\n",
+            (uint)as->peep_saved, (uint)(as->base.code_offset + as->peep_saved));
+    }
+    #endif
+}
+
 STATIC mp_uint_t get_label_dest(asm_m68k_t *as, mp_uint_t label) {
     assert(label < as->base.max_num_labels);
     return as->base.label_offsets[label];
@@ -92,6 +301,58 @@ void asm_m68k_op32(asm_m68k_t *as, uint32_t op) {
     }
 }
 
+// The peephole optimiser works as the code is emitted: helpers that can be
+// simplified look at the instruction emitted immediately before them, as long
+// as nothing else has been emitted since and no label has been assigned in
+// between (which would make the current position a jump target).  The
+// decisions only depend on the instruction stream, so the code size is the
+// same in every pass.
+
+#if MICROPY_EMIT_M68K_PEEPHOLE
+
+STATIC void asm_m68k_peep_record(asm_m68k_t *as, uint kind, uint rd, uint rs) {
+    as->peep_kind = kind;
+    as->peep_rd = rd;
+    as->peep_rs = rs;
+    as->peep_end = as->base.code_offset;
+}
+
+STATIC bool asm_m68k_peep_follows(asm_m68k_t *as, uint kind) {
+    return as->peep_kind == kind
+           && as->peep_end == as->base.code_offset
+           && as->base.last_label_offset != as->base.code_offset;
+}
+
+STATIC void asm_m68k_peep_saved(asm_m68k_t *as, uint n) {
+    as->peep_saved += n;
+}
+
+#else
+
+#define asm_m68k_peep_record(as, kind, rd, rs)
+#define asm_m68k_peep_follows(as, kind) (false)
+#define asm_m68k_peep_saved(as, n)
+
+#endif
+
+// Get an address register holding rbase, loading a0 with it if there isn't one
+STATIC uint asm_m68k_get_areg(asm_m68k_t *as, uint rbase) {
+    if (ASM_M68K_IS_AREG(rbase)) {
+        asm_m68k_peep_saved(as, 2);
+        return rbase;
+    }
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    // move.l An,rbase; movea.l rbase,a0; ... (a0) -> move.l An,rbase; ... (An)
+    if (asm_m68k_peep_follows(as, ASM_M68K_PEEP_MOVE)
+        && as->peep_rd == rbase && ASM_M68K_IS_AREG(as->peep_rs)) {
+        asm_m68k_peep_saved(as, 2);
+        return as->peep_rs;
+    }
+    #endif
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
+    return ASM_M68K_REG_AT;
+}
+
 void asm_m68k_mov_arg_to_r32(asm_m68k_t *as, int src_arg_num, int rd) {
     DEBUG_printf("ASM_MOV_ARG([%d]->r%d)\n", src_arg_num, rd);
     asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_FP_DSP);  // move.l xxxx(fp),rd
@@ -113,17 +374,100 @@ void asm_m68k_cmp_reg_reg_setcc(asm_m68k_t *as, uint rd, uint rs, uint cond, uin
 }
 
 STATIC void asm_m68k_jump_cond(asm_m68k_t *as, uint label, uint op) {
+    if (as->base.pass < MP_ASM_PASS_EMIT) {
+        // Record the branch and reserve room for its long form
+        if (as->branch_len >= as->branch_alloc) {
+            size_t new_alloc = as->branch_alloc + 32;
+            as->branch = m_renew(asm_m68k_branch_t, as->branch, as->branch_alloc, new_alloc);
+            as->branch_alloc = new_alloc;
+        }
+        asm_m68k_branch_t *b = &as->branch[as->branch_len++];
+        b->pos = as->base.code_offset;
+        b->label = label;
+        b->min_size = ASM_M68K_IS_DBRA(op) ? 4 : 2;
+        b->max_size = as->base.suppress ? 0 : asm_m68k_branch_long_size(as, op);
+        asm_m68k_get_cur_to_write_bytes(as, b->max_size);
+        return;
+    }
+
+    assert(as->branch_cur < as->branch_len);
+    asm_m68k_branch_t *b = &as->branch[as->branch_cur++];
     mp_uint_t dest = get_label_dest(as, label);
-    mp_int_t rel = dest - as->base.code_offset;
-    if ((dest != (mp_uint_t)-1) && (rel <= 0) && ((rel - 2) >= -0x80)) {
-        asm_m68k_op16(as, op | ((rel - 2) & 0xff)); // bcc.s <label>
-    } else {
-        assert((dest == (mp_uint_t)-1) || ((rel - 2) < 0x7fff && (rel - 2) >= -0x8000));
+    mp_int_t rel = dest - as->base.code_offset - 2;
+    if (b->size == 2) {
+        assert(rel >= -0x80 && rel < 0x80);
+        if (rel == 0) {
+            asm_m68k_op16(as, 0x4e71);              // nop (branch to the next instruction)
+        } else {
+            asm_m68k_op16(as, op | (rel & 0xff));   // bcc.s <label>
+        }
+    } else if (b->size == 4) {
+        assert(rel >= -0x8000 && rel < 0x8000);
         asm_m68k_op16(as, op);                      // bcc.w <label>
-        asm_m68k_op16(as, rel - 2);
+        asm_m68k_op16(as, rel);
+    } else if (b->size != 0 && as->cpu020) {
+        if (ASM_M68K_IS_DBRA(op)) {
+            asm_m68k_op16(as, op);                  // dbra dn,2f
+            asm_m68k_op16(as, 4);
+            asm_m68k_op16(as, 0x6006);              // bra.s 1f
+            op = 0x6000;                            // 2:
+        }
+        rel = dest - as->base.code_offset - 2;
+        asm_m68k_op16(as, op | 0xff);               // bcc.l <label>
+        asm_m68k_op32(as, rel);
+                                                    // 1:
+    } else if (b->size != 0) {
+        if (ASM_M68K_IS_DBRA(op)) {
+            asm_m68k_op16(as, op);                  // dbra dn,2f
+            asm_m68k_op16(as, 4);
+            asm_m68k_op16(as, 0x600a);              // bra.s 1f
+        } else if (op != 0x6000) {
+            asm_m68k_op16(as, (op ^ 0x0100) | 10);  // b!cc.s 1f
+        }
+        rel = dest - as->base.code_offset - 8;
+        asm_m68k_op16(as, 0x207c);                  // 2: movea.l #<label>-3f,a0
+        asm_m68k_op32(as, rel);
+        asm_m68k_op16(as, 0x4efb);                  // jmp 3f(pc,a0.l)
+        asm_m68k_op16(as, 0x8800);                  // 3:
+                                                    // 1:
     }
 }
 
+// Counted loops keep the number of iterations left minus one in a 32-bit
+// counter, which is decremented at the end of each iteration: the low word
+// with dbra, and the high word each time the low word wraps around.
+
+// Turn the number of iterations in rd into a counter, jumping to label if
+// there are none
+void asm_m68k_count_start(asm_m68k_t *as, uint rd, uint label) {
+    DEBUG_printf("ASM_COUNT_START(r%d, %d)\n", rd, label);
+    asm_m68k_op_regea(as, 0x5180, 1, rd);           // subq.l #1,rd
+    asm_m68k_jump_cond(as, label, 0x6d00);          // blt <label>
+}
+
+// Count down the counter in rd and jump to label while it doesn't underflow
+void asm_m68k_count_jump(asm_m68k_t *as, uint rd, uint label) {
+    DEBUG_printf("ASM_COUNT_JUMP(r%d, %d)\n", rd, label);
+    if (ASM_M68K_IS_AREG(rd)) {
+        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D0, rd);  // move.l rd,d0
+        asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_REG_D0);  // subq.l #1,d0
+        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_REG_D0);  // movea.l d0,rd
+    } else {
+        asm_m68k_jump_cond(as, label, 0x51c8 | rd);         // dbra rd,<label>
+        asm_m68k_op_ea(as, 0x0480, rd);                     // subi.l #0x10000,rd
+        asm_m68k_op32(as, 0x10000);
+    }
+    asm_m68k_jump_cond(as, label, 0x6400);                  // bcc <label>
+}
+
+// As asm_m68k_count_jump with the counter in a local on the stack
+void asm_m68k_count_jump_local(asm_m68k_t *as, uint local_num, uint label) {
+    DEBUG_printf("ASM_COUNT_JUMP_LOCAL(local %d, %d)\n", local_num, label);
+    asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_FP_DSP);     // subq.l #1,xxxx(fp)
+    asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
+    asm_m68k_jump_cond(as, label, 0x6400);                  // bcc <label>
+}
+
 void asm_m68k_jump(asm_m68k_t *as, uint label) {
     DEBUG_printf("ASM_JUMP(%d)\n", label);
     asm_m68k_jump_cond(as, label, 0x6000);          // bra <label>
@@ -147,51 +491,109 @@ void asm_m68k_jmp_if_reg_eq(asm_m68k_t *as, uint reg1, uint reg2, uint label) {
     asm_m68k_jump_cond(as, label, 0x6700);          // beq <label>
 }
 
+// Compare rd with the length of a checked viper buffer, which is in the
+// register rlen, or in the local len_local if rlen is -1
+STATIC void asm_m68k_cmp_len(asm_m68k_t *as, uint rd, int rlen, int len_local) {
+    uint op = ASM_M68K_IS_AREG(rd) ? 0xb1c0 : 0xb080;
+    if (rlen >= 0) {
+        asm_m68k_op_regea(as, op, rd, rlen);                // cmp.l rlen,rd
+    } else {
+        asm_m68k_op_regea(as, op, rd, ASM_M68K_FP_DSP);     // cmp.l xxxx(fp),rd
+        asm_m68k_op16(as, (len_local * 4) - as->stack_adjust);
+    }
+}
+
+// Jump to label unless 0 <= rindex < length
+void asm_m68k_jmp_if_index_out(asm_m68k_t *as, uint rindex, int rlen, int len_local, uint label) {
+    DEBUG_printf("ASM_JUMP_IF_INDEX_OUT(r%d, r%d, local %d, %d)\n", rindex, rlen, len_local, label);
+    asm_m68k_cmp_len(as, rindex, rlen, len_local);
+    asm_m68k_jump_cond(as, label, 0x6400);                  // bcc <label>
+}
+
+// Jump to label unless 0 <= index < length, for a constant index
+void asm_m68k_jmp_if_index_imm_out(asm_m68k_t *as, int index, int rlen, int len_local, uint label) {
+    DEBUG_printf("ASM_JUMP_IF_INDEX_IMM_OUT(%d, r%d, local %d, %d)\n", index, rlen, len_local, label);
+    if (rlen >= 0) {
+        uint op = ASM_M68K_IS_AREG(rlen) ? 0xb1c0 : 0xb080;
+        asm_m68k_op_regea(as, op, rlen, ASM_M68K_IMM);      // cmp.l #index,rlen
+        asm_m68k_op32(as, index);
+    } else {
+        asm_m68k_op_ea(as, 0x0c80, ASM_M68K_FP_DSP);        // cmpi.l #index,xxxx(fp)
+        asm_m68k_op32(as, index);
+        asm_m68k_op16(as, (len_local * 4) - as->stack_adjust);
+    }
+    asm_m68k_jump_cond(as, label, 0x6300);                  // bls <label>
+}
+
+// Jump to label unless 0 <= rlo <= rhi <= length, comparing signed values
+void asm_m68k_jmp_if_range_out(asm_m68k_t *as, uint rlo, uint rhi, int rlen, int len_local, uint label) {
+    DEBUG_printf("ASM_JUMP_IF_RANGE_OUT(r%d, r%d, r%d, local %d, %d)\n", rlo, rhi, rlen, len_local, label);
+    asm_m68k_op_ea(as, 0x4a80, rlo);                        // tst.l rlo
+    asm_m68k_jump_cond(as, label, 0x6b00);                  // bmi <label>
+    asm_m68k_op_regea(as, 0xb080, rhi, rlo);                // cmp.l rlo,rhi
+    asm_m68k_jump_cond(as, label, 0x6d00);                  // blt <label>
+    asm_m68k_cmp_len(as, rhi, rlen, len_local);
+    asm_m68k_jump_cond(as, label, 0x6e00);                  // bgt <label>
+}
+
 void asm_m68k_jmp_reg(asm_m68k_t *as, uint reg) {
     DEBUG_printf("ASM_JUMP_REG(r%d)\n", reg);
     asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, reg);   // movea.l reg,a0
     asm_m68k_op_ea(as, 0x4ec0, ASM_M68K_AT_IND);      // jmp (a0)
 }
 
+// The arguments are stored into the outgoing argument area reserved by
+// asm_m68k_entry, so there is no need to adjust sp around the call.
 void asm_m68k_call_ind(asm_m68k_t *as, uint idx, uint n_args) {
     DEBUG_printf("ASM_CALL_IND(%d %d)\n", idx, n_args);
+    assert(n_args * 4 <= as->out_args);
     switch (n_args) {
         case 1:
-            asm_m68k_op16(as, 0x2f00);      // move.l d0,-(sp)
+            asm_m68k_op16(as, 0x2e80);      // move.l d0,(sp)
             break;
         case 2:
-            asm_m68k_op32(as, 0x48e7c000);  // movem.l d0-d1,-(sp)
+            asm_m68k_op32(as, 0x48d70003);  // movem.l d0-d1,(sp)
             break;
         case 3:
-            asm_m68k_op32(as, 0x48e7e000);  // movem.l d0-d2,-(sp)
+            asm_m68k_op32(as, 0x48d70007);  // movem.l d0-d2,(sp)
             break;
         case 4:
-            asm_m68k_op32(as, 0x48e7f000);  // movem.l d0-d3,-(sp)
+            asm_m68k_op32(as, 0x48d7000f);  // movem.l d0-d3,(sp)
             break;
     }
     asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, ASM_M68K_DSP(ASM_M68K_REG_FUN_TABLE)); // movea.l idx*4(a5),a0
     asm_m68k_op16(as, idx * 4);
     asm_m68k_op_ea(as, 0x4e80, ASM_M68K_AT_IND);    // jsr (a0)
-    if (n_args > 0 && n_args <= 2) {
-        asm_m68k_op_regea(as, 0x5080, n_args * 4, ASM_M68K_REG_SP); // addq.l #xx,sp
-    } else if (n_args > 2) {
-        asm_m68k_op_regea(as, 0x41c0, ASM_M68K_REG_SP, ASM_M68K_DSP(ASM_M68K_REG_SP));  // lea.l xxxx(sp),sp
-        asm_m68k_op16(as, n_args * 4);
-    }
 }
 
 void asm_m68k_mov_reg_pcrel(asm_m68k_t *as, uint rd, uint label) {
     DEBUG_printf("ASM_MOV_REG_PCREL(r%d<-rel(%d))\n", rd, label);
     mp_uint_t dest = get_label_dest(as, label);
     mp_int_t rel = dest - as->base.code_offset -2;
-    asm_m68k_op_regea(as, 0x41c0, ASM_M68K_REG_AT, ASM_M68K_PCDSP); // lea.l <label>(pc),a0
-    asm_m68k_op16(as, rel);
-    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_REG_AT);              // move.l a0,rd
+    if (ASM_M68K_IS_AREG(rd)) {
+        asm_m68k_op_regea(as, 0x41c0, rd, ASM_M68K_PCDSP);          // lea.l <label>(pc),rd
+        asm_m68k_op16(as, rel);
+        asm_m68k_peep_saved(as, 2);
+    } else {
+        asm_m68k_op_regea(as, 0x41c0, ASM_M68K_REG_AT, ASM_M68K_PCDSP); // lea.l <label>(pc),a0
+        asm_m68k_op16(as, rel);
+        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_REG_AT);              // move.l a0,rd
+    }
 }
 
 void asm_m68k_mov_reg_imm(asm_m68k_t *as, uint rd, int imm) {
     DEBUG_printf("ASM_MOV_REG_IMM(r%d<-#0x%x)\n", rd, imm);
-    if (imm <= 0x7f && imm >= -0x80) {
+    if (ASM_M68K_IS_AREG(rd)) {
+        if (imm == 0) {
+            asm_m68k_op_regea(as, 0x91c0, rd, rd);      // suba.l rd,rd
+        } else if (imm <= 0x7fff && imm >= -0x8000) {
+            asm_m68k_op_move(as, 0x3000, rd, ASM_M68K_IMM); // movea.w #xxxx,rd
+            asm_m68k_op16(as, imm);
+        } else {
+            asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_IMM); // movea.l #xxxx,rd
+            asm_m68k_op32(as, imm);
+        }
+    } else if (imm <= 0x7f && imm >= -0x80) {
         asm_m68k_op_reg_imm8(as, 0x7000, rd, imm);      // moveq.l #xx,rd
     } else {
         asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_IMM); // move.l #xxxx,rd
@@ -203,25 +605,54 @@ void asm_m68k_mov_local_reg(asm_m68k_t *as, int local_num, uint rs) {
     DEBUG_printf("ASM_MOV_LOCAL_REG([sp+%d]<-r%d)\n", local_num, rs);
     asm_m68k_op_move(as, 0x2000, ASM_M68K_FP_DSP, rs);  // move.l rs,xxxx(fp)
     asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
+    asm_m68k_peep_record(as, ASM_M68K_PEEP_STORE, local_num, rs);
 }
 
 void asm_m68k_mov_reg_local(asm_m68k_t *as, uint rd, int local_num) {
     DEBUG_printf("ASM_MOV_REG_LOCAL(r%d<-[sp+%d])\n", rd, local_num);
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    // move.l rs,xxxx(fp); move.l xxxx(fp),rd -> move.l rs,xxxx(fp); move.l rs,rd
+    if (asm_m68k_peep_follows(as, ASM_M68K_PEEP_STORE) && as->peep_rd == (uint)local_num) {
+        asm_m68k_peep_saved(as, 2);
+        asm_m68k_mov_reg_reg(as, rd, as->peep_rs);
+        return;
+    }
+    #endif
     asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_FP_DSP);  // move.l xxxx(fp),rd
     asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
 }
 
 void asm_m68k_mov_reg_local_addr(asm_m68k_t *as, uint rd, int local_num) {
     DEBUG_printf("ASM_MOV_REG_LOCAL_ADDR(r%d<-sp+%d)\n", rd, local_num);
-
-    asm_m68k_op_regea(as, 0x41c0, ASM_M68K_REG_AT, ASM_M68K_FP_DSP);    // lea.l xxxx(fp),a0
-    asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
-    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_REG_AT);                  // move.l a0,rd
+    if (ASM_M68K_IS_AREG(rd)) {
+        asm_m68k_op_regea(as, 0x41c0, rd, ASM_M68K_FP_DSP);             // lea.l xxxx(fp),rd
+        asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
+        asm_m68k_peep_saved(as, 2);
+    } else {
+        asm_m68k_op_regea(as, 0x41c0, ASM_M68K_REG_AT, ASM_M68K_FP_DSP);    // lea.l xxxx(fp),a0
+        asm_m68k_op16(as, (local_num * 4) - as->stack_adjust);
+        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_REG_AT);                  // move.l a0,rd
+    }
 }
 
 void asm_m68k_mov_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
     DEBUG_printf("ASM_MOV_REG_REG(r%d<-r%d)\n", rd, rs);
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    // The code generated for the ASM API never depends on the condition codes
+    // set by a move, so a move that doesn't change any register can be dropped
+    if (rd == rs) {
+        asm_m68k_peep_saved(as, 2);
+        return;
+    }
+    // move.l rs,rd; move.l rd,rs -> move.l rs,rd
+    if (asm_m68k_peep_follows(as, ASM_M68K_PEEP_MOVE)
+        && ((as->peep_rd == rd && as->peep_rs == rs) || (as->peep_rd == rs && as->peep_rs == rd))) {
+        asm_m68k_peep_saved(as, 2);
+        return;
+    }
+    #endif
     asm_m68k_op_move(as, 0x2000, rd, rs);               // move.l rs,rd
+    asm_m68k_peep_record(as, ASM_M68K_PEEP_MOVE, rd, rs);
 }
 
 void asm_m68k_lsl_reg_reg(asm_m68k_t *as, uint rd, uint rshift) {
@@ -242,6 +673,10 @@ void asm_m68k_or_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
 }
 void asm_m68k_xor_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
     DEBUG_printf("ASM_XOR_REG_REG(r%d<-r%d)\n", rd, rs);
+    if (rd == rs) {
+        asm_m68k_op_reg_imm8(as, 0x7000, rd, 0);        // moveq.l #0,rd
+        return;
+    }
     asm_m68k_op_regea(as, 0xb180, rs, rd);              // eor.l rs,rd
 }
 void asm_m68k_and_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
@@ -257,36 +692,487 @@ void asm_m68k_sub_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
     asm_m68k_op_regea(as, 0x9080, rd, rs);              // sub.l rs,rd
 }
 
-#if !MICROPY_SMALL_INT_MUL_HELPER
-void asm_m68k_mul_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
+// The 68000 only has a 16x16->32 multiply, so a 32-bit product is built from
+// partial products: a*b = al*bl + ((ah*bl + al*bh) << 16) (mod 2^32).  The
+// 68020 and later have muls.l; its 64-bit product form is avoided as the 68060
+// doesn't implement it.
+
+void asm_m68k_mulu_w_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
+    DEBUG_printf("ASM_MULU_W_REG_REG(r%d<-r%d)\n", rd, rs);
+    asm_m68k_op_regea(as, 0xc0c0, rd, rs);          // mulu.w rs,rd
+}
+
+void asm_m68k_muls_w_reg_reg(asm_m68k_t *as, uint rd, uint rs) {
+    DEBUG_printf("ASM_MULS_W_REG_REG(r%d<-r%d)\n", rd, rs);
+    asm_m68k_op_regea(as, 0xc1c0, rd, rs);          // muls.w rs,rd
+}
+
+// rtemp <- (rsrc.h * imm) << 16, using the high word of rsrc
+STATIC void asm_m68k_mul_high_imm(asm_m68k_t *as, uint rtemp, uint rsrc, uint imm) {
+    asm_m68k_op_move(as, 0x2000, rtemp, rsrc);      // move.l rsrc,rtemp
+    asm_m68k_op_ea(as, 0x4840, rtemp);              // swap rtemp
+    asm_m68k_op_regea(as, 0xc0c0, rtemp, ASM_M68K_IMM); // mulu.w #imm,rtemp
+    asm_m68k_op16(as, imm);
+    asm_m68k_op_ea(as, 0x4840, rtemp);              // swap rtemp
+    asm_m68k_op_ea(as, 0x4240, rtemp);              // clr.w rtemp
+}
+
+// rd_s16 says that rd is known to fit in 16 bits signed, as does imm
+void asm_m68k_mul_reg_imm(asm_m68k_t *as, uint rd, int32_t imm, uint rtemp, bool rd_s16) {
+    DEBUG_printf("ASM_MUL_REG_IMM(r%d<-#0x%x)\n", rd, imm);
+    uint32_t mag = imm < 0 ? -(uint32_t)imm : (uint32_t)imm;
+    if (imm == 0) {
+        asm_m68k_op_reg_imm8(as, 0x7000, rd, 0);    // moveq.l #0,rd
+        return;
+    }
+    if ((mag & (mag - 1)) == 0) {
+        // power of two
+        uint n = 0;
+        while ((1u << n) != mag) {
+            ++n;
+        }
+        if (n > 0 && n <= 8) {
+            asm_m68k_op_regea(as, 0xe188, n & 7, rd); // lsl.l #n,rd
+        } else if (n > 8) {
+            asm_m68k_op_reg_imm8(as, 0x7000, rtemp, n); // moveq.l #n,rtemp
+            asm_m68k_op_regea(as, 0xe1a8, rtemp, rd);   // lsl.l rtemp,rd
+        }
+    } else if (rd_s16) {
+        asm_m68k_op_regea(as, 0xc1c0, rd, ASM_M68K_IMM); // muls.w #imm,rd
+        asm_m68k_op16(as, imm);
+        return;
+    } else if (as->cpu020) {
+        asm_m68k_op_ea(as, 0x4c00, ASM_M68K_IMM);   // muls.l #imm,rd
+        asm_m68k_op16(as, (rd << 12) | 0x0800);
+        asm_m68k_op32(as, imm);
+        return;
+    } else if (mag <= 0xffff) {
+        asm_m68k_mul_high_imm(as, rtemp, rd, mag);
+        asm_m68k_op_regea(as, 0xc0c0, rd, ASM_M68K_IMM); // mulu.w #mag,rd
+        asm_m68k_op16(as, mag);
+        asm_m68k_op_regea(as, 0xd080, rd, rtemp);   // add.l rtemp,rd
+    } else {
+        uint32_t uimm = imm;
+        asm_m68k_op_move(as, 0x2000, rtemp, rd);    // move.l rd,rtemp
+        asm_m68k_op_regea(as, 0xc0c0, rtemp, ASM_M68K_IMM); // mulu.w #imm.h,rtemp
+        asm_m68k_op16(as, uimm >> 16);
+        asm_m68k_op_ea(as, 0x4840, rtemp);          // swap rtemp
+        asm_m68k_op_ea(as, 0x4240, rtemp);          // clr.w rtemp
+        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rtemp); // movea.l rtemp,a0
+        asm_m68k_mul_high_imm(as, rtemp, rd, uimm & 0xffff);
+        asm_m68k_op_regea(as, 0xd080, rtemp, ASM_M68K_REG_AT); // add.l a0,rtemp
+        asm_m68k_op_regea(as, 0xc0c0, rd, ASM_M68K_IMM); // mulu.w #imm.l,rd
+        asm_m68k_op16(as, uimm & 0xffff);
+        asm_m68k_op_regea(as, 0xd080, rd, rtemp);   // add.l rtemp,rd
+        return;
+    }
+    if (imm < 0) {
+        asm_m68k_op_ea(as, 0x4480, rd);             // neg.l rd
+    }
+}
+
+void asm_m68k_mul_reg_reg(asm_m68k_t *as, uint rd, uint rs, uint rtemp) {
     DEBUG_printf("ASM_MUL_REG_REG(r%d<-r%d)\n", rd, rs);
-    asm_m68k_op16(as, 0x518f);                      // subq.l #8,sp
-    asm_m68k_op16(as, 0x2e80 | (rd));               // move.l rd,(sp)
-    asm_m68k_op16(as, 0x2f40 | (rs));               // move.l rs,4(sp)
-    asm_m68k_op16(as, 0x0004);
-    asm_m68k_op16(as, 0xc0ef | (rd << 9));          // mulu.w 4(sp),rd
-    asm_m68k_op16(as, 0x0004);
-    asm_m68k_op16(as, 0xc0d7 | (rs << 9));          // mulu.w (sp),rs
-    asm_m68k_op16(as, 0xd040 | (rd << 9) | (rs));   // add.w rs,rd
-    asm_m68k_op16(as, 0x4840 | (rd));               // swap rd
-    asm_m68k_op16(as, 0x4240 | (rd));               // clr.w rd
-    asm_m68k_op16(as, 0x302f | (rs << 9));          // move.w 2(sp),rs
-    asm_m68k_op16(as, 0x0002);
-    asm_m68k_op16(as, 0xc0ef | (rs << 9));          // mulu.w 6(sp),rs
-    asm_m68k_op16(as, 0x0006);
-    asm_m68k_op16(as, 0xd080 | (rd << 9) | (rs));   // add.l rs,rd
-    asm_m68k_op16(as, 0x508f);                      // addq.l #8,sp
+    if (as->cpu020) {
+        asm_m68k_op_ea(as, 0x4c00, rs);             // muls.l rs,rd
+        asm_m68k_op16(as, (rd << 12) | 0x0800);
+        return;
+    }
+    asm_m68k_op_move(as, 0x2000, rtemp, rs);        // move.l rs,rtemp
+    asm_m68k_op_ea(as, 0x4840, rtemp);              // swap rtemp
+    asm_m68k_op_regea(as, 0xc0c0, rtemp, rd);       // mulu.w rd,rtemp
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rtemp); // movea.l rtemp,a0
+    asm_m68k_op_move(as, 0x2000, rtemp, rd);        // move.l rd,rtemp
+    asm_m68k_op_ea(as, 0x4840, rtemp);              // swap rtemp
+    asm_m68k_op_regea(as, 0xc0c0, rtemp, rs);       // mulu.w rs,rtemp
+    asm_m68k_op_regea(as, 0xd080, rtemp, ASM_M68K_REG_AT); // add.l a0,rtemp
+    asm_m68k_op_ea(as, 0x4840, rtemp);              // swap rtemp
+    asm_m68k_op_ea(as, 0x4240, rtemp);              // clr.w rtemp
+    asm_m68k_op_regea(as, 0xc0c0, rd, rs);          // mulu.w rs,rd
+    asm_m68k_op_regea(as, 0xd080, rd, rtemp);       // add.l rtemp,rd
 }
-#endif
 
-void asm_m68k_ld_reg_reg(asm_m68k_t *as, uint rd, uint rbase) {
-    DEBUG_printf("ASM_LOAD_REG_REG(r%d<-[r%d])\n", rd, rbase);
-    if (ASM_M68K_IS_AREG(rbase)) {
-        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_IND(rbase));  // move.l (rbase),rd
+// Viper floor division and modulo.  The 68000 divu.w only divides 32 bits by
+// 16 bits and traps or overflows if the quotient doesn't fit in 16 bits, so
+// a 32-bit dividend is divided in two steps (high word, then remainder:low
+// word).  Negative dividends are folded with n // d == ~(~n // d) and
+// n % d == d - 1 - (~n % d), which hold for d > 0 and give Python's rounding
+// towards minus infinity.  The dividend is in d0 and the result goes to d0;
+// d1-d3 and a0 are used as scratch.  The 68020 and later divide 32 bits by 32
+// bits with divsl.l, whose quotient rounds towards zero and is adjusted down
+// when the remainder is non-zero and its sign differs from the divisor's.
+
+// Emit a forward bcc.s and return its position, to be fixed up by asm_m68k_bcc_fwd_here
+STATIC size_t asm_m68k_bcc_fwd(asm_m68k_t *as, uint op) {
+    size_t pos = as->base.code_offset;
+    asm_m68k_op16(as, op);                          // bcc.s <fixed up later>
+    return pos;
+}
+
+STATIC void asm_m68k_bcc_fwd_here(asm_m68k_t *as, size_t pos) {
+    if (as->base.pass == MP_ASM_PASS_EMIT && !as->base.suppress) {
+        mp_int_t rel = as->base.code_offset - pos - 2;
+        assert(rel > 0 && rel < 0x80);
+        as->base.code_base[pos + 1] = rel;
+    }
+}
+
+// Direct calls between viper functions.  A viper function that can be called
+// directly starts with a header: a bra.s to the normal entry, then a 32-bit
+// signature of its arguments, then the direct entry, which takes the function
+// object in a0 and the raw arguments in d0-d3 and returns an object in d0 as
+// usual.  A caller checks that the object it calls is a native function whose
+// code starts with the signature it expects, and otherwise makes a normal call.
+
+// Emit the header and the frame of the direct entry; the position returned is
+// passed to asm_m68k_entry_normal after the rest of the direct entry
+size_t asm_m68k_entry_direct(asm_m68k_t *as, int num_locals, uint out_args, uint32_t sig) {
+    DEBUG_printf("locals=%d sig=%08x\n", num_locals, sig);
+    assert(num_locals >= 0 && (uint)num_locals <= ((0x8000 - 40 - out_args) / 4));
+    asm_m68k_entry_init(as, num_locals, out_args);
+    size_t pos = asm_m68k_bcc_fwd(as, 0x6000);      // bra.s <normal entry>
+    asm_m68k_op32(as, sig);
+    asm_m68k_entry_frame(as);
+    return pos;
+}
+
+void asm_m68k_entry_normal(asm_m68k_t *as, size_t pos) {
+    asm_m68k_bcc_fwd_here(as, pos);
+    asm_m68k_entry_frame(as);
+}
+
+// Call the function object in the local fun_local directly, with the n_args
+// locals after it as its raw arguments, if its type is the one in the entry
+// type_idx of the function table and its code (found at word code_ofs in
+// the object) has the signature sig.  The branches taken otherwise are stored in
+// fwd and fixed up by asm_m68k_call_direct_fallback.  The result is in d0.
+void asm_m68k_call_direct(asm_m68k_t *as, int fun_local, uint n_args, uint32_t sig, uint type_idx, uint code_ofs, size_t *fwd) {
+    DEBUG_printf("ASM_CALL_DIRECT(local %d, %d, %08x)\n", fun_local, n_args, sig);
+    assert(n_args <= 4);
+    int disp = fun_local * 4 - as->stack_adjust;
+    asm_m68k_op16(as, 0x202e);                      // move.l <fun>(fp),d0
+    asm_m68k_op16(as, disp);
+    asm_m68k_op16(as, 0x7203);                      // moveq.l #3,d1
+    asm_m68k_op16(as, 0xc200);                      // and.b d0,d1
+    fwd[0] = asm_m68k_bcc_fwd(as, 0x6600);          // bne.s <fallback>
+    asm_m68k_op16(as, 0x2040);                      // movea.l d0,a0
+    asm_m68k_op16(as, 0x2210);                      // move.l (a0),d1
+    asm_m68k_op16(as, 0xb2ad);                      // cmp.l <type_idx>*4(a5),d1
+    asm_m68k_op16(as, type_idx * 4);
+    fwd[1] = asm_m68k_bcc_fwd(as, 0x6600);          // bne.s <fallback>
+    asm_m68k_op16(as, 0x2268);                      // movea.l <code_ofs>*4(a0),a1
+    asm_m68k_op16(as, code_ofs * 4);
+    asm_m68k_op16(as, 0x0ca9);                      // cmpi.l #sig,2(a1)
+    asm_m68k_op32(as, sig);
+    asm_m68k_op16(as, 2);
+    fwd[2] = asm_m68k_bcc_fwd(as, 0x6600);          // bne.s <fallback>
+    if (n_args == 1) {
+        asm_m68k_op16(as, 0x202e);                  // move.l <fun+1>(fp),d0
+        asm_m68k_op16(as, disp + 4);
+    } else if (n_args > 1) {
+        asm_m68k_op16(as, 0x4cee);                  // movem.l <fun+1>(fp),d0-d<n_args-1>
+        asm_m68k_op16(as, (1 << n_args) - 1);
+        asm_m68k_op16(as, disp + 4);
+    }
+    asm_m68k_op16(as, 0x4ea9);                      // jsr 6(a1)
+    asm_m68k_op16(as, 6);
+}
+
+// Emit the branch from the end of a direct call over the normal call that
+// follows it, and make the guard branches of the direct call go here.  The
+// position returned is passed to asm_m68k_call_direct_done after the normal call.
+size_t asm_m68k_call_direct_fallback(asm_m68k_t *as, const size_t *fwd) {
+    size_t pos = as->base.code_offset;
+    asm_m68k_op16(as, 0x6000);                      // bra.w <done>
+    asm_m68k_op16(as, 0);
+    for (int i = 0; i < ASM_M68K_CALL_DIRECT_FWD; ++i) {
+        asm_m68k_bcc_fwd_here(as, fwd[i]);          // <fallback>:
+    }
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    as->peep_kind = ASM_M68K_PEEP_NONE;
+    #endif
+    return pos;
+}
+
+void asm_m68k_call_direct_done(asm_m68k_t *as, size_t pos) {
+    if (as->base.pass == MP_ASM_PASS_EMIT && !as->base.suppress) {
+        mp_int_t rel = as->base.code_offset - pos - 2;
+        assert(rel > 0 && rel < 0x8000);
+        as->base.code_base[pos + 2] = rel >> 8;
+        as->base.code_base[pos + 3] = rel;
+    }
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    as->peep_kind = ASM_M68K_PEEP_NONE;
+    #endif
+}
+
+// Box the int in d0 as a small int, or if it doesn't fit by calling the
+// helper fun_idx with d0 and type
+void asm_m68k_box_int(asm_m68k_t *as, uint fun_idx, uint type) {
+    DEBUG_printf("ASM_BOX_INT(%d)\n", fun_idx);
+    asm_m68k_op16(as, 0xd080);                      // add.l d0,d0
+    size_t pos = asm_m68k_bcc_fwd(as, 0x6900);      // bvs.s 1f
+    asm_m68k_op16(as, 0x5280);                      // addq.l #1,d0
+    size_t pos_done = asm_m68k_bcc_fwd(as, 0x6000); // bra.s 2f
+    asm_m68k_bcc_fwd_here(as, pos);                 // 1:
+    asm_m68k_op16(as, 0xe290);                      // roxr.l #1,d0
+    asm_m68k_mov_reg_imm(as, ASM_M68K_REG_D1, type);
+    asm_m68k_call_ind(as, fun_idx, 2);
+    asm_m68k_bcc_fwd_here(as, pos_done);            // 2:
+}
+
+// Unbox the small int in d0, or if it isn't one convert it by calling the
+// helper fun_idx with d0 and type
+void asm_m68k_unbox_int(asm_m68k_t *as, uint fun_idx, uint type) {
+    DEBUG_printf("ASM_UNBOX_INT(%d)\n", fun_idx);
+    asm_m68k_op16(as, 0x2200);                      // move.l d0,d1
+    asm_m68k_op16(as, 0xe281);                      // asr.l #1,d1
+    size_t pos = asm_m68k_bcc_fwd(as, 0x6400);      // bcc.s 1f
+    asm_m68k_op16(as, 0x2001);                      // move.l d1,d0
+    size_t pos_done = asm_m68k_bcc_fwd(as, 0x6000); // bra.s 2f
+    asm_m68k_bcc_fwd_here(as, pos);                 // 1:
+    asm_m68k_mov_reg_imm(as, ASM_M68K_REG_D1, type);
+    asm_m68k_call_ind(as, fun_idx, 2);
+    asm_m68k_bcc_fwd_here(as, pos_done);            // 2:
+}
+
+// Call the helper fun_idx with d0, unless d0 is zero
+void asm_m68k_call_ind_if_nonzero(asm_m68k_t *as, uint fun_idx) {
+    DEBUG_printf("ASM_CALL_IND_IF_NONZERO(%d)\n", fun_idx);
+    asm_m68k_op16(as, 0x4a80);                      // tst.l d0
+    size_t pos = asm_m68k_bcc_fwd(as, 0x6700);      // beq.s 1f
+    asm_m68k_call_ind(as, fun_idx, 1);
+    asm_m68k_bcc_fwd_here(as, pos);                 // 1:
+}
+
+// divu.w <divisor>,rd where the divisor is d1 or an immediate
+STATIC void asm_m68k_divu_w(asm_m68k_t *as, uint rd, bool is_imm, uint imm) {
+    if (is_imm) {
+        asm_m68k_op_regea(as, 0x80c0, rd, ASM_M68K_IMM); // divu.w #imm,rd
+        asm_m68k_op16(as, imm);
+    } else {
+        asm_m68k_op_regea(as, 0x80c0, rd, ASM_M68K_REG_D1); // divu.w d1,rd
+    }
+}
+
+STATIC void asm_m68k_floordiv_core(asm_m68k_t *as, bool is_imm, uint imm, bool mod) {
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D3, ASM_M68K_REG_D0); // move.l d0,d3
+    size_t pos = asm_m68k_bcc_fwd(as, 0x6a00);      // bpl.s 1f
+    asm_m68k_op_ea(as, 0x4680, ASM_M68K_REG_D0);    // not.l d0
+    asm_m68k_bcc_fwd_here(as, pos);                 // 1:
+    asm_m68k_op_move(as, 0x3000, ASM_M68K_REG_AT, ASM_M68K_REG_D0); // movea.w d0,a0
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D2, ASM_M68K_REG_D0); // move.l d0,d2
+    asm_m68k_op_ea(as, 0x4240, ASM_M68K_REG_D2);    // clr.w d2
+    asm_m68k_op_ea(as, 0x4840, ASM_M68K_REG_D2);    // swap d2
+    asm_m68k_divu_w(as, ASM_M68K_REG_D2, is_imm, imm);
+    asm_m68k_op_move(as, 0x3000, ASM_M68K_REG_D0, ASM_M68K_REG_D2); // move.w d2,d0
+    asm_m68k_op_ea(as, 0x4840, ASM_M68K_REG_D0);    // swap d0
+    asm_m68k_op_move(as, 0x3000, ASM_M68K_REG_D2, ASM_M68K_REG_AT); // move.w a0,d2
+    asm_m68k_divu_w(as, ASM_M68K_REG_D2, is_imm, imm);
+    if (mod) {
+        asm_m68k_op_ea(as, 0x4240, ASM_M68K_REG_D2); // clr.w d2
+        asm_m68k_op_ea(as, 0x4840, ASM_M68K_REG_D2); // swap d2
+        asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D3); // tst.l d3
+        pos = asm_m68k_bcc_fwd(as, 0x6a00);         // bpl.s 1f
+        asm_m68k_op_ea(as, 0x4680, ASM_M68K_REG_D2); // not.l d2
+        if (is_imm) {
+            asm_m68k_op_regea(as, 0xd080, ASM_M68K_REG_D2, ASM_M68K_IMM); // add.l #imm,d2
+            asm_m68k_op32(as, imm);
+        } else {
+            asm_m68k_op_regea(as, 0xd080, ASM_M68K_REG_D2, ASM_M68K_REG_D1); // add.l d1,d2
+        }
+        asm_m68k_bcc_fwd_here(as, pos);             // 1:
+        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D0, ASM_M68K_REG_D2); // move.l d2,d0
+    } else {
+        asm_m68k_op_move(as, 0x3000, ASM_M68K_REG_D0, ASM_M68K_REG_D2); // move.w d2,d0
+        asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D3); // tst.l d3
+        pos = asm_m68k_bcc_fwd(as, 0x6a00);         // bpl.s 1f
+        asm_m68k_op_ea(as, 0x4680, ASM_M68K_REG_D0); // not.l d0
+        asm_m68k_bcc_fwd_here(as, pos);             // 1:
+    }
+}
+
+// d0 <- d0 // imm or d0 % imm, for 0 < imm <= 0xffff, or 0 < imm < 2^31 on a
+// 68020.  n_u16 says that the dividend is known to fit in 16 bits unsigned.
+void asm_m68k_floordiv_imm(asm_m68k_t *as, uint imm, bool mod, bool n_u16) {
+    DEBUG_printf("ASM_FLOORDIV_IMM(#%u, %d)\n", imm, mod);
+    assert(0 < imm && (imm <= 0xffff || (as->cpu020 && imm <= 0x7fffffff)));
+    if ((imm & (imm - 1)) == 0) {
+        // power of two: an arithmetic shift already rounds towards minus infinity
+        uint n = 0;
+        while ((1u << n) != imm) {
+            ++n;
+        }
+        if (mod) {
+            asm_m68k_op_ea(as, 0x0280, ASM_M68K_REG_D0); // andi.l #imm-1,d0
+            asm_m68k_op32(as, imm - 1);
+        } else if (n > 0 && n <= 8) {
+            asm_m68k_op_regea(as, 0xe080, n & 7, ASM_M68K_REG_D0); // asr.l #n,d0
+        } else if (n > 8) {
+            asm_m68k_op_reg_imm8(as, 0x7000, ASM_M68K_REG_D1, n); // moveq.l #n,d1
+            asm_m68k_op_regea(as, 0xe0a0, ASM_M68K_REG_D1, ASM_M68K_REG_D0); // asr.l d1,d0
+        }
+    } else if (n_u16 && imm <= 0xffff) {
+        asm_m68k_divu_w(as, ASM_M68K_REG_D0, true, imm);
+        if (!mod) {
+            asm_m68k_op_ea(as, 0x4840, ASM_M68K_REG_D0); // swap d0
+        }
+        asm_m68k_op_ea(as, 0x4240, ASM_M68K_REG_D0); // clr.w d0
+        asm_m68k_op_ea(as, 0x4840, ASM_M68K_REG_D0); // swap d0
+    } else if (as->cpu020) {
+        asm_m68k_op_ea(as, 0x4c40, ASM_M68K_IMM);   // divsl.l #imm,d1:d0
+        asm_m68k_op16(as, 0x0801);
+        asm_m68k_op32(as, imm);
+        if (mod) {
+            asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D0, ASM_M68K_REG_D1); // move.l d1,d0
+            size_t pos = asm_m68k_bcc_fwd(as, 0x6a00); // bpl.s 1f
+            asm_m68k_op_regea(as, 0xd080, ASM_M68K_REG_D0, ASM_M68K_IMM); // add.l #imm,d0
+            asm_m68k_op32(as, imm);
+            asm_m68k_bcc_fwd_here(as, pos);         // 1:
+        } else {
+            asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D1); // tst.l d1
+            size_t pos = asm_m68k_bcc_fwd(as, 0x6a00); // bpl.s 1f
+            asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_REG_D0); // subq.l #1,d0
+            asm_m68k_bcc_fwd_here(as, pos);         // 1:
+        }
+    } else {
+        asm_m68k_floordiv_core(as, true, imm, mod);
+    }
+}
+
+// d0 <- d0 // d1 or d0 % d1, calling the runtime helper fun_idx if d1 isn't
+// in the range 1..0xffff, or is zero on a 68020
+void asm_m68k_floordiv_reg(asm_m68k_t *as, bool mod, uint fun_idx) {
+    DEBUG_printf("ASM_FLOORDIV_REG(%d)\n", mod);
+    if (as->cpu020) {
+        asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D1); // tst.l d1
+        size_t pos_slow = asm_m68k_bcc_fwd(as, 0x6700); // beq.s 3f
+        asm_m68k_op_reg_imm8(as, 0x7000, ASM_M68K_REG_D2, 0); // moveq.l #0,d2
+        asm_m68k_op_ea(as, 0x4c40, ASM_M68K_REG_D1); // divsl.l d1,d2:d0
+        asm_m68k_op16(as, 0x0802);
+        asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D2); // tst.l d2
+        size_t pos_exact = asm_m68k_bcc_fwd(as, 0x6700); // beq.s 1f
+        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D3, ASM_M68K_REG_D2); // move.l d2,d3
+        asm_m68k_op_regea(as, 0xb180, ASM_M68K_REG_D1, ASM_M68K_REG_D3); // eor.l d1,d3
+        size_t pos_same = asm_m68k_bcc_fwd(as, 0x6a00); // bpl.s 1f
+        if (mod) {
+            asm_m68k_op_regea(as, 0xd080, ASM_M68K_REG_D2, ASM_M68K_REG_D1); // add.l d1,d2
+        } else {
+            asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_REG_D0); // subq.l #1,d0
+        }
+        asm_m68k_bcc_fwd_here(as, pos_exact);       // 1:
+        asm_m68k_bcc_fwd_here(as, pos_same);
+        if (mod) {
+            asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D0, ASM_M68K_REG_D2); // move.l d2,d0
+        }
+        size_t pos_done = asm_m68k_bcc_fwd(as, 0x6000); // bra.s 2f
+        asm_m68k_bcc_fwd_here(as, pos_slow);        // 3:
+        asm_m68k_call_ind(as, fun_idx, 2);
+        asm_m68k_bcc_fwd_here(as, pos_done);        // 2:
+        return;
+    }
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_D2, ASM_M68K_REG_D1); // move.l d1,d2
+    asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_REG_D2); // subq.l #1,d2
+    asm_m68k_op_ea(as, 0x0c80, ASM_M68K_REG_D2);    // cmpi.l #0xfffe,d2
+    asm_m68k_op32(as, 0xfffe);
+    size_t pos_slow = asm_m68k_bcc_fwd(as, 0x6200); // bhi.s 1f
+    asm_m68k_floordiv_core(as, false, 0, mod);
+    size_t pos_done = asm_m68k_bcc_fwd(as, 0x6000); // bra.s 2f
+    asm_m68k_bcc_fwd_here(as, pos_slow);            // 1:
+    asm_m68k_call_ind(as, fun_idx, 2);
+    asm_m68k_bcc_fwd_here(as, pos_done);            // 2:
+}
+
+// Viper floats are held in data registers as the bits of an IEEE-754 single,
+// and are only moved into fp0 for the duration of one 68881/68882 operation
+
+// rd <- rd <fop> rs
+void asm_m68k_float_op(asm_m68k_t *as, uint fop, uint rd, uint rs) {
+    DEBUG_printf("ASM_FLOAT_OP(%02x r%d r%d)\n", fop, rd, rs);
+    assert(!ASM_M68K_IS_AREG(rd) && !ASM_M68K_IS_AREG(rs));
+    asm_m68k_op_ea(as, 0xf200, rd);             // fmove.s rd,fp0
+    asm_m68k_op16(as, 0x4400);
+    asm_m68k_op_ea(as, 0xf200, rs);             // f<op>.s rs,fp0
+    asm_m68k_op16(as, 0x4400 | fop);
+    asm_m68k_op_ea(as, 0xf200, rd);             // fmove.s fp0,rd
+    asm_m68k_op16(as, 0x6400);
+}
+
+// rr <- 1 if rd <fcond> rs else 0
+void asm_m68k_float_cmp_setcc(asm_m68k_t *as, uint rd, uint rs, uint fcond, uint rr) {
+    DEBUG_printf("ASM_FLOAT_CMP(%d r%d r%d -> r%d)\n", fcond, rd, rs, rr);
+    assert(!ASM_M68K_IS_AREG(rd) && !ASM_M68K_IS_AREG(rs));
+    asm_m68k_op_ea(as, 0xf200, rd);             // fmove.s rd,fp0
+    asm_m68k_op16(as, 0x4400);
+    asm_m68k_op_ea(as, 0xf200, rs);             // fcmp.s rs,fp0
+    asm_m68k_op16(as, 0x4400 | ASM_M68K_FOP_CMP);
+    asm_m68k_op_reg_imm8(as, 0x7000, rr, 1);    // moveq.l #1,rr
+    asm_m68k_op16(as, 0xf280 | fcond);          // fb<fcond>.w 1f
+    asm_m68k_op16(as, 4);
+    asm_m68k_op_reg_imm8(as, 0x7000, rr, 0);    // moveq.l #0,rr
+                                                // 1:
+}
+
+// rr <- 1 if d0, the result of the soft-float compare helper which is -1, 0 or 1
+// for less, equal or greater and 2 if unordered, satisfies fcond
+void asm_m68k_float_cmp_result_setcc(asm_m68k_t *as, uint fcond, uint rr) {
+    DEBUG_printf("ASM_FLOAT_CMP_RESULT(%d -> r%d)\n", fcond, rr);
+    uint cond;
+    bool vs_one = false;
+    switch (fcond) {
+        case ASM_M68K_FCC_OLT:
+            cond = ASM_M68K_CC_MI;
+            break;
+        case ASM_M68K_FCC_OLE:
+            cond = ASM_M68K_CC_LE;
+            break;
+        case ASM_M68K_FCC_EQ:
+            cond = ASM_M68K_CC_EQ;
+            break;
+        case ASM_M68K_FCC_NE:
+            cond = ASM_M68K_CC_NE;
+            break;
+        case ASM_M68K_FCC_OGT:
+            cond = ASM_M68K_CC_EQ;
+            vs_one = true;
+            break;
+        default:
+            assert(fcond == ASM_M68K_FCC_OGE);
+            cond = ASM_M68K_CC_LS;
+            vs_one = true;
+            break;
+    }
+    asm_m68k_op_reg_imm8(as, 0x7000, rr, 0);    // moveq.l #0,rr
+    if (vs_one) {
+        asm_m68k_op_regea(as, 0x5180, 1, ASM_M68K_REG_D0); // subq.l #1,d0
     } else {
-        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_AT_IND);      // move.l (a0),rd
+        asm_m68k_op_ea(as, 0x4a80, ASM_M68K_REG_D0); // tst.l d0
     }
+    asm_m68k_op_cc(as, 0x50c0, cond, rr);       // scc rr
+}
+
+// rd <- float(rd)
+void asm_m68k_float_from_int(asm_m68k_t *as, uint rd) {
+    DEBUG_printf("ASM_FLOAT_FROM_INT(r%d)\n", rd);
+    assert(!ASM_M68K_IS_AREG(rd));
+    asm_m68k_op_ea(as, 0xf200, rd);             // fmove.l rd,fp0
+    asm_m68k_op16(as, 0x4000);
+    asm_m68k_op_ea(as, 0xf200, rd);             // fmove.s fp0,rd
+    asm_m68k_op16(as, 0x6400);
+}
+
+// rd <- -rd, which only needs the sign bit flipped
+void asm_m68k_float_neg(asm_m68k_t *as, uint rd) {
+    DEBUG_printf("ASM_FLOAT_NEG(r%d)\n", rd);
+    assert(!ASM_M68K_IS_AREG(rd));
+    asm_m68k_op_ea(as, 0x0840, rd);             // bchg #31,rd
+    asm_m68k_op16(as, 31);
+}
+
+void asm_m68k_ld_reg_reg(asm_m68k_t *as, uint rd, uint rbase) {
+    DEBUG_printf("ASM_LOAD_REG_REG(r%d<-[r%d])\n", rd, rbase);
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_IND(areg));   // move.l (areg),rd
 }
 
 void asm_m68k_ld_reg_reg_ofst(asm_m68k_t *as, uint rd, uint rbase, uint word_offset) {
@@ -295,74 +1181,130 @@ void asm_m68k_ld_reg_reg_ofst(asm_m68k_t *as, uint rd, uint rbase, uint word_off
         return;
     }
     DEBUG_printf("ASM_LOAD_REG_REG_OFFSET(r%d<-[r%d+%d])\n", rd, rbase, word_offset);
-    if (ASM_M68K_IS_AREG(rbase)) {
-        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_DSP(rbase));  // move.l xxxx(rbase),rd
-    } else {
-        asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-        asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_AT_DSP);      // move.l xxxx(a0),rd
-    }
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_DSP(areg));   // move.l xxxx(areg),rd
     asm_m68k_op16(as, word_offset * 4);
 }
 
 void asm_m68k_ld8_reg_reg(asm_m68k_t *as, uint rd, uint rbase) {
     DEBUG_printf("ASM_LOAD8_REG_REG(r%d<-[r%d])\n", rd, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x1000, rd, ASM_M68K_AT_IND);      // move.b (a0),rd
-    asm_m68k_op_ea(as, 0x4880, rd);                         // ext.w rd
-    asm_m68k_op_ea(as, 0x48c0, rd);                         // ext.l rd
+    asm_m68k_ldn_reg_reg_disp(as, 0, rd, rbase, 0);
 }
 
 void asm_m68k_ld16_reg_reg(asm_m68k_t *as, uint rd, uint rbase) {
     DEBUG_printf("ASM_LOAD16_REG_REG(r%d<-[r%d])\n", rd, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x3000, rd, ASM_M68K_AT_IND);      // move.w (a0),rd
-    asm_m68k_op_ea(as, 0x48c0, rd);                         // ext.l rd
+    asm_m68k_ldn_reg_reg_disp(as, 1, rd, rbase, 0);
 }
 
 void asm_m68k_ld16_reg_reg_ofst(asm_m68k_t *as, uint rd, uint rbase, uint uint16_offset) {
     DEBUG_printf("ASM_LOAD16_REG_REG_OFFSET(r%d<-[r%d+%d])\n", rd, rbase, uint16_offset);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x3000, rd, ASM_M68K_AT_DSP);      // move.w xxxx(a0),rd
-    asm_m68k_op16(as, uint16_offset * 2);
-    asm_m68k_op_ea(as, 0x48c0, rd);                         // ext.l rd
+    asm_m68k_ldn_reg_reg_disp(as, 1, rd, rbase, uint16_offset * 2);
 }
 
 void asm_m68k_ld32_reg_reg(asm_m68k_t *as, uint rd, uint rbase) {
     DEBUG_printf("ASM_LOAD32_REG_REG(r%d<-[r%d])\n", rd, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_AT_IND);      // move.l (a0),rd
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, rd, ASM_M68K_IND(areg));   // move.l (areg),rd
 }
 
 
 void asm_m68k_st_reg_reg(asm_m68k_t *as, uint rs, uint rbase) {
     DEBUG_printf("ASM_STORE_REG_REG(r%d->[r%d])\n", rs, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_AT_IND, rs);      // move.l rs,(a0)
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_IND(areg), rs);   // move.l rs,(areg)
 }
 
 void asm_m68k_st_reg_reg_ofst(asm_m68k_t *as, uint rs, uint rbase, uint word_offset) {
     DEBUG_printf("ASM_STORE_REG_REG_OFFSET(r%d->[r%d+%d])\n", rs, rbase, word_offset);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_AT_DSP, rs);      // move.l rs,xxxx(a0)
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_DSP(areg), rs);   // move.l rs,xxxx(areg)
     asm_m68k_op16(as, word_offset * 4);
 }
 
 void asm_m68k_st8_reg_reg(asm_m68k_t *as, uint rs, uint rbase) {
     DEBUG_printf("ASM_STORE8_REG_REG(r%d->[r%d])\n", rs, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x1000, ASM_M68K_AT_IND, rs);      // move.b rs,(a0)
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x1000, ASM_M68K_IND(areg), rs);   // move.b rs,(areg)
 }
 
 void asm_m68k_st16_reg_reg(asm_m68k_t *as, uint rs, uint rbase) {
     DEBUG_printf("ASM_STORE16_REG_REG(r%d->[r%d])\n", rs, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x3000, ASM_M68K_AT_IND, rs);      // move.w rs,(a0)
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x3000, ASM_M68K_IND(areg), rs);   // move.w rs,(areg)
 }
 
 void asm_m68k_st32_reg_reg(asm_m68k_t *as, uint rs, uint rbase) {
     DEBUG_printf("ASM_STORE32_REG_REG(r%d->[r%d])\n", rs, rbase);
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_REG_AT, rbase);   // movea.l rbase,a0
-    asm_m68k_op_move(as, 0x2000, ASM_M68K_AT_IND, rs);      // move.l rs,(a0)
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, 0x2000, ASM_M68K_IND(areg), rs);   // move.l rs,(areg)
+}
+
+STATIC const uint16_t asm_m68k_move_size[3] = { 0x1000, 0x3000, 0x2000 };
+
+// Brief extension word for (0,An,rindex.l*scale); scales other than 1 need a 68020
+static inline uint asm_m68k_index_ext(asm_m68k_t *as, uint rindex, uint scale_log2) {
+    assert(scale_log2 == 0 || as->cpu020);
+    return (rindex << 12) | 0x0800 | (scale_log2 << 9);
+}
+
+// Scale rindex for elements of 1 << size_log2 bytes, returning the scale that
+// is left for the addressing mode: all of it on a 68020, none on a 68000
+STATIC uint asm_m68k_scale_index(asm_m68k_t *as, uint size_log2, uint rindex) {
+    assert(!ASM_M68K_IS_AREG(rindex));
+    if (as->cpu020) {
+        return size_log2;
+    }
+    for (uint i = 0; i < size_log2; ++i) {
+        asm_m68k_op_regea(as, 0xd080, rindex, rindex);  // add.l rindex,rindex
+    }
+    return 0;
+}
+
+// (areg) or disp(areg), the displacement word following the instruction
+STATIC uint asm_m68k_disp_ea(uint areg, int disp) {
+    assert(-0x8000 <= disp && disp < 0x8000);
+    return disp == 0 ? ASM_M68K_IND(areg) : ASM_M68K_DSP(areg);
+}
+
+void asm_m68k_ldn_reg_reg_disp(asm_m68k_t *as, uint size_log2, uint rd, uint rbase, int disp) {
+    DEBUG_printf("ASM_LOADN_REG_REG_DISP(%d, r%d<-[r%d+%d])\n", 1 << size_log2, rd, rbase, disp);
+    uint areg = asm_m68k_get_areg(as, rbase);
+    if (size_log2 < 2) {
+        asm_m68k_op_reg_imm8(as, 0x7000, rd, 0);        // moveq.l #0,rd
+    }
+    asm_m68k_op_move(as, asm_m68k_move_size[size_log2], rd, asm_m68k_disp_ea(areg, disp)); // move.x disp(areg),rd
+    if (disp != 0) {
+        asm_m68k_op16(as, disp);
+    }
+}
+
+void asm_m68k_ldn_reg_reg_reg(asm_m68k_t *as, uint size_log2, uint rd, uint rbase, uint rindex) {
+    DEBUG_printf("ASM_LOADN_REG_REG_REG(%d, r%d<-[r%d+r%d])\n", 1 << size_log2, rd, rbase, rindex);
+    assert(rd != rindex);
+    uint areg = asm_m68k_get_areg(as, rbase);
+    uint scale = asm_m68k_scale_index(as, size_log2, rindex);
+    if (size_log2 < 2) {
+        asm_m68k_op_reg_imm8(as, 0x7000, rd, 0);        // moveq.l #0,rd
+    }
+    asm_m68k_op_move(as, asm_m68k_move_size[size_log2], rd, ASM_M68K_IDX(areg)); // move.x 0(areg,rindex.l*scale),rd
+    asm_m68k_op16(as, asm_m68k_index_ext(as, rindex, scale));
+}
+
+void asm_m68k_stn_reg_reg_disp(asm_m68k_t *as, uint size_log2, uint rs, uint rbase, int disp) {
+    DEBUG_printf("ASM_STOREN_REG_REG_DISP(%d, r%d->[r%d+%d])\n", 1 << size_log2, rs, rbase, disp);
+    uint areg = asm_m68k_get_areg(as, rbase);
+    asm_m68k_op_move(as, asm_m68k_move_size[size_log2], asm_m68k_disp_ea(areg, disp), rs); // move.x rs,disp(areg)
+    if (disp != 0) {
+        asm_m68k_op16(as, disp);
+    }
+}
+
+void asm_m68k_stn_reg_reg_reg(asm_m68k_t *as, uint size_log2, uint rs, uint rbase, uint rindex) {
+    DEBUG_printf("ASM_STOREN_REG_REG_REG(%d, r%d->[r%d+r%d])\n", 1 << size_log2, rs, rbase, rindex);
+    uint areg = asm_m68k_get_areg(as, rbase);
+    uint scale = asm_m68k_scale_index(as, size_log2, rindex);
+    asm_m68k_op_move(as, asm_m68k_move_size[size_log2], ASM_M68K_IDX(areg), rs); // move.x rs,0(areg,rindex.l*scale)
+    asm_m68k_op16(as, asm_m68k_index_ext(as, rindex, scale));
 }
 
 #endif // MICROPY_EMIT_M68K || MICROPY_EMIT_INLINE_M68K
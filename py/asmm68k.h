@@ -67,26 +67,87 @@
 #define ASM_M68K_CC_GT  (0xe)
 #define ASM_M68K_CC_LE  (0xf)
 
+// 68881/68882 operations and IEEE-aware conditions for viper floats
+#define ASM_M68K_FOP_DIV    (0x20)
+#define ASM_M68K_FOP_ADD    (0x22)
+#define ASM_M68K_FOP_MUL    (0x23)
+#define ASM_M68K_FOP_SUB    (0x28)
+#define ASM_M68K_FOP_CMP    (0x38)
+
+#define ASM_M68K_FCC_EQ     (0x01)
+#define ASM_M68K_FCC_OGT    (0x02)
+#define ASM_M68K_FCC_OGE    (0x03)
+#define ASM_M68K_FCC_OLT    (0x04)
+#define ASM_M68K_FCC_OLE    (0x05)
+#define ASM_M68K_FCC_NE     (0x0e)
+
 // m68k passes values on the stack, but the emitter is register based, so we need
 // to define registers that can temporarily hold the function arguments.  They
-// need to be defined here so that asm_m68k_call_ind can push them onto the stack
-// before the call.
+// need to be defined here so that asm_m68k_call_ind can store them into the
+// outgoing argument area before the call.
 #define ASM_M68K_REG_ARG_1 ASM_M68K_REG_D0
 #define ASM_M68K_REG_ARG_2 ASM_M68K_REG_D1
 #define ASM_M68K_REG_ARG_3 ASM_M68K_REG_D2
 #define ASM_M68K_REG_ARG_4 ASM_M68K_REG_D3
 
+// Size of the outgoing argument area for calls to runtime helpers, which
+// take at most 4 arguments
+#define ASM_M68K_OUT_ARGS_SIZE  (4 * 4)
+
+// Kinds of instruction remembered by the peephole optimiser
+#define ASM_M68K_PEEP_NONE      (0)
+#define ASM_M68K_PEEP_MOVE      (1) // move.l peep_rs,peep_rd
+#define ASM_M68K_PEEP_STORE     (2) // move.l peep_rs,<local peep_rd>(fp)
+
+// A branch to a label, see asm_m68k_relax_branches
+typedef struct _asm_m68k_branch_t {
+    size_t pos;             // offset of the branch in the compute pass
+    size_t saved_before;    // bytes saved by relaxing the branches before this one
+    uint16_t label;
+    uint8_t min_size;       // size of the shortest form
+    uint8_t max_size;       // size reserved in the compute pass, 0 if suppressed
+    uint8_t size;           // size chosen for the emit pass
+} asm_m68k_branch_t;
+
 typedef struct _asm_m68k_t {
     mp_asm_base_t base;
     uint stack_adjust;
+    uint out_args;
+    bool cpu020;            // 68020 and later instructions can be used
+    asm_m68k_branch_t *branch;
+    size_t branch_alloc;
+    size_t branch_len;
+    size_t branch_cur;
+    size_t branch_saved;
+    #if MICROPY_EMIT_M68K_PEEPHOLE
+    // The last instruction emitted, if it is one the peephole optimiser can use
+    uint8_t peep_kind;
+    uint8_t peep_rs;
+    uint16_t peep_rd;
+    size_t peep_end;
+    size_t peep_saved;
+    #endif
 } asm_m68k_t;
 
-static inline void asm_m68k_end_pass(asm_m68k_t *as) {
-    (void)as;
-}
+void asm_m68k_end_pass(asm_m68k_t *as);
+size_t asm_m68k_relaxed_pos(asm_m68k_t *as, size_t pos);
 
-void asm_m68k_entry(asm_m68k_t *as, int num_locals);
+void asm_m68k_entry(asm_m68k_t *as, int num_locals, uint out_args);
 void asm_m68k_exit(asm_m68k_t *as);
+void asm_m68k_entry_inline(asm_m68k_t *as, uint save_regs, bool link, uint arg_regs);
+void asm_m68k_exit_inline(asm_m68k_t *as, uint save_regs, bool link);
+
+// Number of guard branches of asm_m68k_call_direct
+#define ASM_M68K_CALL_DIRECT_FWD (3)
+
+size_t asm_m68k_entry_direct(asm_m68k_t *as, int num_locals, uint out_args, uint32_t sig);
+void asm_m68k_entry_normal(asm_m68k_t *as, size_t pos);
+void asm_m68k_call_direct(asm_m68k_t *as, int fun_local, uint n_args, uint32_t sig, uint type_idx, uint code_ofs, size_t *fwd);
+size_t asm_m68k_call_direct_fallback(asm_m68k_t *as, const size_t *fwd);
+void asm_m68k_call_direct_done(asm_m68k_t *as, size_t pos);
+void asm_m68k_box_int(asm_m68k_t *as, uint fun_idx, uint type);
+void asm_m68k_unbox_int(asm_m68k_t *as, uint fun_idx, uint type);
+void asm_m68k_call_ind_if_nonzero(asm_m68k_t *as, uint fun_idx);
 
 void asm_m68k_op16(asm_m68k_t *as, uint op);
 void asm_m68k_op32(asm_m68k_t *as, uint32_t op);
@@ -125,9 +186,15 @@ void asm_m68k_mov_args_to_r32(asm_m68k_t *as, int src_arg_num, uint reglist);
 void asm_m68k_cmp_reg_reg_setcc(asm_m68k_t *as, uint rd, uint rs, uint cond, uint rr);
 
 void asm_m68k_jump(asm_m68k_t *as, uint label);
+void asm_m68k_count_start(asm_m68k_t *as, uint rd, uint label);
+void asm_m68k_count_jump(asm_m68k_t *as, uint rd, uint label);
+void asm_m68k_count_jump_local(asm_m68k_t *as, uint local_num, uint label);
 void asm_m68k_jmp_if_reg_zero(asm_m68k_t *as, uint reg, uint label, uint bool_test);
 void asm_m68k_jmp_if_reg_nonzero(asm_m68k_t *as, uint reg, uint label, uint bool_test);
 void asm_m68k_jmp_if_reg_eq(asm_m68k_t *as, uint reg1, uint reg2, uint label);
+void asm_m68k_jmp_if_index_out(asm_m68k_t *as, uint rindex, int rlen, int len_local, uint label);
+void asm_m68k_jmp_if_index_imm_out(asm_m68k_t *as, int index, int rlen, int len_local, uint label);
+void asm_m68k_jmp_if_range_out(asm_m68k_t *as, uint rlo, uint rhi, int rlen, int len_local, uint label);
 void asm_m68k_jmp_reg(asm_m68k_t *as, uint reg);
 void asm_m68k_call_ind(asm_m68k_t *as, uint idx, uint n_args);
 void asm_m68k_mov_reg_pcrel(asm_m68k_t *as, uint rd, uint label);
@@ -146,7 +213,17 @@ void asm_m68k_xor_reg_reg(asm_m68k_t *as, uint rd, uint rs);
 void asm_m68k_and_reg_reg(asm_m68k_t *as, uint rd, uint rs);
 void asm_m68k_add_reg_reg(asm_m68k_t *as, uint rd, uint rs);
 void asm_m68k_sub_reg_reg(asm_m68k_t *as, uint rd, uint rs);
-void asm_m68k_mul_reg_reg(asm_m68k_t *as, uint rd, uint rs);
+void asm_m68k_mulu_w_reg_reg(asm_m68k_t *as, uint rd, uint rs);
+void asm_m68k_muls_w_reg_reg(asm_m68k_t *as, uint rd, uint rs);
+void asm_m68k_mul_reg_imm(asm_m68k_t *as, uint rd, int32_t imm, uint rtemp, bool rd_s16);
+void asm_m68k_mul_reg_reg(asm_m68k_t *as, uint rd, uint rs, uint rtemp);
+void asm_m68k_floordiv_imm(asm_m68k_t *as, uint imm, bool mod, bool n_u16);
+void asm_m68k_floordiv_reg(asm_m68k_t *as, bool mod, uint fun_idx);
+void asm_m68k_float_op(asm_m68k_t *as, uint fop, uint rd, uint rs);
+void asm_m68k_float_cmp_setcc(asm_m68k_t *as, uint rd, uint rs, uint fcond, uint rr);
+void asm_m68k_float_cmp_result_setcc(asm_m68k_t *as, uint fcond, uint rr);
+void asm_m68k_float_from_int(asm_m68k_t *as, uint rd);
+void asm_m68k_float_neg(asm_m68k_t *as, uint rd);
 
 void asm_m68k_ld_reg_reg(asm_m68k_t *as, uint rd, uint rbase);
 void asm_m68k_ld_reg_reg_ofst(asm_m68k_t *as, uint rd, uint rbase, uint word_offset);
@@ -161,12 +238,21 @@ void asm_m68k_st8_reg_reg(asm_m68k_t *as, uint rs, uint rbase);
 void asm_m68k_st16_reg_reg(asm_m68k_t *as, uint rs, uint rbase);
 void asm_m68k_st32_reg_reg(asm_m68k_t *as, uint rs, uint rbase);
 
+// Viper pointer loads and stores of 1 << size_log2 bytes at rbase+disp or
+// rbase+(rindex << size_log2).  Loads zero extend.  On a 68000 rindex is
+// scaled in place, so it must be a register that can be clobbered.
+void asm_m68k_ldn_reg_reg_disp(asm_m68k_t *as, uint size_log2, uint rd, uint rbase, int disp);
+void asm_m68k_ldn_reg_reg_reg(asm_m68k_t *as, uint size_log2, uint rd, uint rbase, uint rindex);
+void asm_m68k_stn_reg_reg_disp(asm_m68k_t *as, uint size_log2, uint rs, uint rbase, int disp);
+void asm_m68k_stn_reg_reg_reg(asm_m68k_t *as, uint size_log2, uint rs, uint rbase, uint rindex);
+
 // Temporary address register for register indirect addressing
 #define ASM_M68K_REG_AT         ASM_M68K_REG_A0
 
 #define ASM_M68K_IND(areg)      (((areg) & 7) | 0x10)
 #define ASM_M68K_PRD(areg)      (((areg) & 7) | 0x20)
 #define ASM_M68K_DSP(areg)      (((areg) & 7) | 0x28)
+#define ASM_M68K_IDX(areg)      (((areg) & 7) | 0x30)
 #define ASM_M68K_PCDSP          (0x3a)
 #define ASM_M68K_IMM            (0x3c)
 
@@ -199,13 +285,17 @@ void asm_m68k_st32_reg_reg(asm_m68k_t *as, uint rs, uint rbase);
 #define REG_LOCAL_1     ASM_M68K_REG_D4
 #define REG_LOCAL_2     ASM_M68K_REG_D5
 #define REG_LOCAL_3     ASM_M68K_REG_D6
-#define REG_LOCAL_NUM (3)
+#define REG_LOCAL_4     ASM_M68K_REG_D7
+#define REG_LOCAL_5     ASM_M68K_REG_A2
+#define REG_LOCAL_6     ASM_M68K_REG_A3
+#define REG_LOCAL_7     ASM_M68K_REG_A4
+#define REG_LOCAL_NUM (7)
 
 #define REG_FUN_TABLE ASM_M68K_REG_FUN_TABLE
 
 #define ASM_T               asm_m68k_t
 #define ASM_END_PASS        asm_m68k_end_pass
-#define ASM_ENTRY           asm_m68k_entry
+#define ASM_ENTRY(as, num_locals) asm_m68k_entry((as), (num_locals), ASM_M68K_OUT_ARGS_SIZE)
 #define ASM_EXIT            asm_m68k_exit
 
 #define ASM_JUMP(as, label) asm_m68k_jump((as), (label))
@@ -233,9 +323,6 @@ void asm_m68k_st32_reg_reg(asm_m68k_t *as, uint rs, uint rbase);
 #define ASM_AND_REG_REG(as, reg_dest, reg_src) asm_m68k_and_reg_reg((as), (reg_dest), (reg_src))
 #define ASM_ADD_REG_REG(as, reg_dest, reg_src) asm_m68k_add_reg_reg((as), (reg_dest), (reg_src))
 #define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_m68k_sub_reg_reg((as), (reg_dest), (reg_src))
-#if !MICROPY_SMALL_INT_MUL_HELPER
-#define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_m68k_mul_reg_reg((as), (reg_dest), (reg_src))
-#endif
 
 #define ASM_LOAD_REG_REG(as, reg_dest, reg_base) asm_m68k_ld_reg_reg((as), (reg_dest), (reg_base))
 #define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, offset) asm_m68k_ld_reg_reg_ofst((as), (reg_dest), (reg_base), (offset))
@@ -195,6 +195,169 @@ STATIC void do_execute_raw_code(const mp_module_context_t *context, const mp_raw
 }
 #endif
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+
+#include "extmod/vfs.h"
+#include "py/stream.h"
+
+// A module compiled from "dir/name.py" is cached in "dir/__pycache__/name.mpy".
+// The .mpy data follows a header holding the mtime and size of the source, and
+// the emitter and optimisation level it was compiled for, so any change to
+// those compiles it again.
+typedef struct _mp_import_cache_header_t {
+    byte magic[2];
+    byte emit_opt;
+    byte arch;
+    byte opt_level;
+    byte reserved[3];
+    uint32_t mtime;
+    uint32_t size;
+    uint32_t mpy_len; // not part of the key, used to check the file is complete
+} mp_import_cache_header_t;
+
+#define IMPORT_CACHE_KEY_LEN (offsetof(mp_import_cache_header_t, mpy_len))
+
+// Re-raise an exception caught while accessing the cache unless it is an error
+// that only makes the cache unusable (rather than, say, a KeyboardInterrupt)
+STATIC void cache_check_exception(nlr_buf_t *nlr) {
+    if (!mp_obj_exception_match(MP_OBJ_FROM_PTR(nlr->ret_val), MP_OBJ_FROM_PTR(&mp_type_Exception))) {
+        nlr_jump(nlr->ret_val);
+    }
+}
+
+STATIC mp_obj_t cache_stat(const char *path, size_t len, size_t idx) {
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(mp_vfs_stat(mp_obj_new_str(path, len)), 10, &items);
+    return items[idx];
+}
+
+// Make the path of the cached module and the header it must have
+STATIC bool cache_init(vstr_t *file, vstr_t *cache, mp_import_cache_header_t *hdr) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        hdr->magic[0] = 'M';
+        hdr->magic[1] = 'C';
+        #if MICROPY_EMIT_NATIVE
+        hdr->emit_opt = MP_STATE_VM(default_emit_opt);
+        #else
+        hdr->emit_opt = MP_EMIT_OPT_BYTECODE;
+        #endif
+        #if defined(MPY_FEATURE_ARCH_RUNTIME)
+        hdr->arch = MPY_FEATURE_ARCH_RUNTIME;
+        #else
+        hdr->arch = MPY_FEATURE_ARCH;
+        #endif
+        hdr->opt_level = MP_STATE_VM(mp_optimise_value);
+        memset(hdr->reserved, 0, sizeof(hdr->reserved));
+        hdr->mtime = mp_obj_get_int_truncated(cache_stat(file->buf, file->len, 8));
+        hdr->size = mp_obj_get_int_truncated(cache_stat(file->buf, file->len, 6));
+        nlr_pop();
+    } else {
+        cache_check_exception(&nlr);
+        return false;
+    }
+
+    const char *name = strrchr(file->buf, '/');
+    name = name == NULL ? file->buf : name + 1;
+    vstr_init(cache, file->len + sizeof(MICROPY_PERSISTENT_CODE_CACHE_DIR) + 2);
+    vstr_add_strn(cache, file->buf, name - file->buf);
+    vstr_add_str(cache, MICROPY_PERSISTENT_CODE_CACHE_DIR PATH_SEP_CHAR);
+    vstr_add_strn(cache, name, file->buf + file->len - name - 2); // keep the "."
+    vstr_add_str(cache, "mpy");
+    return true;
+}
+
+// Load the cached module if it is complete and has the given header
+STATIC bool cache_load(vstr_t *cache, const mp_import_cache_header_t *hdr, mp_compiled_module_t *cm) {
+    const char *cache_str = vstr_null_terminated_str(cache);
+    if (mp_import_stat(cache_str) != MP_IMPORT_STAT_FILE) {
+        return false;
+    }
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_reader_t reader;
+        mp_reader_new_file(&reader, cache_str);
+
+        // Close the reader if checking the header raises; once the header is
+        // good, mp_raw_code_load takes over closing it
+        MP_DEFINE_NLR_JUMP_CALLBACK_FUNCTION_1(ctx, reader.close, reader.data);
+        nlr_push_jump_callback(&ctx.callback, mp_call_function_1_from_nlr_jump_callback);
+        mp_import_cache_header_t h;
+        for (size_t i = 0; i < sizeof(h); ++i) {
+            ((byte *)&h)[i] = reader.readbyte(reader.data);
+        }
+        bool valid = memcmp(&h, hdr, IMPORT_CACHE_KEY_LEN) == 0
+            && (size_t)mp_obj_get_int_truncated(cache_stat(cache->buf, cache->len, 6)) == sizeof(h) + h.mpy_len;
+        nlr_pop_jump_callback(!valid);
+        if (!valid) {
+            nlr_pop();
+            return false;
+        }
+        mp_raw_code_load(&reader, cm);
+        nlr_pop();
+        return true;
+    } else {
+        cache_check_exception(&nlr);
+        return false;
+    }
+}
+
+// Save the compiled module to the cache, ignoring any errors doing so
+STATIC void cache_save(mp_compiled_module_t *cm, vstr_t *cache, mp_import_cache_header_t *hdr) {
+    vstr_t mpy;
+    mp_print_t print;
+    vstr_init_print(&mpy, 1024, &print);
+    mp_raw_code_save(cm, &print);
+    hdr->mpy_len = mpy.len;
+
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        size_t dir_len = strrchr(cache->buf, '/') - cache->buf;
+        vstr_null_terminated_str(cache)[dir_len] = '\0';
+        if (mp_import_stat(cache->buf) != MP_IMPORT_STAT_DIR) {
+            mp_vfs_mkdir(mp_obj_new_str(cache->buf, dir_len));
+        }
+        cache->buf[dir_len] = '/';
+        mp_obj_t args[2] = { mp_obj_new_str(cache->buf, cache->len), MP_OBJ_NEW_QSTR(MP_QSTR_wb) };
+        mp_obj_t f = mp_vfs_open(MP_ARRAY_SIZE(args), args, (mp_map_t *)&mp_const_empty_map);
+        mp_stream_write(f, hdr, sizeof(*hdr), MP_STREAM_RW_WRITE);
+        mp_stream_write(f, mpy.buf, mpy.len, MP_STREAM_RW_WRITE);
+        mp_stream_close(f);
+        nlr_pop();
+    } else {
+        cache_check_exception(&nlr);
+    }
+    vstr_clear(&mpy);
+}
+
+// Execute the module from its cached .mpy if that is up to date, or otherwise
+// compile it and save it to the cache for the next import
+STATIC bool do_load_cached(mp_module_context_t *context, vstr_t *file) {
+    vstr_t cache;
+    mp_import_cache_header_t hdr;
+    if (!cache_init(file, &cache, &hdr)) {
+        return false;
+    }
+    const char *file_str = vstr_null_terminated_str(file);
+    mp_compiled_module_t cm;
+    cm.context = context;
+    if (!cache_load(&cache, &hdr, &cm)) {
+        DEBUG_printf("compiling %s to cache %s\n", file_str, cache.buf);
+        mp_lexer_t *lex = mp_lexer_new_from_file(file_str);
+        qstr source_name = lex->source_name;
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        mp_compile_to_raw_code(&parse_tree, source_name, false, &cm);
+        if (!mp_obj_is_true(MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_DONT_WRITE_BYTECODE]))) {
+            cache_save(&cm, &cache, &hdr);
+        }
+    }
+    vstr_clear(&cache);
+    do_execute_raw_code(cm.context, cm.rc, file_str);
+    return true;
+}
+
+#endif // MICROPY_PERSISTENT_CODE_CACHE
+
 STATIC void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_ENABLE_COMPILER || (MICROPY_PERSISTENT_CODE_LOAD && MICROPY_HAS_FILE_READER)
     const char *file_str = vstr_null_terminated_str(file);
@@ -247,6 +410,11 @@ STATIC void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
+        #if MICROPY_PERSISTENT_CODE_CACHE
+        if (do_load_cached(module_obj, file)) {
+            return;
+        }
+        #endif
         mp_lexer_t *lex = mp_lexer_new_from_file(file_str);
         do_load_from_lexer(module_obj, lex);
         return;
@@ -105,6 +105,8 @@ STATIC const emit_method_table_t *emit_native_table[] = {
     &emit_native_xtensa_method_table,
     &emit_native_xtensawin_method_table,
     &emit_native_m68k_method_table,
+    &emit_native_m68k_method_table,
+    &emit_native_m68k_method_table,
 };
 
 #elif MICROPY_EMIT_NATIVE
@@ -147,6 +149,8 @@ STATIC const emit_inline_asm_method_table_t *emit_asm_table[] = {
     &emit_inline_xtensa_method_table,
     NULL,
     &emit_inline_m68k_method_table,
+    &emit_inline_m68k_method_table,
+    &emit_inline_m68k_method_table,
 };
 
 #elif MICROPY_EMIT_INLINE_ASM
@@ -169,6 +173,26 @@ STATIC const emit_inline_asm_method_table_t *emit_asm_table[] = {
 #define EMIT_INLINE_ASM(fun) (comp->emit_inline_asm_method_table->fun(comp->emit_inline_asm))
 #define EMIT_INLINE_ASM_ARG(fun, ...) (comp->emit_inline_asm_method_table->fun(comp->emit_inline_asm, __VA_ARGS__))
 
+#if MICROPY_EMIT_NATIVE
+#define BUF_HOIST_MAX_RANGES (4)
+#define BUF_HOIST_MAX_ACCESSES (16)
+
+// Subscripts of checked viper buffers in the body of a range loop that are in
+// range for every iteration once the checks of the ranges have passed; see
+// compile_for_stmt_buf_hoist
+typedef struct _buf_hoist_t {
+    qstr var;
+    uint8_t n_range;
+    uint8_t n_access;
+    struct {
+        qstr buf;
+        mp_parse_node_t pn_offset; // small int or local, MP_PARSE_NODE_NULL for none
+        bool negate;
+    } range[BUF_HOIST_MAX_RANGES];
+    mp_parse_node_struct_t *access[BUF_HOIST_MAX_ACCESSES]; // the trailer_bracket nodes
+} buf_hoist_t;
+#endif
+
 // elements in this struct are ordered to make it compact
 typedef struct _compiler_t {
     uint8_t is_repl;
@@ -197,6 +221,10 @@ typedef struct _compiler_t {
     const emit_method_table_t *emit_method_table;   // current emit method table
     #endif
 
+    #if MICROPY_EMIT_NATIVE
+    buf_hoist_t *buf_hoist; // non-NULL while compiling the unchecked copy of a loop
+    #endif
+
     #if MICROPY_EMIT_INLINE_ASM
     emit_inline_asm_t *emit_inline_asm;                                   // current emitter for inline asm
     const emit_inline_asm_method_table_t *emit_inline_asm_method_table;   // current emit method table for inline asm
@@ -438,6 +466,24 @@ STATIC void c_if_cond(compiler_t *comp, mp_parse_node_t pn, bool jump_if, int la
     EMIT_ARG(pop_jump_if, jump_if, label);
 }
 
+#if MICROPY_EMIT_NATIVE
+// Tell the emitter that the subscript of pns_trailer about to be emitted needs no
+// bounds check, if it is one of those found by compile_for_stmt_buf_hoist
+STATIC void compile_buf_unchecked(compiler_t *comp, mp_parse_node_struct_t *pns_trailer) {
+    buf_hoist_t *hoist = comp->buf_hoist;
+    if (hoist != NULL) {
+        for (size_t i = 0; i < hoist->n_access; i++) {
+            if (hoist->access[i] == pns_trailer) {
+                EMIT_ARG(buf_check, 0, 0, MP_EMIT_BUF_CHECK_NONE);
+                return;
+            }
+        }
+    }
+}
+#else
+#define compile_buf_unchecked(comp, pns_trailer)
+#endif
+
 typedef enum { ASSIGN_STORE, ASSIGN_AUG_LOAD, ASSIGN_AUG_STORE } assign_kind_t;
 STATIC void c_assign(compiler_t *comp, mp_parse_node_t pn, assign_kind_t kind);
 
@@ -461,13 +507,16 @@ STATIC void c_assign_atom_expr(compiler_t *comp, mp_parse_node_struct_t *pns, as
         if (MP_PARSE_NODE_STRUCT_KIND(pns1) == PN_trailer_bracket) {
             if (assign_kind == ASSIGN_AUG_STORE) {
                 EMIT(rot_three);
+                compile_buf_unchecked(comp, pns1);
                 EMIT_ARG(subscr, MP_EMIT_SUBSCR_STORE);
             } else {
                 compile_node(comp, pns1->nodes[0]);
                 if (assign_kind == ASSIGN_AUG_LOAD) {
                     EMIT(dup_top_two);
+                    compile_buf_unchecked(comp, pns1);
                     EMIT_ARG(subscr, MP_EMIT_SUBSCR_LOAD);
                 } else {
+                    compile_buf_unchecked(comp, pns1);
                     EMIT_ARG(subscr, MP_EMIT_SUBSCR_STORE);
                 }
             }
@@ -887,6 +936,9 @@ STATIC void compile_decorated(compiler_t *comp, mp_parse_node_struct_t *pns) {
 
     // inherit emit options for this function/class definition
     uint emit_options = comp->scope_cur->emit_options;
+    #if MICROPY_EMIT_INLINE_ASM
+    mp_parse_node_t pn_asm_options = MP_PARSE_NODE_NULL;
+    #endif
 
     // compile each decorator
     size_t num_built_in_decorators = 0;
@@ -902,6 +954,12 @@ STATIC void compile_decorated(compiler_t *comp, mp_parse_node_struct_t *pns) {
         if (compile_built_in_decorator(comp, name_len, name_nodes, &emit_options)) {
             // this was a built-in
             num_built_in_decorators += 1;
+            #if MICROPY_EMIT_INLINE_ASM
+            if (emit_options == MP_EMIT_OPT_ASM && MP_PARSE_NODE_IS_STRUCT(pns_decorator->nodes[1])) {
+                // arguments to the decorator (in a trailer_paren) are handed to the inline assembler
+                pn_asm_options = ((mp_parse_node_struct_t *)pns_decorator->nodes[1])->nodes[0];
+            }
+            #endif
 
         } else {
             // not a built-in, compile normally
@@ -926,6 +984,11 @@ STATIC void compile_decorated(compiler_t *comp, mp_parse_node_struct_t *pns) {
     qstr body_name = 0;
     if (MP_PARSE_NODE_STRUCT_KIND(pns_body) == PN_funcdef) {
         body_name = compile_funcdef_helper(comp, pns_body, emit_options);
+        #if MICROPY_EMIT_INLINE_ASM
+        if (comp->pass == MP_PASS_SCOPE) {
+            ((scope_t *)pns_body->nodes[4])->pn_asm_options = pn_asm_options;
+        }
+        #endif
     #if MICROPY_PY_ASYNC_AWAIT
     } else if (MP_PARSE_NODE_STRUCT_KIND(pns_body) == PN_async_funcdef) {
         assert(MP_PARSE_NODE_IS_STRUCT(pns_body->nodes[0]));
@@ -1503,6 +1566,370 @@ STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
     }
 }
 
+#if MICROPY_EMIT_NATIVE
+// Count the uses of qst in pn, and the for-loops with qst as the target.
+// in_for tells whether pn is within such a loop, and *nested is set if one
+// of those loops is within another.
+STATIC void compile_count_id(mp_parse_node_t pn, qstr qst, size_t *n_use, size_t *n_for, bool in_for, bool *nested) {
+    if (MP_PARSE_NODE_IS_ID(pn)) {
+        if (MP_PARSE_NODE_LEAF_ARG(pn) == qst) {
+            *n_use += 1;
+        }
+    } else if (MP_PARSE_NODE_IS_STRUCT(pn)) {
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
+        if (MP_PARSE_NODE_STRUCT_KIND(pns) == PN_const_object) {
+            return;
+        }
+        if (MP_PARSE_NODE_STRUCT_KIND(pns) == PN_for_stmt
+            && MP_PARSE_NODE_IS_ID(pns->nodes[0]) && MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]) == qst) {
+            *n_for += 1;
+            if (in_for) {
+                *nested = true;
+            }
+            in_for = true;
+        }
+        size_t num_nodes = MP_PARSE_NODE_STRUCT_NUM_NODES(pns);
+        for (size_t i = 0; i < num_nodes; i++) {
+            compile_count_id(pns->nodes[i], qst, n_use, n_for, in_for, nested);
+        }
+    }
+}
+
+// Whether a range loop can be compiled by compile_for_stmt_counted
+STATIC bool compile_for_stmt_can_count(compiler_t *comp, mp_parse_node_t pn_var, mp_parse_node_t pn_step, mp_parse_node_t pn_else) {
+    scope_t *scope = comp->scope_cur;
+    if (scope->emit_options != MP_EMIT_OPT_VIPER
+        || comp->emit_method_table->counted_loop == NULL
+        || (scope->scope_flags & MP_SCOPE_FLAG_GENERATOR)
+        || MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) != 1
+        || !MP_PARSE_NODE_IS_NULL(pn_else)) {
+        return false;
+    }
+    qstr qst = MP_PARSE_NODE_LEAF_ARG(pn_var);
+    id_info_t *id = scope_find(scope, qst);
+    if (id == NULL || id->kind != ID_INFO_KIND_LOCAL) {
+        return false;
+    }
+    // the loop variable must not be used other than as the target of loops,
+    // and the loops must not be nested as they would share the counter
+    size_t n_use = 0;
+    size_t n_for = 0;
+    bool nested = false;
+    compile_count_id(scope->pn, qst, &n_use, &n_for, false, &nested);
+    return n_use == n_for && !nested;
+}
+
+// This function compiles a for-loop of the form:
+//      for <var> in range(<start>, <end>):
+//          <body>
+// when the value of <var> is never used, by counting the number of iterations
+// down in <var> itself.  <end> - <start> is computed once at the start.
+STATIC void compile_for_stmt_counted(compiler_t *comp, mp_parse_node_t pn_var, mp_parse_node_t pn_start, mp_parse_node_t pn_end, mp_parse_node_t pn_body) {
+    START_BREAK_CONTINUE_BLOCK
+
+    uint top_label = comp_next_label(comp);
+    id_info_t *id = scope_find(comp->scope_cur, MP_PARSE_NODE_LEAF_ARG(pn_var));
+
+    // compile: end - start
+    compile_node(comp, pn_end);
+    if (!MP_PARSE_NODE_IS_SMALL_INT(pn_start) || MP_PARSE_NODE_LEAF_SMALL_INT(pn_start) != 0) {
+        compile_node(comp, pn_start);
+        EMIT_ARG(binary_op, MP_BINARY_OP_SUBTRACT);
+    }
+
+    EMIT_ARG(counted_loop, id->local_num, break_label, MP_EMIT_COUNTED_LOOP_START);
+    EMIT_ARG(label_assign, top_label);
+
+    compile_node(comp, pn_body);
+
+    EMIT_ARG(label_assign, continue_label);
+    EMIT_ARG(counted_loop, id->local_num, top_label, MP_EMIT_COUNTED_LOOP_END);
+
+    END_BREAK_CONTINUE_BLOCK
+
+    EMIT_ARG(label_assign, break_label);
+}
+
+// Whether qst is a local of the current scope.  Kinds are only known after
+// MP_PASS_SCOPE, so in that pass any name will do.
+STATIC bool compile_buf_hoist_is_local(compiler_t *comp, qstr qst) {
+    if (comp->pass == MP_PASS_SCOPE) {
+        return true;
+    }
+    id_info_t *id = scope_find(comp->scope_cur, qst);
+    return id != NULL && id->kind == ID_INFO_KIND_LOCAL;
+}
+
+// Whether qst is a checked buffer argument of the current scope
+STATIC bool compile_buf_hoist_is_buf(compiler_t *comp, qstr qst) {
+    id_info_t *id = scope_find(comp->scope_cur, qst);
+    if (id == NULL || !(id->flags & ID_FLAG_IS_PARAM)) {
+        return false;
+    }
+    int native_type = id->flags >> ID_FLAG_VIPER_TYPE_POS;
+    return MP_NATIVE_TYPE_BUF8 <= native_type && native_type <= MP_NATIVE_TYPE_BUF32;
+}
+
+// Whether pn can be evaluated twice with the same result: a small int or a local
+STATIC bool compile_buf_hoist_is_simple(compiler_t *comp, mp_parse_node_t pn) {
+    return MP_PARSE_NODE_IS_SMALL_INT(pn)
+           || (MP_PARSE_NODE_IS_ID(pn) && compile_buf_hoist_is_local(comp, MP_PARSE_NODE_LEAF_ARG(pn)));
+}
+
+// Record the range of indices needed by buf[<index>], if <index> is one of
+// <var>, <var> + <offset>, <offset> + <var> or <var> - <offset>
+STATIC void compile_buf_hoist_add(compiler_t *comp, buf_hoist_t *hoist, qstr buf, mp_parse_node_struct_t *pns_trailer) {
+    mp_parse_node_t pn_index = pns_trailer->nodes[0];
+    mp_parse_node_t pn_offset = MP_PARSE_NODE_NULL;
+    bool negate = false;
+    if (MP_PARSE_NODE_IS_ID(pn_index) && MP_PARSE_NODE_LEAF_ARG(pn_index) == hoist->var) {
+        // buf[var]
+    } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn_index, PN_arith_expr)
+               && MP_PARSE_NODE_STRUCT_NUM_NODES((mp_parse_node_struct_t *)pn_index) == 3) {
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn_index;
+        mp_parse_node_t pn_var = pns->nodes[0];
+        pn_offset = pns->nodes[2];
+        if (MP_PARSE_NODE_IS_TOKEN_KIND(pns->nodes[1], MP_TOKEN_OP_MINUS)) {
+            negate = true;
+        } else if (!(MP_PARSE_NODE_IS_ID(pn_var) && MP_PARSE_NODE_LEAF_ARG(pn_var) == hoist->var)) {
+            // <offset> + <var>
+            pn_var = pns->nodes[2];
+            pn_offset = pns->nodes[0];
+        }
+        if (!(MP_PARSE_NODE_IS_ID(pn_var) && MP_PARSE_NODE_LEAF_ARG(pn_var) == hoist->var)
+            || (MP_PARSE_NODE_IS_ID(pn_offset) && MP_PARSE_NODE_LEAF_ARG(pn_offset) == hoist->var)
+            || !compile_buf_hoist_is_simple(comp, pn_offset)) {
+            return;
+        }
+    } else {
+        return;
+    }
+
+    if (hoist->n_access == BUF_HOIST_MAX_ACCESSES) {
+        return;
+    }
+    size_t i = 0;
+    while (i < hoist->n_range
+           && !(hoist->range[i].buf == buf && hoist->range[i].pn_offset == pn_offset && hoist->range[i].negate == negate)) {
+        i++;
+    }
+    if (i == hoist->n_range) {
+        if (i == BUF_HOIST_MAX_RANGES) {
+            return;
+        }
+        hoist->range[i].buf = buf;
+        hoist->range[i].pn_offset = pn_offset;
+        hoist->range[i].negate = negate;
+        hoist->n_range += 1;
+    }
+    hoist->access[hoist->n_access++] = pns_trailer;
+}
+
+// Collect the subscripts of checked buffers in pn.  Returns false if pn has
+// statements that the loop versioning can't handle: nested loops and blocks,
+// and anything that creates a child scope or binds names other than by a plain
+// assignment.
+STATIC bool compile_buf_hoist_scan(compiler_t *comp, buf_hoist_t *hoist, mp_parse_node_t pn) {
+    if (!MP_PARSE_NODE_IS_STRUCT(pn)) {
+        return true;
+    }
+    mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
+    switch (MP_PARSE_NODE_STRUCT_KIND(pns)) {
+        case PN_const_object:
+            return true;
+        case PN_for_stmt:
+        case PN_while_stmt:
+        case PN_try_stmt:
+        case PN_with_stmt:
+        case PN_del_stmt:
+        case PN_import_name:
+        case PN_import_from:
+        case PN_global_stmt:
+        case PN_nonlocal_stmt:
+        case PN_funcdef:
+        case PN_classdef:
+        case PN_decorated:
+        case PN_lambdef:
+        case PN_lambdef_nocond:
+        case PN_namedexpr_test:
+        case PN_comp_for:
+            return false;
+        case PN_atom_expr_normal:
+            if (MP_PARSE_NODE_IS_ID(pns->nodes[0])
+                && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_trailer_bracket)
+                && compile_buf_hoist_is_buf(comp, MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]))) {
+                compile_buf_hoist_add(comp, hoist, MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]),
+                    (mp_parse_node_struct_t *)pns->nodes[1]);
+            }
+            break;
+    }
+    size_t num_nodes = MP_PARSE_NODE_STRUCT_NUM_NODES(pns);
+    for (size_t i = 0; i < num_nodes; i++) {
+        if (!compile_buf_hoist_scan(comp, hoist, pns->nodes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether assigning to the target pn binds qst
+STATIC bool compile_buf_hoist_target_binds(mp_parse_node_t pn, qstr qst) {
+    if (MP_PARSE_NODE_IS_ID(pn)) {
+        return MP_PARSE_NODE_LEAF_ARG(pn) == qst;
+    }
+    if (!MP_PARSE_NODE_IS_STRUCT(pn) || MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_atom_expr_normal)) {
+        // subscripts and attributes don't bind names
+        return false;
+    }
+    mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
+    size_t num_nodes = MP_PARSE_NODE_STRUCT_NUM_NODES(pns);
+    for (size_t i = 0; i < num_nodes; i++) {
+        if (compile_buf_hoist_target_binds(pns->nodes[i], qst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether an assignment statement in pn binds qst; compile_buf_hoist_scan has
+// already ruled out the other ways of binding a name
+STATIC bool compile_buf_hoist_binds(mp_parse_node_t pn, qstr qst) {
+    if (!MP_PARSE_NODE_IS_STRUCT(pn) || MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_const_object)) {
+        return false;
+    }
+    mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
+    if (MP_PARSE_NODE_STRUCT_KIND(pns) == PN_expr_stmt && !MP_PARSE_NODE_IS_NULL(pns->nodes[1])) {
+        if (compile_buf_hoist_target_binds(pns->nodes[0], qst)) {
+            return true;
+        }
+        if (MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_expr_stmt_assign_list)) {
+            // middle targets of a chained assignment
+            mp_parse_node_struct_t *pns1 = (mp_parse_node_struct_t *)pns->nodes[1];
+            size_t rhs = MP_PARSE_NODE_STRUCT_NUM_NODES(pns1) - 1;
+            for (size_t i = 0; i < rhs; i++) {
+                if (compile_buf_hoist_target_binds(pns1->nodes[i], qst)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    size_t num_nodes = MP_PARSE_NODE_STRUCT_NUM_NODES(pns);
+    for (size_t i = 0; i < num_nodes; i++) {
+        if (compile_buf_hoist_binds(pns->nodes[i], qst)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Find the subscripts of checked buffers in the body of a range loop that can
+// have their bounds checks hoisted out of the loop.  The loop variable and the
+// offsets must not change in the body, and the step must be positive so that
+// the first and last iterations bound the indices.
+STATIC bool compile_buf_hoist_find(compiler_t *comp, buf_hoist_t *hoist, mp_parse_node_t pn_var, mp_parse_node_t pn_start, mp_parse_node_t pn_end, mp_parse_node_t pn_step, mp_parse_node_t pn_body, mp_parse_node_t pn_else) {
+    scope_t *scope = comp->scope_cur;
+    if (scope->emit_options != MP_EMIT_OPT_VIPER
+        || (comp->pass > MP_PASS_SCOPE && comp->emit_method_table->buf_check == NULL)
+        || (scope->scope_flags & MP_SCOPE_FLAG_GENERATOR)
+        || MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) <= 0
+        || MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) > 0x10000
+        || !MP_PARSE_NODE_IS_NULL(pn_else)
+        || !compile_buf_hoist_is_simple(comp, pn_start)
+        || !compile_buf_hoist_is_simple(comp, pn_end)) {
+        return false;
+    }
+    hoist->var = MP_PARSE_NODE_LEAF_ARG(pn_var);
+    hoist->n_range = 0;
+    hoist->n_access = 0;
+    if (!compile_buf_hoist_is_local(comp, hoist->var)
+        || !compile_buf_hoist_scan(comp, hoist, pn_body)
+        || hoist->n_access == 0
+        || compile_buf_hoist_binds(pn_body, hoist->var)) {
+        return false;
+    }
+    for (size_t i = 0; i < hoist->n_range; i++) {
+        mp_parse_node_t pn_offset = hoist->range[i].pn_offset;
+        if (MP_PARSE_NODE_IS_ID(pn_offset) && compile_buf_hoist_binds(pn_body, MP_PARSE_NODE_LEAF_ARG(pn_offset))) {
+            return false;
+        }
+    }
+    if (MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) > 1) {
+        // the loop variable steps past <end>, so <end> must be in range too
+        // to keep it from wrapping around
+        size_t i = 0;
+        while (i < hoist->n_range && !(hoist->range[i].buf == hoist->range[0].buf && MP_PARSE_NODE_IS_NULL(hoist->range[i].pn_offset))) {
+            i++;
+        }
+        if (i == hoist->n_range) {
+            if (i == BUF_HOIST_MAX_RANGES) {
+                return false;
+            }
+            hoist->range[i].buf = hoist->range[0].buf;
+            hoist->range[i].pn_offset = MP_PARSE_NODE_NULL;
+            hoist->range[i].negate = false;
+            hoist->n_range += 1;
+        }
+    }
+    return true;
+}
+
+// compile: <bound> + <offset> for one of the ranges of a hoisted check
+STATIC void compile_buf_hoist_bound(compiler_t *comp, buf_hoist_t *hoist, size_t i, mp_parse_node_t pn_bound) {
+    compile_node(comp, pn_bound);
+    if (!MP_PARSE_NODE_IS_NULL(hoist->range[i].pn_offset)) {
+        compile_node(comp, hoist->range[i].pn_offset);
+        EMIT_ARG(binary_op, hoist->range[i].negate ? MP_BINARY_OP_SUBTRACT : MP_BINARY_OP_ADD);
+    }
+}
+
+// This function compiles a range loop in viper code whose body indexes checked
+// buffers with the loop variable, as in:
+//      for <var> in range(<start>, <end>):
+//          <buf>[<var> + <offset>] = ...
+// Before the loop, the indices of the first and last iterations are checked
+// against the length of each buffer.  If they are in range the loop runs with
+// those subscripts unchecked, otherwise a copy of the loop with all checks runs
+// instead and raises IndexError at the subscript that is out of range.
+STATIC bool compile_for_stmt_buf_hoist(compiler_t *comp, mp_parse_node_t pn_var, mp_parse_node_t pn_start, mp_parse_node_t pn_end, mp_parse_node_t pn_step, mp_parse_node_t pn_body, mp_parse_node_t pn_else) {
+    buf_hoist_t hoist;
+    if (!compile_buf_hoist_find(comp, &hoist, pn_var, pn_start, pn_end, pn_step, pn_body, pn_else)) {
+        return false;
+    }
+
+    if (comp->pass == MP_PASS_SCOPE) {
+        // The bytecode emitter is used for this pass and has no buf_check.
+        // Compile one copy and reserve labels for the other, in case the later
+        // passes decide to version the loop.
+        uint first_label = comp->next_label;
+        compile_for_stmt_optimised_range(comp, pn_var, pn_start, pn_end, pn_step, pn_body, pn_else);
+        comp->next_label += comp->next_label - first_label + 2;
+        return true;
+    }
+
+    uint checked_label = comp_next_label(comp);
+    uint end_label = comp_next_label(comp);
+
+    for (size_t i = 0; i < hoist.n_range; i++) {
+        compile_buf_hoist_bound(comp, &hoist, i, pn_start);
+        compile_buf_hoist_bound(comp, &hoist, i, pn_end);
+        id_info_t *id = scope_find(comp->scope_cur, hoist.range[i].buf);
+        EMIT_ARG(buf_check, id->local_num, checked_label, MP_EMIT_BUF_CHECK_RANGE);
+    }
+
+    comp->buf_hoist = &hoist;
+    compile_for_stmt_optimised_range(comp, pn_var, pn_start, pn_end, pn_step, pn_body, pn_else);
+    comp->buf_hoist = NULL;
+    EMIT_ARG(jump, end_label);
+
+    EMIT_ARG(label_assign, checked_label);
+    compile_for_stmt_optimised_range(comp, pn_var, pn_start, pn_end, pn_step, pn_body, pn_else);
+
+    EMIT_ARG(label_assign, end_label);
+    return true;
+}
+#endif
+
 STATIC void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // this bit optimises: for <x> in range(...), turning it into an explicitly incremented variable
     // this is actually slower, but uses no heap memory
@@ -1554,6 +1981,15 @@ STATIC void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
                 }
             }
             if (optimize) {
+                #if MICROPY_EMIT_NATIVE
+                if (compile_for_stmt_can_count(comp, pns->nodes[0], pn_range_step, pns->nodes[3])) {
+                    compile_for_stmt_counted(comp, pns->nodes[0], pn_range_start, pn_range_end, pns->nodes[2]);
+                    return;
+                }
+                if (compile_for_stmt_buf_hoist(comp, pns->nodes[0], pn_range_start, pn_range_end, pn_range_step, pns->nodes[2], pns->nodes[3])) {
+                    return;
+                }
+                #endif
                 compile_for_stmt_optimised_range(comp, pns->nodes[0], pn_range_start, pn_range_end, pn_range_step, pns->nodes[2], pns->nodes[3]);
                 return;
             }
@@ -2660,6 +3096,7 @@ STATIC void compile_trailer_paren(compiler_t *comp, mp_parse_node_struct_t *pns)
 STATIC void compile_trailer_bracket(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // object who's index we want is on top of stack
     compile_node(comp, pns->nodes[0]); // the index
+    compile_buf_unchecked(comp, pns);
     EMIT_ARG(subscr, MP_EMIT_SUBSCR_LOAD);
 }
 
@@ -2840,6 +3277,47 @@ STATIC int compile_viper_type_annotation(compiler_t *comp, mp_parse_node_t pn_an
     }
     return native_type;
 }
+
+// The checked buffer type for an argument annotated with bytearray, or with an
+// array('H') or xarray('H') call (optionally qualified by a module name), or -1
+STATIC int compile_viper_buf_annotation(mp_parse_node_t pn_annotation) {
+    if (MP_PARSE_NODE_IS_ID(pn_annotation)) {
+        if (MP_PARSE_NODE_LEAF_ARG(pn_annotation) == MP_QSTR_bytearray) {
+            return mp_native_buf_type_from_typecode('B');
+        }
+        return -1;
+    }
+    if (!MP_PARSE_NODE_IS_STRUCT_KIND(pn_annotation, PN_atom_expr_normal)) {
+        return -1;
+    }
+    mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn_annotation;
+    mp_parse_node_t pn_name = pns->nodes[0];
+    mp_parse_node_struct_t *pns_paren = (mp_parse_node_struct_t *)pns->nodes[1];
+    if (MP_PARSE_NODE_STRUCT_KIND(pns_paren) == PN_atom_expr_trailers) {
+        // module.name(...)
+        mp_parse_node_struct_t *pns_trailers = pns_paren;
+        if (MP_PARSE_NODE_STRUCT_NUM_NODES(pns_trailers) != 2
+            || !MP_PARSE_NODE_IS_STRUCT_KIND(pns_trailers->nodes[0], PN_trailer_period)) {
+            return -1;
+        }
+        pn_name = ((mp_parse_node_struct_t *)pns_trailers->nodes[0])->nodes[0];
+        pns_paren = (mp_parse_node_struct_t *)pns_trailers->nodes[1];
+    }
+    if (!MP_PARSE_NODE_IS_ID(pn_name)
+        || (MP_PARSE_NODE_LEAF_ARG(pn_name) != MP_QSTR_array && MP_PARSE_NODE_LEAF_ARG(pn_name) != MP_QSTR_xarray)
+        || MP_PARSE_NODE_STRUCT_KIND(pns_paren) != PN_trailer_paren) {
+        return -1;
+    }
+    mp_parse_node_t pn_typecode = pns_paren->nodes[0];
+    if (!MP_PARSE_NODE_IS_LEAF(pn_typecode) || MP_PARSE_NODE_LEAF_KIND(pn_typecode) != MP_PARSE_NODE_STRING) {
+        return -1;
+    }
+    qstr typecode = MP_PARSE_NODE_LEAF_ARG(pn_typecode);
+    if (qstr_len(typecode) != 1) {
+        return -1;
+    }
+    return mp_native_buf_type_from_typecode(qstr_str(typecode)[0]);
+}
 #endif
 
 STATIC void compile_scope_func_lambda_param(compiler_t *comp, mp_parse_node_t pn, pn_kind_t pn_name, pn_kind_t pn_star, pn_kind_t pn_dbl_star) {
@@ -2921,7 +3399,15 @@ STATIC void compile_scope_func_lambda_param(compiler_t *comp, mp_parse_node_t pn
 
         #if MICROPY_EMIT_NATIVE
         if (comp->scope_cur->emit_options == MP_EMIT_OPT_VIPER && pn_name == PN_typedargslist_name && pns != NULL) {
-            id_info->flags |= compile_viper_type_annotation(comp, pns->nodes[1]) << ID_FLAG_VIPER_TYPE_POS;
+            // checked buffers are only supported for positional arguments
+            int native_type = -1;
+            if (MP_PARSE_NODE_STRUCT_KIND(pns) == pn_name && !comp->have_star) {
+                native_type = compile_viper_buf_annotation(pns->nodes[1]);
+            }
+            if (native_type < 0) {
+                native_type = compile_viper_type_annotation(comp, pns->nodes[1]);
+            }
+            id_info->flags |= native_type << ID_FLAG_VIPER_TYPE_POS;
         }
         #else
         (void)pns;
@@ -3027,7 +3513,7 @@ STATIC bool compile_scope(compiler_t *comp, scope_t *scope, pass_kind_t pass) {
     comp->next_label = 0;
     mp_emit_common_start_pass(&comp->emit_common, pass);
     EMIT_ARG(start_pass, pass, scope);
-    reserve_labels_for_native(comp, 6); // used by native's start_pass
+    reserve_labels_for_native(comp, 8); // used by native's start_pass
 
     if (comp->pass == MP_PASS_SCOPE) {
         // reset maximum stack sizes in scope
@@ -3198,6 +3684,16 @@ STATIC void compile_scope_inline_asm(compiler_t *comp, scope_t *scope, pass_kind
 
     if (comp->pass > MP_PASS_SCOPE) {
         EMIT_INLINE_ASM_ARG(start_pass, comp->pass, &comp->compile_error);
+
+        // arguments to the decorator, eg @micropython.asm_m68k(save='auto')
+        mp_parse_node_t *pn_options;
+        size_t n_options = mp_parse_node_extract_list(&scope->pn_asm_options, PN_arglist, &pn_options);
+        if (comp->emit_inline_asm_method_table->options != NULL) {
+            EMIT_INLINE_ASM_ARG(options, n_options, pn_options);
+        } else if (n_options > 0) {
+            compile_syntax_error(comp, scope->pn_asm_options, MP_ERROR_TEXT("inline assembler takes no options"));
+            return;
+        }
     }
 
     // get the function definition parse node
@@ -3452,6 +3948,20 @@ STATIC void scope_compute_things(scope_t *scope) {
             scope->num_locals += num_free;
         }
     }
+
+    #if MICROPY_EMIT_NATIVE
+    // the native emitter keeps the length of each checked buffer argument in a
+    // hidden local after all the others
+    if (scope->emit_options == MP_EMIT_OPT_VIPER) {
+        for (int i = 0; i < scope->id_info_len; i++) {
+            id_info_t *id = &scope->id_info[i];
+            int native_type = id->flags >> ID_FLAG_VIPER_TYPE_POS;
+            if ((id->flags & ID_FLAG_IS_PARAM) && MP_NATIVE_TYPE_BUF8 <= native_type && native_type <= MP_NATIVE_TYPE_BUF32) {
+                scope->num_locals += 1;
+            }
+        }
+    }
+    #endif
 }
 
 #if !MICROPY_PERSISTENT_CODE_SAVE
@@ -3541,6 +4051,14 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
                 compile_scope_inline_asm(comp, s, MP_PASS_CODE_SIZE);
             }
             #endif
+            #if MICROPY_EMIT_INLINE_M68K
+            // With decorator options m68k needs an extra pass, because the
+            // registers saved in the prologue depend on those the body uses
+            // (the other assemblers have already reported options as an error)
+            if (!MP_PARSE_NODE_IS_NULL(s->pn_asm_options) && comp->compile_error == MP_OBJ_NULL) {
+                compile_scope_inline_asm(comp, s, MP_PASS_CODE_SIZE);
+            }
+            #endif
             if (comp->compile_error == MP_OBJ_NULL) {
                 compile_scope_inline_asm(comp, s, MP_PASS_EMIT);
             }
@@ -99,6 +99,19 @@ CROSS = xtensa-esp32-elf-
 CFLAGS +=
 MICROPY_FLOAT_IMPL ?= float
 
+else ifeq ($(ARCH),m68k)
+
+# m68k (68000 code, runs on all CPU models)
+CROSS = m68k-xelf-
+CFLAGS += -m68000
+MICROPY_FLOAT_IMPL ?= float
+
+# The 68000 has no 32-bit multiply and divide instructions, so link in the
+# libgcc routines that gcc calls for them
+LIBGCC_FILE_NAME = $(shell $(CROSS)gcc -m68000 -print-libgcc-file-name)
+LIBGCC_O = $(addprefix $(BUILD)/libgcc/,_mulsi3.o _divsi3.o _udivsi3.o _modsi3.o _umodsi3.o)
+SRC_O += $(LIBGCC_O)
+
 else
 $(error architecture '$(ARCH)' not supported)
 endif
@@ -139,6 +152,11 @@ $(BUILD)/%.o: %.S $(CONFIG_H) Makefile
 	$(ECHO) "AS $<"
 	$(Q)$(CROSS)gcc $(CFLAGS) -o $@ -c $<
 
+# Extract .o from libgcc
+$(BUILD)/libgcc/%.o:
+	$(ECHO) "AR $@"
+	$(Q)cd $(dir $@) && $(CROSS)ar x $(LIBGCC_FILE_NAME) $(notdir $@)
+
 # Build .mpy from .py source files
 $(BUILD)/%.mpy: %.py
 	$(ECHO) "MPY $<"
@@ -90,6 +90,14 @@ typedef enum {
 #define MP_EMIT_YIELD_VALUE (0)
 #define MP_EMIT_YIELD_FROM (1)
 
+// Kind for emit->counted_loop()
+#define MP_EMIT_COUNTED_LOOP_START (0)
+#define MP_EMIT_COUNTED_LOOP_END (1)
+
+// Kind for emit->buf_check()
+#define MP_EMIT_BUF_CHECK_RANGE (0)
+#define MP_EMIT_BUF_CHECK_NONE (1)
+
 typedef struct _emit_t emit_t;
 
 typedef struct _mp_emit_common_t {
@@ -168,6 +176,12 @@ typedef struct _emit_method_table_t {
     // they may or may not emit code
     void (*start_except_handler)(emit_t *emit);
     void (*end_except_handler)(emit_t *emit);
+
+    // optional, counts down a loop in a local, see compile_for_stmt_counted
+    void (*counted_loop)(emit_t *emit, mp_uint_t local_num, mp_uint_t label, int kind);
+
+    // optional, bounds checks of a checked viper buffer, see compile_for_stmt_buf_hoist
+    void (*buf_check)(emit_t *emit, mp_uint_t local_num, mp_uint_t label, int kind);
 } emit_method_table_t;
 
 #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
@@ -296,6 +310,9 @@ typedef struct _emit_inline_asm_method_table_t {
     mp_uint_t (*count_params)(emit_inline_asm_t *emit, mp_uint_t n_params, mp_parse_node_t *pn_params);
     bool (*label)(emit_inline_asm_t *emit, mp_uint_t label_num, qstr label_id);
     void (*op)(emit_inline_asm_t *emit, qstr op, mp_uint_t n_args, mp_parse_node_t *pn_args);
+    // Optional; if given it is called after start_pass in every pass with the
+    // arguments to the decorator (n_args may be 0), otherwise they are an error.
+    void (*options)(emit_inline_asm_t *emit, mp_uint_t n_args, mp_parse_node_t *pn_args);
 } emit_inline_asm_method_table_t;
 
 extern const emit_inline_asm_method_table_t emit_inline_thumb_method_table;
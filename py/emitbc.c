@@ -880,6 +880,9 @@ const emit_method_table_t emit_bc_method_table = {
 
     mp_emit_bc_start_except_handler,
     mp_emit_bc_end_except_handler,
+
+    NULL,
+    NULL,
 };
 #else
 const mp_emit_method_table_id_ops_t mp_emit_bc_method_table_load_id_ops = {
@@ -57,8 +57,19 @@ struct _emit_inline_asm_t {
     mp_obj_t *error_slot;
     mp_uint_t max_num_labels;
     qstr *label_lookup;
+    uint16_t used_regs;     // registers named by the operands in this pass
+    uint16_t save_regs;     // registers saved by the prologue
+    uint8_t n_params;
+    uint8_t arg_reg;        // first data register of regs=, if given
+    uint8_t n_arg_regs;     // number of registers in regs=, 0 for the a6 frame
+    bool save_auto;         // save='auto'
 };
 
+// Callee-saved registers (bit 0 = d0 ... bit 15 = a7): d2-d7/a2-a5, and a6
+// too when there is no a6 frame
+#define SAVE_REGS_LINK  (0x3cfc)
+#define SAVE_REGS_NOLINK (0x7cfc)
+
 STATIC void emit_inline_m68k_error_msg(emit_inline_asm_t *emit, mp_rom_error_text_t msg) {
     if (*emit->error_slot == MP_OBJ_NULL) {
         *emit->error_slot = mp_obj_new_exception_msg(&mp_type_SyntaxError, msg);
@@ -94,18 +105,103 @@ STATIC void emit_inline_m68k_start_pass(emit_inline_asm_t *emit, pass_kind_t pas
         memset(emit->label_lookup, 0, emit->max_num_labels * sizeof(qstr));
     }
     mp_asm_base_start_pass(&emit->as.base, pass == MP_PASS_EMIT ? MP_ASM_PASS_EMIT : MP_ASM_PASS_COMPUTE);
-    asm_m68k_entry(&emit->as, 0);
+    emit->used_regs = 0;
+}
+
+// Data registers the prologue loads the arguments into
+STATIC uint emit_inline_m68k_arg_regs(emit_inline_asm_t *emit) {
+    uint n = MIN(emit->n_params, emit->n_arg_regs);
+    return ((1 << n) - 1) << emit->arg_reg;
 }
 
 STATIC void emit_inline_m68k_end_pass(emit_inline_asm_t *emit, mp_uint_t type_sig) {
-    asm_m68k_exit(&emit->as);
+    bool link = emit->n_arg_regs == 0;
+    asm_m68k_exit_inline(&emit->as, emit->save_regs, link);
     asm_m68k_end_pass(&emit->as);
+
+    // With save='auto' the prologue of the next pass saves the callee-saved
+    // registers this one has found in the body, and those loaded with arguments
+    if (emit->save_auto) {
+        emit->save_regs = (emit->used_regs | emit_inline_m68k_arg_regs(emit))
+            & (link ? SAVE_REGS_LINK : SAVE_REGS_NOLINK);
+    }
 }
 
 STATIC mp_uint_t emit_inline_m68k_count_params(emit_inline_asm_t *emit, mp_uint_t n_params, mp_parse_node_t *pn_params) {
+    if (emit->n_arg_regs != 0 && n_params > emit->n_arg_regs) {
+        emit_inline_m68k_error_msg(emit, MP_ERROR_TEXT("too many arguments for regs"));
+    }
+    emit->n_params = n_params;
     return n_params;
 }
 
+// Parse the value of regs=, 'dN' or 'dN-dM' with up to 4 registers
+STATIC bool emit_inline_m68k_parse_regs(emit_inline_asm_t *emit, const char *str) {
+    if (str[0] != 'd' || str[1] < '0' || str[1] > '7') {
+        return false;
+    }
+    uint first = str[1] - '0';
+    uint last = first;
+    if (str[2] == '-') {
+        if (str[3] != 'd' || str[4] < '0' || str[4] > '7' || str[5] != '\0') {
+            return false;
+        }
+        last = str[4] - '0';
+    } else if (str[2] != '\0') {
+        return false;
+    }
+    if (last < first || last - first >= 4) {
+        return false;
+    }
+    emit->arg_reg = first;
+    emit->n_arg_regs = last - first + 1;
+    return true;
+}
+
+// Decorator options, followed by the prologue of the function:
+//   regs='d0-d3' passes the arguments in these data registers, without an a6 frame
+//   save='auto' saves only the callee-saved registers the body uses ('all' by default)
+STATIC void emit_inline_m68k_options(emit_inline_asm_t *emit, mp_uint_t n_args, mp_parse_node_t *pn_args) {
+    emit->n_arg_regs = 0;
+    emit->save_auto = false;
+    for (mp_uint_t i = 0; i < n_args; i++) {
+        if (!MP_PARSE_NODE_IS_STRUCT_KIND(pn_args[i], PN_argument)) {
+            emit_inline_m68k_error_msg(emit, MP_ERROR_TEXT("asm_m68k options must be keyword arguments"));
+            break;
+        }
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn_args[i];
+        if (!MP_PARSE_NODE_IS_ID(pns->nodes[0]) || !MP_PARSE_NODE_IS_LEAF(pns->nodes[1])) {
+            emit_inline_m68k_error_msg(emit, MP_ERROR_TEXT("asm_m68k options must be keyword arguments"));
+            break;
+        }
+        qstr name = MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]);
+        const char *value = "";
+        if (MP_PARSE_NODE_LEAF_KIND(pns->nodes[1]) == MP_PARSE_NODE_STRING) {
+            value = qstr_str(MP_PARSE_NODE_LEAF_ARG(pns->nodes[1]));
+        }
+        bool ok;
+        if (strcmp(qstr_str(name), "regs") == 0) {
+            ok = emit_inline_m68k_parse_regs(emit, value);
+        } else if (strcmp(qstr_str(name), "save") == 0) {
+            emit->save_auto = strcmp(value, "auto") == 0;
+            ok = emit->save_auto || strcmp(value, "all") == 0;
+        } else {
+            emit_inline_m68k_error_exc(emit, mp_obj_new_exception_msg_varg(&mp_type_SyntaxError, MP_ERROR_TEXT("unknown asm_m68k option '%q'"), name));
+            break;
+        }
+        if (!ok) {
+            emit_inline_m68k_error_exc(emit, mp_obj_new_exception_msg_varg(&mp_type_SyntaxError, MP_ERROR_TEXT("bad value for asm_m68k option '%q'"), name));
+            break;
+        }
+    }
+
+    bool link = emit->n_arg_regs == 0;
+    if (!emit->save_auto) {
+        emit->save_regs = link ? SAVE_REGS_LINK : SAVE_REGS_NOLINK;
+    }
+    asm_m68k_entry_inline(&emit->as, emit->save_regs, link, emit_inline_m68k_arg_regs(emit));
+}
+
 STATIC bool emit_inline_m68k_label(emit_inline_asm_t *emit, mp_uint_t label_num, qstr label_id) {
     assert(label_num < emit->max_num_labels);
     if (emit->pass == MP_PASS_CODE_SIZE) {
@@ -259,6 +355,7 @@ typedef struct _ea_elem_t {
     uint8_t  reg;       /* Register number (Dn/An/Special regs.) */
     uint8_t  areg;      /* Address register number */
     uint8_t  size;      /* Data size */
+    uint8_t  scale;     /* Index scale (log2) */
     uint32_t value;     /* Immediate value / label number / register list */
 } ea_elem_t;
 
@@ -273,6 +370,7 @@ typedef struct _ea_elem_t {
 #define EL_LABEL        (1 << 7)    /* value is label number */
 #define EL_SPREG        (1 << 8)    /* special register (CCR/SR/USP) */
 #define EL_REGLIST      (1 << 9)    /* value is register list */
+#define EL_SCALE        (1 << 10)   /* scale is used : Rn.size*scale */
 
 int get_reglist(emit_inline_asm_t *emit, mp_parse_node_t pn, ea_elem_t *ea) {
     int i;
@@ -420,6 +518,16 @@ int get_ea_elem(emit_inline_asm_t *emit, mp_parse_node_t pn, ea_elem_t *ea) {
                     }
                 }
             }
+        } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_term) && n == 3 &&      /* Rn.size*scale */
+                   MP_PARSE_NODE_IS_TOKEN_KIND(pns->nodes[1], MP_TOKEN_OP_STAR) &&
+                   MP_PARSE_NODE_IS_SMALL_INT(pns->nodes[2])) {
+            mp_int_t scale = MP_PARSE_NODE_LEAF_SMALL_INT(pns->nodes[2]);
+            if ((ea->flag & EL_SCALE) || !(scale == 1 || scale == 2 || scale == 4 || scale == 8)) {
+                return -1;
+            }
+            ea->flag |= EL_SCALE;
+            ea->scale = (scale >= 4 ? 2 : 0) + (scale == 2 || scale == 8);
+            return get_ea_elem(emit, pns->nodes[0], ea);
         } else {
             if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_atom_bracket) ||    /* [ ... ] */
                 MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_trailer_bracket)) {
@@ -491,6 +599,22 @@ int get_operand(emit_inline_asm_t *emit, mp_parse_node_t pn, operand_t *o, uint1
     if (get_ea_elem(emit, pn, &eas) < 0) {
         return -1;
     }
+    /* Record the registers used, for save='auto' */
+    if (eas.flag & EL_REG && eas.reg < 16) {
+        emit->used_regs |= 1 << eas.reg;
+    }
+    if (eas.flag & EL_AREG && eas.areg < 8) {
+        emit->used_regs |= 1 << (8 + eas.areg);
+    }
+    if (eas.flag & EL_REGLIST) {
+        emit->used_regs |= eas.value;
+    }
+    if (eas.flag & EL_SCALE) {              /* scaled index : (d8,An,Rn.size*scale) */
+        if (eas.scale != 0 && !emit->as.cpu020) {
+            emit_inline_m68k_error_msg(emit, MP_ERROR_TEXT("scaled index needs 68020 or later"));
+        }
+        eas.flag &= ~EL_SCALE;
+    }
 
     /* Get addressing mode from elements */
     switch (eas.flag) {
@@ -569,7 +693,7 @@ int get_operand(emit_inline_asm_t *emit, mp_parse_node_t pn, operand_t *o, uint1
             o->ea = (0x7 << 3) | 0x3;
         }
         check_sbyte_range(emit, eas.value);
-        o->data = (eas.value & 0xff) | (eas.size << 11) | (eas.reg << 12);
+        o->data = (eas.value & 0xff) | (eas.scale << 9) | (eas.size << 11) | (eas.reg << 12);
         res = OR_WORD;
         break;
     case EL_AREG|EL_REG|EL_INDIRECT|EL_LABEL|EL_SIZE:
@@ -580,7 +704,7 @@ int get_operand(emit_inline_asm_t *emit, mp_parse_node_t pn, operand_t *o, uint1
             rel = dest - emit->as.base.code_offset;
             o->data = rel - 2;
             check_sbyte_range(emit, o->data);
-            o->data = (o->data & 0xff) | (eas.size << 11) | (eas.reg << 12);
+            o->data = (o->data & 0xff) | (eas.scale << 9) | (eas.size << 11) | (eas.reg << 12);
             res = OR_WORD;
         }
         break;
@@ -625,6 +749,9 @@ int get_operand(emit_inline_asm_t *emit, mp_parse_node_t pn, operand_t *o, uint1
     if (!(o->type & mask)) {
         return -1;          /* Unavailable addressing mode */
     }
+    if (eas.scale != 0 && !(o->type & (OT_AIIDX|OT_PIIDX))) {
+        return -1;          /* Scale without index */
+    }
 
     return res;
 }
@@ -637,6 +764,8 @@ int get_operand(emit_inline_asm_t *emit, mp_parse_node_t pn, operand_t *o, uint1
 #define L       (1 << 2)
 #define S       (1 << 3)
 #define CC      (1 << 4)    /* with condition */
+#define L20     (1 << 5)    /* long word size on 68020 or later (not the default) */
+#define X20     (1 << 6)    /* 68020 or later */
 
 enum m68k_instr_type {
     IN_MOVE,
@@ -667,6 +796,7 @@ enum m68k_instr_type {
     IN_TRAP,
     IN_STOP,
     IN_NOOPR,
+    IN_BITFLD,
 };
 
 typedef struct _m68k_instr_table_t {
@@ -708,9 +838,9 @@ m68k_instr_table_t inst_table[] = {
     { "jsr",      0,      0x4e80,   IN_EA,      OT_EACTL,       0 },
     { "jmp",      0,      0x4ec0,   IN_EA,      OT_EACTL,       0 },
 
-    { "bra",      W|S,    0x6000,   IN_BRA,     OT_LABEL,       0 },
-    { "bsr",      W|S,    0x6100,   IN_BRA,     OT_LABEL,       0 },
-    { "b",        CC|W|S, 0x6000,   IN_BRA,     OT_LABEL,       0 },
+    { "bra",      W|S|L20, 0x6000,  IN_BRA,     OT_LABEL,       0 },
+    { "bsr",      W|S|L20, 0x6100,  IN_BRA,     OT_LABEL,       0 },
+    { "b",        CC|W|S|L20, 0x6000, IN_BRA,   OT_LABEL,       0 },
     { "dbra",     W|S,    0x51c8,   IN_DBRA,    OT_DREG,        OT_LABEL },
     { "db",       CC|W|S, 0x50c8,   IN_DBRA,    OT_DREG,        OT_LABEL },
     { "s",        CC|B,   0x50c0,   IN_SCC,     OT_EADALT,      0 },
@@ -735,11 +865,11 @@ m68k_instr_table_t inst_table[] = {
     { "bset",     L|B,    0x00c0,   IN_BCHG,    OT_DREG|OT_IMM, OT_EADALT },
     { "btst",     L|B,    0x0000,   IN_BCHG,    OT_DREG|OT_IMM, OT_EADAT2 },
 
-    { "mulu",     W,      0xc0c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
-    { "muls",     W,      0xc1c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
-    { "divu",     W,      0x80c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
-    { "divs",     W,      0x81c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
-    { "chk",      W,      0x4180,   IN_MULDIV,  OT_EADATA,      OT_DREG },
+    { "mulu",     W|L20,  0xc0c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
+    { "muls",     W|L20,  0xc1c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
+    { "divu",     W|L20,  0x80c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
+    { "divs",     W|L20,  0x81c0,   IN_MULDIV,  OT_EADATA,      OT_DREG },
+    { "chk",      W|L20,  0x4180,   IN_MULDIV,  OT_EADATA,      OT_DREG },
 
     { "subx",     L|W|B,  0x9100,   IN_ADDX,    OT_DREG|OT_AIDEC, OT_DREG|OT_AIDEC },
     { "addx",     L|W|B,  0xd100,   IN_ADDX,    OT_DREG|OT_AIDEC, OT_DREG|OT_AIDEC },
@@ -750,9 +880,10 @@ m68k_instr_table_t inst_table[] = {
 
     { "swap",     W,      0x4840,   IN_REG,     OT_DREG,        0 },
     { "unlk",     0,      0x4e58,   IN_REG,     OT_AREG,        0 },
-    { "link",     W,      0x4e50,   IN_LINK,    OT_AREG,        OT_IMM },
+    { "link",     W|L20,  0x4e50,   IN_LINK,    OT_AREG,        OT_IMM },
     { "exg",      L,      0xc100,   IN_EXG,     OT_DREG|OT_AREG, OT_DREG|OT_AREG },
     { "ext",      L|W,    0x4800,   IN_EXT,     OT_DREG,        0 },
+    { "extb",     L|X20,  0x49c0,   IN_REG,     OT_DREG,        0 },
     { "cmpm",     L|W|B,  0xb108,   IN_CMPM,    OT_AIINC,       OT_AIINC },
     { "movem",    L|W,    0x4880,   IN_MOVEM,   OT_EACTL|OT_AIINC|OT_REGLIST, OT_EACALT|OT_AIDEC|OT_REGLIST },
     { "movep",    W,      0x0108,   IN_MOVEP,   OT_DREG|OT_AIDSP, OT_DREG|OT_AIDSP },
@@ -767,6 +898,15 @@ m68k_instr_table_t inst_table[] = {
     { "rts",      0,      0x4e75,   IN_NOOPR,   0,              0 },
     { "trapv",    0,      0x4e76,   IN_NOOPR,   0,              0 },
     { "rtr",      0,      0x4e77,   IN_NOOPR,   0,              0 },
+
+    { "bftst",    X20,    0xe8c0,   IN_BITFLD,  OT_DREG|OT_EACTL,  OT_DREG|OT_IMM },
+    { "bfextu",   X20,    0xe9c0,   IN_BITFLD,  OT_DREG|OT_EACTL,  OT_DREG|OT_IMM },
+    { "bfchg",    X20,    0xeac0,   IN_BITFLD,  OT_DREG|OT_EACALT, OT_DREG|OT_IMM },
+    { "bfexts",   X20,    0xebc0,   IN_BITFLD,  OT_DREG|OT_EACTL,  OT_DREG|OT_IMM },
+    { "bfclr",    X20,    0xecc0,   IN_BITFLD,  OT_DREG|OT_EACALT, OT_DREG|OT_IMM },
+    { "bfffo",    X20,    0xedc0,   IN_BITFLD,  OT_DREG|OT_EACTL,  OT_DREG|OT_IMM },
+    { "bfset",    X20,    0xeec0,   IN_BITFLD,  OT_DREG|OT_EACALT, OT_DREG|OT_IMM },
+    { "bfins",    X20,    0xefc0,   IN_BITFLD,  OT_DREG,           OT_DREG|OT_EACALT },
 };
 
 STATIC int emit_inline_m68k_data(emit_inline_asm_t *emit, int size, int opr, uint32_t data) {
@@ -812,7 +952,7 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
                 }
                 size = s - sz;
                 defsize = size;
-                if (!((1 << size) & inst->size)) {
+                if (!((1 << size) & inst->size) && !(size == 2 && (inst->size & L20))) {
                     continue;
                 }
             } else {                        /* default size */
@@ -824,6 +964,12 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
     if (i == MP_ARRAY_SIZE(inst_table)) {
         goto unknown_op;
     }
+    if (((inst->size & X20) || (size == 2 && !(inst->size & L))) && !emit->as.cpu020) {
+        goto need_020;
+    }
+    if (n_args > 2 && inst->type != IN_BITFLD && !(inst->type == IN_MULDIV && size == 2)) {
+        goto unknown_op;
+    }
 
     int r1 = -1, r2 = -1;
     operand_t o1, o2;
@@ -925,6 +1071,7 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
             asm_m68k_op16(&emit->as,
                           inst->instr | (o2.reg << 9) | (size << 6) | o1.ea);
             emit_inline_m68k_data(emit, size, r1, o1.data);
+            return;
         } else if (o1.type != OT_DREG) {
             goto bad_operand;
         }
@@ -975,7 +1122,10 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
         if (cc == 1) {
             goto unknown_op;    /* bf is not allowed */
         }
-        if (size == 1) {    /* bra.w */
+        if (size == 2) {    /* bra.l */
+            asm_m68k_op16(&emit->as, inst->instr | (cc << 8) | 0xff);
+            asm_m68k_op32(&emit->as, rel);
+        } else if (size == 1) {    /* bra.w */
             check_sword_range(emit, rel);
             asm_m68k_op16(&emit->as, inst->instr | (cc << 8));
             asm_m68k_op16(&emit->as, rel);
@@ -1051,6 +1201,27 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
         return;
 
     case IN_MULDIV:         /* OP <ea>,Dn */
+        if (size == 2) {
+            if (inst->instr == 0x4180) {        /* chk.l <ea>,Dn */
+                asm_m68k_op16(&emit->as, 0x4100 | (o2.reg << 9) | o1.ea);
+            } else {                            /* muls.l <ea>,Dl / divs.l <ea>,Dq / divs.l <ea>,Dr,Dq */
+                /* Only the 32-bit product and dividend forms, which the 68060 implements */
+                bool is_mul = inst->instr & 0x4000;
+                uint dr = is_mul ? 0 : o2.reg;
+                uint dq = o2.reg;
+                if (n_args > 2) {               /* divsl.l <ea>,Dr:Dq */
+                    operand_t o3;
+                    if (is_mul || get_operand(emit, pn_args[2], &o3, OT_DREG) < 0) {
+                        goto bad_operand;
+                    }
+                    dq = o3.reg;
+                }
+                asm_m68k_op16(&emit->as, (is_mul ? 0x4c00 : 0x4c40) | o1.ea);
+                asm_m68k_op16(&emit->as, (dq << 12) | ((inst->instr & 0x0100) << 3) | dr);
+            }
+            emit_inline_m68k_data(emit, size, r1, o1.data);
+            return;
+        }
         asm_m68k_op16(&emit->as,
                       inst->instr | (o2.reg << 9) | (size << 7) | o1.ea);
         emit_inline_m68k_data(emit, size, r1, o1.data);
@@ -1070,7 +1241,7 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
         return;
 
     case IN_LINK:           /* link An,#imm */
-        asm_m68k_op16(&emit->as, inst->instr | o1.reg);
+        asm_m68k_op16(&emit->as, (size == 2 ? 0x4808 : inst->instr) | o1.reg);
         emit_inline_m68k_data(emit, size, r2, o2.data);
         return;
 
@@ -1158,6 +1329,45 @@ STATIC void emit_inline_m68k_op(emit_inline_asm_t *emit, qstr op, mp_uint_t n_ar
         asm_m68k_op16(&emit->as, inst->instr);
         return;
 
+    case IN_BITFLD: {       /* OP <ea>,offset,width[,Dn] / bfins Dn,<ea>,offset,width */
+        bool is_ins = inst->instr == 0xefc0;
+        bool has_reg = inst->instr & 0x0100;
+        operand_t *oea = is_ins ? &o2 : &o1;
+        int rea = is_ins ? r2 : r1;
+        int a = is_ins ? 2 : 1;
+        operand_t ooff, owid, oreg;
+        if (n_args != (has_reg ? 4u : 3u)
+            || get_operand(emit, pn_args[a], &ooff, OT_DREG|OT_IMM) < 0
+            || get_operand(emit, pn_args[a + 1], &owid, OT_DREG|OT_IMM) < 0) {
+            goto bad_operand;
+        }
+        uint ext = 0;
+        if (is_ins) {
+            ext = o1.reg << 12;
+        } else if (has_reg) {
+            if (get_operand(emit, pn_args[3], &oreg, OT_DREG) < 0) {
+                goto bad_operand;
+            }
+            ext = oreg.reg << 12;
+        }
+        if (ooff.type == OT_DREG) {
+            ext |= 0x0800 | (ooff.reg << 6);
+        } else {
+            check_value_range(emit, ooff.data, 0, 31);
+            ext |= (ooff.data & 31) << 6;
+        }
+        if (owid.type == OT_DREG) {
+            ext |= 0x0020 | owid.reg;
+        } else {
+            check_value_range(emit, owid.data, 1, 32);
+            ext |= owid.data & 31;
+        }
+        asm_m68k_op16(&emit->as, inst->instr | oea->ea);
+        asm_m68k_op16(&emit->as, ext);
+        emit_inline_m68k_data(emit, size, rea, oea->data);
+        return;
+    }
+
     default:
         goto unknown_op;
     }
@@ -1171,6 +1381,10 @@ unknown_op:
 bad_operand:
     emit_inline_m68k_error_exc(emit, mp_obj_new_exception_msg_varg(&mp_type_SyntaxError, MP_ERROR_TEXT("bad M68K instruction '%s' operand"), op_str));
     return;
+
+need_020:
+    emit_inline_m68k_error_exc(emit, mp_obj_new_exception_msg_varg(&mp_type_SyntaxError, MP_ERROR_TEXT("M68K instruction '%s' needs 68020 or later"), op_str));
+    return;
 }
 
 const emit_inline_asm_method_table_t emit_inline_m68k_method_table = {
@@ -1184,6 +1398,7 @@ const emit_inline_asm_method_table_t emit_inline_m68k_method_table = {
     emit_inline_m68k_count_params,
     emit_inline_m68k_label,
     emit_inline_m68k_op,
+    emit_inline_m68k_options,
 };
 
 #endif // MICROPY_EMIT_INLINE_M68K
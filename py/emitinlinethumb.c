@@ -860,6 +860,7 @@ const emit_inline_asm_method_table_t emit_inline_thumb_method_table = {
     emit_inline_thumb_count_params,
     emit_inline_thumb_label,
     emit_inline_thumb_op,
+    NULL,
 };
 
 #endif // MICROPY_EMIT_INLINE_THUMB
@@ -347,6 +347,7 @@ const emit_inline_asm_method_table_t emit_inline_xtensa_method_table = {
     emit_inline_xtensa_count_params,
     emit_inline_xtensa_label,
     emit_inline_xtensa_op,
+    NULL,
 };
 
 #endif // MICROPY_EMIT_INLINE_XTENSA
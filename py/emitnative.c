@@ -174,6 +174,40 @@ STATIC const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, RE
 
 #define REG_LOCAL_LAST (reg_local_table[MAX_REGS_FOR_LOCAL_VARS - 1])
 
+#if N_M68K
+
+// m68k has more callee-saved registers than the 3 above, so locals are not pinned
+// to REG_LOCAL_1..3 by their number.  Instead accesses to locals (and loops) are
+// recorded during MP_PASS_STACK_SIZE and at the end of that pass each local gets
+// a live range and a weight; the heaviest locals are then given registers from
+// the table below, with locals whose live ranges don't overlap sharing a register.
+// See emit_native_alloc_local_regs.
+
+STATIC const uint8_t reg_local_alloc_table[] = {
+    REG_LOCAL_1, REG_LOCAL_2,
+    #if !MICROPY_PERSISTENT_CODE_SAVE
+    REG_LOCAL_3,
+    #endif
+    REG_LOCAL_4, REG_LOCAL_5, REG_LOCAL_6, REG_LOCAL_7,
+};
+
+#define LOCAL_REG_NONE (0xff)
+#define LOCAL_REG_LIVE_AT_ENTRY (0x80) // local must be loaded into its register at entry
+#define LOCAL_REG_MASK (0x7f)
+
+typedef struct _local_access_t {
+    mp_uint_t pos;
+    uint16_t local_num;
+    bool is_store;
+} local_access_t;
+
+typedef struct _local_loop_t {
+    mp_uint_t start;
+    mp_uint_t end;
+} local_loop_t;
+
+#endif
+
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
 } while (0)
@@ -195,6 +229,14 @@ typedef enum {
     VTYPE_PTR8 = 0x00 | MP_NATIVE_TYPE_PTR8,
     VTYPE_PTR16 = 0x00 | MP_NATIVE_TYPE_PTR16,
     VTYPE_PTR32 = 0x00 | MP_NATIVE_TYPE_PTR32,
+    #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+    VTYPE_FLOAT = 0x00 | MP_NATIVE_TYPE_FLOAT,
+    #endif
+    #if N_M68K
+    VTYPE_BUF8 = 0x00 | MP_NATIVE_TYPE_BUF8,
+    VTYPE_BUF16 = 0x00 | MP_NATIVE_TYPE_BUF16,
+    VTYPE_BUF32 = 0x00 | MP_NATIVE_TYPE_BUF32,
+    #endif
 
     VTYPE_PTR_NONE = 0x50 | MP_NATIVE_TYPE_PTR,
 
@@ -220,6 +262,17 @@ STATIC qstr vtype_to_qstr(vtype_kind_t vtype) {
             return MP_QSTR_ptr16;
         case VTYPE_PTR32:
             return MP_QSTR_ptr32;
+        #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+        case VTYPE_FLOAT:
+            return MP_QSTR_float;
+        #endif
+        #if N_M68K
+        case VTYPE_BUF8:
+            return MP_QSTR_bytearray;
+        case VTYPE_BUF16:
+        case VTYPE_BUF32:
+            return MP_QSTR_array;
+        #endif
         case VTYPE_PTR_NONE:
         default:
             return MP_QSTR_None;
@@ -229,12 +282,33 @@ STATIC qstr vtype_to_qstr(vtype_kind_t vtype) {
 typedef struct _stack_info_t {
     vtype_kind_t vtype;
     stack_info_kind_t kind;
+    #if N_M68K
+    uint8_t narrow; // STACK_NARROW_xxx flags for the value range of a native int
+    #if MICROPY_NATIVE_DIRECT_CALL
+    scope_t *callee; // viper function that a loaded global may be, for a direct call
+    #endif
+    uint16_t buf_len; // for a checked buffer, 1 + the local holding its length; else 0
+    #endif
     union {
         int u_reg;
         mp_int_t u_imm;
     } data;
 } stack_info_t;
 
+#if N_M68K
+// Known value ranges of a native int on the stack, used to pick a multiply sequence
+#define STACK_NARROW_U16 (0x01) // value fits in 16 bits unsigned
+#define STACK_NARROW_S16 (0x02) // value fits in 16 bits signed
+
+#define VTYPE_IS_BUF(vtype) ((vtype) >= VTYPE_BUF8 && (vtype) <= VTYPE_BUF32)
+
+#if MICROPY_DYNAMIC_COMPILER
+#define N_M68K_FPU (mp_dynamic_compiler.native_arch == MP_NATIVE_ARCH_M68K020FPU)
+#else
+#define N_M68K_FPU (MICROPY_EMIT_M68K_FPU)
+#endif
+#endif
+
 #define UNWIND_LABEL_UNUSED (0x7fff)
 #define UNWIND_LABEL_DO_FINAL_UNWIND (0x7ffe)
 
@@ -278,6 +352,24 @@ struct _emit_t {
 
     scope_t *scope;
 
+    #if N_M68K
+    uint8_t *local_reg;
+    size_t local_access_alloc;
+    size_t local_access_len;
+    local_access_t *local_access;
+    size_t local_loop_alloc;
+    size_t local_loop_len;
+    local_loop_t *local_loop;
+    bool fpu; // use 68881/68882 instructions for viper floats
+    #if MICROPY_NATIVE_DIRECT_CALL
+    bool direct_calls; // the function makes direct calls, found in MP_PASS_STACK_SIZE
+    #endif
+    uint16_t n_buf; // number of checked buffer arguments
+    bool buf_unchecked; // the next subscript of a checked buffer is known to be in range
+    bool index_error_used; // some bounds check jumps to index_error_label
+    uint index_error_label;
+    #endif
+
     ASM_T *as;
 };
 
@@ -296,13 +388,24 @@ emit_t *EXPORT_FUN(new)(mp_emit_common_t * emit_common, mp_obj_t *error_slot, ui
     emit->exc_stack_alloc = 8;
     emit->exc_stack = m_new(exc_stack_entry_t, emit->exc_stack_alloc);
     emit->as = m_new0(ASM_T, 1);
+    #if N_M68K
+    emit->as->base.endian = true; // big endian, for the words of a generator's header
+    #endif
     mp_asm_base_init(&emit->as->base, max_num_labels);
     return emit;
 }
 
 void EXPORT_FUN(free)(emit_t * emit) {
     mp_asm_base_deinit(&emit->as->base, false);
+    #if N_M68K
+    m_del(asm_m68k_branch_t, emit->as->branch, emit->as->branch_alloc);
+    #endif
     m_del_obj(ASM_T, emit->as);
+    #if N_M68K
+    m_del(local_loop_t, emit->local_loop, emit->local_loop_alloc);
+    m_del(local_access_t, emit->local_access, emit->local_access_alloc);
+    m_del(uint8_t, emit->local_reg, emit->local_vtype_alloc);
+    #endif
     m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
@@ -362,6 +465,264 @@ STATIC void emit_native_mov_reg_qstr_obj(emit_t *emit, int reg_dest, qstr qst) {
         emit_native_mov_state_reg((emit), (local_num), (reg_temp)); \
     } while (false)
 
+#if N_M68K
+
+// Returns the register holding the given local, or -1 if it lives on the stack
+STATIC int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    uint8_t r = emit->local_reg[local_num];
+    return r == LOCAL_REG_NONE ? -1 : (r & LOCAL_REG_MASK);
+}
+
+// The hidden local holding the length of the checked buffer argument local_num.
+// These come after all other locals, in the order of the arguments.
+STATIC mp_uint_t emit_native_buf_len_local(emit_t *emit, mp_uint_t local_num) {
+    mp_uint_t len_local = emit->scope->num_locals - emit->n_buf;
+    for (mp_uint_t i = 0; i < local_num; ++i) {
+        if (VTYPE_IS_BUF(emit->local_vtype[i])) {
+            ++len_local;
+        }
+    }
+    return len_local;
+}
+
+STATIC void emit_native_record_local_access(emit_t *emit, mp_uint_t local_num, bool is_store) {
+    if (emit->pass != MP_PASS_STACK_SIZE || !CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+    if (emit->local_access_len >= emit->local_access_alloc) {
+        size_t new_alloc = emit->local_access_alloc + 32;
+        emit->local_access = m_renew(local_access_t, emit->local_access, emit->local_access_alloc, new_alloc);
+        emit->local_access_alloc = new_alloc;
+    }
+    local_access_t *a = &emit->local_access[emit->local_access_len++];
+    a->pos = mp_asm_base_get_code_pos(&emit->as->base);
+    a->local_num = local_num;
+    a->is_store = is_store;
+}
+
+// A jump to a label that has already been assigned closes a loop
+STATIC void emit_native_record_jump(emit_t *emit, mp_uint_t label) {
+    if (emit->pass != MP_PASS_STACK_SIZE || !CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+    mp_uint_t dest = emit->as->base.label_offsets[label];
+    if (dest == (mp_uint_t)-1) {
+        return;
+    }
+    if (emit->local_loop_len >= emit->local_loop_alloc) {
+        size_t new_alloc = emit->local_loop_alloc + 8;
+        emit->local_loop = m_renew(local_loop_t, emit->local_loop, emit->local_loop_alloc, new_alloc);
+        emit->local_loop_alloc = new_alloc;
+    }
+    local_loop_t *l = &emit->local_loop[emit->local_loop_len++];
+    l->start = dest;
+    l->end = mp_asm_base_get_code_pos(&emit->as->base);
+}
+
+typedef struct _local_range_t {
+    mp_uint_t start;
+    mp_uint_t end;
+    mp_uint_t weight;
+} local_range_t;
+
+// Assign registers to locals using the accesses recorded in MP_PASS_STACK_SIZE.
+//
+// A local is live from its first store (or from entry, for arguments and locals
+// that may be read before being written) to its last access; a live range that
+// touches a loop is extended to cover the whole loop because the value may be
+// carried round the back edge.  Each access is weighted by its loop depth, and
+// the heaviest locals are assigned first.  Pointers prefer the address registers
+// and everything else prefers the data registers.
+STATIC void emit_native_alloc_local_regs(emit_t *emit) {
+    scope_t *scope = emit->scope;
+    size_t n = scope->num_locals;
+    if (n == 0 || !CAN_USE_REGS_FOR_LOCALS(emit)) {
+        return;
+    }
+
+    mp_uint_t num_args = scope->num_pos_args + scope->num_kwonly_args;
+    if (scope->scope_flags & MP_SCOPE_FLAG_VARARGS) {
+        num_args += 1;
+    }
+    if (scope->scope_flags & MP_SCOPE_FLAG_VARKEYWORDS) {
+        num_args += 1;
+    }
+
+    local_range_t *range = m_new(local_range_t, n);
+    for (size_t i = 0; i < n; ++i) {
+        range[i].start = (mp_uint_t)-1;
+        range[i].end = 0;
+        range[i].weight = 0;
+    }
+
+    for (size_t i = 0; i < emit->local_access_len; ++i) {
+        local_access_t *a = &emit->local_access[i];
+        local_range_t *r = &range[a->local_num];
+        if (r->start == (mp_uint_t)-1) {
+            r->start = (a->is_store && a->local_num >= num_args) ? a->pos : 0;
+        }
+        r->end = a->pos;
+        size_t depth = 0;
+        for (size_t j = 0; j < emit->local_loop_len; ++j) {
+            if (emit->local_loop[j].start <= a->pos && a->pos <= emit->local_loop[j].end) {
+                ++depth;
+            }
+        }
+        r->weight += 1 << (3 * MIN(depth, 4));
+    }
+
+    // Extend live ranges over the loops they touch, until nothing changes
+    bool changed;
+    do {
+        changed = false;
+        for (size_t i = 0; i < n; ++i) {
+            local_range_t *r = &range[i];
+            if (r->weight == 0) {
+                continue;
+            }
+            for (size_t j = 0; j < emit->local_loop_len; ++j) {
+                local_loop_t *l = &emit->local_loop[j];
+                if (r->start <= l->end && r->end >= l->start) {
+                    if (r->start > l->start) {
+                        r->start = l->start;
+                        changed = true;
+                    }
+                    if (r->end < l->end) {
+                        r->end = l->end;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    } while (changed);
+
+    for (;;) {
+        // Pick the heaviest local that hasn't been considered yet
+        size_t best = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (range[i].weight > 0 && (best == n || range[i].weight > range[best].weight)) {
+                best = i;
+            }
+        }
+        if (best == n) {
+            break;
+        }
+        local_range_t *r = &range[best];
+        r->weight = 0;
+
+        vtype_kind_t vtype = emit->local_vtype[best];
+        bool want_areg = vtype == VTYPE_PTR || vtype == VTYPE_PTR8 || vtype == VTYPE_PTR16
+            || vtype == VTYPE_PTR32 || vtype == VTYPE_PTR_NONE || VTYPE_IS_BUF(vtype);
+        for (int pref = 0; pref < 2 && emit->local_reg[best] == LOCAL_REG_NONE; ++pref) {
+            for (size_t k = 0; k < MP_ARRAY_SIZE(reg_local_alloc_table); ++k) {
+                uint8_t reg = reg_local_alloc_table[k];
+                if ((ASM_M68K_IS_AREG(reg) == want_areg) == (pref != 0)) {
+                    continue;
+                }
+                bool avail = true;
+                for (size_t j = 0; j < n; ++j) {
+                    if (emit_native_local_reg(emit, j) == reg
+                        && range[j].start <= r->end && range[j].end >= r->start) {
+                        avail = false;
+                        break;
+                    }
+                }
+                if (avail) {
+                    emit->local_reg[best] = reg | (r->start == 0 ? LOCAL_REG_LIVE_AT_ENTRY : 0);
+                    break;
+                }
+            }
+        }
+    }
+
+    m_del(local_range_t, range, n);
+}
+
+#if MICROPY_NATIVE_DIRECT_CALL
+
+// Viper functions at module level with at most 4 positional arguments, all of
+// integer, pointer or object type, can be called directly by other viper
+// functions (see asm_m68k_entry_direct).  Returns the signature of such a
+// function: a tag byte, the number of arguments and then the type of each
+// argument, 4 bits each; or 0 if it can't be called directly.
+STATIC uint32_t emit_native_direct_sig(scope_t *scope) {
+    if (scope->kind != SCOPE_FUNCTION || scope->emit_options != MP_EMIT_OPT_VIPER
+        || scope->parent == NULL || scope->parent->kind != SCOPE_MODULE
+        || (scope->scope_flags & (MP_SCOPE_FLAG_GENERATOR | MP_SCOPE_FLAG_VARARGS | MP_SCOPE_FLAG_VARKEYWORDS))
+        || scope->num_kwonly_args != 0 || scope->num_pos_args > 4) {
+        return 0;
+    }
+    uint32_t sig = 0x4a000000 | scope->num_pos_args << 20;
+    for (int i = 0; i < scope->id_info_len; ++i) {
+        id_info_t *id = &scope->id_info[i];
+        if (id->kind == ID_INFO_KIND_FREE || id->kind == ID_INFO_KIND_CELL) {
+            return 0;
+        }
+        if (id->flags & ID_FLAG_IS_PARAM) {
+            vtype_kind_t vtype = id->flags >> ID_FLAG_VIPER_TYPE_POS;
+            if (vtype > VTYPE_PTR32) {
+                return 0;
+            }
+            sig |= vtype << (4 * id->local_num);
+        }
+    }
+    return sig;
+}
+
+// The module-level viper function that the global qst is defined as, if it can
+// be called directly from this function
+STATIC scope_t *emit_native_direct_callee(emit_t *emit, qstr qst) {
+    scope_t *module = emit->scope;
+    while (module->parent != NULL) {
+        module = module->parent;
+    }
+    for (scope_t *s = module->next; s != NULL; s = s->next) {
+        if (s->simple_name == qst && s != emit->scope && emit_native_direct_sig(s) != 0) {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+// Whether a value of type vtype can be passed unchanged as an argument of type param
+STATIC bool emit_native_direct_arg_ok(vtype_kind_t param, vtype_kind_t vtype) {
+    switch (param) {
+        case VTYPE_PYOBJ:
+        case VTYPE_BOOL:
+            return vtype == param;
+        default:
+            return vtype == VTYPE_BOOL || vtype == VTYPE_INT || vtype == VTYPE_UINT
+                   || vtype == VTYPE_PTR || vtype == VTYPE_PTR8 || vtype == VTYPE_PTR16 || vtype == VTYPE_PTR32;
+    }
+}
+
+// The direct entry: the function object is in a0 and the arguments in d0-d3
+// have their native types already, so they only need to be put in the locals
+STATIC void emit_native_direct_entry(emit_t *emit, size_t fun_table_off) {
+    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, ASM_M68K_REG_A0, OFFSETOF_OBJ_FUN_BC_CONTEXT);
+    #if MICROPY_PERSISTENT_CODE_SAVE
+    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_QSTR_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_QSTR_TABLE);
+    #endif
+    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_OBJ_TABLE);
+    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_FUN_TABLE, fun_table_off);
+    if (NEED_FUN_OBJ(emit)) {
+        ASM_MOV_LOCAL_REG(emit->as, LOCAL_IDX_FUN_OBJ(emit), ASM_M68K_REG_A0);
+    }
+    for (int i = 0; i < emit->scope->num_pos_args; i++) {
+        int reg_local = emit_native_local_reg(emit, i);
+        if (reg_local >= 0) {
+            ASM_MOV_REG_REG(emit->as, reg_local, ASM_M68K_REG_D0 + i);
+        } else {
+            emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), ASM_M68K_REG_D0 + i);
+        }
+    }
+    ASM_JUMP(emit->as, *emit->label_slot + 6);
+}
+
+#endif
+
+#endif
+
 STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     DEBUG_printf("start_pass(pass=%u, scope=%p)\n", pass, scope);
 
@@ -373,9 +734,26 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
+        #if N_M68K
+        emit->local_reg = m_renew(uint8_t, emit->local_reg, emit->local_vtype_alloc, scope->num_locals);
+        #endif
         emit->local_vtype_alloc = scope->num_locals;
     }
 
+    #if N_M68K
+    emit->fpu = N_M68K_FPU;
+    if (pass == MP_PASS_STACK_SIZE) {
+        #if MICROPY_NATIVE_DIRECT_CALL
+        emit->direct_calls = false;
+        #endif
+        // All locals live on the stack for this pass, which records the accesses
+        // that are used to assign registers for the following passes
+        memset(emit->local_reg, LOCAL_REG_NONE, scope->num_locals);
+        emit->local_access_len = 0;
+        emit->local_loop_len = 0;
+    }
+    #endif
+
     // set default type for arguments
     mp_uint_t num_args = emit->scope->num_pos_args + emit->scope->num_kwonly_args;
     if (scope->scope_flags & MP_SCOPE_FLAG_VARARGS) {
@@ -404,10 +782,31 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         emit->local_vtype[i] = emit->do_viper_types ? VTYPE_UNBOUND : VTYPE_PYOBJ;
     }
 
+    #if N_M68K
+    // the lengths of checked buffer arguments are set on entry
+    emit->n_buf = 0;
+    if (emit->do_viper_types) {
+        for (mp_uint_t i = 0; i < scope->num_pos_args; i++) {
+            if (VTYPE_IS_BUF(emit->local_vtype[i])) {
+                emit->local_vtype[scope->num_locals - 1 - emit->n_buf++] = VTYPE_INT;
+            }
+        }
+    }
+    emit->buf_unchecked = false;
+    emit->index_error_used = false;
+    emit->index_error_label = *emit->label_slot + 7;
+    #endif
+
     // values on stack begin unbound
     for (mp_uint_t i = 0; i < emit->stack_info_alloc; i++) {
         emit->stack_info[i].kind = STACK_VALUE;
         emit->stack_info[i].vtype = VTYPE_UNBOUND;
+        #if N_M68K
+        emit->stack_info[i].buf_len = 0;
+        #if MICROPY_NATIVE_DIRECT_CALL
+        emit->stack_info[i].callee = NULL;
+        #endif
+        #endif
     }
 
     mp_asm_base_start_pass(&emit->as->base, pass == MP_PASS_EMIT ? MP_ASM_PASS_EMIT : MP_ASM_PASS_COMPUTE);
@@ -431,6 +830,8 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // n_state counts all stack and locals, even those in registers
         emit->n_state = scope->num_locals + scope->stack_size;
         int num_locals_in_regs = 0;
+        #if !N_M68K
+        // (m68k assigns registers to locals individually and keeps a slot for every local)
         if (CAN_USE_REGS_FOR_LOCALS(emit)) {
             num_locals_in_regs = scope->num_locals;
             if (num_locals_in_regs > MAX_REGS_FOR_LOCAL_VARS) {
@@ -441,6 +842,7 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 --num_locals_in_regs;
             }
         }
+        #endif
 
         // Work out where the locals and Python stack start within the C stack
         if (NEED_GLOBAL_EXC_HANDLER(emit)) {
@@ -454,7 +856,22 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         }
 
         // Entry to function
-        ASM_ENTRY(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs);
+        #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+        // A function that makes direct calls itself only has a normal entry, so
+        // that there is a stack check between any two direct calls
+        uint32_t direct_sig = emit_native_direct_sig(scope);
+        if (emit->direct_calls) {
+            direct_sig = 0;
+        }
+        if (direct_sig != 0) {
+            size_t pos = asm_m68k_entry_direct(emit->as, emit->stack_start + emit->n_state, ASM_M68K_OUT_ARGS_SIZE, direct_sig);
+            emit_native_direct_entry(emit, fun_table_off);
+            asm_m68k_entry_normal(emit->as, pos);
+        } else
+        #endif
+        {
+            ASM_ENTRY(emit->as, emit->stack_start + emit->n_state - num_locals_in_regs);
+        }
 
         #if N_X86
         asm_x86_mov_arg_to_r32(emit->as, 0, REG_PARENT_ARG_1);
@@ -481,9 +898,9 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         asm_x86_mov_arg_to_r32(emit->as, 2, REG_ARG_2);
         asm_x86_mov_arg_to_r32(emit->as, 3, REG_LOCAL_LAST);
         #elif N_M68K
-        asm_m68k_mov_args_to_r32(emit->as, 1, (1 << REG_ARG_1) |
-                                              (1 << REG_ARG_2) |
-                                              (1 << REG_LOCAL_LAST));
+        // Any of the local registers may be given to an argument, so the args
+        // array is fetched from the C stack into ASM_M68K_REG_AT when needed
+        asm_m68k_mov_args_to_r32(emit->as, 1, (1 << REG_ARG_1) | (1 << REG_ARG_2));
         #else
         ASM_MOV_REG_REG(emit->as, REG_ARG_1, REG_PARENT_ARG_2);
         ASM_MOV_REG_REG(emit->as, REG_ARG_2, REG_PARENT_ARG_3);
@@ -502,11 +919,41 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // Store arguments into locals (reg or stack), converting to native if needed
         for (int i = 0; i < emit->scope->num_pos_args; i++) {
             int r = REG_ARG_1;
+            #if N_M68K
+            // ASM_M68K_REG_AT is clobbered by the conversion call
+            if (i == 0 || emit->local_vtype[i - 1] != VTYPE_PYOBJ) {
+                asm_m68k_mov_arg_to_r32(emit->as, 3, ASM_M68K_REG_AT);
+            }
+            if (VTYPE_IS_BUF(emit->local_vtype[i])) {
+                // a checked buffer also puts its length in its hidden local
+                mp_uint_t len_local = emit_native_buf_len_local(emit, i);
+                ASM_LOAD_REG_REG_OFFSET(emit->as, REG_ARG_1, ASM_M68K_REG_AT, i);
+                emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, emit->local_vtype[i] | MP_NATIVE_TYPE_BUF_LEN, REG_ARG_2);
+                int reg_len = emit_native_local_reg(emit, len_local);
+                if (reg_len >= 0) {
+                    ASM_MOV_REG_REG(emit->as, reg_len, REG_RET);
+                } else {
+                    emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, len_local), REG_RET);
+                }
+                asm_m68k_mov_arg_to_r32(emit->as, 3, ASM_M68K_REG_AT);
+            }
+            ASM_LOAD_REG_REG_OFFSET(emit->as, REG_ARG_1, ASM_M68K_REG_AT, i);
+            #else
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_ARG_1, REG_LOCAL_LAST, i);
+            #endif
             if (emit->local_vtype[i] != VTYPE_PYOBJ) {
                 emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, emit->local_vtype[i], REG_ARG_2);
                 r = REG_RET;
             }
+            #if N_M68K
+            int reg_local = emit_native_local_reg(emit, i);
+            if (reg_local >= 0) {
+                ASM_MOV_REG_REG(emit->as, reg_local, r);
+            } else {
+                emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
+            }
+            continue;
+            #endif
             // REG_LOCAL_LAST points to the args array so be sure not to overwrite it if it's still needed
             if (i < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit) && (i != MAX_REGS_FOR_LOCAL_VARS - 1 || emit->scope->num_pos_args == MAX_REGS_FOR_LOCAL_VARS)) {
                 ASM_MOV_REG_REG(emit->as, reg_local_table[i], r);
@@ -514,10 +961,18 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
             }
         }
+        #if !N_M68K
         // Get local from the stack back into REG_LOCAL_LAST if this reg couldn't be written to above
         if (emit->scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1 && CAN_USE_REGS_FOR_LOCALS(emit)) {
             ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, MAX_REGS_FOR_LOCAL_VARS - 1));
         }
+        #endif
+
+        #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+        if (direct_sig != 0) {
+            mp_asm_base_label_assign(&emit->as->base, *emit->label_slot + 6);
+        }
+        #endif
 
         emit_native_global_exc_entry(emit);
 
@@ -636,9 +1091,17 @@ STATIC void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
         // cache some locals in registers, but only if no exception handlers
         if (CAN_USE_REGS_FOR_LOCALS(emit)) {
+            #if N_M68K
+            for (int i = 0; i < scope->num_locals; ++i) {
+                if (emit->local_reg[i] != LOCAL_REG_NONE && (emit->local_reg[i] & LOCAL_REG_LIVE_AT_ENTRY)) {
+                    ASM_MOV_REG_LOCAL(emit->as, emit_native_local_reg(emit, i), LOCAL_IDX_LOCAL_VAR(emit, i));
+                }
+            }
+            #else
             for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS && i < scope->num_locals; ++i) {
                 ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, i));
             }
+            #endif
         }
 
         // set the type of closed over variables
@@ -662,6 +1125,12 @@ static inline void emit_native_write_code_info_qstr(emit_t *emit, qstr qst) {
 STATIC bool emit_native_end_pass(emit_t *emit) {
     emit_native_global_exc_exit(emit);
 
+    #if N_M68K
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        emit_native_alloc_local_regs(emit);
+    }
+    #endif
+
     if (!emit->do_viper_types) {
         emit->prelude_offset = mp_asm_base_get_code_pos(&emit->as->base);
         emit->prelude_ptr_index = emit->emit_common->ct_cur_child;
@@ -705,6 +1174,13 @@ STATIC bool emit_native_end_pass(emit_t *emit) {
 
     ASM_END_PASS(emit->as);
 
+    #if N_M68K
+    // Branch relaxation at the end of a compute pass moves the code that follows
+    if (emit->pass < MP_PASS_EMIT) {
+        emit->start_offset = asm_m68k_relaxed_pos(emit->as, emit->start_offset);
+    }
+    #endif
+
     // check stack is back to zero size
     assert(emit->stack_size == 0);
     assert(emit->exc_stack_size == 0);
@@ -788,6 +1264,12 @@ STATIC void emit_native_adjust_stack_size(emit_t *emit, mp_int_t delta) {
     for (mp_int_t i = 0; i < delta; i++) {
         stack_info_t *si = &emit->stack_info[emit->stack_size + i];
         si->kind = STACK_VALUE;
+        #if N_M68K
+        si->buf_len = 0;
+        #if MICROPY_NATIVE_DIRECT_CALL
+        si->callee = NULL;
+        #endif
+        #endif
         // TODO we don't know the vtype to use here.  At the moment this is a
         // hack to get the case of multi comparison working.
         if (delta == 1) {
@@ -865,6 +1347,12 @@ STATIC vtype_kind_t load_reg_stack_imm(emit_t *emit, int reg_dest, const stack_i
             ASM_MOV_REG_IMM(emit->as, reg_dest, (uintptr_t)MP_OBJ_NEW_SMALL_INT(si->data.u_imm));
         } else if (si->vtype == VTYPE_PTR_NONE) {
             emit_native_mov_reg_const(emit, reg_dest, MP_F_CONST_NONE_OBJ);
+        #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+        } else if (si->vtype == VTYPE_FLOAT) {
+            // a float must be boxed by a call to the runtime, which the caller does
+            ASM_MOV_REG_IMM(emit->as, reg_dest, si->data.u_imm);
+            return VTYPE_FLOAT;
+        #endif
         } else {
             mp_raise_NotImplementedError(MP_ERROR_TEXT("conversion to object"));
         }
@@ -931,7 +1419,12 @@ STATIC void emit_fold_stack_top(emit_t *emit, int reg_dest) {
 // *reg_dest is set to that register.  Otherwise the value is put in *reg_dest.
 STATIC void emit_pre_pop_reg_flexible(emit_t *emit, vtype_kind_t *vtype, int *reg_dest, int not_r1, int not_r2) {
     stack_info_t *si = peek_stack(emit, 0);
-    if (si->kind == STACK_REG && si->data.u_reg != not_r1 && si->data.u_reg != not_r2) {
+    if (si->kind == STACK_REG && si->data.u_reg != not_r1 && si->data.u_reg != not_r2
+        #if N_M68K
+        // a local held in an address register can't be an operand of most ALU ops
+        && !ASM_M68K_IS_AREG(si->data.u_reg)
+        #endif
+        ) {
         *vtype = si->vtype;
         *reg_dest = si->data.u_reg;
         need_reg_single(emit, *reg_dest, 1);
@@ -975,6 +1468,13 @@ STATIC void emit_post_push_reg(emit_t *emit, vtype_kind_t vtype, int reg) {
     stack_info_t *si = &emit->stack_info[emit->stack_size];
     si->vtype = vtype;
     si->kind = STACK_REG;
+    #if N_M68K
+    si->narrow = 0;
+    si->buf_len = 0;
+    #if MICROPY_NATIVE_DIRECT_CALL
+    si->callee = NULL;
+    #endif
+    #endif
     si->data.u_reg = reg;
     adjust_stack(emit, 1);
 }
@@ -984,6 +1484,14 @@ STATIC void emit_post_push_imm(emit_t *emit, vtype_kind_t vtype, mp_int_t imm) {
     stack_info_t *si = &emit->stack_info[emit->stack_size];
     si->vtype = vtype;
     si->kind = STACK_IMM;
+    #if N_M68K
+    si->narrow = (0 <= imm && imm <= 0xffff ? STACK_NARROW_U16 : 0)
+        | (-0x8000 <= imm && imm <= 0x7fff ? STACK_NARROW_S16 : 0);
+    si->buf_len = 0;
+    #if MICROPY_NATIVE_DIRECT_CALL
+    si->callee = NULL;
+    #endif
+    #endif
     si->data.u_imm = imm;
     adjust_stack(emit, 1);
 }
@@ -1077,6 +1585,9 @@ STATIC void emit_get_stack_pointer_to_reg_for_push(emit_t *emit, mp_uint_t reg_d
     for (mp_uint_t i = 0; i < n_push; i++) {
         emit->stack_info[emit->stack_size + i].kind = STACK_VALUE;
         emit->stack_info[emit->stack_size + i].vtype = VTYPE_PYOBJ;
+        #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+        emit->stack_info[emit->stack_size + i].callee = NULL;
+        #endif
     }
     emit_native_mov_reg_state_addr(emit, reg_dest, emit->stack_start + emit->stack_size);
     adjust_stack(emit, n_push);
@@ -1170,12 +1681,31 @@ STATIC void emit_native_label_assign(emit_t *emit, mp_uint_t l) {
     mp_asm_base_label_assign(&emit->as->base, l);
     emit_post(emit);
 
+    #if N_M68K
+    // the value of a conditional expression may be any buffer
+    if (emit->stack_size > 0) {
+        peek_stack(emit, 0)->buf_len = 0;
+    }
+    #endif
+
     if (is_finally) {
         // Label is at start of finally handler: pop exception stack
         emit_native_leave_exc_stack(emit, false);
     }
 }
 
+// Raise the value in LOCAL_IDX_EXC_VAL, thrown into a resumed generator
+STATIC void emit_native_raise_exc_val(emit_t *emit) {
+    ASM_MOV_REG_LOCAL(emit->as, REG_ARG_1, LOCAL_IDX_EXC_VAL(emit));
+    #if N_M68K
+    // it is usually MP_OBJ_NULL, so the call is skipped inline
+    need_reg_all(emit);
+    asm_m68k_call_ind_if_nonzero(emit->as, MP_F_NATIVE_RAISE);
+    #else
+    emit_call(emit, MP_F_NATIVE_RAISE);
+    #endif
+}
+
 STATIC void emit_native_global_exc_entry(emit_t *emit) {
     // Note: 4 labels are reserved for this function, starting at *emit->label_slot
 
@@ -1272,8 +1802,7 @@ STATIC void emit_native_global_exc_entry(emit_t *emit) {
             // This is the first entry of the generator
 
             // Check LOCAL_IDX_EXC_VAL for any injected value
-            ASM_MOV_REG_LOCAL(emit->as, REG_ARG_1, LOCAL_IDX_EXC_VAL(emit));
-            emit_call(emit, MP_F_NATIVE_RAISE);
+            emit_native_raise_exc_val(emit);
         }
     }
 }
@@ -1311,6 +1840,16 @@ STATIC void emit_native_global_exc_exit(emit_t *emit) {
     }
 
     ASM_EXIT(emit->as);
+
+    #if N_M68K
+    if (emit->index_error_used) {
+        // Shared target of the bounds checks of checked buffers
+        emit_native_label_assign(emit, emit->index_error_label);
+        emit_call_with_qstr_arg(emit, MP_F_LOAD_GLOBAL, MP_QSTR_IndexError, REG_ARG_1);
+        ASM_MOV_REG_REG(emit->as, REG_ARG_1, REG_RET);
+        emit_call(emit, MP_F_NATIVE_RAISE);
+    }
+    #endif
 }
 
 STATIC void emit_native_import_name(emit_t *emit, qstr qst) {
@@ -1400,6 +1939,13 @@ STATIC void emit_native_load_const_str(emit_t *emit, qstr qst) {
 
 STATIC void emit_native_load_const_obj(emit_t *emit, mp_obj_t obj) {
     emit_native_pre(emit);
+    #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+    if (emit->do_viper_types && mp_obj_is_float(obj)) {
+        // float literals in viper are unboxed floats, like int literals are native ints
+        emit_post_push_imm(emit, VTYPE_FLOAT, mp_native_float_new(mp_obj_get_float(obj)));
+        return;
+    }
+    #endif
     need_reg_single(emit, REG_RET, 0);
     emit_load_reg_with_object(emit, REG_RET, obj);
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
@@ -1417,13 +1963,27 @@ STATIC void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
+    #if N_M68K
+    emit_native_record_local_access(emit, local_num, false);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        emit_post_push_reg(emit, vtype, reg_local);
+    } else {
+    #else
     if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
         emit_post_push_reg(emit, vtype, reg_local_table[local_num]);
     } else {
+    #endif
         need_reg_single(emit, REG_TEMP0, 0);
         emit_native_mov_reg_state(emit, REG_TEMP0, LOCAL_IDX_LOCAL_VAR(emit, local_num));
         emit_post_push_reg(emit, vtype, REG_TEMP0);
     }
+    #if N_M68K
+    if (VTYPE_IS_BUF(vtype)) {
+        // remember which length a subscript of this buffer is checked against
+        peek_stack(emit, 0)->buf_len = 1 + emit_native_buf_len_local(emit, local_num);
+    }
+    #endif
 }
 
 STATIC void emit_native_load_deref(emit_t *emit, qstr qst, mp_uint_t local_num) {
@@ -1465,6 +2025,11 @@ STATIC void emit_native_load_global(emit_t *emit, qstr qst, int kind) {
     }
     emit_call_with_qstr_arg(emit, MP_F_LOAD_NAME + kind, qst, REG_ARG_1);
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
+    #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+    if (emit->do_viper_types && kind == MP_EMIT_IDOP_GLOBAL_GLOBAL) {
+        peek_stack(emit, 0)->callee = emit_native_direct_callee(emit, qst);
+    }
+    #endif
 }
 
 STATIC void emit_native_load_attr(emit_t *emit, qstr qst) {
@@ -1499,6 +2064,181 @@ STATIC void emit_native_load_build_class(emit_t *emit) {
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
 }
 
+#if N_M68K
+
+// Viper subscripts on m68k address the element directly with (d16,An) for an
+// immediate index and (d8,An,Dn.l) otherwise.  The base is only read, so a
+// pointer local held in an address register is used without being copied.
+
+// Returns log2 of the element size of a viper pointer type, or -1
+STATIC int emit_native_m68k_ptr_size(vtype_kind_t vtype) {
+    switch (vtype) {
+        case VTYPE_PTR8:
+        case VTYPE_BUF8:
+            return 0;
+        case VTYPE_PTR16:
+        case VTYPE_BUF16:
+            return 1;
+        case VTYPE_PTR32:
+        case VTYPE_BUF32:
+            return 2;
+        default:
+            return -1;
+    }
+}
+
+// Subscripts of checked buffers compare the index with the buffer's length and
+// jump to a shared stub raising IndexError, emitted by end_pass.  Returns the
+// local holding the length for the base at the given depth, or -1 if there is
+// nothing to check: the base is a plain pointer, or the compiler has found the
+// index to be in range (see compile_for_stmt_buf_hoist).
+STATIC int emit_native_m68k_buf_len_local(emit_t *emit, mp_uint_t depth) {
+    stack_info_t *si = peek_stack(emit, depth);
+    if (!VTYPE_IS_BUF(si->vtype)) {
+        return -1;
+    }
+    if (emit->buf_unchecked) {
+        return -1;
+    }
+    if (si->buf_len == 0) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't subscript '%q' of unknown length"), vtype_to_qstr(si->vtype));
+        return -1;
+    }
+    return si->buf_len - 1;
+}
+
+// Check the index in reg_index, or the constant index if reg_index is -1
+STATIC void emit_native_m68k_buf_check_index(emit_t *emit, int len_local, int reg_index, mp_int_t index) {
+    emit_native_record_local_access(emit, len_local, false);
+    int reg_len = emit_native_local_reg(emit, len_local);
+    if (reg_index >= 0) {
+        asm_m68k_jmp_if_index_out(emit->as, reg_index, reg_len, LOCAL_IDX_LOCAL_VAR(emit, len_local), emit->index_error_label);
+    } else {
+        asm_m68k_jmp_if_index_imm_out(emit->as, index, reg_len, LOCAL_IDX_LOCAL_VAR(emit, len_local), emit->index_error_label);
+    }
+    emit->index_error_used = true;
+}
+
+// Whether the top of the stack is an immediate index that fits in a displacement
+STATIC bool emit_native_m68k_imm_index(emit_t *emit, int size_log2) {
+    stack_info_t *top = peek_stack(emit, 0);
+    int s = MAX(size_log2, 0);
+    return top->vtype == VTYPE_INT && top->kind == STACK_IMM
+           && top->data.u_imm >= (-0x8000 >> s) && top->data.u_imm < (0x8000 >> s);
+}
+
+// Pop the base pointer, using the register it's in unless that is not_r1 or not_r2
+STATIC void emit_native_m68k_pre_pop_base(emit_t *emit, vtype_kind_t *vtype, int *reg_base, int not_r1, int not_r2) {
+    stack_info_t *si = peek_stack(emit, 0);
+    if (si->kind == STACK_REG && si->data.u_reg != not_r1 && si->data.u_reg != not_r2) {
+        *vtype = si->vtype;
+        *reg_base = si->data.u_reg;
+        adjust_stack(emit, -1);
+    } else {
+        emit_pre_pop_reg(emit, vtype, *reg_base);
+    }
+}
+
+// Pop the index into a register, which is clobbered if it must be scaled
+STATIC void emit_native_m68k_pre_pop_index(emit_t *emit, int size_log2, int *reg_index, int not_r1, int not_r2) {
+    vtype_kind_t vtype_index;
+    if (size_log2 > 0 && !emit->as->cpu020) {
+        emit_pre_pop_reg(emit, &vtype_index, *reg_index);
+    } else {
+        emit_pre_pop_reg_flexible(emit, &vtype_index, reg_index, not_r1, not_r2);
+    }
+    if (vtype_index != VTYPE_INT && vtype_index != VTYPE_UINT) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't subscript with '%q' index"), vtype_to_qstr(vtype_index));
+    }
+}
+
+STATIC void emit_native_m68k_load_subscr_viper(emit_t *emit) {
+    vtype_kind_t vtype_base = peek_vtype(emit, 1);
+    int size_log2 = emit_native_m68k_ptr_size(vtype_base);
+    int len_local = emit_native_m68k_buf_len_local(emit, 1);
+    int reg_base = REG_ARG_1;
+    if (emit_native_m68k_imm_index(emit, size_log2)) {
+        mp_int_t index = peek_stack(emit, 0)->data.u_imm;
+        mp_int_t disp = index * (1 << MAX(size_log2, 0));
+        emit_pre_pop_discard(emit);
+        emit_native_m68k_pre_pop_base(emit, &vtype_base, &reg_base, -1, -1);
+        need_reg_single(emit, REG_RET, 0);
+        if (len_local >= 0) {
+            emit_native_m68k_buf_check_index(emit, len_local, -1, index);
+        }
+        if (size_log2 >= 0) {
+            asm_m68k_ldn_reg_reg_disp(emit->as, size_log2, REG_RET, reg_base, disp);
+        }
+    } else {
+        int reg_index = REG_ARG_2;
+        emit_native_m68k_pre_pop_index(emit, size_log2, &reg_index, REG_RET, REG_RET);
+        emit_native_m68k_pre_pop_base(emit, &vtype_base, &reg_base, reg_index, -1);
+        need_reg_single(emit, REG_RET, 0);
+        if (len_local >= 0) {
+            emit_native_m68k_buf_check_index(emit, len_local, reg_index, 0);
+        }
+        if (size_log2 >= 0) {
+            asm_m68k_ldn_reg_reg_reg(emit->as, size_log2, REG_RET, reg_base, reg_index);
+        }
+    }
+    if (size_log2 < 0) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't load from '%q'"), vtype_to_qstr(vtype_base));
+    }
+    emit_post_push_reg(emit, VTYPE_INT, REG_RET);
+    // ptr8 and ptr16 loads are zero extended
+    if (size_log2 == 0) {
+        peek_stack(emit, 0)->narrow = STACK_NARROW_U16 | STACK_NARROW_S16;
+    } else if (size_log2 == 1) {
+        peek_stack(emit, 0)->narrow = STACK_NARROW_U16;
+    }
+}
+
+STATIC void emit_native_m68k_store_subscr_viper(emit_t *emit) {
+    vtype_kind_t vtype_base = peek_vtype(emit, 1);
+    vtype_kind_t vtype_value;
+    int size_log2 = emit_native_m68k_ptr_size(vtype_base);
+    int len_local = emit_native_m68k_buf_len_local(emit, 1);
+    int reg_base = REG_ARG_1;
+    int reg_value = REG_ARG_3;
+    if (emit_native_m68k_imm_index(emit, size_log2)) {
+        mp_int_t index = peek_stack(emit, 0)->data.u_imm;
+        mp_int_t disp = index * (1 << MAX(size_log2, 0));
+        emit_pre_pop_discard(emit);
+        emit_native_m68k_pre_pop_base(emit, &vtype_base, &reg_base, reg_value, -1);
+        emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, reg_base, reg_base);
+        if (len_local >= 0) {
+            emit_native_m68k_buf_check_index(emit, len_local, -1, index);
+        }
+        if (size_log2 >= 0) {
+            asm_m68k_stn_reg_reg_disp(emit->as, size_log2, reg_value, reg_base, disp);
+        }
+    } else {
+        int reg_index = REG_ARG_2;
+        emit_native_m68k_pre_pop_index(emit, size_log2, &reg_index, REG_ARG_1, reg_value);
+        emit_native_m68k_pre_pop_base(emit, &vtype_base, &reg_base, reg_index, reg_value);
+        emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, reg_base, reg_index);
+        if (len_local >= 0) {
+            emit_native_m68k_buf_check_index(emit, len_local, reg_index, 0);
+        }
+        if (size_log2 >= 0) {
+            asm_m68k_stn_reg_reg_reg(emit->as, size_log2, reg_value, reg_base, reg_index);
+        }
+    }
+    if (size_log2 < 0) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't store to '%q'"), vtype_to_qstr(vtype_base));
+    }
+    if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't store '%q'"), vtype_to_qstr(vtype_value));
+    }
+}
+
+#endif
+
 STATIC void emit_native_load_subscr(emit_t *emit) {
     DEBUG_printf("load_subscr\n");
     // need to compile: base[index]
@@ -1522,6 +2262,10 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
         emit_call_with_imm_arg(emit, MP_F_OBJ_SUBSCR, (mp_uint_t)MP_OBJ_SENTINEL, REG_ARG_3);
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
     } else {
+        #if N_M68K
+        emit_native_m68k_load_subscr_viper(emit);
+        return;
+        #endif
         // viper load
         // TODO The different machine architectures have very different
         // capabilities and requirements for loads, so probably best to
@@ -1641,9 +2385,21 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
 
 STATIC void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
+    #if N_M68K
+    if (VTYPE_IS_BUF(emit->local_vtype[local_num])) {
+        // its length is only known for the object passed in
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("can't assign to checked buffer '%q'"), qst);
+    }
+    emit_native_record_local_access(emit, local_num, true);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    if (reg_local >= 0) {
+        emit_pre_pop_reg(emit, &vtype, reg_local);
+    } else {
+    #else
     if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
         emit_pre_pop_reg(emit, &vtype, reg_local_table[local_num]);
     } else {
+    #endif
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
         emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), REG_TEMP0);
     }
@@ -1743,6 +2499,10 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
         emit_pre_pop_reg_reg_reg(emit, &vtype_index, REG_ARG_2, &vtype_base, REG_ARG_1, &vtype_value, REG_ARG_3);
         emit_call(emit, MP_F_OBJ_SUBSCR);
     } else {
+        #if N_M68K
+        emit_native_m68k_store_subscr_viper(emit);
+        return;
+        #endif
         // viper store
         // TODO The different machine architectures have very different
         // capabilities and requirements for stores, so probably best to
@@ -1944,6 +2704,10 @@ STATIC void emit_native_subscr(emit_t *emit, int kind) {
     } else {
         emit_native_delete_subscr(emit);
     }
+    #if N_M68K
+    // a hint from buf_check applies to this subscript only
+    emit->buf_unchecked = false;
+    #endif
 }
 
 STATIC void emit_native_attr(emit_t *emit, qstr qst, int kind) {
@@ -1956,18 +2720,37 @@ STATIC void emit_native_attr(emit_t *emit, qstr qst, int kind) {
     }
 }
 
+#if N_M68K
+// Stack shuffles keep track of which checked buffers are moved where
+#define BUF_LEN(depth) (peek_stack(emit, (depth))->buf_len)
+#endif
+
 STATIC void emit_native_dup_top(emit_t *emit) {
     DEBUG_printf("dup_top\n");
     vtype_kind_t vtype;
     int reg = REG_TEMP0;
+    #if N_M68K
+    uint16_t buf_len0 = BUF_LEN(0);
+    #endif
     emit_pre_pop_reg_flexible(emit, &vtype, &reg, -1, -1);
     emit_post_push_reg_reg(emit, vtype, reg, vtype, reg);
+    #if N_M68K
+    BUF_LEN(0) = BUF_LEN(1) = buf_len0;
+    #endif
 }
 
 STATIC void emit_native_dup_top_two(emit_t *emit) {
     vtype_kind_t vtype0, vtype1;
+    #if N_M68K
+    uint16_t buf_len0 = BUF_LEN(0);
+    uint16_t buf_len1 = BUF_LEN(1);
+    #endif
     emit_pre_pop_reg_reg(emit, &vtype0, REG_TEMP0, &vtype1, REG_TEMP1);
     emit_post_push_reg_reg_reg_reg(emit, vtype1, REG_TEMP1, vtype0, REG_TEMP0, vtype1, REG_TEMP1, vtype0, REG_TEMP0);
+    #if N_M68K
+    BUF_LEN(0) = BUF_LEN(2) = buf_len0;
+    BUF_LEN(1) = BUF_LEN(3) = buf_len1;
+    #endif
 }
 
 STATIC void emit_native_pop_top(emit_t *emit) {
@@ -1979,15 +2762,33 @@ STATIC void emit_native_pop_top(emit_t *emit) {
 STATIC void emit_native_rot_two(emit_t *emit) {
     DEBUG_printf("rot_two\n");
     vtype_kind_t vtype0, vtype1;
+    #if N_M68K
+    uint16_t buf_len0 = BUF_LEN(0);
+    uint16_t buf_len1 = BUF_LEN(1);
+    #endif
     emit_pre_pop_reg_reg(emit, &vtype0, REG_TEMP0, &vtype1, REG_TEMP1);
     emit_post_push_reg_reg(emit, vtype0, REG_TEMP0, vtype1, REG_TEMP1);
+    #if N_M68K
+    BUF_LEN(0) = buf_len1;
+    BUF_LEN(1) = buf_len0;
+    #endif
 }
 
 STATIC void emit_native_rot_three(emit_t *emit) {
     DEBUG_printf("rot_three\n");
     vtype_kind_t vtype0, vtype1, vtype2;
+    #if N_M68K
+    uint16_t buf_len0 = BUF_LEN(0);
+    uint16_t buf_len1 = BUF_LEN(1);
+    uint16_t buf_len2 = BUF_LEN(2);
+    #endif
     emit_pre_pop_reg_reg_reg(emit, &vtype0, REG_TEMP0, &vtype1, REG_TEMP1, &vtype2, REG_TEMP2);
     emit_post_push_reg_reg_reg(emit, vtype0, REG_TEMP0, vtype2, REG_TEMP2, vtype1, REG_TEMP1);
+    #if N_M68K
+    BUF_LEN(0) = buf_len1;
+    BUF_LEN(1) = buf_len2;
+    BUF_LEN(2) = buf_len0;
+    #endif
 }
 
 STATIC void emit_native_jump(emit_t *emit, mp_uint_t label) {
@@ -1995,6 +2796,9 @@ STATIC void emit_native_jump(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
+    #if N_M68K
+    emit_native_record_jump(emit, label);
+    #endif
     ASM_JUMP(emit->as, label);
     emit_post(emit);
     mp_asm_base_suppress_code(&emit->as->base);
@@ -2026,6 +2830,9 @@ STATIC void emit_native_jump_helper(emit_t *emit, bool cond, mp_uint_t label, bo
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
     // Emit the jump
+    #if N_M68K
+    emit_native_record_jump(emit, label);
+    #endif
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label, vtype == VTYPE_PYOBJ);
     } else {
@@ -2285,8 +3092,185 @@ STATIC void emit_native_pop_except_jump(emit_t *emit, mp_uint_t label, bool with
     emit_native_jump(emit, label);
 }
 
+#if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+
+// Call a float helper from the runtime, with need_reg_all already done
+STATIC void emit_native_call_float(emit_t *emit, uint fun_idx, uint n_args) {
+    asm_m68k_call_ind(emit->as, fun_idx, n_args);
+}
+
+// Convert the int in reg (REG_ARG_1 or REG_ARG_2) to a float, preserving the other
+// one; without an FPU this calls the runtime so need_reg_all must be done already
+STATIC void emit_native_float_from_int(emit_t *emit, int reg) {
+    if (emit->fpu) {
+        asm_m68k_float_from_int(emit->as, reg);
+        return;
+    }
+    // the helper clobbers REG_ARG_1 and REG_ARG_2 but not REG_ARG_3
+    int reg_other = reg == REG_ARG_1 ? REG_ARG_2 : REG_ARG_1;
+    ASM_MOV_REG_REG(emit->as, REG_ARG_3, reg_other);
+    if (reg != REG_ARG_1) {
+        ASM_MOV_REG_REG(emit->as, REG_ARG_1, reg);
+    }
+    emit_native_call_float(emit, MP_F_FLOAT_FROM_INT, 1);
+    if (reg != REG_RET) {
+        ASM_MOV_REG_REG(emit->as, reg, REG_RET);
+    }
+    ASM_MOV_REG_REG(emit->as, reg_other, REG_ARG_3);
+}
+
+// Box the float at the given depth on the stack so it can be used as an object
+STATIC void emit_native_float_to_obj(emit_t *emit, int depth) {
+    need_stack_settled(emit);
+    stack_info_t *si = peek_stack(emit, depth);
+    mp_uint_t local_num = emit->stack_start + emit->stack_size - 1 - depth;
+    emit_native_mov_reg_state(emit, REG_ARG_1, local_num);
+    emit_call_with_imm_arg(emit, MP_F_CONVERT_NATIVE_TO_OBJ, VTYPE_FLOAT, REG_ARG_2); // arg2 = type
+    emit_native_mov_state_reg(emit, local_num, REG_RET);
+    si->vtype = VTYPE_PYOBJ;
+}
+
+// Binary op where at least one argument is an unboxed float.  With an FPU the
+// values are only moved into fp0 for each operation, otherwise the soft-float
+// helpers in the runtime are called, and neither way allocates on the heap.
+STATIC void emit_native_float_binary_op(emit_t *emit, mp_binary_op_t op) {
+    vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
+    vtype_kind_t vtype_rhs = peek_vtype(emit, 0);
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_POWER) {
+        op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+
+    uint fop;
+    uint fun_idx;
+    uint fcond = 0;
+    if (op == MP_BINARY_OP_ADD) {
+        fop = ASM_M68K_FOP_ADD;
+        fun_idx = MP_F_FLOAT_ADD;
+    } else if (op == MP_BINARY_OP_SUBTRACT) {
+        fop = ASM_M68K_FOP_SUB;
+        fun_idx = MP_F_FLOAT_SUB;
+    } else if (op == MP_BINARY_OP_MULTIPLY) {
+        fop = ASM_M68K_FOP_MUL;
+        fun_idx = MP_F_FLOAT_MUL;
+    } else if (op == MP_BINARY_OP_TRUE_DIVIDE) {
+        fop = ASM_M68K_FOP_DIV;
+        fun_idx = MP_F_FLOAT_DIV;
+    } else if (MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL) {
+        static const uint8_t fccs[6] = {
+            ASM_M68K_FCC_OLT,
+            ASM_M68K_FCC_OGT,
+            ASM_M68K_FCC_EQ,
+            ASM_M68K_FCC_OLE,
+            ASM_M68K_FCC_OGE,
+            ASM_M68K_FCC_NE,
+        };
+        fop = ASM_M68K_FOP_CMP;
+        fun_idx = MP_F_FLOAT_CMP;
+        fcond = fccs[op - MP_BINARY_OP_LESS];
+    } else {
+        adjust_stack(emit, -1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("binary op %q not implemented"), mp_binary_op_method_name[op]);
+        return;
+    }
+
+    // ints are promoted to float, immediates at compile time
+    for (int depth = 0; depth < 2; ++depth) {
+        stack_info_t *si = peek_stack(emit, depth);
+        if (si->kind == STACK_IMM && (si->vtype == VTYPE_INT || si->vtype == VTYPE_BOOL)) {
+            si->vtype = VTYPE_FLOAT;
+            si->data.u_imm = mp_native_float_new((float)si->data.u_imm);
+        }
+    }
+
+    if (!emit->fpu) {
+        need_reg_all(emit);
+    }
+    emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_2, &vtype_lhs, REG_ARG_1);
+    if (vtype_lhs == VTYPE_INT || vtype_lhs == VTYPE_BOOL) {
+        emit_native_float_from_int(emit, REG_ARG_1);
+    } else if (vtype_rhs == VTYPE_INT || vtype_rhs == VTYPE_BOOL) {
+        emit_native_float_from_int(emit, REG_ARG_2);
+    } else if (vtype_lhs != VTYPE_FLOAT || vtype_rhs != VTYPE_FLOAT) {
+        adjust_stack(emit, 1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't do binary op between '%q' and '%q'"),
+            vtype_to_qstr(vtype_lhs), vtype_to_qstr(vtype_rhs));
+        return;
+    }
+
+    if (fop == ASM_M68K_FOP_CMP) {
+        if (emit->fpu) {
+            asm_m68k_float_cmp_setcc(emit->as, REG_ARG_1, REG_ARG_2, fcond, REG_RET);
+            emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
+        } else {
+            emit_native_call_float(emit, fun_idx, 2);
+            asm_m68k_float_cmp_result_setcc(emit->as, fcond, REG_ARG_2);
+            emit_post_push_reg(emit, VTYPE_BOOL, REG_ARG_2);
+        }
+    } else {
+        if (emit->fpu) {
+            asm_m68k_float_op(emit->as, fop, REG_ARG_1, REG_ARG_2);
+        } else {
+            emit_native_call_float(emit, fun_idx, 2);
+        }
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+    }
+}
+
+// float(x) of a native int, or int(x) of a float, which truncates towards zero
+STATIC void emit_native_float_cast(emit_t *emit, vtype_kind_t vtype_cast, vtype_kind_t vtype_arg) {
+    if (vtype_cast == vtype_arg) {
+        emit_fold_stack_top(emit, REG_ARG_1);
+        return;
+    }
+    if (vtype_cast == VTYPE_FLOAT && (vtype_arg == VTYPE_INT || vtype_arg == VTYPE_BOOL)) {
+        stack_info_t *si = peek_stack(emit, 0);
+        if (si->kind == STACK_IMM) {
+            emit_fold_stack_top(emit, REG_ARG_1);
+            emit_post_top_set_vtype(emit, VTYPE_FLOAT);
+            si = peek_stack(emit, 0);
+            si->data.u_imm = mp_native_float_new((float)si->data.u_imm);
+            return;
+        }
+        if (!emit->fpu) {
+            need_reg_all(emit);
+        }
+        vtype_kind_t vtype;
+        emit_pre_pop_reg(emit, &vtype, REG_ARG_1);
+        emit_pre_pop_discard(emit);
+        emit_native_float_from_int(emit, REG_ARG_1);
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_1);
+    } else if (vtype_cast == VTYPE_INT) {
+        need_reg_all(emit);
+        vtype_kind_t vtype;
+        emit_pre_pop_reg(emit, &vtype, REG_ARG_1);
+        emit_pre_pop_discard(emit);
+        emit_native_call_float(emit, MP_F_FLOAT_TO_INT, 1);
+        emit_post_push_reg(emit, VTYPE_INT, REG_RET);
+    } else {
+        adjust_stack(emit, -1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            MP_ERROR_TEXT("can't convert '%q' to '%q'"),
+            vtype_to_qstr(vtype_arg), vtype_to_qstr(vtype_cast));
+    }
+}
+
+#endif
+
 STATIC void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
     vtype_kind_t vtype;
+    #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+    if (peek_vtype(emit, 0) == VTYPE_FLOAT
+        && (op == MP_UNARY_OP_POSITIVE || op == MP_UNARY_OP_NEGATIVE)) {
+        emit_pre_pop_reg(emit, &vtype, REG_RET);
+        if (op == MP_UNARY_OP_NEGATIVE) {
+            asm_m68k_float_neg(emit->as, REG_RET);
+        }
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+        return;
+    }
+    #endif
     emit_pre_pop_reg(emit, &vtype, REG_ARG_2);
     if (vtype == VTYPE_PYOBJ) {
         emit_call_with_imm_arg(emit, MP_F_UNARY_OP, op, REG_ARG_1);
@@ -2302,6 +3286,17 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     DEBUG_printf("binary_op(" UINT_FMT ")\n", op);
     vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
     vtype_kind_t vtype_rhs = peek_vtype(emit, 0);
+    #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+    if (vtype_lhs == VTYPE_FLOAT || vtype_rhs == VTYPE_FLOAT) {
+        if (vtype_lhs != VTYPE_PYOBJ && vtype_rhs != VTYPE_PYOBJ) {
+            emit_native_float_binary_op(emit, op);
+            return;
+        }
+        // with an object the float is boxed and the op done by the runtime
+        emit_native_float_to_obj(emit, vtype_lhs == VTYPE_FLOAT ? 1 : 0);
+        vtype_lhs = vtype_rhs = VTYPE_PYOBJ;
+    }
+    #endif
     if ((vtype_lhs == VTYPE_INT || vtype_lhs == VTYPE_UINT)
         && (vtype_rhs == VTYPE_INT || vtype_rhs == VTYPE_UINT)) {
         // for integers, inplace and normal ops are equivalent, so use just normal ops
@@ -2333,30 +3328,89 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
 
         // special cases for floor-divide and module because we dispatch to helper functions
         if (op == MP_BINARY_OP_FLOOR_DIVIDE || op == MP_BINARY_OP_MODULO) {
+            #if N_M68K
+            // m68k divides inline when the divisor fits in 16 bits, or any positive
+            // divisor on a 68020, see asm_m68k_floordiv_imm
+            stack_info_t *si_rhs = peek_stack(emit, 0);
+            if (si_rhs->kind == STACK_IMM && 0 < si_rhs->data.u_imm
+                && (si_rhs->data.u_imm <= 0xffff || (emit->as->cpu020 && si_rhs->data.u_imm <= 0x7fffffff))) {
+                mp_int_t imm = si_rhs->data.u_imm;
+                bool lhs_u16 = peek_stack(emit, 1)->narrow & STACK_NARROW_U16;
+                emit_pre_pop_discard(emit);
+                emit_pre_pop_reg(emit, &vtype_lhs, REG_ARG_1);
+                if (vtype_lhs != VTYPE_INT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        MP_ERROR_TEXT("div/mod not implemented for uint"), mp_binary_op_method_name[op]);
+                }
+                need_reg_single(emit, REG_ARG_2, 0);
+                need_reg_single(emit, REG_ARG_3, 0);
+                need_reg_single(emit, REG_ARG_4, 0);
+                asm_m68k_floordiv_imm(emit->as, imm, op == MP_BINARY_OP_MODULO, lhs_u16);
+                emit_post_push_reg(emit, VTYPE_INT, REG_RET);
+                return;
+            }
+            #endif
             emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_2, &vtype_lhs, REG_ARG_1);
             if (vtype_lhs != VTYPE_INT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     MP_ERROR_TEXT("div/mod not implemented for uint"), mp_binary_op_method_name[op]);
             }
+            #if N_M68K
+            need_reg_all(emit);
+            if (op == MP_BINARY_OP_FLOOR_DIVIDE) {
+                asm_m68k_floordiv_reg(emit->as, false, MP_F_SMALL_INT_FLOOR_DIVIDE);
+            } else {
+                asm_m68k_floordiv_reg(emit->as, true, MP_F_SMALL_INT_MODULO);
+            }
+            #else
             if (op == MP_BINARY_OP_FLOOR_DIVIDE) {
                 emit_call(emit, MP_F_SMALL_INT_FLOOR_DIVIDE);
             } else {
                 emit_call(emit, MP_F_SMALL_INT_MODULO);
             }
+            #endif
             emit_post_push_reg(emit, VTYPE_INT, REG_RET);
             return;
         }
 
-#if MICROPY_SMALL_INT_MUL_HELPER && defined (ASM_CALL_IND_N)
-        // m68k doesn't have 32bit multiply
+        #if N_M68K
+        // m68k only has a 16x16 multiply, so choose the sequence from what is
+        // known about the operands: a single mulu.w/muls.w if both fit in 16 bits,
+        // shifts or two multiplies by a constant, or the full 32x32 sequence
         if (op == MP_BINARY_OP_MULTIPLY) {
-            emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_2, &vtype_lhs, REG_ARG_1);
-            need_reg_all(emit);
-            ASM_CALL_IND_N(emit->as, MP_F_SMALL_INT_MULTIPLY, 2);
-            emit_post_push_reg(emit, VTYPE_INT, REG_RET);
+            stack_info_t *si_rhs = peek_stack(emit, 0);
+            stack_info_t *si_lhs = peek_stack(emit, 1);
+            uint narrow = si_lhs->narrow & si_rhs->narrow;
+            if (si_rhs->kind == STACK_IMM || si_lhs->kind == STACK_IMM) {
+                mp_int_t imm;
+                if (si_rhs->kind == STACK_IMM) {
+                    imm = si_rhs->data.u_imm;
+                    emit_pre_pop_discard(emit);
+                    emit_pre_pop_reg(emit, &vtype_lhs, REG_ARG_2);
+                } else {
+                    imm = si_lhs->data.u_imm;
+                    emit_pre_pop_reg(emit, &vtype_rhs, REG_ARG_2);
+                    emit_pre_pop_discard(emit);
+                }
+                need_reg_single(emit, REG_TEMP0, 0);
+                asm_m68k_mul_reg_imm(emit->as, REG_ARG_2, imm, REG_TEMP0, narrow & STACK_NARROW_S16);
+            } else {
+                int reg_rhs = REG_ARG_3;
+                emit_pre_pop_reg_flexible(emit, &vtype_rhs, &reg_rhs, REG_TEMP0, REG_ARG_2);
+                emit_pre_pop_reg(emit, &vtype_lhs, REG_ARG_2);
+                if (narrow & STACK_NARROW_U16) {
+                    asm_m68k_mulu_w_reg_reg(emit->as, REG_ARG_2, reg_rhs);
+                } else if (narrow & STACK_NARROW_S16) {
+                    asm_m68k_muls_w_reg_reg(emit->as, REG_ARG_2, reg_rhs);
+                } else {
+                    need_reg_single(emit, REG_TEMP0, 0);
+                    asm_m68k_mul_reg_reg(emit->as, REG_ARG_2, reg_rhs, REG_TEMP0);
+                }
+            }
+            emit_post_push_reg(emit, vtype_lhs, REG_ARG_2);
             return;
         }
-#endif
+        #endif
 
         int reg_rhs = REG_ARG_3;
         emit_pre_pop_reg_flexible(emit, &vtype_rhs, &reg_rhs, REG_RET, REG_ARG_2);
@@ -2393,11 +3447,11 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
         } else if (op == MP_BINARY_OP_SUBTRACT) {
             ASM_SUB_REG_REG(emit->as, REG_ARG_2, reg_rhs);
             emit_post_push_reg(emit, vtype_lhs, REG_ARG_2);
-#if !(MICROPY_SMALL_INT_MUL_HELPER && defined (ASM_CALL_IND_N))
+        #if !N_M68K
         } else if (op == MP_BINARY_OP_MULTIPLY) {
             ASM_MUL_REG_REG(emit->as, REG_ARG_2, reg_rhs);
             emit_post_push_reg(emit, vtype_lhs, REG_ARG_2);
-#endif
+        #endif
         } else if (op == MP_BINARY_OP_LESS
                    || op == MP_BINARY_OP_MORE
                    || op == MP_BINARY_OP_EQUAL
@@ -2542,11 +3596,11 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             #elif N_M68K
             static uint ccs[6 + 6] = {
                 // unsigned
-                ASM_M68K_CC_CC,
+                ASM_M68K_CC_CS,
                 ASM_M68K_CC_HI,
                 ASM_M68K_CC_EQ,
                 ASM_M68K_CC_LS,
-                ASM_M68K_CC_CS,
+                ASM_M68K_CC_CC,
                 ASM_M68K_CC_NE,
                 // signed
                 ASM_M68K_CC_LT,
@@ -2741,6 +3795,42 @@ STATIC void emit_native_make_closure(emit_t *emit, scope_t *scope, mp_uint_t n_c
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
 }
 
+#if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+// If the function being called may be a viper function that can be called
+// directly with these arguments, emit the direct call, guarded by a check of
+// the function object, and return true.  The generic call must follow, and
+// then asm_m68k_call_direct_done with the position in *done.
+STATIC bool emit_native_call_direct(emit_t *emit, mp_uint_t n_args, size_t *done) {
+    scope_t *callee = peek_stack(emit, n_args)->callee;
+    if (callee == NULL || callee->num_pos_args != n_args) {
+        return false;
+    }
+    uint32_t sig = emit_native_direct_sig(callee);
+    for (mp_uint_t i = 0; i < n_args; ++i) {
+        vtype_kind_t param = (sig >> (4 * i)) & 0xf;
+        stack_info_t *si = peek_stack(emit, n_args - 1 - i);
+        if (param == VTYPE_PYOBJ && si->kind == STACK_IMM && si->vtype == VTYPE_INT
+            && -0x40000000 <= si->data.u_imm && si->data.u_imm < 0x40000000) {
+            // a small int constant is boxed now, as the generic call would do
+            si->vtype = VTYPE_PYOBJ;
+            si->data.u_imm = (uintptr_t)MP_OBJ_NEW_SMALL_INT(si->data.u_imm);
+        }
+        if (!emit_native_direct_arg_ok(param, si->vtype)) {
+            return false;
+        }
+    }
+
+    // the function object and arguments are read from the stack in memory
+    need_stack_settled(emit);
+    size_t fwd[ASM_M68K_CALL_DIRECT_FWD];
+    asm_m68k_call_direct(emit->as, emit->stack_start + emit->stack_size - 1 - n_args, n_args, sig,
+        MP_F_TYPE_FUN_NATIVE, OFFSETOF_OBJ_FUN_BC_BYTECODE, fwd);
+    *done = asm_m68k_call_direct_fallback(emit->as, fwd);
+    emit->direct_calls = true;
+    return true;
+}
+#endif
+
 STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_uint_t n_keyword, mp_uint_t star_flags) {
     DEBUG_printf("call_function(n_pos=" UINT_FMT ", n_kw=" UINT_FMT ", star_flags=" UINT_FMT ")\n", n_positional, n_keyword, star_flags);
 
@@ -2755,12 +3845,29 @@ STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
         assert(!star_flags);
         DEBUG_printf("  cast to %d\n", vtype_fun);
         vtype_kind_t vtype_cast = peek_stack(emit, 1)->data.u_imm;
+        #if N_M68K && MICROPY_NATIVE_FLOAT_HELPER
+        vtype_kind_t vtype_arg = peek_vtype(emit, 0);
+        if ((vtype_cast == VTYPE_FLOAT && vtype_arg != VTYPE_PYOBJ) || vtype_arg == VTYPE_FLOAT) {
+            // casts to and from float convert the value instead of reinterpreting it
+            emit_native_float_cast(emit, vtype_cast, vtype_arg);
+            return;
+        }
+        #endif
         switch (peek_vtype(emit, 0)) {
             case VTYPE_PYOBJ: {
                 vtype_kind_t vtype;
                 emit_pre_pop_reg(emit, &vtype, REG_ARG_1);
                 emit_pre_pop_discard(emit);
-                emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, vtype_cast, REG_ARG_2); // arg2 = type
+                #if N_M68K
+                if (vtype_cast == VTYPE_INT || vtype_cast == VTYPE_UINT) {
+                    // a small int is unboxed without calling the runtime
+                    need_reg_all(emit);
+                    asm_m68k_unbox_int(emit->as, MP_F_CONVERT_OBJ_TO_NATIVE, vtype_cast);
+                } else
+                #endif
+                {
+                    emit_call_with_imm_arg(emit, MP_F_CONVERT_OBJ_TO_NATIVE, vtype_cast, REG_ARG_2); // arg2 = type
+                }
                 emit_post_push_reg(emit, vtype_cast, REG_RET);
                 break;
             }
@@ -2786,11 +3893,20 @@ STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
             emit_call_with_2_imm_args(emit, MP_F_CALL_METHOD_N_KW_VAR, 0, REG_ARG_1, n_positional | (n_keyword << 8), REG_ARG_2);
             emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
         } else {
+            #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+            size_t direct_done;
+            bool direct = n_keyword == 0 && emit_native_call_direct(emit, n_positional, &direct_done);
+            #endif
             if (n_positional != 0 || n_keyword != 0) {
                 emit_get_stack_pointer_to_reg_for_pop(emit, REG_ARG_3, n_positional + 2 * n_keyword); // pointer to args
             }
             emit_pre_pop_reg(emit, &vtype_fun, REG_ARG_1); // the function
             emit_call_with_imm_arg(emit, MP_F_NATIVE_CALL_FUNCTION_N_KW, n_positional | (n_keyword << 8), REG_ARG_2);
+            #if N_M68K && MICROPY_NATIVE_DIRECT_CALL
+            if (direct) {
+                asm_m68k_call_direct_done(emit->as, direct_done);
+            }
+            #endif
             emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
         }
     }
@@ -2844,6 +3960,13 @@ STATIC void emit_native_return_value(emit_t *emit) {
                     vtype_to_qstr(return_vtype), vtype_to_qstr(vtype));
             }
         }
+        #if N_M68K
+        if (return_vtype == VTYPE_INT) {
+            // a small int is boxed without calling the runtime
+            need_reg_all(emit);
+            asm_m68k_box_int(emit->as, MP_F_CONVERT_NATIVE_TO_OBJ, VTYPE_INT);
+        } else
+        #endif
         if (return_vtype != VTYPE_PYOBJ) {
             emit_call_with_imm_arg(emit, MP_F_CONVERT_NATIVE_TO_OBJ, return_vtype, REG_ARG_2);
             #if REG_RET != REG_PARENT_RET
@@ -2934,8 +4057,7 @@ STATIC void emit_native_yield(emit_t *emit, int kind) {
 
     if (kind == MP_EMIT_YIELD_VALUE) {
         // Check LOCAL_IDX_EXC_VAL for any injected value
-        ASM_MOV_REG_LOCAL(emit->as, REG_ARG_1, LOCAL_IDX_EXC_VAL(emit));
-        emit_call(emit, MP_F_NATIVE_RAISE);
+        emit_native_raise_exc_val(emit);
     } else {
         // Label loop entry
         emit_native_label_assign(emit, *emit->label_slot + 2);
@@ -2971,6 +4093,77 @@ STATIC void emit_native_end_except_handler(emit_t *emit) {
     adjust_stack(emit, -1); // pop the exception (end_finally didn't use it)
 }
 
+#if N_M68K
+// A loop running a given number of times, counting down in a local that is
+// not otherwise used.  The start pops the number of iterations and jumps to
+// label if there are none, the end jumps back to label for the next one.
+STATIC void emit_native_counted_loop(emit_t *emit, mp_uint_t local_num, mp_uint_t label, int kind) {
+    DEBUG_printf("counted_loop(" UINT_FMT ", label=" UINT_FMT ", %d)\n", local_num, label, kind);
+    int reg_local = emit_native_local_reg(emit, local_num);
+    emit_native_pre(emit);
+    if (kind == MP_EMIT_COUNTED_LOOP_START) {
+        // same errors as the comparison done by a range loop
+        vtype_kind_t vtype = peek_vtype(emit, 0);
+        if (vtype == VTYPE_UINT) {
+            EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("comparison of int and uint"));
+        } else if (vtype != VTYPE_INT) {
+            EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                MP_ERROR_TEXT("can't do binary op between '%q' and '%q'"),
+                vtype_to_qstr(VTYPE_INT), vtype_to_qstr(vtype));
+        }
+        emit_native_record_local_access(emit, local_num, true);
+        int reg = (reg_local >= 0 && !ASM_M68K_IS_AREG(reg_local)) ? reg_local : REG_TEMP0;
+        emit_pre_pop_reg(emit, &vtype, reg);
+        need_stack_settled(emit);
+        asm_m68k_count_start(emit->as, reg, label);
+        if (reg_local < 0) {
+            emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), reg);
+        } else if (reg != reg_local) {
+            ASM_MOV_REG_REG(emit->as, reg_local, reg);
+        }
+        if (emit->local_vtype[local_num] == VTYPE_UNBOUND) {
+            emit->local_vtype[local_num] = VTYPE_INT;
+        }
+    } else {
+        need_stack_settled(emit);
+        emit_native_record_local_access(emit, local_num, false);
+        emit_native_record_jump(emit, label);
+        if (reg_local >= 0) {
+            asm_m68k_count_jump(emit->as, reg_local, label);
+        } else {
+            asm_m68k_count_jump_local(emit->as, LOCAL_IDX_LOCAL_VAR(emit, local_num), label);
+        }
+    }
+    emit_post(emit);
+}
+
+// Bounds checks of the checked buffer in local_num.  A range check pops the
+// last and the first index, plus one, used by a loop and jumps to label unless
+// both are within the buffer; the subscripts inside the loop are then emitted
+// unchecked, each preceded by a check of kind MP_EMIT_BUF_CHECK_NONE.
+STATIC void emit_native_buf_check(emit_t *emit, mp_uint_t local_num, mp_uint_t label, int kind) {
+    DEBUG_printf("buf_check(" UINT_FMT ", label=" UINT_FMT ", %d)\n", local_num, label, kind);
+    if (kind == MP_EMIT_BUF_CHECK_NONE) {
+        emit->buf_unchecked = true;
+        return;
+    }
+    emit_native_pre(emit);
+    vtype_kind_t vtype_hi, vtype_lo;
+    emit_pre_pop_reg_reg(emit, &vtype_hi, REG_ARG_3, &vtype_lo, REG_RET);
+    need_stack_settled(emit);
+    if (vtype_lo == VTYPE_INT && vtype_hi == VTYPE_INT && VTYPE_IS_BUF(emit->local_vtype[local_num])) {
+        mp_uint_t len_local = emit_native_buf_len_local(emit, local_num);
+        emit_native_record_local_access(emit, len_local, false);
+        asm_m68k_jmp_if_range_out(emit->as, REG_RET, REG_ARG_3,
+            emit_native_local_reg(emit, len_local), LOCAL_IDX_LOCAL_VAR(emit, len_local), label);
+    } else {
+        // not known to be in range, so always run the checked loop
+        ASM_JUMP(emit->as, label);
+    }
+    emit_post(emit);
+}
+#endif
+
 const emit_method_table_t EXPORT_FUN(method_table) = {
     #if MICROPY_DYNAMIC_COMPILER
     EXPORT_FUN(new),
@@ -3039,6 +4232,14 @@ const emit_method_table_t EXPORT_FUN(method_table) = {
 
     emit_native_start_except_handler,
     emit_native_end_except_handler,
+
+    #if N_M68K
+    emit_native_counted_loop,
+    emit_native_buf_check,
+    #else
+    NULL,
+    NULL,
+    #endif
 };
 
 #endif
@@ -226,6 +226,9 @@ STATIC const uint16_t sys_mutable_keys[] = {
     #if MICROPY_PY_SYS_TRACEBACKLIMIT
     MP_QSTR_tracebacklimit,
     #endif
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    MP_QSTR_dont_write_bytecode,
+    #endif
     MP_QSTRnull,
 };
 
@@ -312,6 +312,12 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether .mpy data in memory that stays mapped while the code is in use (eg
+// ROM) can be loaded without copying its bytecode, native code and strings.
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_XIP
+#define MICROPY_PERSISTENT_CODE_LOAD_XIP (0)
+#endif
+
 // Whether to support saving of persistent code, i.e. for mpy-cross to
 // generate .mpy files. Enabling this enables additional metadata on raw code
 // objects which is also required for sys.settrace.
@@ -324,6 +330,24 @@
 #define MICROPY_PERSISTENT_CODE_SAVE_FILE (0)
 #endif
 
+// Whether modules compiled from source at import are cached as .mpy files in
+// a directory next to the source, and loaded from there while the source is
+// unchanged.  Needs MICROPY_PERSISTENT_CODE_LOAD/SAVE and MICROPY_VFS.
+#ifndef MICROPY_PERSISTENT_CODE_CACHE
+#define MICROPY_PERSISTENT_CODE_CACHE (0)
+#endif
+
+// Name of the directory holding the cached .mpy files
+#ifndef MICROPY_PERSISTENT_CODE_CACHE_DIR
+#define MICROPY_PERSISTENT_CODE_CACHE_DIR "__pycache__"
+#endif
+
+// Initial value of sys.dont_write_bytecode.  While it is true, modules are
+// still loaded from an up to date cache but are not saved to it.
+#ifndef MICROPY_PERSISTENT_CODE_CACHE_DONT_WRITE
+#define MICROPY_PERSISTENT_CODE_CACHE_DONT_WRITE (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -393,6 +417,28 @@
 #define MICROPY_EMIT_M68K (0)
 #endif
 
+// Whether to optimise m68000 native code with a peephole pass as it is emitted
+#ifndef MICROPY_EMIT_M68K_PEEPHOLE
+#define MICROPY_EMIT_M68K_PEEPHOLE (1)
+#endif
+
+// Whether to print the number of bytes saved by the m68000 peephole pass for each function
+#ifndef MICROPY_EMIT_M68K_PEEPHOLE_DEBUG
+#define MICROPY_EMIT_M68K_PEEPHOLE_DEBUG (0)
+#endif
+
+// Whether m68000 native code and inline assembler may use the instructions of
+// the 68020 and later; may be an expression, eg a port's runtime CPU detection
+#ifndef MICROPY_EMIT_M68K_68020
+#define MICROPY_EMIT_M68K_68020 (0)
+#endif
+
+// Whether m68000 native code may use 68881/68882 FPU instructions for viper
+// floats; may be an expression, eg a port's runtime FPU detection
+#ifndef MICROPY_EMIT_M68K_FPU
+#define MICROPY_EMIT_M68K_FPU (0)
+#endif
+
 // Whether to enable the m68000 inline assembler
 #ifndef MICROPY_EMIT_INLINE_M68K
 #define MICROPY_EMIT_INLINE_M68K (0)
@@ -403,6 +449,17 @@
 #define MICROPY_SMALL_INT_MUL_HELPER (0)
 #endif
 
+// Add single-precision float helper functions so viper can hold floats unboxed
+#ifndef MICROPY_NATIVE_FLOAT_HELPER
+#define MICROPY_NATIVE_FLOAT_HELPER (0)
+#endif
+
+// Add the native function type to mp_fun_table so that viper functions can
+// call each other directly, without boxing the arguments
+#ifndef MICROPY_NATIVE_DIRECT_CALL
+#define MICROPY_NATIVE_DIRECT_CALL (0)
+#endif
+
 // Convenience definition for whether any native emitter is enabled
 #define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN || MICROPY_EMIT_M68K)
 
@@ -1504,7 +1561,7 @@ typedef double mp_float_t;
 // Whether the sys module supports attribute delegation
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PY_SYS_ATTR_DELEGATION
-#define MICROPY_PY_SYS_ATTR_DELEGATION (MICROPY_PY_SYS_PATH || MICROPY_PY_SYS_PS1_PS2 || MICROPY_PY_SYS_TRACEBACKLIMIT)
+#define MICROPY_PY_SYS_ATTR_DELEGATION (MICROPY_PY_SYS_PATH || MICROPY_PY_SYS_PS1_PS2 || MICROPY_PY_SYS_TRACEBACKLIMIT || MICROPY_PERSISTENT_CODE_CACHE)
 #endif
 
 // Whether to provide "errno" module
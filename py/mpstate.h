@@ -53,6 +53,9 @@ enum {
     #if MICROPY_PY_SYS_TRACEBACKLIMIT
     MP_SYS_MUTABLE_TRACEBACKLIMIT,
     #endif
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    MP_SYS_MUTABLE_DONT_WRITE_BYTECODE,
+    #endif
     MP_SYS_MUTABLE_NUM,
 };
 #endif // MICROPY_PY_SYS_ATTR_DELEGATION
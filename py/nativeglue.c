@@ -33,6 +33,7 @@
 #include "py/smallint.h"
 #include "py/nativeglue.h"
 #include "py/gc.h"
+#include "py/binary.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_printf DEBUG_printf
@@ -60,11 +61,48 @@ int mp_native_type_from_qstr(qstr qst) {
             return MP_NATIVE_TYPE_PTR16;
         case MP_QSTR_ptr32:
             return MP_NATIVE_TYPE_PTR32;
+        #if MICROPY_NATIVE_FLOAT_HELPER && MICROPY_EMIT_M68K
+        case MP_QSTR_float:
+            // only the m68k emitter can hold floats unboxed
+            #if MICROPY_DYNAMIC_COMPILER
+            if (mp_dynamic_compiler.native_arch < MP_NATIVE_ARCH_M68K) {
+                return -1;
+            }
+            #endif
+            return MP_NATIVE_TYPE_FLOAT;
+        #endif
         default:
             return -1;
     }
 }
 
+// The checked buffer type for an argument annotated with the given array
+// typecode, or -1.  8 and 16-bit loads zero extend, so only the unsigned
+// typecodes are accepted for them.
+int mp_native_buf_type_from_typecode(int typecode) {
+    #if MICROPY_EMIT_M68K
+    #if MICROPY_DYNAMIC_COMPILER
+    if (mp_dynamic_compiler.native_arch < MP_NATIVE_ARCH_M68K) {
+        return -1;
+    }
+    #endif
+    switch (typecode) {
+        case 'B':
+            return MP_NATIVE_TYPE_BUF8;
+        case 'H':
+            return MP_NATIVE_TYPE_BUF16;
+        case 'i':
+        case 'I':
+        case 'l':
+        case 'L':
+            return MP_NATIVE_TYPE_BUF32;
+    }
+    #else
+    (void)typecode;
+    #endif
+    return -1;
+}
+
 // convert a MicroPython object to a valid native value based on type
 mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type) {
     DEBUG_printf("mp_native_from_obj(%p, " UINT_FMT ")\n", obj, type);
@@ -76,6 +114,31 @@ mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type) {
         case MP_NATIVE_TYPE_INT:
         case MP_NATIVE_TYPE_UINT:
             return mp_obj_get_int_truncated(obj);
+        #if MICROPY_NATIVE_FLOAT_HELPER
+        case MP_NATIVE_TYPE_FLOAT:
+            return mp_native_float_new(mp_obj_get_float(obj));
+        #endif
+        #if MICROPY_EMIT_M68K
+        case MP_NATIVE_TYPE_BUF8:
+        case MP_NATIVE_TYPE_BUF16:
+        case MP_NATIVE_TYPE_BUF32: {
+            // the buffer's items must have the size the code was compiled for
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
+            size_t size = 1 << ((type & 0xf) - MP_NATIVE_TYPE_BUF8);
+            size_t item_size = bufinfo.typecode == BYTEARRAY_TYPECODE ? 1 : mp_binary_get_size('@', bufinfo.typecode, NULL);
+            if (item_size != size) {
+                mp_raise_TypeError(MP_ERROR_TEXT("wrong buffer item size"));
+            }
+            if (size > 1 && ((uintptr_t)bufinfo.buf & 1)) {
+                mp_raise_ValueError(MP_ERROR_TEXT("buffer not aligned"));
+            }
+            if (type & MP_NATIVE_TYPE_BUF_LEN) {
+                return bufinfo.len / size;
+            }
+            return (mp_uint_t)bufinfo.buf;
+        }
+        #endif
         default: { // cast obj to a pointer
             mp_buffer_info_t bufinfo;
             if (mp_get_buffer(obj, &bufinfo, MP_BUFFER_READ)) {
@@ -106,6 +169,10 @@ mp_obj_t mp_native_to_obj(mp_uint_t val, mp_uint_t type) {
             return mp_obj_new_int_from_uint(val);
         case MP_NATIVE_TYPE_QSTR:
             return MP_OBJ_NEW_QSTR(val);
+        #if MICROPY_NATIVE_FLOAT_HELPER
+        case MP_NATIVE_TYPE_FLOAT:
+            return mp_obj_new_float(mp_native_float_get(val));
+        #endif
         default: // a pointer
             // we return just the value of the pointer as an integer
             return mp_obj_new_int_from_uint(val);
@@ -253,6 +320,57 @@ STATIC double mp_obj_get_float_to_d(mp_obj_t o) {
 
 #endif
 
+#if MICROPY_NATIVE_FLOAT_HELPER
+
+STATIC mp_uint_t mp_native_float_add(mp_uint_t lhs, mp_uint_t rhs) {
+    return mp_native_float_new(mp_native_float_get(lhs) + mp_native_float_get(rhs));
+}
+
+STATIC mp_uint_t mp_native_float_sub(mp_uint_t lhs, mp_uint_t rhs) {
+    return mp_native_float_new(mp_native_float_get(lhs) - mp_native_float_get(rhs));
+}
+
+STATIC mp_uint_t mp_native_float_mul(mp_uint_t lhs, mp_uint_t rhs) {
+    return mp_native_float_new(mp_native_float_get(lhs) * mp_native_float_get(rhs));
+}
+
+// like viper integer ops this doesn't raise, dividing by zero gives inf or nan
+STATIC mp_uint_t mp_native_float_div(mp_uint_t lhs, mp_uint_t rhs) {
+    return mp_native_float_new(mp_native_float_get(lhs) / mp_native_float_get(rhs));
+}
+
+// returns -1, 0 or 1 if lhs is less than, equal to or greater than rhs, and 2 if unordered
+STATIC mp_int_t mp_native_float_cmp(mp_uint_t lhs, mp_uint_t rhs) {
+    float a = mp_native_float_get(lhs);
+    float b = mp_native_float_get(rhs);
+    if (a < b) {
+        return -1;
+    } else if (a == b) {
+        return 0;
+    } else if (a > b) {
+        return 1;
+    } else {
+        return 2;
+    }
+}
+
+STATIC mp_uint_t mp_native_float_from_int(mp_int_t val) {
+    return mp_native_float_new((float)val);
+}
+
+STATIC mp_int_t mp_native_float_to_int(mp_uint_t val) {
+    float f = mp_native_float_get(val);
+    if (f != f) {
+        mp_raise_ValueError(MP_ERROR_TEXT("can't convert NaN to int"));
+    }
+    if (!(f >= -2147483648.0f && f < 2147483648.0f)) {
+        mp_raise_msg(&mp_type_OverflowError, MP_ERROR_TEXT("overflow converting long int to machine word"));
+    }
+    return (mp_int_t)f;
+}
+
+#endif
+
 // these must correspond to the respective enum in nativeglue.h
 const mp_fun_table_t mp_fun_table = {
     mp_const_none,
@@ -347,6 +465,18 @@ const mp_fun_table_t mp_fun_table = {
     #if MICROPY_SMALL_INT_MUL_HELPER
     mp_small_int_multiply,
     #endif
+    #if MICROPY_NATIVE_FLOAT_HELPER
+    mp_native_float_add,
+    mp_native_float_sub,
+    mp_native_float_mul,
+    mp_native_float_div,
+    mp_native_float_cmp,
+    mp_native_float_from_int,
+    mp_native_float_to_int,
+    #endif
+    #if MICROPY_NATIVE_DIRECT_CALL
+    &mp_type_fun_native,
+    #endif
 };
 
 #elif MICROPY_EMIT_NATIVE && MICROPY_DYNAMIC_COMPILER
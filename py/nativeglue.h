@@ -27,6 +27,7 @@
 #define MICROPY_INCLUDED_PY_NATIVEGLUE_H
 
 #include <stdarg.h>
+#include <stddef.h>
 #include "py/obj.h"
 #include "py/persistentcode.h"
 #include "py/stream.h"
@@ -173,10 +174,57 @@ typedef struct _mp_fun_table_t {
     #if MICROPY_SMALL_INT_MUL_HELPER
     mp_int_t (*small_int_multiply)(mp_int_t num, mp_int_t mulp);
     #endif
+    #if MICROPY_NATIVE_FLOAT_HELPER
+    // viper floats are passed as the bits of an IEEE-754 single
+    mp_uint_t (*float_add)(mp_uint_t lhs, mp_uint_t rhs);
+    mp_uint_t (*float_sub)(mp_uint_t lhs, mp_uint_t rhs);
+    mp_uint_t (*float_mul)(mp_uint_t lhs, mp_uint_t rhs);
+    mp_uint_t (*float_div)(mp_uint_t lhs, mp_uint_t rhs);
+    mp_int_t (*float_cmp)(mp_uint_t lhs, mp_uint_t rhs);
+    mp_uint_t (*float_from_int)(mp_int_t val);
+    mp_int_t (*float_to_int)(mp_uint_t val);
+    #endif
+    #if MICROPY_NATIVE_DIRECT_CALL
+    const mp_obj_type_t *type_fun_native;
+    #endif
 } mp_fun_table_t;
 
+#define MP_F_INDEX_OF(member)       (offsetof(mp_fun_table_t, member) / sizeof(void *))
+
 #if MICROPY_SMALL_INT_MUL_HELPER
-#define MP_F_SMALL_INT_MULTIPLY     ((sizeof(mp_fun_table_t) / sizeof(void *))- 1)
+#define MP_F_SMALL_INT_MULTIPLY     MP_F_INDEX_OF(small_int_multiply)
+#endif
+
+#if MICROPY_NATIVE_FLOAT_HELPER
+#define MP_F_FLOAT_ADD              MP_F_INDEX_OF(float_add)
+#define MP_F_FLOAT_SUB              MP_F_INDEX_OF(float_sub)
+#define MP_F_FLOAT_MUL              MP_F_INDEX_OF(float_mul)
+#define MP_F_FLOAT_DIV              MP_F_INDEX_OF(float_div)
+#define MP_F_FLOAT_CMP              MP_F_INDEX_OF(float_cmp)
+#define MP_F_FLOAT_FROM_INT         MP_F_INDEX_OF(float_from_int)
+#define MP_F_FLOAT_TO_INT           MP_F_INDEX_OF(float_to_int)
+#endif
+
+#if MICROPY_NATIVE_DIRECT_CALL
+#define MP_F_TYPE_FUN_NATIVE        MP_F_INDEX_OF(type_fun_native)
+#endif
+
+#if MICROPY_NATIVE_FLOAT_HELPER
+// Conversion between a float and the bits of an unboxed viper float
+typedef union _mp_native_float_t {
+    float f;
+    uint32_t u;
+} mp_native_float_t;
+
+static inline float mp_native_float_get(mp_uint_t val) {
+    mp_native_float_t v = { .u = val };
+    return v.f;
+}
+
+static inline mp_uint_t mp_native_float_new(float f) {
+    mp_native_float_t v = { .f = f };
+    return v.u;
+}
 #endif
 
 #if (MICROPY_EMIT_NATIVE && !MICROPY_DYNAMIC_COMPILER) || MICROPY_ENABLE_DYNRUNTIME
@@ -44,6 +44,8 @@
 #define MICROPY_NLR_NUM_REGS_MIPS           (13)
 #define MICROPY_NLR_NUM_REGS_XTENSA         (10)
 #define MICROPY_NLR_NUM_REGS_XTENSAWIN      (17)
+#define MICROPY_NLR_NUM_REGS_M68K           (13)
+#define MICROPY_NLR_NUM_REGS_M68K_FP        (13 + 18)
 
 // *FORMAT-OFF*
 
@@ -88,6 +90,14 @@
 #elif defined(__mips__)
     #define MICROPY_NLR_MIPS (1)
     #define MICROPY_NLR_NUM_REGS (MICROPY_NLR_NUM_REGS_MIPS)
+#elif defined(__m68k__)
+    #define MICROPY_NLR_M68K (1)
+    #if defined(__HAVE_68881__)
+        // fp2-fp7 are callee save and take 3 words each
+        #define MICROPY_NLR_NUM_REGS (MICROPY_NLR_NUM_REGS_M68K_FP)
+    #else
+        #define MICROPY_NLR_NUM_REGS (MICROPY_NLR_NUM_REGS_M68K)
+    #endif
 #else
     #define MICROPY_NLR_SETJMP (1)
     //#warning "No native NLR support for this arch, using setjmp implementation"
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Yuichi Nakamura
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "py/mpstate.h"
+
+#if MICROPY_NLR_M68K
+
+#undef nlr_push
+
+// For reference, m68k callee save regs are:
+//  d2-d7, a2-a6, sp, pc (and fp2-fp7 with a 68881)
+//
+// They are stored in nlr_buf_t.regs in this order, so that the native emitter
+// finds d4 (REG_LOCAL_1) at regs[2].  gcc for m68k has no naked attribute, so
+// nlr_push is written as a top-level asm block.  It is called with the C
+// calling convention: the return address at (sp) and nlr_buf at 4(sp).
+
+__asm__ (
+    "    .text                          \n"
+    "    .even                          \n"
+    "    .globl  nlr_push               \n"
+    "    .type   nlr_push, @function    \n"
+    "nlr_push:                          \n"
+    "    move.l  4(%sp), %a0            \n" // load nlr_buf
+    "    movem.l %d2-%d7/%a2-%a6, 8(%a0)\n" // store callee-save regs into nlr_buf
+    "    move.l  %sp, 52(%a0)           \n" // store %sp into nlr_buf
+    "    move.l  (%sp), 56(%a0)         \n" // store return %pc into nlr_buf
+    #if defined(__HAVE_68881__)
+    "    fmovem.x %fp2-%fp7, 60(%a0)    \n" // store callee-save fp regs into nlr_buf
+    #endif
+    "    jra     nlr_push_tail          \n" // do the rest in C
+    "    .size   nlr_push, .-nlr_push   \n"
+    );
+
+NORETURN void nlr_jump(void *val) {
+    MP_NLR_JUMP_HEAD(val, top)
+
+    __asm volatile (
+        "move.l  %0, %%a0               \n" // %a0 points to nlr_buf
+        #if defined(__HAVE_68881__)
+        "fmovem.x 60(%%a0), %%fp2-%%fp7 \n" // load saved fp regs
+        #endif
+        "movem.l 8(%%a0), %%d2-%%d7/%%a2-%%a6\n" // load saved callee-save regs
+        "move.l  52(%%a0), %%sp         \n" // load saved %sp
+        "move.l  56(%%a0), (%%sp)       \n" // store saved %pc to stack
+        "moveq   #1, %%d0               \n" // non-local return
+        "rts                            \n" // return
+        :                               // output operands
+        : "r" (top)                     // input operands
+        : "memory"                      // clobbered registers
+        );
+
+    MP_UNREACHABLE
+}
+
+#endif // MICROPY_NLR_M68K
@@ -44,6 +44,8 @@
 
 #if MICROPY_DYNAMIC_COMPILER
 #define MPY_FEATURE_ARCH_DYNAMIC mp_dynamic_compiler.native_arch
+#elif defined(MPY_FEATURE_ARCH_RUNTIME)
+#define MPY_FEATURE_ARCH_DYNAMIC MPY_FEATURE_ARCH_RUNTIME
 #else
 #define MPY_FEATURE_ARCH_DYNAMIC MPY_FEATURE_ARCH
 #endif
@@ -69,6 +71,35 @@ STATIC size_t read_uint(mp_reader_t *reader);
 
 #if MICROPY_EMIT_MACHINE_CODE
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// Native code and viper rodata are used in place only when suitably aligned
+#if MICROPY_EMIT_X86 || MICROPY_EMIT_X64
+#define NATIVE_CODE_ALIGN (1)
+#elif MICROPY_EMIT_M68K
+#define NATIVE_CODE_ALIGN (2)
+#else
+#define NATIVE_CODE_ALIGN (sizeof(uintptr_t))
+#endif
+#define NATIVE_CODE_IS_ALIGNED(p) (((uintptr_t)(p) & (NATIVE_CODE_ALIGN - 1)) == 0)
+
+// Native code can run in place unless it needs relocating or the port copies it
+// to executable memory anyway
+#if defined(MP_PLAT_COMMIT_EXEC)
+#define NATIVE_CODE_CAN_XIP(code, scope_flags) (false)
+#else
+#define NATIVE_CODE_CAN_XIP(code, scope_flags) \
+    (!((scope_flags) & MP_SCOPE_FLAG_VIPERRELOC) && NATIVE_CODE_IS_ALIGNED(code))
+#endif
+#endif
+
+// Relocation addresses are counted in units of machine words, except on m68k
+// where words in code and data are only aligned to 16 bits.
+#if MICROPY_EMIT_M68K
+#define NATIVE_RELOC_UNIT (2)
+#else
+#define NATIVE_RELOC_UNIT (sizeof(uintptr_t))
+#endif
+
 typedef struct _reloc_info_t {
     mp_reader_t *reader;
     mp_module_context_t *context;
@@ -80,17 +111,17 @@ void mp_native_relocate(void *ri_in, uint8_t *text, uintptr_t reloc_text) {
     // Relocate native code
     reloc_info_t *ri = ri_in;
     uint8_t op;
-    uintptr_t *addr_to_adjust = NULL;
+    uint8_t *addr_to_adjust = NULL;
     while ((op = read_byte(ri->reader)) != 0xff) {
         if (op & 1) {
             // Point to new location to make adjustments
             size_t addr = read_uint(ri->reader);
             if ((addr & 1) == 0) {
                 // Point to somewhere in text
-                addr_to_adjust = &((uintptr_t *)text)[addr >> 1];
+                addr_to_adjust = text + (addr >> 1) * NATIVE_RELOC_UNIT;
             } else {
                 // Point to somewhere in rodata
-                addr_to_adjust = &((uintptr_t *)ri->rodata)[addr >> 1];
+                addr_to_adjust = ri->rodata + (addr >> 1) * NATIVE_RELOC_UNIT;
             }
         }
         op >>= 1;
@@ -126,7 +157,8 @@ void mp_native_relocate(void *ri_in, uint8_t *text, uintptr_t reloc_text) {
             dest = ((uintptr_t *)&mp_fun_table)[op - 9];
         }
         while (n--) {
-            *addr_to_adjust++ += dest;
+            *(uintptr_t *)addr_to_adjust += dest;
+            addr_to_adjust += sizeof(uintptr_t);
         }
     }
 }
@@ -143,6 +175,12 @@ STATIC void read_bytes(mp_reader_t *reader, byte *buf, size_t len) {
     }
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+#define read_rom(reader, len) mp_reader_try_read_rom((reader), (len))
+#else
+#define read_rom(reader, len) ((const byte *)NULL)
+#endif
+
 STATIC size_t read_uint(mp_reader_t *reader) {
     size_t unum = 0;
     for (;;) {
@@ -162,6 +200,10 @@ STATIC qstr load_qstr(mp_reader_t *reader) {
         return len >> 1;
     }
     len >>= 1;
+    const byte *rom = read_rom(reader, len + 1);
+    if (rom != NULL) {
+        return qstr_from_strn_static((const char *)rom, len);
+    }
     char *str = m_new(char, len);
     read_bytes(reader, (byte *)str, len);
     read_byte(reader); // read and discard null terminator
@@ -197,6 +239,26 @@ STATIC mp_obj_t load_obj(mp_reader_t *reader) {
             }
             return MP_OBJ_FROM_PTR(tuple);
         }
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        if (obj_type == MP_PERSISTENT_OBJ_STR || obj_type == MP_PERSISTENT_OBJ_BYTES) {
+            const byte *rom = read_rom(reader, len + 1);
+            if (rom != NULL) {
+                if (obj_type == MP_PERSISTENT_OBJ_STR) {
+                    // Use an existing qstr, as mp_obj_new_str_from_utf8_vstr() does
+                    qstr q = qstr_find_strn((const char *)rom, len);
+                    if (q != MP_QSTRnull) {
+                        return MP_OBJ_NEW_QSTR(q);
+                    }
+                }
+                // Refer to the data (and its null terminator) where it is
+                mp_obj_str_t *o = mp_obj_malloc(mp_obj_str_t, obj_type == MP_PERSISTENT_OBJ_STR ? &mp_type_str : &mp_type_bytes);
+                o->hash = qstr_compute_hash(rom, len);
+                o->len = len;
+                o->data = rom;
+                return MP_OBJ_FROM_PTR(o);
+            }
+        }
+        #endif
         vstr_t vstr;
         vstr_init_len(&vstr, len);
         read_bytes(reader, (byte *)vstr.buf, len);
@@ -238,17 +300,26 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
     #endif
 
     if (kind == MP_CODE_BYTECODE) {
-        // Allocate memory for the bytecode
-        fun_data = m_new(uint8_t, fun_data_len);
-        // Load bytecode
-        read_bytes(reader, fun_data, fun_data_len);
+        // Use the bytecode in place if possible
+        fun_data = (uint8_t *)read_rom(reader, fun_data_len);
+        if (fun_data == NULL) {
+            // Allocate memory for the bytecode
+            fun_data = m_new(uint8_t, fun_data_len);
+            // Load bytecode
+            read_bytes(reader, fun_data, fun_data_len);
+        }
 
     #if MICROPY_EMIT_MACHINE_CODE
     } else {
-        // Allocate memory for native data and load it
-        size_t fun_alloc;
-        MP_PLAT_ALLOC_EXEC(fun_data_len, (void **)&fun_data, &fun_alloc);
-        read_bytes(reader, fun_data, fun_data_len);
+        // Refer to native data in place if possible, otherwise allocate memory
+        // for it and load it
+        const byte *fun_rom = read_rom(reader, fun_data_len);
+        fun_data = (uint8_t *)fun_rom;
+        if (fun_data == NULL) {
+            size_t fun_alloc;
+            MP_PLAT_ALLOC_EXEC(fun_data_len, (void **)&fun_data, &fun_alloc);
+            read_bytes(reader, fun_data, fun_data_len);
+        }
 
         if (kind == MP_CODE_NATIVE_PY) {
             // Read prelude offset within fun_data, and extract scope flags.
@@ -264,6 +335,16 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
                 native_type_sig = read_uint(reader);
             }
         }
+
+        #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+        if (fun_rom != NULL && !NATIVE_CODE_CAN_XIP(fun_rom, native_scope_flags)) {
+            // The code is modified when loaded, or cannot run where it is, so
+            // it must be copied
+            size_t fun_alloc;
+            MP_PLAT_ALLOC_EXEC(fun_data_len, (void **)&fun_data, &fun_alloc);
+            memcpy(fun_data, fun_rom, fun_data_len);
+        }
+        #endif
     #endif
     }
 
@@ -287,11 +368,26 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
 
         if (rodata_size + bss_size != 0) {
             bss_size = (uintptr_t)MP_ALIGN(bss_size, sizeof(uintptr_t));
+            const byte *rodata_rom = NULL;
+            if ((native_scope_flags & (MP_SCOPE_FLAG_VIPERRODATA | MP_SCOPE_FLAG_VIPERRELOC)) == MP_SCOPE_FLAG_VIPERRODATA) {
+                // Rodata that is not relocated can be used in place if aligned
+                rodata_rom = read_rom(reader, rodata_size);
+                #if MICROPY_PERSISTENT_CODE_LOAD_XIP
+                if (rodata_rom != NULL && NATIVE_CODE_IS_ALIGNED(rodata_rom)) {
+                    rodata = (uint8_t *)rodata_rom;
+                    rodata_size = 0;
+                }
+                #endif
+            }
             uint8_t *data = m_new0(uint8_t, bss_size + rodata_size);
             bss = data;
-            rodata = bss + bss_size;
-            if (native_scope_flags & MP_SCOPE_FLAG_VIPERRODATA) {
-                read_bytes(reader, rodata, rodata_size);
+            if (rodata == NULL) {
+                rodata = bss + bss_size;
+                if (rodata_rom != NULL) {
+                    memcpy(rodata, rodata_rom, rodata_size);
+                } else if (native_scope_flags & MP_SCOPE_FLAG_VIPERRODATA) {
+                    read_bytes(reader, rodata, rodata_size);
+                }
             }
 
             // Viper code with BSS/rodata should not have any children.
@@ -449,6 +545,18 @@ void mp_raw_code_load_mem(const byte *buf, size_t len, mp_compiled_module_t *con
     mp_raw_code_load(&reader, context);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+
+// Load .mpy data that stays at buf, referring to it instead of copying it
+// where possible.
+void mp_raw_code_load_rom(const byte *buf, size_t len, mp_compiled_module_t *context) {
+    mp_reader_t reader;
+    mp_reader_new_mem(&reader, buf, len, MP_READER_IS_ROM);
+    mp_raw_code_load(&reader, context);
+}
+
+#endif
+
 #if MICROPY_HAS_FILE_READER
 
 void mp_raw_code_load_file(const char *filename, mp_compiled_module_t *context) {
@@ -73,6 +73,14 @@
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_XTENSAWIN)
 #elif MICROPY_EMIT_M68K
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_M68K)
+    // Code for a 68020 or later, with or without an FPU, is only accepted when
+    // the CPU running it has one; these may be runtime checks, see mpconfig.h
+    #define MPY_FEATURE_ARCH_TEST(x) ((x) == MP_NATIVE_ARCH_M68K \
+        || ((x) == MP_NATIVE_ARCH_M68K020 && MICROPY_EMIT_M68K_68020) \
+        || ((x) == MP_NATIVE_ARCH_M68K020FPU && MICROPY_EMIT_M68K_68020 && MICROPY_EMIT_M68K_FPU))
+    // Native code compiled at runtime uses the instructions of the running CPU
+    #define MPY_FEATURE_ARCH_RUNTIME (!MICROPY_EMIT_M68K_68020 ? MP_NATIVE_ARCH_M68K \
+        : MICROPY_EMIT_M68K_FPU ? MP_NATIVE_ARCH_M68K020FPU : MP_NATIVE_ARCH_M68K020)
 #else
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_NONE)
 #endif
@@ -98,6 +106,8 @@ enum {
     MP_NATIVE_ARCH_XTENSA,
     MP_NATIVE_ARCH_XTENSAWIN,
     MP_NATIVE_ARCH_M68K,
+    MP_NATIVE_ARCH_M68K020,
+    MP_NATIVE_ARCH_M68K020FPU,
 };
 
 enum {
@@ -116,6 +126,7 @@ enum {
 
 void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *ctx);
 void mp_raw_code_load_mem(const byte *buf, size_t len, mp_compiled_module_t *ctx);
+void mp_raw_code_load_rom(const byte *buf, size_t len, mp_compiled_module_t *ctx);
 void mp_raw_code_load_file(const char *filename, mp_compiled_module_t *ctx);
 
 void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print);
@@ -83,6 +83,7 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	nlrmips.o \
 	nlrpowerpc.o \
 	nlrxtensa.o \
+	nlrm68k.o \
 	nlrsetjmp.o \
 	malloc.o \
 	gc.o \
@@ -33,7 +33,7 @@
 #include "py/reader.h"
 
 typedef struct _mp_reader_mem_t {
-    size_t free_len; // if >0 mem is freed on close by: m_free(beg, free_len)
+    size_t free_len; // if >0 mem is freed on close by: m_free(beg, free_len), unless MP_READER_IS_ROM
     const byte *beg;
     const byte *cur;
     const byte *end;
@@ -50,7 +50,7 @@ STATIC mp_uint_t mp_reader_mem_readbyte(void *data) {
 
 STATIC void mp_reader_mem_close(void *data) {
     mp_reader_mem_t *reader = (mp_reader_mem_t *)data;
-    if (reader->free_len > 0) {
+    if (reader->free_len > 0 && reader->free_len != MP_READER_IS_ROM) {
         m_del(char, (char *)reader->beg, reader->free_len);
     }
     m_del_obj(mp_reader_mem_t, reader);
@@ -67,6 +67,23 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
     reader->close = mp_reader_mem_close;
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_XIP
+// If the reader reads from ROM, return a pointer to the next len bytes and skip
+// over them; otherwise return NULL and leave the reader as it is.
+const byte *mp_reader_try_read_rom(mp_reader_t *reader, size_t len) {
+    if (reader->readbyte != mp_reader_mem_readbyte) {
+        return NULL;
+    }
+    mp_reader_mem_t *rm = reader->data;
+    if (rm->free_len != MP_READER_IS_ROM || (size_t)(rm->end - rm->cur) < len) {
+        return NULL;
+    }
+    const byte *data = rm->cur;
+    rm->cur += len;
+    return data;
+}
+#endif
+
 #if MICROPY_READER_POSIX
 
 #include <sys/stat.h>
@@ -39,7 +39,12 @@ typedef struct _mp_reader_t {
     void (*close)(void *data);
 } mp_reader_t;
 
+// free_len for mp_reader_new_mem() when buf stays mapped at the same address
+// for as long as anything read from it is in use
+#define MP_READER_IS_ROM ((size_t)-1)
+
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len);
+const byte *mp_reader_try_read_rom(mp_reader_t *reader, size_t len);
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
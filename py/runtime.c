@@ -156,6 +156,10 @@ void mp_init(void) {
     MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_PS2]) = MP_OBJ_NEW_QSTR(MP_QSTR__dot__dot__dot__space_);
     #endif
 
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    MP_STATE_VM(sys_mutable[MP_SYS_MUTABLE_DONT_WRITE_BYTECODE]) = mp_obj_new_bool(MICROPY_PERSISTENT_CODE_CACHE_DONT_WRITE);
+    #endif
+
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
@@ -239,6 +239,7 @@ NORETURN void mp_raise_recursion_depth(void);
 
 // helper functions for native/viper code
 int mp_native_type_from_qstr(qstr qst);
+int mp_native_buf_type_from_typecode(int typecode);
 mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type);
 mp_obj_t mp_native_to_obj(mp_uint_t val, mp_uint_t type);
 
@@ -35,7 +35,7 @@
 #define MP_SCOPE_FLAG_DEFKWARGS    (0x08)
 #define MP_SCOPE_FLAG_REFGLOBALS   (0x10) // used only if native emitter enabled
 #define MP_SCOPE_FLAG_HASCONSTS    (0x20) // used only if native emitter enabled
-#define MP_SCOPE_FLAG_VIPERRET_POS    (6) // 3 bits used for viper return type, to pass from compiler to native emitter
+#define MP_SCOPE_FLAG_VIPERRET_POS    (6) // 4 bits used for viper return type, to pass from compiler to native emitter
 #define MP_SCOPE_FLAG_VIPERRELOC   (0x10) // used only when loading viper from .mpy
 #define MP_SCOPE_FLAG_VIPERRODATA  (0x20) // used only when loading viper from .mpy
 #define MP_SCOPE_FLAG_VIPERBSS     (0x40) // used only when loading viper from .mpy
@@ -53,6 +53,17 @@
 // Not use for viper, but for dynamic native modules
 #define MP_NATIVE_TYPE_QSTR (0x08)
 
+// Unboxed single-precision float, only with MICROPY_NATIVE_FLOAT_HELPER
+#define MP_NATIVE_TYPE_FLOAT (0x09)
+
+// Bounds-checked buffers of 8, 16 and 32-bit items, only for viper arguments
+// on m68k.  With MP_NATIVE_TYPE_BUF_LEN added, mp_native_from_obj returns the
+// number of items instead of the address.
+#define MP_NATIVE_TYPE_BUF8 (0x0a)
+#define MP_NATIVE_TYPE_BUF16 (0x0b)
+#define MP_NATIVE_TYPE_BUF32 (0x0c)
+#define MP_NATIVE_TYPE_BUF_LEN (0x10)
+
 // Bytecode and runtime boundaries for unary ops
 #define MP_UNARY_OP_NUM_BYTECODE    (MP_UNARY_OP_NOT + 1)
 #define MP_UNARY_OP_NUM_RUNTIME     (MP_UNARY_OP_SIZEOF + 1)
@@ -75,6 +75,9 @@ typedef struct _scope_t {
     struct _scope_t *parent;
     struct _scope_t *next;
     mp_parse_node_t pn;
+    #if MICROPY_EMIT_INLINE_ASM
+    mp_parse_node_t pn_asm_options; // arguments to the inline assembler decorator
+    #endif
     mp_raw_code_t *raw_code;
     uint16_t simple_name; // a qstr
     uint16_t scope_flags;  // see runtime0.h
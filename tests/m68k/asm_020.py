@@ -0,0 +1,85 @@
+# 68020 additions to the instruction set
+import micropython
+
+# CPU 68020
+
+
+@micropython.asm_m68k
+def mul32(a, b):
+    movel([8, fp], d0)
+    mulsl([12, fp], d0)
+
+
+# TEST mul32(70000, 70000) -> (70000 * 70000) - (1 << 32)
+# TEST mul32(-12345, 6789) -> -12345 * 6789
+
+
+@micropython.asm_m68k
+def divmod32(a, b):
+    movel([8, fp], d0)
+    divsl([12, fp], d1, d0)
+    mulul(1000, d0)
+    addl(d1, d0)
+
+
+# TEST divmod32(123456789, 100000) -> 1234 * 1000 + 56789
+# TEST divmod32(-7, 2) -> -3 * 1000 - 1
+
+
+@micropython.asm_m68k
+def sext(a):
+    movel([8, fp], d0)
+    extbl(d0)
+
+
+# TEST sext(0x1280) -> -128
+# TEST sext(0x7f) -> 127
+
+
+@micropython.asm_m68k
+def bitfield(a):
+    movel([8, fp], d1)
+    bfextu(d1, 4, 12, d0)
+    bfexts(d1, 0, 4, d2)
+    addl(d2, d0)
+    moveq(12, d2)
+    bfins(d2, d0, 28, 4)
+
+
+# TEST bitfield(0x9abcdef0) -> 0xabc
+
+
+@micropython.asm_m68k
+def bfmem(buf, off):
+    moveal([8, fp], a0)
+    movel([12, fp], d1)
+    bfset([a0], d1, 8)
+    bfffo([a0], 0, 32, d0)
+
+
+# SETUP m = bytearray(4)
+# TEST bfmem(m, 12) -> 12
+# CHECK m == b"\x00\x0f\xf0\x00"
+
+
+@micropython.asm_m68k
+def index4(buf, i):
+    moveal([8, fp], a0)
+    movel([12, fp], d0)
+    movel([0, a0, d0.l * 4], d0)
+
+
+# SETUP words = bytearray(b"\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00\x03")
+# TEST index4(words, 2) -> 3
+
+
+@micropython.asm_m68k
+def farbranch(a):
+    movel([8, fp], d0)
+    bral(skip)
+    data(4, 0, 1, 2, 3)
+    label(skip)
+    addql(1, d0)
+
+
+# TEST farbranch(41) -> 42
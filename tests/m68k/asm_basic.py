@@ -0,0 +1,75 @@
+import micropython
+
+
+@micropython.asm_m68k
+def add(a, b):
+    movel([8, fp], d0)
+    addl([12, fp], d0)
+
+
+# TEST add(1, 2) -> 3
+# TEST add(-5, 2) -> -3
+
+
+@micropython.asm_m68k
+def sumbuf(buf, n):
+    moveal([8, fp], a0)
+    movel([12, fp], d1)
+    moveq(0, d0)
+    moveq(0, d2)
+    bras(loop_end)
+    label(loop)
+    moveb([a0.inc], d2)
+    addl(d2, d0)
+    label(loop_end)
+    dbra(d1, loop)
+
+
+# SETUP b = bytearray(range(100, 200))
+# TEST sumbuf(b, 100) -> sum(range(100, 200))
+
+
+@micropython.asm_m68k
+def fill(buf, n, v):
+    moveal([8, fp], a0)
+    movel([12, fp], d1)
+    movel([16, fp], d0)
+    subql(1, d1)
+    label(loop)
+    movew(d0, [a0.inc])
+    dbra(d1, loop)
+
+
+# SETUP w = bytearray(8)
+# TEST fill(w, 4, 0x1234) -> 0x1234
+# CHECK w == b'\x12\x34' * 4
+
+
+@micropython.asm_m68k
+def regs(a):
+    movel([8, fp], d7)
+    moveal(d7, a5)
+    moveml({d3 - d7, a2 - a5}, [sp.dec])
+    moveq(0, d3)
+    moveq(0, d7)
+    subal(a2, a2)
+    moveml([sp.inc], {d3 - d7, a2 - a5})
+    movel(a5, d0)
+    muluw(3, d0)
+
+
+# TEST regs(7) -> 21
+
+
+@micropython.asm_m68k
+def alu(a, b):
+    movel([8, fp], d0)
+    movel([12, fp], d1)
+    movel(d0, d2)
+    subl(d1, d2)
+    andl(d1, d0)
+    orl(d2, d0)
+    eorl(d1, d0)
+
+
+# TEST alu(0x5a5a, 0x0ff0) -> (((0x5a5a & 0x0ff0) | (0x5a5a - 0x0ff0)) ^ 0x0ff0)
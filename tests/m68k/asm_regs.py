@@ -0,0 +1,94 @@
+import micropython
+
+
+@micropython.asm_m68k
+def add(a, b):
+    movel([8, fp], d0)
+    addl([12, fp], d0)
+
+
+@micropython.asm_m68k(regs="d0-d1", save="auto")
+def addr(a, b):
+    addl(d1, d0)
+
+
+# TEST add(1, 2) -> 3
+# TEST addr(1, 2) -> 3
+# TEST addr(-5, 2) -> -3
+# BENCH add(1, 2)
+# BENCH addr(1, 2)
+
+
+@micropython.asm_m68k(regs="d0-d3", save="auto")
+def sum4(a, b, c, d):
+    addl(d1, d0)
+    addl(d2, d0)
+    addl(d3, d0)
+
+
+# TEST sum4(1, 20, 300, 4000) -> 4321
+
+
+@micropython.asm_m68k(regs="d0-d3", save="auto")
+def one(a):
+    addql(1, d0)
+
+
+# TEST one(41) -> 42
+
+
+@micropython.asm_m68k(regs="d0-d1", save="auto")
+def sumbuf(buf, n):
+    moveal(d0, a3)
+    moveq(0, d0)
+    moveq(0, d5)
+    bras(loop_end)
+    label(loop)
+    moveb([a3.inc], d5)
+    addl(d5, d0)
+    label(loop_end)
+    dbra(d1, loop)
+
+
+# SETUP b = bytearray(range(100, 200))
+# TEST sumbuf(b, 100) -> sum(range(100, 200))
+
+
+@micropython.asm_m68k(regs="d0-d1", save="auto")
+def movem(a, b):
+    moveml({d0 - d1}, [sp.dec])
+    moveml([sp.inc], {d6, a4})
+    movel(a4, d0)
+    addl(d6, d0)
+
+
+# TEST movem(100, 7) -> 107
+
+
+@micropython.asm_m68k(regs="d4-d5", save="auto")
+def high(a, b):
+    movel(d4, d0)
+    subl(d5, d0)
+
+
+# TEST high(10, 3) -> 7
+
+
+@micropython.asm_m68k(save="auto")
+def frame(a, b):
+    movel([8, fp], d7)
+    movel([12, fp], d0)
+    mulsw(d7, d0)
+
+
+# TEST frame(6, 7) -> 42
+
+
+@micropython.asm_m68k(regs="d0")
+def fp_reg(a):
+    moveal(d0, fp)
+    addql(2, fp)
+    movel(fp, d0)
+
+
+# TEST fp_reg(40) -> 42
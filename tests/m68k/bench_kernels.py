@@ -0,0 +1,116 @@
+import micropython
+
+
+@micropython.viper
+def f1a(x):
+    return x
+
+
+@micropython.viper
+def f2v(x: int, y: int) -> int:
+    return x + y
+
+
+@micropython.native
+def call_native(n):
+    f = f1a
+    for _ in range(n):
+        f(1)
+
+
+@micropython.viper
+def call_viper(n: int) -> int:
+    s = 0
+    for i in range(n):
+        s = int(f2v(s, i))
+    return s
+
+
+# TEST call_viper(10) -> 45
+# BENCH call_native(100)
+# BENCH call_viper(100)
+
+
+@micropython.native
+def sum_native(buf, n):
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+@micropython.viper
+def sum_viper(buf: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+# SETUP b = bytearray(range(100))
+# TEST sum_native(b, 100) -> 4950
+# TEST sum_viper(b, 100) -> 4950
+# BENCH sum_native(b, 100)
+# BENCH sum_viper(b, 100)
+
+
+@micropython.native
+def mandel_native(cr, ci):
+    zr = 0
+    zi = 0
+    n = 0
+    while n < 50:
+        zr2 = zr * zr >> 12
+        zi2 = zi * zi >> 12
+        if zr2 + zi2 > 4 << 12:
+            break
+        zi = (zr * zi >> 11) + ci
+        zr = zr2 - zi2 + cr
+        n += 1
+    return n
+
+
+@micropython.viper
+def mandel_viper(cr: int, ci: int) -> int:
+    zr = 0
+    zi = 0
+    n = 0
+    while n < 50:
+        zr2 = zr * zr >> 12
+        zi2 = zi * zi >> 12
+        if zr2 + zi2 > 4 << 12:
+            break
+        zi = (zr * zi >> 11) + ci
+        zr = zr2 - zi2 + cr
+        n += 1
+    return n
+
+
+# TEST mandel_native(-2048, 1024) -> 50
+# TEST mandel_native(-3000, 2600) -> 5
+# TEST mandel_viper(-2048, 1024) -> 50
+# TEST mandel_viper(-3000, 2600) -> 5
+# BENCH mandel_native(-2048, 1024)
+# BENCH mandel_viper(-2048, 1024)
+
+
+@micropython.viper
+def sieve_viper(buf: ptr8, n: int) -> int:
+    count = 0
+    for i in range(n):
+        buf[i] = 1
+    i = 2
+    while i < n:
+        if buf[i]:
+            count += 1
+            j = i + i
+            while j < n:
+                buf[j] = 0
+                j += i
+        i += 1
+    return count
+
+
+# SETUP s = bytearray(200)
+# TEST sieve_viper(s, 200) -> 46
+# BENCH sieve_viper(s, 200)
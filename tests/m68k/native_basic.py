@@ -0,0 +1,42 @@
+import micropython
+
+
+@micropython.native
+def nf(a, b):
+    s = 0
+    for i in range(a):
+        s += i * b
+    return s
+
+
+# TEST nf(10, 3) -> 135
+
+
+@micropython.native
+def nmany(a, b, c, d):
+    x = a + b
+    y = c + d
+    z = x * y
+    w = z - a
+    v = w + b
+    u = v + c
+    t = u + d
+    return x + y + z + w + v + u + t
+
+
+# TEST nmany(1, 2, 3, 4) -> (lambda x,y: (lambda z: (lambda w: (lambda v: (lambda u: x+y+z+w+v+u+(u+4))(v+3))(w+2))(z-1))(x*y))(3, 7)
+
+
+@micropython.native
+def nloop(n):
+    x = 0
+    i = 0
+    while i < n:
+        if i > 2:
+            x = x + y
+        y = i
+        i += 1
+    return x
+
+
+# TEST nloop(6) -> 2+3+4
@@ -0,0 +1,86 @@
+import micropython
+
+
+@micropython.native
+def gen(n):
+    for i in range(n):
+        yield i * 2
+    return 99
+
+
+@micropython.native
+def total(n):
+    s = 0
+    for v in gen(n):
+        s += v
+    return s
+
+
+# TEST gen(3) -> ([0, 2, 4], 99)
+# TEST total(10) -> 90
+# BENCH total(10)
+
+
+@micropython.native
+def delegate(n):
+    r = yield from gen(n)
+    yield r
+
+
+# TEST delegate(2) -> ([0, 2, 99], None)
+
+
+@micropython.native
+def catch(x):
+    try:
+        yield 10 // x
+    except ZeroDivisionError:
+        yield -1
+    finally:
+        yield 100
+
+
+# TEST catch(5) -> ([2, 100], None)
+# TEST catch(0) -> ([-1, 100], None)
+
+
+@micropython.native
+def check(x):
+    if x < 0:
+        raise ValueError
+    return x
+
+
+@micropython.native
+def safe(x):
+    try:
+        return check(x)
+    except ValueError:
+        return 0
+
+
+# TEST safe(7) -> 7
+# TEST safe(-7) -> 0
+
+
+@micropython.native
+def tick():
+    yield
+
+
+@micropython.native
+async def wait(n):
+    for _ in range(n):
+        await tick()
+    return n
+
+
+@micropython.native
+async def task(a, b):
+    x = await wait(a)
+    y = await wait(b)
+    return x * 10 + y
+
+
+# TEST task(2, 3) -> ([None] * 5, 23)
+# BENCH task(2, 3)
@@ -0,0 +1,242 @@
+import micropython
+
+
+@micropython.viper
+def f(a: int, b: int) -> int:
+    s = 0
+    i = 0
+    while i < a:
+        s += i * b
+        i += 1
+    return s
+
+
+# TEST f(10, 3) -> 135
+# TEST f(0, 3) -> 0
+
+
+@micropython.viper
+def many(a: int, b: int, c: int, d: int, e: int) -> int:
+    x = a + b
+    y = c - d
+    z = x * y
+    w = z + e
+    v = w ^ a
+    u = v | b
+    t = u & 0xFF
+    r = t + x + y + z + w + v + u
+    return r
+
+
+# TEST many(1, 2, 30, 4, 5) -> (lambda a,b,c,d,e: (lambda x,y: (lambda z: (lambda w: (lambda v: (lambda u: (u & 0xff) + x + y + z + w + v + u)(v | b))(w ^ a))(z + e))(x * y))(a + b, c - d))(1, 2, 30, 4, 5)
+
+
+@micropython.viper
+def nested(n: int) -> int:
+    s = 0
+    for i in range(n):
+        for j in range(i):
+            s += i * j + 1
+    return s
+
+
+# TEST nested(12) -> sum(i*j+1 for i in range(12) for j in range(i))
+
+
+@micropython.viper
+def unusedargs(a: int, b: int, c: int, d: int, e: int, f: int, g: int, h: int, k: int) -> int:
+    return a + c + e + g + k
+
+
+# TEST unusedargs(1, 2, 3, 4, 5, 6, 7, 8, 9) -> 25
+
+
+@micropython.viper
+def allargs(a: int, b: int, c: int, d: int, e: int, f: int, g: int, h: int, k: int) -> int:
+    return a + b * 2 + c * 3 + d * 4 + e * 5 + f * 6 + g * 7 + h * 8 + k * 9
+
+
+# TEST allargs(1, 2, 3, 4, 5, 6, 7, 8, 9) -> sum(i*i for i in range(1,10))
+
+
+@micropython.viper
+def seq(n: int) -> int:
+    a = n + 1
+    b = a * 2
+    c = b - 3
+    d = c + a
+    e = d * 2
+    f = e - b
+    g = f + c
+    h = g + d
+    k = h - e
+    m = k + f
+    p = m + g + h
+    return p + k
+
+
+# TEST seq(5) -> (lambda n: (lambda a: (lambda b: (lambda c: (lambda d: (lambda e: (lambda f: (lambda g: (lambda h: (lambda k: (lambda m: m + g + h + k)(k + f))(h - e))(g + d))(f + c))(e - b))(d * 2))(c + a))(b - 3))(a * 2))(n + 1))(5)
+
+
+@micropython.viper
+def cmp(a: int, b: int) -> int:
+    r = 0
+    if a < b:
+        r |= 1
+    if a <= b:
+        r |= 2
+    if a == b:
+        r |= 4
+    if a != b:
+        r |= 8
+    if a > b:
+        r |= 16
+    if a >= b:
+        r |= 32
+    return r
+
+
+# TEST cmp(1, 2) -> 1|2|8
+# TEST cmp(2, 2) -> 2|4|32
+# TEST cmp(-3, -5) -> 8|16|32
+
+
+@micropython.viper
+def ucmp(a: uint, b: uint) -> int:
+    r = 0
+    if a < b:
+        r |= 1
+    if a > b:
+        r |= 2
+    return r
+
+
+# TEST ucmp(1, 2) -> 1
+
+
+# unsigned comparisons with the top bit set in the operands
+@micropython.viper
+def ucmp2(a: uint, b: uint) -> int:
+    r = 0
+    if a < b:
+        r |= 1
+    if a <= b:
+        r |= 2
+    if a > b:
+        r |= 4
+    if a >= b:
+        r |= 8
+    return r
+
+
+# TEST ucmp2(1, 0x80000000) -> 1|2
+# TEST ucmp2(0x80000000, 1) -> 4|8
+# TEST ucmp2(0xfffffffe, 0xffffffff) -> 1|2
+# TEST ucmp2(0xffffffff, 0xfffffffe) -> 4|8
+# TEST ucmp2(0x80000000, 0x80000000) -> 2|8
+
+
+@micropython.viper
+def shifts(a: int, n: int) -> int:
+    x = a << n
+    y = a >> n
+    return x + y
+
+
+# TEST shifts(100, 3) -> 800 + 12
+# TEST shifts(-100, 2) -> -400 + (-25)
+
+
+@micropython.viper
+def divmod_(a: int, b: int) -> int:
+    return (a // b) * 1000 + (a % b)
+
+
+# TEST divmod_(17, 5) -> 3*1000 + 2
+# TEST divmod_(-17, 5) -> -4*1000 + 3
+# TEST divmod_(17, -5) -> -4*1000 - 3
+
+
+@micropython.viper
+def swap(a: int, b: int) -> int:
+    for i in range(5):
+        a, b = b, a + b
+    return a * 1000 + b
+
+
+# TEST swap(0, 1) -> 5 * 1000 + 8
+
+
+@micropython.viper
+def boolloc(a: int) -> int:
+    t = a > 5
+    u = a < 10
+    if t and u:
+        return 1
+    return 0
+
+
+# TEST boolloc(7) -> 1
+# TEST boolloc(3) -> 0
+
+
+@micropython.viper
+def retbool(a: int) -> bool:
+    return a > 3
+
+
+# TEST retbool(7) -> True
+
+
+@micropython.viper
+def neg(a: int) -> int:
+    b = 0 - a
+    c = a ^ -1
+    return b * 100 + c
+
+
+# TEST neg(5) -> -500 - 6
+
+
+@micropython.viper
+def loopvars(n: int) -> int:
+    a = 0
+    b = 1
+    c = 2
+    d = 3
+    e = 4
+    f = 5
+    g = 6
+    h = 7
+    for i in range(n):
+        a += 1
+        b += a
+        c += b
+        d += c
+        e += d
+        f += e
+        g += f
+        h += g
+    return a + b + c + d + e + f + g + h
+
+
+# TEST loopvars(20) -> 3484844
+
+
+@micropython.viper
+def disjoint(n: int) -> int:
+    a = n + 1
+    b = a * 3
+    r = b
+    c = r + 7
+    d = c * 2
+    r = d
+    e = r - 1
+    f = e * e
+    g = f + 1
+    h = g - 2
+    k = h + 3
+    return k
+
+
+# TEST disjoint(2) -> (lambda e: e*e + 2)(((2 + 1) * 3 + 7) * 2 - 1)
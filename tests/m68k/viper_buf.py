@@ -0,0 +1,137 @@
+import micropython
+from array import array
+
+
+@micropython.viper
+def get8(buf: bytearray, i: int) -> int:
+    return buf[i]
+
+
+@micropython.viper
+def get8_3(buf: bytearray) -> int:
+    return buf[3]
+
+
+@micropython.native
+def safe_get8(buf, i):
+    try:
+        return get8(buf, i)
+    except IndexError:
+        return -1
+
+
+@micropython.native
+def safe_get8_3(buf):
+    try:
+        return get8_3(buf)
+    except IndexError:
+        return -1
+
+
+# SETUP b = bytearray(range(10, 14))
+# TEST safe_get8(b, 0) -> 10
+# TEST safe_get8(b, 3) -> 13
+# TEST safe_get8(b, 4) -> -1
+# TEST safe_get8(b, -1) -> -1
+# TEST safe_get8_3(b) -> 13
+# TEST safe_get8_3(bytearray(3)) -> -1
+
+
+@micropython.viper
+def put16(buf: array("H"), i: int, v: int):
+    buf[i] = v
+
+
+@micropython.native
+def safe_put16(buf, i, v):
+    try:
+        put16(buf, i, v)
+        return True
+    except IndexError:
+        return False
+
+
+# SETUP import array
+# SETUP a = array.array("H", [0, 0, 0])
+# TEST safe_put16(a, 2, 0x8001) -> True
+# TEST safe_put16(a, 3, 1) -> False
+# CHECK list(a) == [0, 0, 0x8001]
+
+
+@micropython.viper
+def sum_buf(buf: bytearray, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+@micropython.native
+def safe_sum_buf(buf, n):
+    try:
+        return sum_buf(buf, n)
+    except IndexError:
+        return -1
+
+
+# SETUP b = bytearray(range(100))
+# TEST safe_sum_buf(b, 100) -> sum(range(100))
+# TEST safe_sum_buf(b, 0) -> 0
+# TEST safe_sum_buf(b, 101) -> -1
+# BENCH sum_buf(b, 100)
+
+
+@micropython.viper
+def smooth(dst: array("H"), src: array("H"), n: int):
+    for i in range(1, n - 1):
+        dst[i] = (src[i - 1] + src[i] + src[i] + src[i + 1]) >> 2
+
+
+@micropython.native
+def safe_smooth(dst, src, n):
+    try:
+        smooth(dst, src, n)
+        return True
+    except IndexError:
+        return False
+
+
+# SETUP s = array.array("H", [0, 400, 800, 400, 0, 4000])
+# SETUP d = array.array("H", [0] * 6)
+# TEST safe_smooth(d, s, 6) -> True
+# CHECK list(d) == [0, 400, 600, 400, 1100, 0]
+# TEST safe_smooth(d, s, 7) -> False
+# BENCH smooth(d, s, 6)
+
+
+@micropython.viper
+def copy_at(dst: bytearray, src: bytearray, off: int, n: int):
+    for i in range(0, n, 2):
+        dst[off + i] = src[i]
+
+
+@micropython.native
+def safe_copy_at(dst, src, off, n):
+    try:
+        copy_at(dst, src, off, n)
+        return True
+    except IndexError:
+        return False
+
+
+# SETUP b = bytearray(8)
+# TEST safe_copy_at(b, bytearray(range(1, 5)), 2, 4) -> True
+# CHECK b == bytearray([0, 0, 1, 0, 3, 0, 0, 0])
+# TEST safe_copy_at(b, bytearray(4), 6, 4) -> False
+
+
+@micropython.viper
+def add32(buf: array("i"), n: int, v: int) -> int:
+    for i in range(n):
+        buf[i] += v
+    return buf[n - 1]
+
+
+# SETUP a = array.array("i", [1, -2, 3])
+# TEST add32(a, 3, 10) -> 13
+# CHECK list(a) == [11, 8, 13]
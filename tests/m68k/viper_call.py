@@ -0,0 +1,96 @@
+import micropython
+
+
+@micropython.viper
+def add2(x: int, y: int) -> int:
+    return x + y
+
+
+@micropython.viper
+def call_add2(n: int) -> int:
+    s = 0
+    for i in range(n):
+        s = int(add2(s, i))
+    return s
+
+
+# TEST call_add2(10) -> 45
+# BENCH call_add2(100)
+
+
+@micropython.viper
+def big(x: int) -> int:
+    return x << 20
+
+
+@micropython.viper
+def call_big(x: int) -> int:
+    return int(big(x)) >> 20
+
+
+# TEST call_big(3) -> 3
+# TEST call_big(1500) -> 1500
+# TEST call_big(-1500) -> -1500
+
+
+@micropython.viper
+def peek(buf: ptr8, i: int, flag: bool, o) -> int:
+    if flag:
+        return buf[i] + int(o)
+    return buf[i]
+
+
+@micropython.viper
+def call_peek(buf: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += int(peek(buf, i, i == 2, 1000))
+    return s
+
+
+# SETUP b = bytearray(range(10, 20))
+# TEST call_peek(b, 4) -> 10 + 11 + 12 + 13 + 1000
+
+
+@micropython.viper
+def mid(x: int) -> int:
+    return int(add2(x, 1)) + 1
+
+
+@micropython.viper
+def call_mid(x: int) -> int:
+    return int(mid(x))
+
+
+# TEST call_mid(40) -> 42
+
+
+@micropython.native
+def other(x):
+    return x * 3
+
+
+@micropython.viper
+def other(x: int) -> int:
+    return x * 2
+
+
+@micropython.viper
+def call_other(x: int) -> int:
+    return int(other(x))
+
+
+# TEST call_other(7) -> 21
+
+
+@micropython.viper
+def count(o, k: int) -> int:
+    return int(len(o)) + k
+
+
+@micropython.viper
+def call_count(o, k: uint) -> int:
+    return int(count(o, k)) * 2
+
+
+# TEST call_count([1, 2, 3], 1) -> 8
@@ -0,0 +1,93 @@
+import micropython
+
+
+@micropython.viper
+def fdiv(a: int, b: int) -> int:
+    return a // b
+
+
+# TEST fdiv(17, 5) -> 17 // 5
+# TEST fdiv(-17, 5) -> -17 // 5
+# TEST fdiv(-15, 5) -> -15 // 5
+# TEST fdiv(0x7fffffff, 3) -> 0x7fffffff // 3
+# TEST fdiv(-0x80000000, 7) -> -0x80000000 // 7
+# TEST fdiv(123456789, 65535) -> 123456789 // 65535
+# TEST fdiv(123456789, 65536) -> 123456789 // 65536
+# TEST fdiv(123456789, -1000) -> 123456789 // -1000
+# TEST fdiv(-123456789, -1000) -> -123456789 // -1000
+
+
+@micropython.viper
+def fmod(a: int, b: int) -> int:
+    return a % b
+
+
+# TEST fmod(17, 5) -> 17 % 5
+# TEST fmod(-17, 5) -> -17 % 5
+# TEST fmod(-15, 5) -> -15 % 5
+# TEST fmod(0x7fffffff, 3) -> 0x7fffffff % 3
+# TEST fmod(-0x80000000, 7) -> -0x80000000 % 7
+# TEST fmod(-123456789, 65535) -> -123456789 % 65535
+# TEST fmod(123456789, 70000) -> 123456789 % 70000
+# TEST fmod(123456789, -1000) -> 123456789 % -1000
+
+
+@micropython.viper
+def divk(a: int) -> int:
+    return (
+        (a // 1)
+        ^ (a // 2)
+        ^ (a // 8)
+        ^ (a // 1024)
+        ^ (a // 3)
+        ^ (a // 7)
+        ^ (a // 1000)
+        ^ (a // 65535)
+    )
+
+
+# TEST divk(123456789) -> (123456789 // 1) ^ (123456789 // 2) ^ (123456789 // 8) ^ (123456789 // 1024) ^ (123456789 // 3) ^ (123456789 // 7) ^ (123456789 // 1000) ^ (123456789 // 65535)
+# TEST divk(-987654) -> (-987654 // 1) ^ (-987654 // 2) ^ (-987654 // 8) ^ (-987654 // 1024) ^ (-987654 // 3) ^ (-987654 // 7) ^ (-987654 // 1000) ^ (-987654 // 65535)
+# TEST divk(-1) -> (-1 // 1) ^ (-1 // 2) ^ (-1 // 8) ^ (-1 // 1024) ^ (-1 // 3) ^ (-1 // 7) ^ (-1 // 1000) ^ (-1 // 65535)
+
+
+@micropython.viper
+def modk(a: int) -> int:
+    return (a % 1) + (a % 2) + (a % 8) + (a % 1024) + (a % 3) + (a % 7) + (a % 1000) + (a % 65535)
+
+
+# TEST modk(123456789) -> (123456789 % 1) + (123456789 % 2) + (123456789 % 8) + (123456789 % 1024) + (123456789 % 3) + (123456789 % 7) + (123456789 % 1000) + (123456789 % 65535)
+# TEST modk(-987654) -> (-987654 % 1) + (-987654 % 2) + (-987654 % 8) + (-987654 % 1024) + (-987654 % 3) + (-987654 % 7) + (-987654 % 1000) + (-987654 % 65535)
+
+
+@micropython.viper
+def div16(buf: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += (buf[i] // 10) + (buf[i] % 10)
+    return s
+
+
+# SETUP buf = bytearray(range(0, 128, 3))
+# TEST div16(buf, 40) -> sum(b // 10 + b % 10 for b in buf[:40])
+
+
+@micropython.viper
+def digits(x: int) -> int:
+    n = 0
+    while x:
+        n += x % 10
+        x //= 10
+    return n
+
+
+# TEST digits(1234567890) -> 45
+
+
+@micropython.viper
+def divbig(a: int) -> int:
+    return (a // 100000) + (a % 100000) + (a // 0x12345) + (a % 0x12345)
+
+
+# TEST divbig(123456789) -> (123456789 // 100000) + (123456789 % 100000) + (123456789 // 0x12345) + (123456789 % 0x12345)
+# TEST divbig(-987654321) -> (-987654321 // 100000) + (-987654321 % 100000) + (-987654321 // 0x12345) + (-987654321 % 0x12345)
@@ -0,0 +1,119 @@
+# SETUP import struct
+# SETUP f32 = lambda x: struct.unpack("f", struct.pack("f", x))[0]
+import micropython
+
+
+@micropython.viper
+def fadd(a: float, b: float) -> float:
+    return a + b
+
+
+# TEST fadd(1.5, 2.25) -> 3.75
+# TEST fadd(0.1, 0.2) -> f32(f32(0.1) + f32(0.2))
+
+
+@micropython.viper
+def fpoly(x: float) -> float:
+    return (x * x - 2.0) * x / 4.0 + 1
+
+
+# TEST fpoly(3.0) -> 6.25
+# TEST fpoly(-0.5) -> f32((0.25 - 2.0) * -0.5 / 4.0 + 1)
+
+
+@micropython.viper
+def fcmp(a: float, b: float) -> int:
+    r = 0
+    if a < b:
+        r |= 1
+    if a > b:
+        r |= 2
+    if a == b:
+        r |= 4
+    if a <= b:
+        r |= 8
+    if a >= b:
+        r |= 16
+    if a != b:
+        r |= 32
+    return r
+
+
+# TEST fcmp(1.0, 2.0) -> 41
+# TEST fcmp(2.0, 1.0) -> 50
+# TEST fcmp(1.5, 1.5) -> 28
+# TEST fcmp(-0.0, 0.0) -> 28
+# TEST fcmp(float("nan"), 1.0) -> 32
+
+
+@micropython.viper
+def fneg(a: float) -> float:
+    return -a
+
+
+# TEST fneg(2.5) -> -2.5
+
+
+@micropython.viper
+def fconv(n: int) -> int:
+    x = float(n) * 0.5
+    return int(x) + int(float(3))
+
+
+# TEST fconv(7) -> 6
+# TEST fconv(-7) -> 0
+
+
+@micropython.viper
+def fmix(n: int) -> float:
+    s = 0.0
+    for i in range(n):
+        s += i * 0.5
+    return s / 2
+
+
+# TEST fmix(10) -> 11.25
+
+
+@micropython.viper
+def fobj(a, b: float):
+    return a * b
+
+
+# TEST fobj(3, 1.5) -> 4.5
+
+
+@micropython.viper
+def fdiv0(a: float) -> float:
+    return a / 0.0
+
+
+# TEST fdiv0(1.0) -> float("inf")
+
+
+@micropython.viper
+def fdot(n: int) -> float:
+    x = 0.0
+    y = 1.0
+    acc = 0.0
+    for i in range(n):
+        acc += x * x + y * y
+        x += 0.25
+        y = y - 0.125
+    return acc
+
+
+@micropython.native
+def fdot_native(n):
+    x = 0.0
+    y = 1.0
+    acc = 0.0
+    for i in range(n):
+        acc += x * x + y * y
+        x += 0.25
+        y = y - 0.125
+    return acc
+
+
+# TEST fdot(20) -> 165.46875
+# TEST fdot_native(20) -> 165.46875
@@ -0,0 +1,89 @@
+import micropython
+
+
+@micropython.viper
+def loop(n: int) -> int:
+    s = 0
+    for _ in range(n):
+        s += 1
+    return s
+
+
+# TEST loop(0) -> 0
+# TEST loop(-5) -> 0
+# TEST loop(1) -> 1
+# TEST loop(1000) -> 1000
+# TEST loop(65536) -> 65536
+# TEST loop(65537) -> 65537
+# TEST loop(131075) -> 131075
+
+
+@micropython.viper
+def loop2(a: int, b: int) -> int:
+    s = 0
+    for _ in range(a, b):
+        s += 3
+    for _ in range(b, a):
+        s += 5
+    return s
+
+
+# TEST loop2(10, 20) -> 30
+# TEST loop2(20, 10) -> 50
+# TEST loop2(-3, 4) -> 21
+
+
+@micropython.viper
+def loopbc(n: int) -> int:
+    s = 0
+    t = 0
+    for k in range(n):
+        t += k
+    for _ in range(n):
+        s += 1
+        if s == 7:
+            continue
+        if s > 20:
+            break
+        s += 1
+    return s * 1000 + t
+
+
+# TEST loopbc(5) -> 9010
+# TEST loopbc(100) -> 26950
+
+
+@micropython.viper
+def nested(n: int, m: int) -> int:
+    s = 0
+    for _ in range(n):
+        for __ in range(m):
+            s += 1
+    return s
+
+
+# TEST nested(10, 30) -> 300
+# TEST nested(0, 30) -> 0
+
+
+@micropython.viper
+def cnt2(e: int) -> int:
+    n = 0
+    for i in range(e):
+        for i in range(3):
+            n += 1
+    return n
+
+
+# TEST cnt2(4) -> 12
+# TEST cnt2(0) -> 0
+
+
+@micropython.viper
+def bench() -> int:
+    for _ in range(50000):
+        pass
+    return 1
+
+
+# TEST bench() -> 1
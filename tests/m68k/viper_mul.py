@@ -0,0 +1,75 @@
+import micropython
+
+# SETUP w = lambda x: ((x + 2**31) % 2**32) - 2**31
+
+
+@micropython.viper
+def mul(a: int, b: int) -> int:
+    return a * b
+
+
+# TEST mul(3, 4) -> 12
+# TEST mul(-3, 4) -> -12
+# TEST mul(-3, -4) -> 12
+# TEST mul(70000, 70000) -> w(70000 * 70000)
+# TEST mul(0x12345678, 0x9abc) -> w(0x12345678 * 0x9abc)
+# TEST mul(-123456, 98765) -> w(-123456 * 98765)
+# TEST mul(0x7fffffff, 0x7fffffff) -> w(0x7fffffff ** 2)
+
+
+@micropython.viper
+def mulc(a: int) -> int:
+    return (a * 0) + (a * 1) + (a * -1) + (a * 8) + (a * 256) + (a * 1024) + (a * -4)
+
+
+# TEST mulc(12345) -> w(12345 * (0 + 1 - 1 + 8 + 256 + 1024 - 4))
+# TEST mulc(-77777) -> w(-77777 * (0 + 1 - 1 + 8 + 256 + 1024 - 4))
+
+
+@micropython.viper
+def mulk(a: int) -> int:
+    return (
+        (a * 3)
+        ^ (a * 1000)
+        ^ (a * -7)
+        ^ (a * 65535)
+        ^ (a * 70000)
+        ^ (a * -70000)
+        ^ (a * 0x12345678)
+        ^ (5 * a)
+    )
+
+
+# TEST mulk(12345) -> w(12345*3) ^ w(12345*1000) ^ w(12345*-7) ^ w(12345*65535) ^ w(12345*70000) ^ w(12345*-70000) ^ w(12345*0x12345678) ^ w(5*12345)
+# TEST mulk(-987654) -> w(-987654*3) ^ w(-987654*1000) ^ w(-987654*-7) ^ w(-987654*65535) ^ w(-987654*70000) ^ w(-987654*-70000) ^ w(-987654*0x12345678) ^ w(5*-987654)
+
+
+@micropython.viper
+def mul8(buf: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i] * buf[i] + buf[i] * 3
+    return s
+
+
+# SETUP b8 = bytearray(range(0, 100, 3))
+# TEST mul8(b8, len(b8)) -> sum(x * x + x * 3 for x in range(0, 100, 3))
+
+
+@micropython.viper
+def mulloop(n: int, k: int) -> int:
+    s = 0
+    for i in range(n):
+        s += i * k
+    return s
+
+
+# TEST mulloop(100, 12345) -> 12345 * sum(range(100))
+
+
+@micropython.viper
+def mulu(a: uint, b: uint) -> uint:
+    return a * b
+
+
+# TEST mulu(100000, 3) -> 300000
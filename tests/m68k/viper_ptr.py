@@ -0,0 +1,175 @@
+import micropython
+
+
+@micropython.viper
+def sum8(buf: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+# SETUP b = bytearray(range(256))
+# TEST sum8(b, 256) -> sum(range(256))
+
+
+@micropython.viper
+def sum16(buf: ptr16, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+# SETUP b = bytearray(b'\x7f\xf0\x00\x01\x80\x00\xff\xff')
+# TEST sum16(b, 4) -> 0x7ff0 + 1 + 0x8000 + 0xffff
+
+
+@micropython.viper
+def sum32(buf: ptr32, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i]
+    return s
+
+
+# SETUP b = bytearray(b'\x00\x00\x00\x05\xff\xff\xff\xfe\x00\x01\x00\x00')
+# TEST sum32(b, 3) -> 5 - 2 + 65536
+
+
+@micropython.viper
+def fill(buf: ptr8, n: int, v: int):
+    for i in range(n):
+        buf[i] = v + i
+
+
+# SETUP b = bytearray(10)
+# TEST fill(b, 10, 3) -> None
+# CHECK b == bytearray(range(3, 13))
+
+
+@micropython.viper
+def fill16(buf: ptr16, n: int, v: int):
+    for i in range(n):
+        buf[i] = v + i
+
+
+# SETUP b = bytearray(8)
+# TEST fill16(b, 4, 0x1234) -> None
+# CHECK b == bytearray(b'\x12\x34\x12\x35\x12\x36\x12\x37')
+
+
+@micropython.viper
+def fill32(buf: ptr32, n: int, v: int):
+    for i in range(n):
+        buf[i] = v + i
+
+
+# SETUP b = bytearray(8)
+# TEST fill32(b, 2, 0x12345678) -> None
+# CHECK b == bytearray(b'\x12\x34\x56\x78\x12\x34\x56\x79')
+
+
+@micropython.viper
+def copy(dst: ptr8, src: ptr8, n: int):
+    i = 0
+    while i < n:
+        dst[i] = src[i]
+        i += 1
+
+
+# SETUP b = bytearray(6)
+# SETUP c = bytearray(b'abcdef')
+# TEST copy(b, c, 6) -> None
+# CHECK b == c
+
+
+@micropython.viper
+def consts(buf: ptr8):
+    buf[0] = 1
+    buf[1] = buf[0] + 1
+    buf[3] = buf[2] + buf[1]
+
+
+# SETUP b = bytearray(b'\x00\x00\x05\x00')
+# TEST consts(b) -> None
+# CHECK b == bytearray(b'\x01\x02\x05\x07')
+
+
+@micropython.viper
+def consts16(buf: ptr16):
+    buf[0] = 0x100
+    buf[2] = buf[1] + buf[0]
+
+
+# SETUP b = bytearray(b'\x00\x00\x00\x05\x00\x00')
+# TEST consts16(b) -> None
+# CHECK b == bytearray(b'\x01\x00\x00\x05\x01\x05')
+
+
+@micropython.viper
+def consts32(buf: ptr32):
+    buf[1] = buf[0] + 1
+
+
+# SETUP b = bytearray(b'\x01\x02\x03\x04\x00\x00\x00\x00')
+# TEST consts32(b) -> None
+# CHECK b == bytearray(b'\x01\x02\x03\x04\x01\x02\x03\x05')
+
+
+@micropython.viper
+def ptrarith(buf: ptr8, n: int) -> int:
+    p = ptr8(buf)
+    q = ptr8(int(buf) + 1)
+    s = 0
+    for i in range(n - 1):
+        s += q[i] - p[i]
+    return s
+
+
+# SETUP b = bytearray(b'\x01\x03\x06\x0a')
+# TEST ptrarith(b, 4) -> 9
+
+
+@micropython.viper
+def manyptrs(a: ptr8, b: ptr8, c: ptr8, d: ptr8, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += a[i] + b[i] * 2 + c[i] * 3 + d[i] * 4
+    return s
+
+
+# SETUP w = bytearray(b'\x01\x02')
+# SETUP x = bytearray(b'\x03\x04')
+# SETUP y = bytearray(b'\x05\x06')
+# SETUP z = bytearray(b'\x07\x08')
+# TEST manyptrs(w, x, y, z, 2) -> 3 + 7*2 + 11*3 + 15*4
+
+
+@micropython.viper
+def div16(buf: ptr16, n: int) -> int:
+    s = 0
+    for i in range(n):
+        s += buf[i] // 10 + buf[i] % 10
+    return s
+
+
+# SETUP b = bytearray(b'\xff\xff\x80\x00\x00\x09')
+# TEST div16(b, 3) -> 6553 + 5 + 3276 + 8 + 0 + 9
+
+
+@micropython.viper
+def far(buf: ptr32, p: ptr16) -> int:
+    buf[9000] = buf[1] + 1
+    p[17000] = p[1]
+    q = ptr8(int(p) + 1)
+    q[-1] = 7
+    return buf[9000] + p[17000] + q[-1]
+
+
+# SETUP big = bytearray(40000)
+# SETUP big[4:8] = b'\x00\x00\x01\x00'
+# SETUP h = bytearray(40000)
+# SETUP h[2:4] = b'\xab\xcd'
+# TEST far(big, h) -> 0x101 + 0xabcd + 7
+# CHECK big[36000:36004] == b'\x00\x00\x01\x01' and h[34000:34002] == b'\xab\xcd' and h[0] == 7
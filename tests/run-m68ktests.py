@@ -0,0 +1,907 @@
+#!/usr/bin/env python3
+#
+# This file is part of the MicroPython project, http://micropython.org/
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 Yuichi Nakamura
+#
+# Run native, viper and inline assembler functions compiled by
+# mpy-cross -march=m68k on the instruction set simulator in tools/m68kemu.py,
+# checking their results and reporting the cycles each call takes.
+#
+# Only the native children of a compiled module are run: the module-level
+# bytecode is not executed and the runtime helpers reached through mp_fun_table
+# are implemented here in Python.  Each test file annotates its functions with
+# comment lines of the form:
+#
+#   # SETUP <python statement>          executed on the host before later lines
+#   # TEST <func>(<args>) -> <expr>     call func on the simulator, compare result
+#   # CHECK <python expression>         must be true after the preceding tests
+#   # BENCH <func>(<args>)              call func only to report its cycles
+#   # CPU 68020                         skip the file unless run for a 68020
+#
+# A call that returns a generator or coroutine runs it to completion, and its
+# result is a tuple of the list of values it yielded and its return value.
+# Exceptions raised by native code unwind through nlr buffers laid out as in
+# py/nlrm68k.c, so try/except, finally and generators run as on the target.
+
+import argparse
+import array
+import ast
+import builtins
+import glob
+import importlib.util
+import math
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+TOP = os.path.dirname(TESTS_DIR)
+
+sys.path.insert(0, TOP + "/tools")
+from m68kemu import CPU, M68kError  # noqa: E402
+
+MPY_CROSS = os.getenv("MICROPY_MPYCROSS", TOP + "/mpy-cross/build/mpy-cross")
+
+_spec = importlib.util.spec_from_file_location("mpytool", TOP + "/tools/mpy-tool.py")
+mpytool = importlib.util.module_from_spec(_spec)
+sys.modules["mpytool"] = mpytool
+_spec.loader.exec_module(mpytool)
+
+MP_NATIVE_TYPE_OBJ = 0
+MP_NATIVE_TYPE_BOOL = 1
+MP_NATIVE_TYPE_INT = 2
+MP_NATIVE_TYPE_UINT = 3
+MP_NATIVE_TYPE_FLOAT = 9
+MP_NATIVE_TYPE_BUF8 = 0x0A
+MP_NATIVE_TYPE_BUF32 = 0x0C
+MP_NATIVE_TYPE_BUF_LEN = 0x10
+
+MP_SCOPE_FLAG_GENERATOR = 0x01
+
+MP_VM_RETURN_NORMAL = 0
+MP_VM_RETURN_YIELD = 1
+MP_VM_RETURN_EXCEPTION = 2
+
+# nlr_buf_t of py/nlrm68k.c: prev, ret_val, d2-d7, a2-a6, sp, pc
+NLR_RET_VAL = 4
+NLR_REGS = 8
+NLR_SP = 52
+NLR_PC = 56
+
+# Memory map
+FUN_TABLE = 0x000400
+TRAP_BASE = 0x001000
+RETURN_TRAP = 0x000F00
+CONST_NONE = 0x002000
+CONST_FALSE = 0x002010
+CONST_TRUE = 0x002020
+TYPE_FUN_NATIVE = 0x002030
+CONTEXT = 0x003000
+OBJ_TABLE = 0x003100
+QSTR_TABLE = 0x003800
+CODE_BASE = 0x010000
+HEAP_BASE = 0x080000
+STACK_TOP = 0x0FFFF0
+
+QSTR_BASE = 1000  # qstr id of the first entry in the module's qstr table
+
+
+def _enum(header, name):
+    src = open(TOP + "/py/" + header).read()
+    m = re.search(r"typedef enum \{([^{}]*)\} " + name + ";", src)
+    body = re.sub(r"//.*", "", m.group(1))
+    body = re.sub(r"#.*", "", body)
+    names = [x.strip().split("=")[0].strip() for x in body.split(",")]
+    return [x for x in names if x]
+
+
+FUN_NAMES = _enum("nativeglue.h", "mp_fun_kind_t")[:-1]
+BINARY_OPS = _enum("runtime0.h", "mp_binary_op_t")
+UNARY_OPS = _enum("runtime0.h", "mp_unary_op_t")
+MP_F = {n[5:].lower(): i for i, n in enumerate(FUN_NAMES)}
+# Entries after the dynamic-runtime ones, see the end of mp_fun_table_t.
+EXTRA_FUNS = [
+    "small_int_multiply",
+    "float_add",
+    "float_sub",
+    "float_mul",
+    "float_div",
+    "float_cmp",
+    "float_from_int",
+    "float_to_int",
+    "type_fun_native",
+]
+for _i, _n in enumerate(EXTRA_FUNS):
+    MP_F[_n] = 80 + _i
+N_FUNS = 80 + len(EXTRA_FUNS)
+
+
+def f2bits(f):
+    try:
+        return struct.unpack(">I", struct.pack(">f", f))[0]
+    except OverflowError:
+        return struct.unpack(">I", struct.pack(">f", math.copysign(math.inf, f)))[0]
+
+
+def bits2f(b):
+    return struct.unpack(">f", struct.pack(">I", b & 0xFFFFFFFF))[0]
+
+
+# Approximate cost in cycles of the C runtime helpers, used so that timings of
+# code that calls helpers are comparable with code that does the work inline.
+ALLOC_CYCLES = 300  # gc allocation of a boxed float
+
+HELPER_CYCLES = {
+    "convert_obj_to_native": 70,
+    "convert_native_to_obj": 70,
+    "small_int_multiply": 260,
+    # soft-float routines of libgcc on a 68000
+    "float_add": 350,
+    "float_sub": 370,
+    "float_mul": 700,
+    "float_div": 1200,
+    "float_cmp": 150,
+    "float_from_int": 200,
+    "float_to_int": 150,
+    "small_int_floor_divide": 420,
+    "small_int_modulo": 420,
+    "binary_op": 400,
+    "unary_op": 200,
+    "obj_is_true": 60,
+    "load_global": 250,
+    "load_attr": 400,
+    "load_method": 400,
+    "obj_subscr": 300,
+    "native_getiter": 200,
+    "native_iternext": 150,
+    "call_method_n_kw": 500,
+    "native_call_function_n_kw": 500,
+    "arg_check_num_sig": 40,
+    "setup_code_state": 300,
+    "native_swap_globals": 40,
+    "native_yield_from": 200,
+    "nlr_push": 60,
+    "nlr_pop": 30,
+    "native_raise": 300,
+}
+
+
+class Buffer:
+    def __init__(self, addr, data):
+        self.addr = addr
+        self.size = len(data)
+
+
+class Builtin:
+    def __init__(self, name, fn):
+        self.name = name
+        self.fn = fn
+
+
+class NativeFun:
+    # A native, viper or asm_m68k function loaded into the simulator
+    def __init__(self, name, rc, addr, fun):
+        self.name = name
+        self.rc = rc
+        self.addr = addr
+        self.fun = fun
+
+
+class RangeIter:
+    def __init__(self, it):
+        self.it = it
+
+
+class GenInstance:
+    # A native generator or coroutine, with its code state in simulator memory
+    def __init__(self, f, code_state):
+        self.f = f
+        self.code_state = code_state
+        self.done = False
+
+
+class Raise(Exception):
+    # An exception raised by native code that has no handler in the current run
+    def __init__(self, obj):
+        self.obj = obj
+
+
+class Harness:
+    def __init__(self, source, mpy, march="m68k"):
+        mpytool.global_qstrs = mpytool.GlobalQStrList()
+        mpytool.config.native_arch = mpytool.MP_NATIVE_ARCH_NONE
+        mpytool.config.MICROPY_QSTR_BYTES_IN_LEN = 1
+        mpytool.config.MICROPY_QSTR_BYTES_IN_HASH = 1
+        mpytool.RawCode.escaped_names = set()
+        self.source = source
+        self.cm = mpytool.read_mpy(mpy)
+        self.cpu = CPU()
+        self.cpu.fpu = march.endswith("+fpu")
+        self.cpu.cpu020 = march.startswith("m68k020") or self.cpu.fpu
+        self.objs = {}
+        self.heap = HEAP_BASE
+        self.globals = {"range": Builtin("range", range), "len": Builtin("len", len)}
+        self.helper_calls = {}
+        self.helper_cycles = 0
+        self.nlr_top = 0
+        self.run_base = []
+        self._setup()
+
+    # Objects
+
+    def alloc(self, n):
+        addr = self.heap
+        self.heap += (n + 15) & ~15
+        return addr
+
+    def to_obj(self, v):
+        if v is None:
+            return CONST_NONE
+        if v is False:
+            return CONST_FALSE
+        if v is True:
+            return CONST_TRUE
+        if isinstance(v, NativeFun):
+            return v.fun
+        if isinstance(v, int) and -(1 << 30) <= v < (1 << 30):
+            return ((v << 1) | 1) & 0xFFFFFFFF
+        addr = self.alloc(16)
+        if isinstance(v, (bytearray, memoryview)):
+            buf = self.alloc(len(v))
+            self.cpu.load(buf, bytes(v))
+            self.objs[addr] = (v, Buffer(buf, v))
+        elif isinstance(v, array.array):
+            # arrays are stored big endian, as on the target
+            a = array.array(v.typecode, v)
+            a.byteswap()
+            buf = self.alloc(len(a) * a.itemsize)
+            self.cpu.load(buf, a.tobytes())
+            self.objs[addr] = (v, Buffer(buf, a.tobytes()))
+        else:
+            self.objs[addr] = (v, None)
+        return addr
+
+    def from_obj(self, o):
+        if o == CONST_NONE:
+            return None
+        if o == CONST_FALSE:
+            return False
+        if o == CONST_TRUE:
+            return True
+        if o & 1:
+            return ((o >> 1) ^ 0x40000000) - 0x40000000
+        if o == 0:
+            return None
+        return self.objs[o][0]
+
+    def sync_buffers(self):
+        for v, b in self.objs.values():
+            if b is None:
+                continue
+            data = self.cpu.mem[b.addr : b.addr + b.size]
+            if isinstance(v, array.array):
+                a = array.array(v.typecode, bytes(data))
+                a.byteswap()
+                v[:] = a
+            else:
+                v[:] = data
+
+    def qstr(self, q):
+        return self.cm.qstr_table[q - QSTR_BASE].str
+
+    # Setup of memory image
+
+    def _setup(self):
+        cpu = self.cpu
+        for i in range(N_FUNS):
+            cpu.write(FUN_TABLE + 4 * i, 4, TRAP_BASE + 4 * i)
+            cpu.add_trap(TRAP_BASE + 4 * i, self._make_trap(i))
+        cpu.write(FUN_TABLE + 0, 4, CONST_NONE)
+        cpu.write(FUN_TABLE + 4, 4, CONST_FALSE)
+        cpu.write(FUN_TABLE + 8, 4, CONST_TRUE)
+        cpu.write(FUN_TABLE + 4 * MP_F["type_fun_native"], 4, TYPE_FUN_NATIVE)
+        cpu.add_trap(RETURN_TRAP, lambda c: False)
+
+        # module context: base, globals, qstr_table, obj_table
+        cpu.write(CONTEXT + 8, 4, QSTR_TABLE)
+        cpu.write(CONTEXT + 12, 4, OBJ_TABLE)
+        for i in range(len(self.cm.qstr_table)):
+            cpu.write(QSTR_TABLE + 2 * i, 2, QSTR_BASE + i)
+        for i, o in enumerate(self.cm.obj_table):
+            if isinstance(o, mpytool.MPFunTable):
+                v = FUN_TABLE
+            else:
+                v = self.to_obj(o)
+            cpu.write(OBJ_TABLE + 4 * i, 4, v)
+
+        # load all raw code
+        self.funcs = {}
+        self.code_addr = CODE_BASE
+        # children of the module are in source order, lambdas have no usable name
+        tree = ast.parse(open(self.source).read())
+        self.names = [
+            n.name
+            for n in tree.body
+            if isinstance(n, (ast.FunctionDef, ast.AsyncFunctionDef, ast.ClassDef))
+        ]
+        for i, c in enumerate(self.cm.raw_code.children):
+            self._load_rc(c, self.names[i] if i < len(self.names) else None)
+
+    def _load_rc(self, rc, name=None):
+        if rc.code_kind != mpytool.MP_CODE_BYTECODE:
+            addr = self.code_addr
+            self.cpu.load(addr, rc.fun_data)
+            self.code_addr = (addr + len(rc.fun_data) + 15) & ~15
+            fun = self.alloc(16)
+            if rc.code_kind != mpytool.MP_CODE_NATIVE_ASM:
+                self.cpu.write(fun, 4, TYPE_FUN_NATIVE)
+            self.cpu.write(fun + 4, 4, CONTEXT)
+            if rc.code_kind == mpytool.MP_CODE_NATIVE_PY:
+                # child_table holds the prelude pointer (no children supported)
+                self.cpu.write(fun + 8, 4, addr + rc.prelude_offset)
+            self.cpu.write(fun + 12, 4, addr)
+            if name is None or rc.code_kind == mpytool.MP_CODE_NATIVE_PY:
+                name = rc.simple_name.str
+            f = NativeFun(name, rc, addr, fun)
+            self.objs[fun] = (f, None)
+            self.funcs[name] = f
+            self.globals.setdefault(name, f)
+        for c in rc.children:
+            self._load_rc(c)
+
+    # Calling
+
+    def _run_at(self, addr, args):
+        # Call the code at addr with the C calling convention and run it until
+        # it returns.  The nlr buffers pushed before belong to outer runs.
+        cpu = self.cpu
+        sp = cpu.a[7]
+        for a in reversed(args):
+            cpu.push32(a)
+        expect_sp = cpu.a[7]
+        cpu.push32(RETURN_TRAP)
+        cpu.pc = addr
+        self.run_base.append(self.nlr_top)
+        try:
+            cpu.run()
+        finally:
+            self.run_base.pop()
+        if cpu.a[7] != expect_sp:
+            raise M68kError("stack imbalance: sp=0x%x" % cpu.a[7])
+        cpu.a[7] = sp
+        return cpu.d[0]
+
+    def _run(self, f, args):
+        # Call f with the given words as arguments and run it until it returns.
+        if f.rc.code_kind == mpytool.MP_CODE_NATIVE_ASM:
+            # inline assembler functions take their arguments directly
+            return self._run_at(f.addr, args)
+        argv = self._argv(args)
+        if f.rc.code_kind == mpytool.MP_CODE_NATIVE_PY:
+            if f.rc.scope_flags & MP_SCOPE_FLAG_GENERATOR:
+                return self.to_obj(self._new_gen(f, len(args), argv))
+        return self._run_at(f.addr, [f.fun, len(args), 0, argv])
+
+    def _argv(self, args):
+        argv = self.alloc(4 * len(args) + 4)
+        for i, a in enumerate(args):
+            self.cpu.write(argv + 4 * i, 4, a)
+        return argv
+
+    def _new_gen(self, f, n_args, argv):
+        # As native_gen_wrap_call() in py/objgenerator.c
+        cpu = self.cpu
+        n_state = f.rc.prelude_signature[0]
+        cs = self.alloc(20 + 4 * n_state)
+        cpu.write(cs, 4, f.fun)
+        cpu.write(cs + 4, 4, f.addr + f.rc.prelude_offset)
+        cpu.write(cs + 12, 2, n_state)
+        cpu.write(cs + 14, 2, 0xFFFF)
+        self.f_setup_code_state(cs, n_args, 0, argv)
+        cpu.write(cs + 4, 4, f.addr + cpu.read(f.addr + 4, 4))
+        return GenInstance(f, cs)
+
+    def _resume(self, gen, send_value, throw_value=0):
+        # As mp_obj_gen_resume(), returning the kind of return and its value
+        cpu = self.cpu
+        if gen.done:
+            return MP_VM_RETURN_NORMAL, CONST_NONE
+        state = gen.code_state + 20
+        if cpu.read(gen.code_state + 8, 4) != state - 4:
+            cpu.write(cpu.read(gen.code_state + 8, 4), 4, send_value)
+        kind = self._run_at(gen.f.addr + 8, [gen.code_state, throw_value])
+        if kind == MP_VM_RETURN_YIELD:
+            return kind, cpu.read(cpu.read(gen.code_state + 8, 4), 4)
+        gen.done = True
+        if kind == MP_VM_RETURN_NORMAL:
+            return kind, cpu.read(cpu.read(gen.code_state + 8, 4), 4)
+        return kind, cpu.read(state, 4)
+
+    def _drain(self, gen):
+        # Run a generator returned to the host, see the comment at the top
+        values = []
+        while True:
+            kind, v = self._resume(gen, CONST_NONE)
+            if kind == MP_VM_RETURN_YIELD:
+                values.append(self.from_obj(v))
+            elif kind == MP_VM_RETURN_NORMAL:
+                return values, self.from_obj(v)
+            else:
+                raise M68kError("uncaught exception %r" % self.from_obj(v))
+
+    def call(self, name, *args):
+        f = self.funcs[name]
+        cpu = self.cpu
+        cpu.a[7] = STACK_TOP
+        if f.rc.code_kind == mpytool.MP_CODE_NATIVE_ASM:
+            args = [self.to_native_arg(a) for a in args]
+        else:
+            args = [self.to_obj(a) for a in args]
+        # callee-saved registers are filled with junk to catch missing saves
+        saved = [0x5A5A0000 + i for i in range(16)]
+        for i in range(2, 8):
+            cpu.d[i] = saved[i]
+        for i in range(2, 7):
+            cpu.a[i] = saved[8 + i]
+        cpu.d[0] = cpu.d[1] = 0xDEAD0000
+        cpu.a[0] = cpu.a[1] = 0xDEAD0000
+        cpu.cycles = 0
+        cpu.insns = 0
+        self.helper_calls = {}
+        self.helper_cycles = 0
+        try:
+            r = self._run(f, args)
+        except Raise as er:
+            raise M68kError("uncaught exception %r" % self.from_obj(er.obj))
+        for i in range(2, 8):
+            if cpu.d[i] != saved[i]:
+                raise M68kError("d%d not preserved" % i)
+        for i in range(2, 7):
+            if cpu.a[i] != saved[8 + i]:
+                raise M68kError("a%d not preserved" % i)
+        self.sync_buffers()
+        if f.rc.code_kind == mpytool.MP_CODE_NATIVE_ASM:
+            return r - (1 << 32) if r & 0x80000000 else r
+        r = self.from_obj(r)
+        if isinstance(r, GenInstance):
+            r = self._drain(r)
+            self.sync_buffers()
+        return r
+
+    def to_native_arg(self, a):
+        if isinstance(a, int):
+            return a & 0xFFFFFFFF
+        o = self.to_obj(a)
+        b = self.objs[o][1]
+        return b.addr if b else o
+
+    # Runtime helpers
+
+    def _make_trap(self, idx):
+        name = None
+        if idx < len(FUN_NAMES):
+            name = FUN_NAMES[idx][5:].lower()
+        elif idx >= 80:
+            name = EXTRA_FUNS[idx - 80]
+        fn = getattr(self, "f_" + name, None) if name else None
+
+        def trap(cpu):
+            if fn is None:
+                raise M68kError("unsupported runtime helper %d (%s)" % (idx, name))
+            sp = cpu.a[7]
+            args = [cpu.read(sp + 4 + 4 * i, 4) for i in range(6)]
+            try:
+                r = fn(*args)
+            except Raise as er:
+                r = self._nlr_jump(er.obj)
+            except M68kError:
+                raise
+            except Exception as er:
+                # an exception of a helper is raised in the native code
+                r = self._nlr_jump(self.to_obj(er))
+            cpu.d[0] = (r or 0) & 0xFFFFFFFF
+            cpu.d[1] = 0xDEAD0001
+            cpu.a[0] = 0xDEAD0002
+            cpu.a[1] = 0xDEAD0003
+            cpu.pc = cpu.pop32()
+            c = HELPER_CYCLES.get(name, 100)
+            cpu.cycles += c
+            self.helper_cycles += c
+            self.helper_calls[name] = self.helper_calls.get(name, 0) + 1
+
+        return trap
+
+    def f_convert_obj_to_native(self, obj, typ, *_):
+        v = self.from_obj(obj)
+        if typ == MP_NATIVE_TYPE_BOOL:
+            return 1 if v else 0
+        if typ in (MP_NATIVE_TYPE_INT, MP_NATIVE_TYPE_UINT):
+            return int(v) & 0xFFFFFFFF
+        if typ == MP_NATIVE_TYPE_FLOAT:
+            return f2bits(float(v))
+        if MP_NATIVE_TYPE_BUF8 <= typ & 0xF <= MP_NATIVE_TYPE_BUF32:
+            size = 1 << ((typ & 0xF) - MP_NATIVE_TYPE_BUF8)
+            b = self.objs[obj][1] if obj in self.objs else None
+            if b is None:
+                raise TypeError("object with buffer protocol required")
+            if getattr(v, "itemsize", 1) != size:
+                raise TypeError("wrong buffer item size")
+            if typ & MP_NATIVE_TYPE_BUF_LEN:
+                return b.size // size
+            return b.addr
+        if typ >= 4:
+            if isinstance(v, int):
+                return v & 0xFFFFFFFF
+            if v is None:
+                return 0
+            return self.objs[obj][1].addr
+        return obj
+
+    def f_convert_native_to_obj(self, val, typ, *_):
+        if typ == MP_NATIVE_TYPE_OBJ:
+            return val
+        if typ == MP_NATIVE_TYPE_BOOL:
+            return CONST_TRUE if val else CONST_FALSE
+        if typ == MP_NATIVE_TYPE_UINT:
+            return self.to_obj(val)
+        if typ == MP_NATIVE_TYPE_FLOAT:
+            self.cpu.cycles += ALLOC_CYCLES
+            return self.to_obj(bits2f(val))
+        s = val - (1 << 32) if val & 0x80000000 else val
+        return self.to_obj(s)
+
+    def f_native_swap_globals(self, *_):
+        return 0
+
+    def f_load_global(self, q, *_):
+        name = self.qstr(q)
+        if name not in self.globals:
+            exc = getattr(builtins, name, None)
+            if isinstance(exc, type) and issubclass(exc, BaseException):
+                return self.to_obj(exc)
+        return self.to_obj(self.globals[name])
+
+    def f_load_name(self, q, *_):
+        return self.f_load_global(q)
+
+    def f_obj_is_true(self, o, *_):
+        return 1 if self.from_obj(o) else 0
+
+    def f_unary_op(self, op, o, *_):
+        v = self.from_obj(o)
+        name = UNARY_OPS[op][len("MP_UNARY_OP_") :]
+        r = {
+            "POSITIVE": lambda x: +x,
+            "NEGATIVE": lambda x: -x,
+            "INVERT": lambda x: ~x,
+            "NOT": lambda x: not x,
+            "BOOL": bool,
+            "LEN": len,
+            "ABS": abs,
+        }[name](v)
+        return self.to_obj(r)
+
+    def f_binary_op(self, op, lhs, rhs, *_):
+        a = self.from_obj(lhs)
+        b = self.from_obj(rhs)
+        name = BINARY_OPS[op][len("MP_BINARY_OP_") :]
+        if name.startswith("INPLACE_"):
+            name = name[8:]
+        ops = {
+            "LESS": lambda: a < b,
+            "MORE": lambda: a > b,
+            "EQUAL": lambda: a == b,
+            "LESS_EQUAL": lambda: a <= b,
+            "MORE_EQUAL": lambda: a >= b,
+            "NOT_EQUAL": lambda: a != b,
+            "IN": lambda: a in b,
+            "IS": lambda: a is b,
+            "OR": lambda: a | b,
+            "XOR": lambda: a ^ b,
+            "AND": lambda: a & b,
+            "LSHIFT": lambda: a << b,
+            "RSHIFT": lambda: a >> b,
+            "ADD": lambda: a + b,
+            "SUBTRACT": lambda: a - b,
+            "MULTIPLY": lambda: a * b,
+            "FLOOR_DIVIDE": lambda: a // b,
+            "TRUE_DIVIDE": lambda: a / b,
+            "MODULO": lambda: a % b,
+            "POWER": lambda: a**b,
+            "NOT_IN": lambda: a not in b,
+            "IS_NOT": lambda: a is not b,
+            "EXCEPTION_MATCH": lambda: isinstance(a, b),
+        }
+        if isinstance(a, float) or isinstance(b, float):
+            # a boxed float op runs the soft-float routine and allocates the result
+            fop = {
+                "ADD": "float_add",
+                "SUBTRACT": "float_sub",
+                "MULTIPLY": "float_mul",
+                "TRUE_DIVIDE": "float_div",
+            }
+            self.cpu.cycles += HELPER_CYCLES.get(fop.get(name, "float_cmp"), 0)
+            if name in fop:
+                self.cpu.cycles += ALLOC_CYCLES
+                return self.to_obj(bits2f(f2bits(ops[name]())))
+        return self.to_obj(ops[name]())
+
+    def f_obj_subscr(self, base, index, val, *_):
+        b = self.from_obj(base)
+        i = self.from_obj(index)
+        if val == 4:  # MP_OBJ_SENTINEL: load
+            return self.to_obj(b[i])
+        if val == 0:
+            del b[i]
+        else:
+            b[i] = self.from_obj(val)
+        return 0
+
+    def f_native_getiter(self, o, iter_buf, *_):
+        # As mp_native_getiter(), the iterator is kept in buf[0] of iter_buf
+        v = self.from_obj(o)
+        if not isinstance(v, GenInstance):
+            o = self.to_obj(RangeIter(iter(v)))
+        if not iter_buf:
+            return o
+        self.cpu.write(iter_buf, 4, 0)
+        self.cpu.write(iter_buf + 4, 4, o)
+        return 0
+
+    def f_native_iternext(self, it, *_):
+        if it not in self.objs:
+            it = self.cpu.read(it + 4, 4)
+        v = self.from_obj(it)
+        if isinstance(v, GenInstance):
+            kind, r = self._resume(v, CONST_NONE)
+            if kind == MP_VM_RETURN_EXCEPTION:
+                raise Raise(r)
+            return r if kind == MP_VM_RETURN_YIELD else 0
+        try:
+            return self.to_obj(next(v.it))
+        except StopIteration:
+            return 0
+
+    def f_native_yield_from(self, gen, send_value, ret_value, *_):
+        # As mp_native_yield_from() in py/nativeglue.c
+        cpu = self.cpu
+        throw_value = cpu.read(ret_value, 4)
+        if throw_value:
+            send_value = 0
+        kind, r = self._resume(self.from_obj(gen), send_value, throw_value)
+        if kind == MP_VM_RETURN_EXCEPTION:
+            raise Raise(r)
+        cpu.write(ret_value, 4, r or CONST_NONE)
+        return 1 if kind == MP_VM_RETURN_YIELD else 0
+
+    def f_native_call_function_n_kw(self, fun, n_args_kw, args, *_):
+        f = self.from_obj(fun)
+        argv = [self.cpu.read(args + 4 * i, 4) for i in range(n_args_kw & 0xFF)]
+        if isinstance(f, NativeFun):
+            return self._run(f, argv)
+        fn = f.fn if isinstance(f, Builtin) else f
+        return self.to_obj(fn(*(self.from_obj(a) for a in argv)))
+
+    def f_nlr_push(self, buf, *_):
+        # As nlr_push() in py/nlrm68k.c, called from the native code
+        cpu = self.cpu
+        for i in range(6):
+            cpu.write(buf + NLR_REGS + 4 * i, 4, cpu.d[2 + i])
+        for i in range(5):
+            cpu.write(buf + NLR_REGS + 24 + 4 * i, 4, cpu.a[2 + i])
+        cpu.write(buf + NLR_SP, 4, cpu.a[7])
+        cpu.write(buf + NLR_PC, 4, cpu.read(cpu.a[7], 4))
+        cpu.write(buf, 4, self.nlr_top)
+        self.nlr_top = buf
+        return 0
+
+    def f_nlr_pop(self, *_):
+        self.nlr_top = self.cpu.read(self.nlr_top, 4)
+        return 0
+
+    def _nlr_jump(self, obj):
+        # As nlr_jump() in py/nlrm68k.c.  Returns 1 for the trap to return to
+        # the pc of the innermost nlr_push, with the registers it saved.
+        cpu = self.cpu
+        top = self.nlr_top
+        if top == self.run_base[-1]:
+            raise Raise(obj)
+        cpu.write(top + NLR_RET_VAL, 4, obj)
+        self.nlr_top = cpu.read(top, 4)
+        for i in range(6):
+            cpu.d[2 + i] = cpu.read(top + NLR_REGS + 4 * i, 4)
+        for i in range(5):
+            cpu.a[2 + i] = cpu.read(top + NLR_REGS + 24 + 4 * i, 4)
+        cpu.a[7] = cpu.read(top + NLR_SP, 4)
+        cpu.write(cpu.a[7], 4, cpu.read(top + NLR_PC, 4))
+        return 1
+
+    def f_native_raise(self, o, *_):
+        if o == 0 or o == CONST_NONE:
+            return 0
+        v = self.from_obj(o)
+        if isinstance(v, type):
+            o = self.to_obj(v())
+        return self._nlr_jump(o)
+
+    def f_arg_check_num_sig(self, n_args, n_kw, sig, *_):
+        raise M68kError(
+            "arg_check_num_sig failed: n_args=%d n_kw=%d sig=0x%x" % (n_args, n_kw, sig)
+        )
+
+    def f_setup_code_state(self, cs, n_args, n_kw, args, *_):
+        cpu = self.cpu
+        n_state = cpu.read(cs + 12, 2)
+        state = cs + 20
+        for i in range(n_state):
+            cpu.write(state + 4 * i, 4, 0)
+        for i in range(n_args):
+            cpu.write(state + 4 * (n_state - 1 - i), 4, cpu.read(args + 4 * i, 4))
+        cpu.write(cs + 8, 4, state - 4)
+        return 0
+
+    def _sint(self, v):
+        return v - (1 << 32) if v & 0x80000000 else v
+
+    def f_small_int_floor_divide(self, a, b, *_):
+        return self._sint(a) // self._sint(b)
+
+    def f_small_int_modulo(self, a, b, *_):
+        return self._sint(a) % self._sint(b)
+
+    def f_small_int_multiply(self, a, b, *_):
+        return self._sint(a) * self._sint(b)
+
+    def _fdiv(self, a, b):
+        if b == 0:
+            if a == 0 or math.isnan(a):
+                return math.nan
+            return math.copysign(math.inf, a) * math.copysign(1.0, b)
+        return a / b
+
+    def f_float_add(self, a, b, *_):
+        return f2bits(bits2f(a) + bits2f(b))
+
+    def f_float_sub(self, a, b, *_):
+        return f2bits(bits2f(a) - bits2f(b))
+
+    def f_float_mul(self, a, b, *_):
+        return f2bits(bits2f(a) * bits2f(b))
+
+    def f_float_div(self, a, b, *_):
+        return f2bits(self._fdiv(bits2f(a), bits2f(b)))
+
+    def f_float_cmp(self, a, b, *_):
+        a = bits2f(a)
+        b = bits2f(b)
+        return -1 if a < b else 0 if a == b else 1 if a > b else 2
+
+    def f_float_from_int(self, a, *_):
+        return f2bits(float(self._sint(a)))
+
+    def f_float_to_int(self, a, *_):
+        f = bits2f(a)
+        if not math.isfinite(f):
+            raise M68kError("float_to_int of %r" % f)
+        return math.trunc(f)
+
+
+def run_file(path, march="m68k", verbose=False, bench=None):
+    # Run the annotations of one test file, returning the number of failures
+    # and the total cycles of the calls.  If bench is a list, the BENCH calls
+    # are appended to it as (call, cycles) and TEST/CHECK lines are skipped.
+    # Files marked for a 68020 return None when run for a 68000.
+    cpu020 = march.startswith("m68k020") or march.endswith("+fpu")
+    if not cpu020 and "\n# CPU 68020\n" in open(path).read():
+        return None
+    with tempfile.TemporaryDirectory() as tmp:
+        mpy = os.path.join(tmp, "test.mpy")
+        subprocess.check_call([MPY_CROSS, "-march=" + march, "-o", mpy, path])
+        h = Harness(path, mpy, march=march)
+    env = {}
+    fails = 0
+    total_cycles = 0
+    for line in open(path):
+        m = re.match(r"# (SETUP|TEST|CHECK|BENCH) (.*)", line)
+        if not m:
+            continue
+        kind, text = m.groups()
+        if kind == "SETUP":
+            exec(text, env)
+            continue
+        if bench is not None and kind != "BENCH":
+            continue
+        if kind == "CHECK":
+            if not eval(text, env):
+                print("FAIL %s: CHECK %s" % (path, text))
+                fails += 1
+            continue
+        call, _, exp = text.partition(" -> ")
+        name, args = re.match(r"(\w+)\((.*)\)$", call).groups()
+        args = eval("(" + args + ",)", env) if args else ()
+        try:
+            r = h.call(name, *args)
+        except M68kError as er:
+            print("FAIL %s: %s raised %r" % (path, call, er))
+            fails += 1
+            continue
+        total_cycles += h.cpu.cycles
+        if verbose:
+            helpers = " ".join("%s:%d" % kv for kv in sorted(h.helper_calls.items()))
+            print("  %-40s %9d cycles %7d insns  %s" % (call, h.cpu.cycles, h.cpu.insns, helpers))
+        if kind == "BENCH":
+            if bench is not None:
+                bench.append((call, h.cpu.cycles))
+        elif r != eval(exp, env):
+            print("FAIL %s: %s -> %r, expected %r" % (path, call, r, eval(exp, env)))
+            fails += 1
+    return fails, total_cycles
+
+
+def main():
+    cmd_parser = argparse.ArgumentParser(
+        description="Run m68k native code tests on an instruction set simulator."
+    )
+    cmd_parser.add_argument(
+        "-v", "--verbose", action="store_true", help="print the cycle count of each call"
+    )
+    cmd_parser.add_argument(
+        "--fpu",
+        action="store_true",
+        help="compile for and simulate a 68881/68882 FPU (implies --cpu 68020)",
+    )
+    cmd_parser.add_argument(
+        "--cpu",
+        choices=("68000", "68020"),
+        default="68000",
+        help="compile for and simulate this CPU (default 68000)",
+    )
+    cmd_parser.add_argument(
+        "--bench",
+        action="store_true",
+        help="only run BENCH calls and print their cycles in run-perfbench.py format"
+        " (native and viper code only, the bytecode VM is not simulated)",
+    )
+    cmd_parser.add_argument("files", nargs="*", help="input test files")
+    args = cmd_parser.parse_args()
+
+    march = "m68k020" if args.cpu == "68020" or args.fpu else "m68k"
+    if args.fpu:
+        march += "+fpu"
+    files = args.files or sorted(glob.glob(TESTS_DIR + "/m68k/*.py"))
+    if args.bench:
+        # The output can be compared with "run-perfbench.py -t old new", the
+        # score being the number of calls per second on a 10MHz 68000.
+        print("N=0 M=0 march={}".format(march))
+    n_fail = 0
+    for f in files:
+        name = os.path.relpath(f, TESTS_DIR)
+        bench = [] if args.bench else None
+        result = run_file(f, march, args.verbose, bench)
+        if result is None:
+            if not args.bench:
+                print("%s: skip" % name)
+            continue
+        fails, cycles = result
+        n_fail += fails
+        if args.bench:
+            for call, cycles in bench:
+                print(
+                    "{}/{}: {:.2f} 0.0000 {:.2f} 0.0000".format(
+                        name, call, cycles, 10000000 / cycles
+                    )
+                )
+        else:
+            result = "pass" if not fails else "%d failures" % fails
+            print("%s: %s, %d cycles" % (name, result, cycles))
+    sys.exit(1 if n_fail else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+# Test GVRam.blit() from buffers, framebuf and GVRAM pages
+
+try:
+    import x68k
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+from array import array
+
+x68k.crtmod(12, True)
+g = x68k.GVRam()
+
+
+def show(x0, y0, x1, y1):
+    with x68k.Super():
+        for y in range(y0, y1 + 1):
+            print(" ".join("%2x" % g.point(x, y) for x in range(x0, x1 + 1)))
+    print()
+
+
+# 4x3 image of 16-bit pixels
+img = array("H", range(1, 13))
+g.blit(img, 1, 1, 4, 3)
+show(0, 0, 5, 4)
+# transparency key and raster op
+g.blit(img, 1, 1, 4, 3, 6, "xor")
+show(0, 0, 5, 4)
+# stride and source origin
+g.wipe()
+g.blit(img, 0, 0, 2, 2, stride=4, sx=1, sy=1)
+show(0, 0, 2, 2)
+# clipping by window and by negative position
+g.wipe()
+g.window(2, 2, 4, 4)
+g.blit(img, 1, 1, 4, 3)
+show(0, 0, 5, 4)
+g.window(0, 0, 511, 511)
+g.wipe()
+g.blit(img, -2, -1, 4, 3)
+show(0, 0, 3, 2)
+# page to itself, overlapping
+g.wipe()
+g.blit(img, 0, 0, 4, 3)
+g.blit(g, 1, 1, 4, 3)
+show(0, 0, 5, 4)
+g.blit(g, 0, 0, 4, 3, sx=1, sy=1)
+show(0, 0, 5, 4)
+# framebuf.FrameBuffer in the RGB565 format
+fb = framebuf.FrameBuffer(bytearray(4 * 2 * 2), 4, 2, framebuf.RGB565)
+fb.fill(0x55)
+fb.pixel(1, 1, 0)
+g.wipe()
+g.blit(fb, 0, 0, 4, 2, key=0, op="or")
+show(0, 0, 4, 2)
+# errors
+for bad in ({"op": "nand"}, {}):
+    try:
+        g.blit(bytearray(3), 0, 0, 4, 3, **bad)
+    except ValueError as e:
+        print(e)
+# 16 colors: 4 bits per pixel, pages are copied to each other
+x68k.crtmod(4, True)
+g1 = x68k.GVRam(1)
+g1.blit(bytes([0x12, 0x34, 0x56]), 0, 0, 3, 2)
+g3 = x68k.GVRam(3)
+g3.blit(g1, 1, 0, 3, 2)
+with x68k.Super():
+    print([g1.point(x, y) for y in range(2) for x in range(3)], [g3.point(x, 0) for x in range(4)])
+fb = framebuf.FrameBuffer(bytearray(3 * 2), 3, 2, framebuf.GS4_HMSB)
+fb.pixel(2, 1, 9)
+g1.blit(fb, 0, 0, 3, 2, stride=4)
+with x68k.Super():
+    print([g1.point(x, y) for y in range(2) for x in range(3)])
+# 256 colors: 8 bits per pixel
+x68k.crtmod(8, True)
+g = x68k.GVRam(1)
+g.blit(b"\x01\x02\x03\x04", 10, 10, 2, 2, key=2)
+with x68k.Super():
+    print(g.point(10, 10), g.point(11, 10), g.point(10, 11), g.point(11, 11))
+try:
+    x68k.GVRam(2).blit(g, 0, 0, 1, 1)
+except ValueError as e:
+    print(e)
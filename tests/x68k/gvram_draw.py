@@ -0,0 +1,82 @@
+# Test the GVRam drawing methods that write into the GVRAM directly
+
+try:
+    import x68k
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+from array import array
+
+x68k.crtmod(12, True)  # 512x512 65536 colors
+g = x68k.GVRam()
+
+
+def pixels(x0, y0, x1, y1):
+    with x68k.Super():
+        return [[g.point(x, y) for x in range(x0, x1 + 1)] for y in range(y0, y1 + 1)]
+
+
+def show(x0, y0, x1, y1):
+    for row in pixels(x0, y0, x1, y1):
+        print("".join("." if c == 0 else "#" for c in row))
+
+
+def painted():
+    # number of pixels drawn on the whole page
+    n = 0
+    with x68k.Super():
+        m = memoryview(g)
+        for i in range(0, len(m), 2):
+            if m[i] or m[i + 1]:
+                n += 1
+    return n
+
+
+# lines, boxes and fills
+g.line(0, 0, 15, 5, 1)
+g.line(0, 7, 15, 7, 1, 0xf0f0)
+g.box(0, 9, 7, 14, 1)
+g.fill(10, 10, 13, 13, 1)
+show(0, 0, 15, 15)
+
+# circles: outline, ellipse and filled
+g.wipe()
+g.circle(8, 8, 6, 1)
+show(0, 0, 16, 16)
+g.wipe()
+g.circle(8, 4, 8, 1, ratio=128, fill=True)
+show(0, 0, 16, 8)
+g.wipe()
+g.circle(40, 40, 5, 1, 0, 90)
+show(35, 35, 45, 45)
+try:
+    g.circle(40, 40, 5, 1, 0, 90, fill=True)
+except ValueError:
+    print("ValueError")
+
+# clipping to the window
+g.wipe()
+g.window(100, 100, 199, 149)
+g.fill(0, 0, 511, 511, 2)
+g.line(0, 0, 511, 511, 3)
+g.circle(150, 125, 80, 4)
+g.circle(150, 125, 80, 5, fill=True)
+print(pixels(99, 99, 100, 100), pixels(199, 149, 200, 150))
+print(painted())
+g.window(0, 0, 511, 511)
+
+# batched points, with one color or each its own
+g.wipe()
+g.plot(array("h", [1, 1, 3, 1, 5, 1, -1, 0, 512, 0]), 1)
+g.plot(array("h", [2, 2, 6, 4, 2, 7]))
+show(0, 0, 6, 2)
+with x68k.Super():
+    print(g.point(2, 2), g.point(4, 2))
+
+# 16 color mode: colors are masked to 4 bits, pages are separate
+x68k.crtmod(4, True)
+g1 = x68k.GVRam(1)
+g1.fill(0, 0, 3, 3, 0x1f)
+with x68k.Super():
+    g1.pset(5, 5, 0x23)
+    print(g1.point(0, 0), g1.point(5, 5), x68k.GVRam(0).point(0, 0))
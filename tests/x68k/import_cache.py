@@ -0,0 +1,109 @@
+# test caching of modules compiled at import in __pycache__
+
+try:
+    import x68k
+    import os
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+import sys
+import micropython
+
+tmp = "import_cache_tmp"
+
+
+def write(path, data):
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+def read(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def rmtree(path):
+    for name in os.listdir(path):
+        p = path + "/" + name
+        if os.stat(p)[0] & 0x4000:
+            rmtree(p)
+        else:
+            os.remove(p)
+    os.rmdir(path)
+
+
+def load(name):
+    sys.modules.pop(name, None)
+    return __import__(name).x
+
+
+try:
+    rmtree(tmp)
+except OSError:
+    pass
+os.mkdir(tmp)
+sys.path.insert(0, tmp)
+dont_write = sys.dont_write_bytecode
+try:
+    mod = tmp + "/cachemod.py"
+    cache = tmp + "/__pycache__/cachemod.mpy"
+    write(mod, b'x = "aaaa"\n')
+
+    # nothing is saved while sys.dont_write_bytecode is set
+    sys.dont_write_bytecode = True
+    print(load("cachemod"), "__pycache__" in os.listdir(tmp))
+
+    # otherwise the first import compiles the module and saves it to the cache
+    sys.dont_write_bytecode = False
+    print(load("cachemod"), "cachemod.mpy" in os.listdir(tmp + "/__pycache__"))
+
+    # the next import loads the cache, seen here by patching the string in it
+    write(cache, read(cache).replace(b"aaaa", b"bbbb"))
+    print(load("cachemod"))
+
+    # a cache saved for another optimisation level is stale, and is saved again
+    micropython.opt_level(1)
+    print(load("cachemod"))
+    write(cache, read(cache).replace(b"aaaa", b"bbbb"))
+    print(load("cachemod"))
+    micropython.opt_level(0)
+    print(load("cachemod"))
+    write(cache, read(cache).replace(b"aaaa", b"bbbb"))
+
+    # so is a cache saved for another source mtime
+    data = bytearray(read(cache))
+    data[8] ^= 1
+    write(cache, data)
+    print(load("cachemod"), read(cache)[8] == data[8] ^ 1)
+
+    # so is a cache saved for another source size
+    write(mod, b'x = "ccccc"\n')
+    print(load("cachemod"))
+    write(cache, read(cache).replace(b"ccccc", b"ddddd"))
+    print(load("cachemod"))
+
+    # a truncated cache is not loaded, and is saved again in full
+    data = read(cache)
+    write(cache, data[:-3])
+    print(load("cachemod"), read(cache) == data.replace(b"ddddd", b"ccccc"))
+
+    # packages are cached in their own directory
+    os.mkdir(tmp + "/cachepkg")
+    write(tmp + "/cachepkg/__init__.py", b'x = "ppp"\n')
+    write(tmp + "/cachepkg/sub.py", b'x = "sss"\n')
+    import cachepkg.sub
+
+    print(cachepkg.x, cachepkg.sub.x, sorted(os.listdir(tmp + "/cachepkg/__pycache__")))
+    for name in ("__init__", "sub"):
+        cache = tmp + "/cachepkg/__pycache__/" + name + ".mpy"
+        write(cache, read(cache).replace(b"ppp", b"PPP").replace(b"sss", b"SSS"))
+    del sys.modules["cachepkg"], sys.modules["cachepkg.sub"]
+    import cachepkg.sub
+
+    print(cachepkg.x, cachepkg.sub.x)
+finally:
+    sys.dont_write_bytecode = dont_write
+    micropython.opt_level(0)
+    sys.path.pop(0)
+    rmtree(tmp)
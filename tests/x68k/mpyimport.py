@@ -0,0 +1,94 @@
+# test x68k.mpyimport() running .mpy images in place, at any alignment
+
+try:
+    import x68k
+    import uctypes
+    import os
+    import struct
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+import sys
+
+# the image is made by compiling a module through the .mpy import cache, so it
+# holds native code for the machine running the test
+if not hasattr(sys, "dont_write_bytecode"):
+    print("SKIP")
+    raise SystemExit
+
+tmp = "mpyimport_tmp"
+src = b"""
+import micropython
+
+x = 6
+
+
+def f(a):
+    return a * x
+
+
+@micropython.native
+def g(a):
+    return a + 1
+
+
+@micropython.viper
+def h(a: int) -> int:
+    return a * 3
+"""
+
+
+def rmtree(path):
+    for name in os.listdir(path):
+        p = path + "/" + name
+        if os.stat(p)[0] & 0x4000:
+            rmtree(p)
+        else:
+            os.remove(p)
+    os.rmdir(path)
+
+
+def make_image():
+    os.mkdir(tmp)
+    sys.path.insert(0, tmp)
+    dont_write = sys.dont_write_bytecode
+    sys.dont_write_bytecode = False
+    try:
+        with open(tmp + "/mpyimp_src.py", "wb") as f:
+            f.write(src)
+        __import__("mpyimp_src")
+        del sys.modules["mpyimp_src"]
+        with open(tmp + "/__pycache__/mpyimp_src.mpy", "rb") as f:
+            data = f.read()
+    finally:
+        sys.dont_write_bytecode = dont_write
+        sys.path.pop(0)
+        rmtree(tmp)
+    # the cache header ends with the length of the .mpy data that follows it
+    n = struct.unpack_from("I", data, 16)[0]
+    return data[20:] if n == len(data) - 20 else None
+
+
+def load(name, image, off):
+    buf = bytearray(len(image) + 1)
+    buf[off : off + len(image)] = image
+    return buf, x68k.mpyimport(name, uctypes.addressof(buf) + off, len(image))
+
+
+img = make_image()
+print(img[:1])
+
+# the image must stay in memory while the module is used
+keep = []
+for off in (0, 1):
+    buf, m = load("mpyimp_mod", img, off)
+    keep.append(buf)
+    print(m.f(7), m.g(1), m.h(5), sys.modules["mpyimp_mod"] is m)
+
+# a broken image raises, and does not leave the module behind
+try:
+    load("mpyimp_bad", b"X" + img[1:], 0)
+except ValueError:
+    print("ValueError")
+print("mpyimp_bad" in sys.modules)
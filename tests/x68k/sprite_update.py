@@ -0,0 +1,74 @@
+try:
+    import x68k
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+import machine
+from array import array
+
+spr = x68k.Sprite()
+
+def regs(plane):
+    a = 0xEB0000 + plane * 8
+    return tuple(machine.mem16[a + i * 2] for i in range(4))
+
+print(spr.NOW, spr.VSYNC, spr.DEFER)
+
+# one pass, written at once
+buf = array("h", [0, 16, 32, 0x0101, 3, 5, 1040, -1, 0x8102 - 0x10000, 2])
+spr.update(buf, spr.NOW)
+print(regs(0), regs(5))
+
+# waits for the blanking period
+spr.update(array("h", [1, 100, 200, 0x0203, 3]))
+print(regs(1))
+
+# deferred: written by the VSYNC interrupt, latest record wins
+buf = array("h", [2, 48, 64, 0x0304, 3, 2, 49, 65, 0x0305, 2])
+spr.update(buf, spr.DEFER)
+buf[1] = 0
+print(regs(2))
+x68k.vsync()
+print(regs(2))
+x68k.vsync()
+print(regs(2))
+
+# written at once after a deferred update of the same plane, which is dropped
+spr.update(array("h", [2, 10, 11, 0x0306, 1, 6, 12, 13, 0x0307, 1]), spr.DEFER)
+spr.update(array("h", [2, 20, 21, 0x0308, 3]), spr.NOW)
+x68k.vsync()
+print(regs(2), regs(6))
+
+# together with an IntVSync callback
+count = 0
+def cb(arg):
+    global count
+    count += 1
+with x68k.IntVSync(cb):
+    spr.update(array("h", [3, 1, 2, 3, 1]), spr.DEFER)
+    x68k.vsync()
+    print(regs(3), count)
+spr.update(array("h", [3, 4, 5, 6, 1]), spr.DEFER)
+x68k.vsync()
+print(regs(3), count)
+
+# flushed in the next frame even when the callback runs every 3rd frame
+count = 0
+with x68k.IntVSync(cb, disp=True, cycle=3):
+    spr.update(array("h", [3, 7, 8, 9, 1]), spr.DEFER)
+    x68k.vsync()
+    print(regs(3), count)
+    x68k.vsync()
+    x68k.vsync()
+    print(count)
+
+# bytes with native int16 records
+spr.update(bytes(array("h", [4, 7, 8, 9, 1])), False)
+print(regs(4))
+
+for bad in (array("h", [128, 0, 0, 0, 0]), array("h", [-1, 0, 0, 0, 0]), array("h", [0, 1, 2, 3])):
+    try:
+        spr.update(bad)
+    except ValueError:
+        print("ValueError")
+print(regs(0))
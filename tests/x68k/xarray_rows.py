@@ -0,0 +1,96 @@
+# test 2-dimension xarray element and row access, and whole-buffer operations
+
+try:
+    import x68k
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+import micropython
+
+# a[i, j] reads and writes an element
+a = x68k.xarray_int(3, 4)
+for i in range(3):
+    for j in range(4):
+        a[i, j] = i * 10 + j
+print(a)
+print(a[-1, -1], a[2][3])
+
+# rows are views sharing the items, and the same view is returned each time
+print(a[1], a[1] is a[1])
+a[1][2] = 99
+print(a[1, 2])
+
+# row and slice assignment
+a[0] = [7, 7, 7, 7]
+a[2] = (1, 2, 3, 4)
+print(a.list())
+a[0:2] = range(8)
+print(a.list())
+
+# fill() and copyfrom()
+a.fill(5)
+print(a.list(True))
+b = x68k.xarray_char(4)
+b.fill(200)
+print(b)
+b.copyfrom(b"\x01\x02\x03\x04")
+print(b)
+b[1:3] = b"\x09\x08"
+print(b)
+b[:] = [4, 3, 2, 1]
+print(b)
+c = x68k.xarray_float(2, 2)
+c.fill(1.5)
+print(c)
+c.copyfrom([1, 2, 3, 4])
+print(c)
+print([list(r) for r in c])
+
+# buffers of another item type are converted item by item, not copied as raw
+# bits, and floats are not stored to ints
+import array
+d = x68k.xarray_int(2, 3)
+d[1] = array.array("I", [4, 5, 6])
+try:
+    d[0] = array.array("f", [1.0, 2.0, 3.0])
+except TypeError:
+    print("TypeError")
+print(d.list())
+c[0] = array.array("q", [7, 8])
+c[1] = array.array("d", [0.5, 0.25])
+print(c.list())
+
+# errors
+try:
+    b[1:3] = [1]
+except ValueError:
+    print("ValueError")
+try:
+    b.copyfrom(b"\x00")
+except ValueError:
+    print("ValueError")
+try:
+    a[3, 0]
+except IndexError:
+    print("IndexError")
+try:
+    b[0, 0]
+except TypeError:
+    print("TypeError")
+
+# row access allocates nothing once the views exist
+s = 0
+for r in a:
+    s += r[0]
+micropython.heap_lock()
+i = 0
+while i < 3:
+    j = 0
+    while j < 4:
+        a[i][j] = i + j
+        s += a[i][j]
+        j += 1
+    i += 1
+micropython.heap_unlock()
+print(s)
@@ -100,6 +100,17 @@ function ci_mpy_format_test {
     ./tools/mpy-tool.py -xd examples/natmod/features1/features1.mpy
 }
 
+########################################################################################
+# m68k native emitter
+
+function ci_m68k_emitter_build {
+    make ${MAKEOPTS} -C mpy-cross
+}
+
+function ci_m68k_emitter_run_tests {
+    (cd tests && ./run-m68ktests.py && ./run-m68ktests.py --cpu 68020 && ./run-m68ktests.py --fpu)
+}
+
 ########################################################################################
 # ports/cc3200
 
@@ -0,0 +1,1167 @@
+#!/usr/bin/env python3
+#
+# This file is part of the MicroPython project, http://micropython.org/
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 Yuichi Nakamura
+#
+# Minimal MC68000 instruction set simulator, used to run and time machine code
+# generated by the m68k native emitter and inline assembler on a host machine.
+#
+# Cycle counts follow the MC68000 user's manual instruction timing tables with
+# zero wait states.  Memory refresh and bus arbitration are not modelled.
+#
+# With cpu020 set, the 68020 instructions used by the native emitter and the
+# inline assembler are also accepted: 32-bit multiply and divide, extb.l,
+# link.l, bcc.l, bit fields and scaled index addressing.  These take roughly
+# their 68020 cache-case times while everything else keeps 68000 timings, so
+# cycle counts in this mode are only an estimate of the instructions saved.
+
+import math
+import struct
+
+
+class M68kError(Exception):
+    pass
+
+
+class Trap(Exception):
+    # Raised when the PC reaches an address registered with add_trap().
+    def __init__(self, addr):
+        self.addr = addr
+
+
+# Effective address calculation time, (byte/word, long), indexed by mode/reg
+def _ea_time(mode, reg, size):
+    if mode <= 1:
+        return 0
+    if mode == 7:
+        t = {0: (8, 12), 1: (12, 16), 2: (8, 12), 3: (10, 14), 4: (4, 8)}[reg]
+    else:
+        t = {2: (4, 8), 3: (4, 8), 4: (6, 10), 5: (8, 12), 6: (10, 14)}[mode]
+    return t[size == 4]
+
+
+# Destination EA time for MOVE
+def _ea_time_move_dst(mode, reg, size):
+    if mode <= 1:
+        return 0
+    if mode == 7:
+        t = {0: (8, 12), 1: (12, 16)}[reg]
+    else:
+        t = {2: (4, 8), 3: (4, 8), 4: (4, 8), 5: (8, 12), 6: (10, 14)}[mode]
+    return t[size == 4]
+
+
+_MASK = {1: 0xFF, 2: 0xFFFF, 4: 0xFFFFFFFF}
+_SIGN = {1: 0x80, 2: 0x8000, 4: 0x80000000}
+_SIZE2 = {0: 1, 1: 2, 2: 4}  # standard size field encoding
+
+
+def _sext(v, size):
+    v &= _MASK[size]
+    if v & _SIGN[size]:
+        v -= _MASK[size] + 1
+    return v
+
+
+class CPU:
+    def __init__(self, mem_size=0x100000):
+        self.mem = bytearray(mem_size)
+        self.d = [0] * 8
+        self.a = [0] * 8
+        self.pc = 0
+        self.x = self.n = self.z = self.v = self.c = 0
+        self.cycles = 0
+        self.insns = 0
+        self.traps = {}
+        self.cpu020 = False
+        # 68881/68882 coprocessor, only Dn source/destination forms are modelled
+        self.fpu = False
+        self.fp = [0.0] * 8
+        self.fpcc_n = self.fpcc_z = self.fpcc_nan = 0
+
+    # Memory access
+
+    def _check(self, addr, size):
+        if size > 1 and addr & 1:
+            raise M68kError("address error at 0x%06x (pc=0x%06x)" % (addr, self.pc))
+        if addr + size > len(self.mem) or addr < 0:
+            raise M68kError("bus error at 0x%08x (pc=0x%06x)" % (addr, self.pc))
+
+    def read(self, addr, size):
+        addr &= 0xFFFFFFFF
+        self._check(addr, size)
+        return int.from_bytes(self.mem[addr : addr + size], "big")
+
+    def write(self, addr, size, val):
+        addr &= 0xFFFFFFFF
+        self._check(addr, size)
+        self.mem[addr : addr + size] = (val & _MASK[size]).to_bytes(size, "big")
+
+    def load(self, addr, data):
+        self.mem[addr : addr + len(data)] = data
+
+    def push32(self, val):
+        self.a[7] = (self.a[7] - 4) & 0xFFFFFFFF
+        self.write(self.a[7], 4, val)
+
+    def pop32(self):
+        v = self.read(self.a[7], 4)
+        self.a[7] = (self.a[7] + 4) & 0xFFFFFFFF
+        return v
+
+    def add_trap(self, addr, fn):
+        self.traps[addr] = fn
+
+    def fetch16(self):
+        v = self.read(self.pc, 2)
+        self.pc += 2
+        return v
+
+    def fetch32(self):
+        v = self.read(self.pc, 4)
+        self.pc += 4
+        return v
+
+    # Condition codes
+
+    def ccr(self):
+        return self.x << 4 | self.n << 3 | self.z << 2 | self.v << 1 | self.c
+
+    def set_ccr(self, v):
+        self.x = v >> 4 & 1
+        self.n = v >> 3 & 1
+        self.z = v >> 2 & 1
+        self.v = v >> 1 & 1
+        self.c = v & 1
+
+    def test_cc(self, cc):
+        n, z, v, c = self.n, self.z, self.v, self.c
+        return [
+            True,
+            False,
+            not c and not z,
+            c or z,
+            not c,
+            c,
+            not z,
+            z,
+            not v,
+            v,
+            not n,
+            n,
+            n == v,
+            n != v,
+            n == v and not z,
+            z or n != v,
+        ][cc]
+
+    def flags_logic(self, r, size):
+        self.n = 1 if r & _SIGN[size] else 0
+        self.z = 1 if r & _MASK[size] == 0 else 0
+        self.v = self.c = 0
+
+    def do_add(self, s, d, size, x=0):
+        m = _MASK[size]
+        s &= m
+        d &= m
+        r = s + d + x
+        rm = r & m
+        sb = _SIGN[size]
+        self.c = self.x = 1 if r > m else 0
+        self.v = 1 if (~(s ^ d) & (s ^ rm)) & sb else 0
+        self.n = 1 if rm & sb else 0
+        self.z = 1 if rm == 0 else 0
+        return rm
+
+    def do_sub(self, s, d, size, x=0, cmp=False):
+        m = _MASK[size]
+        s &= m
+        d &= m
+        r = d - s - x
+        rm = r & m
+        sb = _SIGN[size]
+        c = 1 if r < 0 else 0
+        self.c = c
+        if not cmp:
+            self.x = c
+        self.v = 1 if ((s ^ d) & (d ^ rm)) & sb else 0
+        self.n = 1 if rm & sb else 0
+        self.z = 1 if rm == 0 else 0
+        return rm
+
+    # Effective addresses
+    #
+    # An EA is resolved to a tuple (kind, value): kind is "d", "a", "m" or "i"
+
+    def ea(self, mode, reg, size):
+        if mode == 0:
+            return ("d", reg)
+        if mode == 1:
+            return ("a", reg)
+        if mode == 2:
+            return ("m", self.a[reg])
+        if mode == 3:
+            addr = self.a[reg]
+            inc = 2 if (reg == 7 and size == 1) else size
+            self.a[reg] = (addr + inc) & 0xFFFFFFFF
+            return ("m", addr)
+        if mode == 4:
+            dec = 2 if (reg == 7 and size == 1) else size
+            self.a[reg] = (self.a[reg] - dec) & 0xFFFFFFFF
+            return ("m", self.a[reg])
+        if mode == 5:
+            return ("m", (self.a[reg] + _sext(self.fetch16(), 2)) & 0xFFFFFFFF)
+        if mode == 6:
+            return ("m", (self.a[reg] + self._index()) & 0xFFFFFFFF)
+        if reg == 0:
+            return ("m", _sext(self.fetch16(), 2) & 0xFFFFFFFF)
+        if reg == 1:
+            return ("m", self.fetch32())
+        if reg == 2:
+            base = self.pc
+            return ("m", (base + _sext(self.fetch16(), 2)) & 0xFFFFFFFF)
+        if reg == 3:
+            base = self.pc
+            return ("m", (base + self._index()) & 0xFFFFFFFF)
+        if reg == 4:
+            if size == 4:
+                return ("i", self.fetch32())
+            return ("i", self.fetch16() & _MASK[size])
+        raise M68kError("bad EA mode 7/%d at 0x%06x" % (reg, self.pc))
+
+    def _index(self):
+        ext = self.fetch16()
+        if ext & 0x0100 or (ext & 0x0600 and not self.cpu020):
+            raise M68kError("68020 extension word not supported at 0x%06x" % self.pc)
+        xr = ext >> 12 & 7
+        xv = self.a[xr] if ext & 0x8000 else self.d[xr]
+        if not ext & 0x0800:
+            xv = _sext(xv, 2)
+        return (xv << (ext >> 9 & 3)) + _sext(ext & 0xFF, 1)
+
+    def rd(self, e, size):
+        k, v = e
+        if k == "d":
+            return self.d[v] & _MASK[size]
+        if k == "a":
+            return self.a[v] & _MASK[size]
+        if k == "m":
+            return self.read(v, size)
+        return v & _MASK[size]
+
+    def wr(self, e, size, val):
+        k, v = e
+        if k == "d":
+            m = _MASK[size]
+            self.d[v] = (self.d[v] & ~m & 0xFFFFFFFF) | (val & m)
+        elif k == "a":
+            self.a[v] = val & 0xFFFFFFFF
+        elif k == "m":
+            self.write(v, size, val)
+        else:
+            raise M68kError("write to immediate at 0x%06x" % self.pc)
+
+    # Execution
+
+    def run(self, max_insns=10000000):
+        while True:
+            if self.pc in self.traps:
+                fn = self.traps[self.pc]
+                if fn(self) is False:
+                    return
+                continue
+            self.step()
+            if self.insns > max_insns:
+                raise M68kError("instruction limit exceeded")
+
+    def step(self):
+        self.insn_pc = self.pc
+        op = self.fetch16()
+        self.insns += 1
+        h = self._dispatch[op >> 12]
+        h(self, op)
+
+    def illegal(self, op):
+        raise M68kError("illegal instruction %04x at 0x%06x" % (op, self.insn_pc))
+
+    # 0000: immediate ops, bit ops, movep
+    def op_0(self, op):
+        mode = op >> 3 & 7
+        reg = op & 7
+        if op & 0x0100 or (op & 0x0F00) == 0x0800:
+            # bit operations
+            if op & 0x0100:
+                if mode == 1:
+                    self.illegal(op)
+                bit = self.d[op >> 9 & 7]
+                imm = False
+            else:
+                bit = self.fetch16() & 0xFF
+                imm = True
+            kind = op >> 6 & 3
+            if mode == 0:
+                bit &= 31
+                e = ("d", reg)
+                size = 4
+            else:
+                bit &= 7
+                size = 1
+                e = self.ea(mode, reg, 1)
+            val = self.rd(e, size)
+            self.z = 0 if val & (1 << bit) else 1
+            if kind == 0:
+                if mode == 0:
+                    self.cycles += 10 if imm else 6
+                else:
+                    self.cycles += (8 if imm else 4) + _ea_time(mode, reg, 1)
+                return
+            if kind == 1:
+                val ^= 1 << bit
+            elif kind == 2:
+                val &= ~(1 << bit)
+            else:
+                val |= 1 << bit
+            self.wr(e, size, val)
+            base = {1: 8, 2: 10, 3: 8}[kind]
+            if mode == 0:
+                self.cycles += base + (4 if imm else 0)
+            else:
+                self.cycles += 8 + (4 if imm else 0) + _ea_time(mode, reg, 1)
+            return
+        sub = op >> 9 & 7
+        sz = op >> 6 & 3
+        if sz == 3:
+            self.illegal(op)
+        size = _SIZE2[sz]
+        imm = self.fetch32() if size == 4 else self.fetch16() & _MASK[size]
+        if mode == 7 and reg == 4:
+            # to CCR/SR
+            if sub == 0:
+                self.set_ccr(self.ccr() | imm)
+            elif sub == 1:
+                self.set_ccr(self.ccr() & imm)
+            elif sub == 5:
+                self.set_ccr(self.ccr() ^ imm)
+            else:
+                self.illegal(op)
+            self.cycles += 20
+            return
+        e = self.ea(mode, reg, size)
+        d = self.rd(e, size)
+        if sub == 0:
+            r = d | imm
+            self.flags_logic(r, size)
+        elif sub == 1:
+            r = d & imm
+            self.flags_logic(r, size)
+        elif sub == 2:
+            r = self.do_sub(imm, d, size)
+        elif sub == 3:
+            r = self.do_add(imm, d, size)
+        elif sub == 5:
+            r = d ^ imm
+            self.flags_logic(r, size)
+        elif sub == 6:
+            self.do_sub(imm, d, size, cmp=True)
+            if mode == 0:
+                self.cycles += 14 if size == 4 else 8
+            else:
+                self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+            return
+        else:
+            self.illegal(op)
+        self.wr(e, size, r)
+        if mode == 0:
+            self.cycles += 16 if size == 4 else 8
+        else:
+            self.cycles += (20 if size == 4 else 12) + _ea_time(mode, reg, size)
+
+    # 0001/0010/0011: move
+    def op_move(self, op):
+        size = {1: 1, 3: 2, 2: 4}[op >> 12]
+        smode = op >> 3 & 7
+        sreg = op & 7
+        dmode = op >> 6 & 7
+        dreg = op >> 9 & 7
+        s = self.rd(self.ea(smode, sreg, size), size)
+        t = 4 + _ea_time(smode, sreg, size)
+        if dmode == 1:
+            # movea
+            if size == 1:
+                self.illegal(op)
+            self.a[dreg] = _sext(s, size) & 0xFFFFFFFF
+            self.cycles += t
+            return
+        e = self.ea(dmode, dreg, size)
+        self.wr(e, size, s)
+        self.flags_logic(s, size)
+        self.cycles += t + _ea_time_move_dst(dmode, dreg, size)
+
+    # 0100: misc
+    def op_4(self, op):
+        mode = op >> 3 & 7
+        reg = op & 7
+        if op == 0x4E71:  # nop
+            self.cycles += 4
+            return
+        if op == 0x4E75:  # rts
+            self.pc = self.pop32()
+            self.cycles += 16
+            return
+        if op & 0xFFF8 == 0x4E50:  # link
+            disp = _sext(self.fetch16(), 2)
+            self.push32(self.a[reg])
+            self.a[reg] = self.a[7]
+            self.a[7] = (self.a[7] + disp) & 0xFFFFFFFF
+            self.cycles += 16
+            return
+        if op & 0xFFF8 == 0x4E58:  # unlk
+            self.a[7] = self.a[reg]
+            self.a[reg] = self.pop32()
+            self.cycles += 12
+            return
+        if op & 0xFFC0 == 0x4E80 or op & 0xFFC0 == 0x4EC0:  # jsr / jmp
+            e = self.ea(mode, reg, 4)
+            if e[0] != "m":
+                self.illegal(op)
+            jt = {2: 8, 5: 10, 6: 14}.get(mode) or {0: 10, 1: 12, 2: 10, 3: 14}[reg]
+            if op & 0x0040 == 0:
+                self.push32(self.pc)
+                jt += 8
+            self.pc = e[1]
+            self.cycles += jt
+            return
+        if self.cpu020 and op & 0xFFF8 == 0x49C0:  # extb.l
+            v = _sext(self.d[reg], 1) & 0xFFFFFFFF
+            self.d[reg] = v
+            self.flags_logic(v, 4)
+            self.cycles += 4
+            return
+        if op & 0xF1C0 == 0x41C0:  # lea
+            e = self.ea(mode, reg, 4)
+            if e[0] != "m":
+                self.illegal(op)
+            self.a[op >> 9 & 7] = e[1]
+            self.cycles += {2: 4, 5: 8, 6: 12}.get(mode) or {0: 8, 1: 12, 2: 8, 3: 12}[reg]
+            return
+        if op & 0xFFC0 == 0x4840:
+            if mode == 0:  # swap
+                v = self.d[reg]
+                v = ((v >> 16) | (v << 16)) & 0xFFFFFFFF
+                self.d[reg] = v
+                self.flags_logic(v, 4)
+                self.cycles += 4
+                return
+            e = self.ea(mode, reg, 4)  # pea
+            self.push32(e[1])
+            self.cycles += {2: 12, 5: 16, 6: 20}.get(mode) or {0: 16, 1: 20, 2: 16, 3: 20}[reg]
+            return
+        if self.cpu020 and op & 0xFFF8 == 0x4808:  # link.l
+            disp = _sext(self.fetch32(), 4)
+            self.push32(self.a[reg])
+            self.a[reg] = self.a[7]
+            self.a[7] = (self.a[7] + disp) & 0xFFFFFFFF
+            self.cycles += 16
+            return
+        if self.cpu020 and op & 0xFF80 == 0x4C00:  # mul.l / div.l
+            return self.op_muldivl(op)
+        if op & 0xFFB8 == 0x4880:  # ext
+            if op & 0x40:
+                v = _sext(self.d[reg], 2) & 0xFFFFFFFF
+                self.d[reg] = v
+                self.flags_logic(v, 4)
+            else:
+                v = _sext(self.d[reg], 1) & 0xFFFF
+                self.d[reg] = (self.d[reg] & 0xFFFF0000) | v
+                self.flags_logic(v, 2)
+            self.cycles += 4
+            return
+        if op & 0xFB80 == 0x4880:  # movem
+            return self.op_movem(op)
+        if op & 0xFF00 in (0x4000, 0x4200, 0x4400, 0x4600) and op & 0xC0 != 0xC0:
+            size = _SIZE2[op >> 6 & 3]
+            e = self.ea(mode, reg, size)
+            kind = op & 0xFF00
+            if kind == 0x4200:  # clr
+                if e[0] == "m":
+                    self.rd(e, size)
+                r = 0
+                self.flags_logic(0, size)
+            else:
+                d = self.rd(e, size)
+                if kind == 0x4400:  # neg
+                    r = self.do_sub(d, 0, size)
+                elif kind == 0x4000:  # negx
+                    z = self.z
+                    r = self.do_sub(d, 0, size, self.x)
+                    self.z = z if r == 0 else 0
+                else:  # not
+                    r = ~d & _MASK[size]
+                    self.flags_logic(r, size)
+            self.wr(e, size, r)
+            if mode == 0:
+                self.cycles += 6 if size == 4 else 4
+            else:
+                self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+            return
+        if op & 0xFF00 == 0x4A00 and op & 0xC0 != 0xC0:  # tst
+            size = _SIZE2[op >> 6 & 3]
+            if mode == 1:
+                self.illegal(op)
+            d = self.rd(self.ea(mode, reg, size), size)
+            self.flags_logic(d, size)
+            self.cycles += 4 + _ea_time(mode, reg, size)
+            return
+        if op & 0xFFC0 == 0x44C0:  # move to ccr
+            self.set_ccr(self.rd(self.ea(mode, reg, 2), 2))
+            self.cycles += 12 + _ea_time(mode, reg, 2)
+            return
+        if op & 0xFFC0 == 0x40C0:  # move from sr
+            self.wr(self.ea(mode, reg, 2), 2, self.ccr())
+            self.cycles += 6 if mode == 0 else 8 + _ea_time(mode, reg, 2)
+            return
+        if op & 0xF1C0 == 0x4180:  # chk
+            self.illegal(op)
+        self.illegal(op)
+
+    def op_muldivl(self, op):
+        ext = self.fetch16()
+        mode = op >> 3 & 7
+        reg = op & 7
+        if mode == 1:
+            self.illegal(op)
+        s = self.rd(self.ea(mode, reg, 4), 4)
+        signed = ext & 0x0800
+        wide = ext & 0x0400
+        dl = ext >> 12 & 7
+        dh = ext & 7
+        self.c = 0
+        if not op & 0x40:
+            # muls.l/mulu.l <ea>,Dl or <ea>,Dh:Dl
+            a = self.d[dl]
+            if signed:
+                a, s = _sext(a, 4), _sext(s, 4)
+            r = a * s
+            if wide:
+                r &= (1 << 64) - 1
+                self.d[dh] = r >> 32
+                self.d[dl] = r & 0xFFFFFFFF
+                self.n = r >> 63
+                self.v = 0
+            else:
+                lo = r & 0xFFFFFFFF
+                self.v = 1 if (_sext(lo, 4) if signed else lo) != r else 0
+                self.d[dl] = lo
+                self.n = lo >> 31
+            self.z = 1 if r & ((1 << 64) - 1 if wide else 0xFFFFFFFF) == 0 else 0
+            self.cycles += 43 + _ea_time(mode, reg, 4)
+            return
+        # divs.l/divu.l <ea>,Dq, divsl.l/divul.l <ea>,Dr:Dq or 64-bit <ea>,Dr:Dq
+        if s == 0:
+            raise M68kError("division by zero at 0x%06x" % self.insn_pc)
+        dv = self.d[dh] << 32 | self.d[dl] if wide else self.d[dl]
+        if signed:
+            bits = 64 if wide else 32
+            if dv >> (bits - 1):
+                dv -= 1 << bits
+            s = _sext(s, 4)
+        q = abs(dv) // abs(s)
+        if (dv < 0) != (s < 0):
+            q = -q
+        rem = dv - q * s
+        self.cycles += (90 if signed else 78) + _ea_time(mode, reg, 4)
+        if not (-(1 << 31) <= q < (1 << 31) if signed else q <= 0xFFFFFFFF):
+            self.v = 1
+            return
+        if dh != dl:
+            self.d[dh] = rem & 0xFFFFFFFF
+        self.d[dl] = q & 0xFFFFFFFF
+        self.v = 0
+        self.n = 1 if q & 0x80000000 else 0
+        self.z = 1 if q & 0xFFFFFFFF == 0 else 0
+
+    def op_movem(self, op):
+        size = 4 if op & 0x40 else 2
+        mode = op >> 3 & 7
+        reg = op & 7
+        mask = self.fetch16()
+        n = bin(mask).count("1")
+        per = 8 if size == 4 else 4
+        if op & 0x0400:
+            # memory to registers
+            if mode == 3:
+                addr = self.a[reg]
+            else:
+                e = self.ea(mode, reg, size)
+                addr = e[1]
+            for i in range(16):
+                if mask & (1 << i):
+                    v = _sext(self.read(addr, size), size) & 0xFFFFFFFF
+                    if i < 8:
+                        self.d[i] = v if size == 4 else (self.d[i] & 0xFFFF0000) | (v & 0xFFFF)
+                        if size == 2:
+                            self.d[i] = v
+                    else:
+                        self.a[i - 8] = v
+                    addr += size
+            if mode == 3:
+                self.a[reg] = addr & 0xFFFFFFFF
+            self.cycles += 12 + n * per + (0 if mode in (2, 3) else _ea_time(mode, reg, 2) - 4 + 4)
+        else:
+            # registers to memory
+            if mode == 4:
+                addr = self.a[reg]
+                for i in range(16):
+                    if mask & (1 << i):
+                        r = 15 - i
+                        v = self.d[r] if r < 8 else self.a[r - 8]
+                        addr -= size
+                        self.write(addr, size, v)
+                self.a[reg] = addr & 0xFFFFFFFF
+                self.cycles += 8 + n * per
+            else:
+                e = self.ea(mode, reg, size)
+                addr = e[1]
+                for i in range(16):
+                    if mask & (1 << i):
+                        v = self.d[i] if i < 8 else self.a[i - 8]
+                        self.write(addr, size, v)
+                        addr += size
+                self.cycles += 8 + n * per + (_ea_time(mode, reg, 2) - 4 if mode != 2 else 0)
+
+    # 0101: addq/subq/scc/dbcc
+    def op_5(self, op):
+        mode = op >> 3 & 7
+        reg = op & 7
+        if op & 0xC0 == 0xC0:
+            cc = op >> 8 & 15
+            if mode == 1:  # dbcc
+                disp = _sext(self.fetch16(), 2)
+                if self.test_cc(cc):
+                    self.cycles += 12
+                    return
+                v = (self.d[reg] - 1) & 0xFFFF
+                self.d[reg] = (self.d[reg] & 0xFFFF0000) | v
+                if v == 0xFFFF:
+                    self.cycles += 14
+                    return
+                self.pc = (self.insn_pc + 2 + disp) & 0xFFFFFFFF
+                self.cycles += 10
+                return
+            t = self.test_cc(cc)  # scc
+            e = self.ea(mode, reg, 1)
+            self.wr(e, 1, 0xFF if t else 0)
+            self.cycles += (6 if t else 4) if mode == 0 else 8 + _ea_time(mode, reg, 1)
+            return
+        size = _SIZE2[op >> 6 & 3]
+        q = op >> 9 & 7 or 8
+        if mode == 1:
+            v = self.a[reg]
+            self.a[reg] = (v - q if op & 0x100 else v + q) & 0xFFFFFFFF
+            self.cycles += 8
+            return
+        e = self.ea(mode, reg, size)
+        d = self.rd(e, size)
+        r = self.do_sub(q, d, size) if op & 0x100 else self.do_add(q, d, size)
+        self.wr(e, size, r)
+        if mode == 0:
+            self.cycles += 8 if size == 4 else 4
+        else:
+            self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+
+    # 0110: branches
+    def op_6(self, op):
+        cc = op >> 8 & 15
+        disp = op & 0xFF
+        base = self.pc
+        if disp == 0:
+            disp = _sext(self.fetch16(), 2)
+            short = False
+        elif disp == 0xFF:
+            if not self.cpu020:
+                raise M68kError("bcc.l is not a 68000 instruction at 0x%06x" % self.insn_pc)
+            disp = _sext(self.fetch32(), 4)
+            short = False
+        else:
+            disp = _sext(disp, 1)
+            short = True
+        if cc == 1:  # bsr
+            self.push32(self.pc)
+            self.pc = (base + disp) & 0xFFFFFFFF
+            self.cycles += 18
+            return
+        if self.test_cc(cc):
+            self.pc = (base + disp) & 0xFFFFFFFF
+            self.cycles += 10
+        else:
+            self.cycles += 8 if short else 12
+
+    # 0111: moveq
+    def op_7(self, op):
+        if op & 0x100:
+            self.illegal(op)
+        v = _sext(op & 0xFF, 1) & 0xFFFFFFFF
+        self.d[op >> 9 & 7] = v
+        self.flags_logic(v, 4)
+        self.cycles += 4
+
+    def _mul_time(self, v, signed):
+        if signed:
+            v = (v << 1) & 0x1FFFF
+            n = sum(1 for i in range(16) if ((v >> i) & 3) in (1, 2))
+        else:
+            n = bin(v & 0xFFFF).count("1")
+        return 38 + 2 * n
+
+    # 1000: or/div, 1100: and/mul/exg
+    def op_8c(self, op):
+        dreg = op >> 9 & 7
+        mode = op >> 3 & 7
+        reg = op & 7
+        opm = op >> 6 & 7
+        is_and = op >> 12 == 0xC
+        if opm == 3 or opm == 7:
+            s = self.rd(self.ea(mode, reg, 2), 2)
+            signed = opm == 7
+            if is_and:
+                if signed:
+                    r = _sext(self.d[dreg], 2) * _sext(s, 2)
+                else:
+                    r = (self.d[dreg] & 0xFFFF) * s
+                r &= 0xFFFFFFFF
+                self.d[dreg] = r
+                self.flags_logic(r, 4)
+                self.cycles += self._mul_time(s, signed) + _ea_time(mode, reg, 2)
+                return
+            if s == 0:
+                raise M68kError("division by zero at 0x%06x" % self.insn_pc)
+            dv = self.d[dreg]
+            if signed:
+                dv = _sext(dv, 4)
+                ds = _sext(s, 2)
+                q = abs(dv) // abs(ds)
+                if (dv < 0) != (ds < 0):
+                    q = -q
+                rem = dv - q * ds
+                ovf = not (-0x8000 <= q <= 0x7FFF)
+                self.cycles += 158 + _ea_time(mode, reg, 2)
+            else:
+                q, rem = divmod(dv, s)
+                ovf = q > 0xFFFF
+                self.cycles += 140 + _ea_time(mode, reg, 2)
+            self.c = 0
+            if ovf:
+                self.v = 1
+                return
+            self.d[dreg] = ((rem & 0xFFFF) << 16) | (q & 0xFFFF)
+            self.v = 0
+            self.n = 1 if q & 0x8000 else 0
+            self.z = 1 if q & 0xFFFF == 0 else 0
+            return
+        if is_and and opm in (5, 6) and mode in (0, 1) and (op & 0x1F8) in (0x140, 0x148, 0x188):
+            # exg
+            rx = op >> 9 & 7
+            ry = op & 7
+            kind = op >> 3 & 0x1F
+            if kind == 0x08:
+                self.d[rx], self.d[ry] = self.d[ry], self.d[rx]
+            elif kind == 0x09:
+                self.a[rx], self.a[ry] = self.a[ry], self.a[rx]
+            else:
+                self.d[rx], self.a[ry] = self.a[ry], self.d[rx]
+            self.cycles += 6
+            return
+        size = _SIZE2[opm & 3]
+        if opm & 4 and mode <= 1:
+            # abcd/sbcd and friends
+            self.illegal(op)
+        if mode == 1:
+            self.illegal(op)
+        e = self.ea(mode, reg, size)
+        s = self.rd(e, size)
+        d = self.d[dreg] & _MASK[size]
+        r = (s & d) if is_and else (s | d)
+        self.flags_logic(r, size)
+        if opm & 4:
+            self.wr(e, size, r)
+            self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+        else:
+            self.wr(("d", dreg), size, r)
+            self.cycles += self._alu_time(mode, reg, size)
+
+    def _alu_time(self, mode, reg, size):
+        if size == 4:
+            return (8 if mode <= 1 or (mode == 7 and reg == 4) else 6) + _ea_time(mode, reg, size)
+        return 4 + _ea_time(mode, reg, size)
+
+    # 1001: sub, 1101: add
+    def op_9d(self, op):
+        is_add = op >> 12 == 0xD
+        dreg = op >> 9 & 7
+        mode = op >> 3 & 7
+        reg = op & 7
+        opm = op >> 6 & 7
+        if opm == 3 or opm == 7:
+            # adda/suba
+            size = 4 if opm == 7 else 2
+            s = _sext(self.rd(self.ea(mode, reg, size), size), size)
+            a = self.a[dreg]
+            self.a[dreg] = (a + s if is_add else a - s) & 0xFFFFFFFF
+            if size == 4:
+                fast = mode <= 1 or (mode == 7 and reg == 4)
+                self.cycles += (8 if fast else 6) + _ea_time(mode, reg, 4)
+            else:
+                self.cycles += 8 + _ea_time(mode, reg, 2)
+            return
+        size = _SIZE2[opm & 3]
+        if opm & 4 and mode <= 1:
+            # addx/subx
+            if mode == 1:
+                self.illegal(op)
+            s = self.d[reg]
+            d = self.d[dreg]
+            z = self.z
+            r = self.do_add(s, d, size, self.x) if is_add else self.do_sub(s, d, size, self.x)
+            self.z = z if (r & _MASK[size]) == 0 else 0
+            self.wr(("d", dreg), size, r)
+            self.cycles += 8 if size == 4 else 4
+            return
+        e = self.ea(mode, reg, size)
+        if mode == 1 and size == 1:
+            self.illegal(op)
+        s = self.rd(e, size)
+        if opm & 4:
+            d = s
+            s = self.d[dreg]
+            r = self.do_add(s, d, size) if is_add else self.do_sub(s, d, size)
+            self.wr(e, size, r)
+            self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+        else:
+            d = self.d[dreg]
+            r = self.do_add(s, d, size) if is_add else self.do_sub(s, d, size)
+            self.wr(("d", dreg), size, r)
+            self.cycles += self._alu_time(mode, reg, size)
+
+    # 1011: cmp/cmpa/eor/cmpm
+    def op_b(self, op):
+        dreg = op >> 9 & 7
+        mode = op >> 3 & 7
+        reg = op & 7
+        opm = op >> 6 & 7
+        if opm == 3 or opm == 7:
+            size = 4 if opm == 7 else 2
+            s = _sext(self.rd(self.ea(mode, reg, size), size), size)
+            self.do_sub(s, self.a[dreg], 4, cmp=True)
+            self.cycles += 6 + _ea_time(mode, reg, size)
+            return
+        size = _SIZE2[opm & 3]
+        if opm & 4:
+            if mode == 1:
+                # cmpm
+                s = self.rd(self.ea(3, reg, size), size)
+                d = self.rd(self.ea(3, dreg, size), size)
+                self.do_sub(s, d, size, cmp=True)
+                self.cycles += 20 if size == 4 else 12
+                return
+            e = self.ea(mode, reg, size)
+            r = self.rd(e, size) ^ self.d[dreg]
+            self.flags_logic(r, size)
+            self.wr(e, size, r)
+            if mode == 0:
+                self.cycles += 8 if size == 4 else 4
+            else:
+                self.cycles += (12 if size == 4 else 8) + _ea_time(mode, reg, size)
+            return
+        if mode == 1 and size == 1:
+            self.illegal(op)
+        s = self.rd(self.ea(mode, reg, size), size)
+        self.do_sub(s, self.d[dreg], size, cmp=True)
+        self.cycles += (6 if size == 4 else 4) + _ea_time(mode, reg, size)
+
+    # 1110: shifts and rotates
+    def op_e(self, op):
+        if self.cpu020 and op & 0xF8C0 == 0xE8C0:
+            return self.op_bitfield(op)
+        if op & 0xC0 == 0xC0:
+            # memory shift by one
+            mode = op >> 3 & 7
+            reg = op & 7
+            kind = op >> 9 & 3
+            left = op & 0x100
+            e = self.ea(mode, reg, 2)
+            r = self._shift(kind, left, self.rd(e, 2), 1, 2)
+            self.wr(e, 2, r)
+            self.cycles += 8 + _ea_time(mode, reg, 2)
+            return
+        size = _SIZE2[op >> 6 & 3]
+        kind = op >> 3 & 3
+        left = op & 0x100
+        cnt = op >> 9 & 7
+        if op & 0x20:
+            cnt = self.d[cnt] & 63
+        elif cnt == 0:
+            cnt = 8
+        reg = op & 7
+        r = self._shift(kind, left, self.d[reg] & _MASK[size], cnt, size)
+        self.wr(("d", reg), size, r)
+        self.cycles += (8 if size == 4 else 6) + 2 * cnt
+
+    # bftst, bfextu, bfchg, bfexts, bfclr, bfffo, bfset, bfins
+    def op_bitfield(self, op):
+        ext = self.fetch16()
+        kind = op >> 8 & 7
+        mode = op >> 3 & 7
+        reg = op & 7
+        if ext & 0x0800:
+            off = _sext(self.d[ext >> 6 & 7], 4)
+        else:
+            off = ext >> 6 & 31
+        if ext & 0x0020:
+            width = self.d[ext & 7]
+        else:
+            width = ext & 31
+        width = ((width - 1) & 31) + 1
+        wmask = (1 << width) - 1
+        dn = ext >> 12 & 7
+        if mode == 0:
+            # the field is counted from bit 31 and wraps around in a register
+            off &= 31
+            v = self.d[reg]
+            field = ((v << 32 | v) >> (64 - off - width)) & wmask
+            self.cycles += 8
+        elif mode == 1 or mode == 3 or mode == 4:
+            self.illegal(op)
+        else:
+            e = self.ea(mode, reg, 4)
+            if e[0] != "m":
+                self.illegal(op)
+            addr = e[1] + (off >> 3)
+            bit = off & 7
+            nbytes = (bit + width + 7) // 8
+            v = 0
+            for i in range(nbytes):
+                v = v << 8 | self.read(addr + i, 1)
+            shift = nbytes * 8 - bit - width
+            field = (v >> shift) & wmask
+            self.cycles += 18 + _ea_time(mode, reg, 4)
+        if kind == 7:  # bfins
+            new = self.d[dn] & wmask
+            flagv = new
+        else:
+            flagv = field
+        self.n = flagv >> (width - 1) & 1
+        self.z = 1 if flagv == 0 else 0
+        self.v = self.c = 0
+        if kind == 0:
+            return
+        if kind == 1:
+            self.d[dn] = field
+            return
+        if kind == 3:
+            self.d[dn] = _sext(field << (32 - width), 4) >> (32 - width) & 0xFFFFFFFF
+            return
+        if kind == 5:
+            n = 0
+            while n < width and not field >> (width - 1 - n) & 1:
+                n += 1
+            self.d[dn] = (off + n) & 0xFFFFFFFF
+            self.cycles += 10
+            return
+        if kind == 2:
+            new = field ^ wmask
+        elif kind == 4:
+            new = 0
+        elif kind == 6:
+            new = wmask
+        if mode == 0:
+            m = wmask << (32 - width)
+            m = (m >> off | m << (32 - off)) & 0xFFFFFFFF
+            ins = new << (32 - width)
+            ins = (ins >> off | ins << (32 - off)) & 0xFFFFFFFF
+            self.d[reg] = (self.d[reg] & ~m | ins) & 0xFFFFFFFF
+        else:
+            v = v & ~(wmask << shift) | new << shift
+            for i in range(nbytes):
+                self.write(addr + i, 1, v >> (8 * (nbytes - 1 - i)))
+
+    def _shift(self, kind, left, v, cnt, size):
+        m = _MASK[size]
+        bits = size * 8
+        sb = _SIGN[size]
+        self.v = 0
+        if cnt == 0:
+            self.c = 0 if kind != 2 else self.x
+            self.flags_nz(v, size)
+            return v
+        if kind == 0 or kind == 1:  # asx / lsx
+            if left:
+                ov = 0
+                for _ in range(cnt):
+                    c = 1 if v & sb else 0
+                    v = (v << 1) & m
+                    if kind == 0 and (1 if v & sb else 0) != c:
+                        ov = 1
+                    self.c = self.x = c
+                if kind == 0:
+                    self.v = ov
+            else:
+                for _ in range(cnt):
+                    c = v & 1
+                    if kind == 0:
+                        v = (v >> 1) | (v & sb)
+                    else:
+                        v >>= 1
+                    self.c = self.x = c
+        elif kind == 3:  # rox
+            for _ in range(cnt):
+                if left:
+                    c = 1 if v & sb else 0
+                    v = ((v << 1) | c) & m
+                else:
+                    c = v & 1
+                    v = (v >> 1) | (sb if c else 0)
+                self.c = c
+        else:  # roxx
+            for _ in range(cnt):
+                if left:
+                    c = 1 if v & sb else 0
+                    v = ((v << 1) | self.x) & m
+                else:
+                    c = v & 1
+                    v = (v >> 1) | (sb if self.x else 0)
+                self.c = self.x = c
+        self.flags_nz(v, size)
+        return v
+
+    def flags_nz(self, r, size):
+        self.n = 1 if r & _SIGN[size] else 0
+        self.z = 1 if r & _MASK[size] == 0 else 0
+
+    def op_line(self, op):
+        self.illegal(op)
+
+    # 1111: 68881 FPU (coprocessor id 1)
+    def _fround(self, v, fmt):
+        if fmt == 1:
+            try:
+                return struct.unpack(">f", struct.pack(">f", v))[0]
+            except OverflowError:
+                return math.copysign(math.inf, v)
+        return v
+
+    def _fset_cc(self, v):
+        self.fpcc_nan = 1 if math.isnan(v) else 0
+        self.fpcc_z = 1 if v == 0 else 0
+        self.fpcc_n = 1 if math.copysign(1.0, v) < 0 and not self.fpcc_nan else 0
+
+    def _ftest(self, cond):
+        n, z, nan = self.fpcc_n, self.fpcc_z, self.fpcc_nan
+        table = {
+            0x01: z,
+            0x02: not (nan or z or n),
+            0x03: z or not (nan or n),
+            0x04: n and not (nan or z),
+            0x05: z or (n and not nan),
+            0x0E: not z,
+        }
+        if cond not in table:
+            raise M68kError("unsupported FPU condition %02x" % cond)
+        return bool(table[cond])
+
+    def op_f(self, op):
+        if not self.fpu or (op >> 9 & 7) != 1:
+            self.illegal(op)
+        kind = op >> 6 & 7
+        if kind == 2:
+            # fbcc.w
+            base = self.pc
+            disp = _sext(self.fetch16(), 2)
+            if self._ftest(op & 0x3F):
+                self.pc = (base + disp) & 0xFFFFFFFF
+            self.cycles += 22
+            return
+        if kind != 0 or op & 0x38:
+            self.illegal(op)
+        dn = op & 7
+        w2 = self.fetch16()
+        fmt = w2 >> 10 & 7
+        fpn = w2 >> 7 & 7
+        if fmt not in (0, 1):
+            self.illegal(op)
+        if w2 & 0xE000 == 0x6000:
+            # fmove fpn,dn
+            v = self.fp[fpn]
+            if fmt == 1:
+                self.d[dn] = struct.unpack(">I", struct.pack(">f", v))[0]
+            else:
+                if math.isnan(v):
+                    r = 0x7FFFFFFF
+                else:
+                    r = max(-(1 << 31), min((1 << 31) - 1, round(v)))
+                self.d[dn] = r & 0xFFFFFFFF
+            self.cycles += 40
+            return
+        if w2 & 0xE000 != 0x4000:
+            self.illegal(op)
+        if fmt == 1:
+            src = struct.unpack(">f", struct.pack(">I", self.d[dn]))[0]
+        else:
+            src = _sext(self.d[dn], 4)
+        opmode = w2 & 0x7F
+        dst = self.fp[fpn]
+        if opmode == 0x00:
+            r, c = float(src), 32
+        elif opmode == 0x03:
+            r, c = float(math.trunc(src)) if math.isfinite(src) else src, 42
+        elif opmode == 0x22:
+            r, c = dst + src, 56
+        elif opmode == 0x28:
+            r, c = dst - src, 56
+        elif opmode == 0x23:
+            r, c = dst * src, 76
+        elif opmode == 0x20:
+            if src == 0:
+                if dst == 0 or math.isnan(dst):
+                    r = math.nan
+                else:
+                    r = math.copysign(math.inf, dst) * math.copysign(1.0, src)
+            else:
+                r = dst / src
+            c = 108
+        elif opmode == 0x38:
+            if math.isnan(dst) or math.isnan(src):
+                self.fpcc_nan, self.fpcc_z, self.fpcc_n = 1, 0, 0
+            else:
+                self.fpcc_nan = 0
+                self.fpcc_z = 1 if dst == src else 0
+                self.fpcc_n = 1 if dst < src else 0
+            self.cycles += 42
+            return
+        else:
+            self.illegal(op)
+        r = self._fround(r, 1)
+        self.fp[fpn] = r
+        self._fset_cc(r)
+        self.cycles += c
+
+    _dispatch = [
+        op_0,
+        op_move,
+        op_move,
+        op_move,
+        op_4,
+        op_5,
+        op_6,
+        op_7,
+        op_8c,
+        op_9d,
+        op_line,
+        op_b,
+        op_8c,
+        op_9d,
+        op_e,
+        op_f,
+    ]
@@ -113,6 +113,9 @@ MP_NATIVE_ARCH_ARMV7EMSP = 7
 MP_NATIVE_ARCH_ARMV7EMDP = 8
 MP_NATIVE_ARCH_XTENSA = 9
 MP_NATIVE_ARCH_XTENSAWIN = 10
+MP_NATIVE_ARCH_M68K = 11
+MP_NATIVE_ARCH_M68K020 = 12
+MP_NATIVE_ARCH_M68K020FPU = 13
 
 MP_PERSISTENT_OBJ_FUN_TABLE = 0
 MP_PERSISTENT_OBJ_NONE = 1
@@ -579,6 +582,15 @@ class CompiledModule:
         self.raw_code_file_offset = raw_code_file_offset
         self.escaped_name = escaped_name
 
+        # Native code needs the name of the module to refer to its constant tables.
+        self.has_relocs = False
+        raw_codes = [raw_code]
+        while raw_codes:
+            rc = raw_codes.pop()
+            rc.module_escaped_name = escaped_name
+            self.has_relocs |= bool(getattr(rc, "relocs", None))
+            raw_codes.extend(rc.children)
+
     def hexdump(self):
         with open(self.mpy_source_file, "rb") as f:
             WIDTH = 16
@@ -663,6 +675,19 @@ class CompiledModule:
         print("// - .mpy header: %s" % ":".join("%02x" % b for b in self.header))
         print()
 
+        if self.has_relocs:
+            # Relocated native code may refer to the constant tables defined below.
+            if len(self.qstr_table):
+                print(
+                    "static const qstr_short_t const_qstr_table_data_%s[%u];"
+                    % (self.escaped_name, len(self.qstr_table))
+                )
+            if len(self.obj_table):
+                print(
+                    "static const mp_rom_obj_t const_obj_table_data_%s[%u];"
+                    % (self.escaped_name, len(self.obj_table))
+                )
+
         self.raw_code.freeze()
         print()
 
@@ -910,7 +935,11 @@ class RawCode(object):
         print("    .kind = %s," % RawCode.code_kind_str[self.code_kind])
         print("    .scope_flags = 0x%02x," % self.scope_flags)
         print("    .n_pos_args = %u," % self.n_pos_args)
-        print("    .fun_data = fun_data_%s," % self.escaped_name)
+        if getattr(self, "relocs", None):
+            # relocated native code is frozen as a struct
+            print("    .fun_data = &fun_data_%s," % self.escaped_name)
+        else:
+            print("    .fun_data = fun_data_%s," % self.escaped_name)
         print("    #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_DEBUG_PRINTERS")
         print("    .fun_data_len = %u," % len(self.fun_data))
         print("    #endif")
@@ -1037,6 +1066,17 @@ class RawCodeBytecode(RawCode):
         bc_content += len(bc)
 
 
+def native_word_size():
+    return 8 if config.native_arch == MP_NATIVE_ARCH_X64 else 4
+
+
+def native_reloc_unit():
+    # See NATIVE_RELOC_UNIT in py/persistentcode.c.
+    if MP_NATIVE_ARCH_M68K <= config.native_arch <= MP_NATIVE_ARCH_M68K020FPU:
+        return 2
+    return native_word_size()
+
+
 class RawCodeNative(RawCode):
     def __init__(
         self,
@@ -1048,11 +1088,21 @@ class RawCodeNative(RawCode):
         scope_flags,
         n_pos_args,
         type_sig,
+        rodata=b"",
+        bss_size=0,
+        relocs=(),
     ):
         super(RawCodeNative, self).__init__(
             parent_name, qstr_table, fun_data, prelude_offset, kind
         )
 
+        # Viper code from a native module may have rodata and bss, and words in
+        # its text and rodata to be relocated, as (in_rodata, index, dest) with
+        # index counted in units of native_reloc_unit().
+        self.rodata = rodata
+        self.bss_size = bss_size
+        self.relocs = relocs
+
         if kind in (MP_CODE_NATIVE_VIPER, MP_CODE_NATIVE_ASM):
             self.scope_flags = scope_flags
             self.n_pos_args = n_pos_args
@@ -1065,6 +1115,9 @@ class RawCodeNative(RawCode):
             MP_NATIVE_ARCH_XTENSAWIN,
         ):
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits # ")))'
+        elif MP_NATIVE_ARCH_M68K <= config.native_arch <= MP_NATIVE_ARCH_M68K020FPU:
+            # The m68k assembler only takes "|" as a comment after the start of a line.
+            self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits | ")))'
         else:
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",%progbits @ ")))'
 
@@ -1081,6 +1134,9 @@ class RawCodeNative(RawCode):
         elif MP_NATIVE_ARCH_ARMV6M <= config.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP:
             # ARMVxxM -- two byte align.
             self.fun_data_attributes += " __attribute__ ((aligned (2)))"
+        elif MP_NATIVE_ARCH_M68K <= config.native_arch <= MP_NATIVE_ARCH_M68K020FPU:
+            # m68k -- two byte align.
+            self.fun_data_attributes += " __attribute__ ((aligned (2)))"
 
     def disassemble(self):
         fun_data = self.fun_data
@@ -1103,33 +1159,116 @@ class RawCodeNative(RawCode):
             ip += sz
         self.disassemble_children()
 
-    def freeze(self):
-        if self.scope_flags & ~0x0F:
-            raise FreezeError("unable to freeze code with relocations")
+    def reloc_fields(self, data, in_rodata):
+        # Split data into runs of plain bytes and the words that are relocated,
+        # as (offset, bytes, dest) with dest None for plain bytes.
+        word_size = native_word_size()
+        fields = []
+        pos = 0
+        for r, idx, dest in sorted(self.relocs):
+            if r != in_rodata:
+                continue
+            offset = idx * native_reloc_unit()
+            if offset > pos:
+                fields.append((pos, data[pos:offset], None))
+            fields.append((offset, data[offset : offset + word_size], dest))
+            pos = offset + word_size
+        if pos < len(data):
+            fields.append((pos, data[pos:], None))
+        return fields
+
+    def freeze_reloc_type(self, name, fields):
+        # Relocated words need not be aligned (on m68k), so use a packed struct.
+        print("struct %s_t {" % name)
+        for offset, chunk, dest in fields:
+            if dest is None:
+                print("    byte b%u[%u];" % (offset, len(chunk)))
+            else:
+                print("    uintptr_t w%u;" % offset)
+        print("} __attribute__((packed));")
+
+    def freeze_reloc_data(self, name, attributes, fields):
+        # Print the data with the relocations that apply to it done by the C
+        # compiler and linker.
+        byteorder = (
+            "big"
+            if MP_NATIVE_ARCH_M68K <= config.native_arch <= MP_NATIVE_ARCH_M68K020FPU
+            else "little"
+        )
+        dest_names = {
+            "text": "&fun_data_%s" % self.escaped_name,
+            "rodata": "&fun_data_%s_rodata" % self.escaped_name,
+            "bss": "fun_data_%s_bss" % self.escaped_name,
+            "qstr_table": "const_qstr_table_data_%s" % self.module_escaped_name,
+            "obj_table": "const_obj_table_data_%s" % self.module_escaped_name,
+            "fun_table": "&mp_fun_table",
+        }
+        print("static const struct %s_t %s%s = {" % (name, name, attributes))
+        for offset, chunk, dest in fields:
+            if dest is None:
+                print("    {", end="")
+                for i in range(0, len(chunk), 16):
+                    print("\n       ", end="")
+                    for b in chunk[i : i + 16]:
+                        print(" 0x%02x," % b, end="")
+                print("\n    },")
+            else:
+                word = int.from_bytes(chunk, byteorder)
+                print("    0x%x + (uintptr_t)%s," % (word, dest_names[dest]))
+        print("};")
 
-        # generate native code data
+    def freeze(self):
         print()
         print(
             "// frozen native code for file %s, scope %s"
             % (self.qstr_table[0].str, self.escaped_name)
         )
-        print(
-            "static const byte fun_data_%s[%u] %s = {"
-            % (self.escaped_name, len(self.fun_data), self.fun_data_attributes)
-        )
 
-        i_top = len(self.fun_data)
-        i = 0
-        while i < i_top:
-            # copy machine code (max 16 bytes)
-            i16 = min(i + 16, i_top)
-            print("   ", end="")
-            for ii in range(i, i16):
-                print(" 0x%02x," % self.fun_data[ii], end="")
-            print()
-            i = i16
+        # generate bss and rodata, and declare the code, which relocations may refer to
+        if self.scope_flags & MP_SCOPE_FLAG_VIPERBSS:
+            print(
+                "static uintptr_t fun_data_%s_bss[%u];"
+                % (self.escaped_name, -(-self.bss_size // native_word_size()))
+            )
+        if self.relocs:
+            text_fields = self.reloc_fields(self.fun_data, False)
+            self.freeze_reloc_type("fun_data_%s" % self.escaped_name, text_fields)
+            print(
+                "static const struct fun_data_%s_t fun_data_%s %s;"
+                % (self.escaped_name, self.escaped_name, self.fun_data_attributes)
+            )
+        if self.scope_flags & MP_SCOPE_FLAG_VIPERRODATA:
+            rodata_fields = self.reloc_fields(self.rodata, True)
+            self.freeze_reloc_type("fun_data_%s_rodata" % self.escaped_name, rodata_fields)
+            self.freeze_reloc_data(
+                "fun_data_%s_rodata" % self.escaped_name,
+                " __attribute__((aligned(%u)))" % native_word_size(),
+                rodata_fields,
+            )
 
-        print("};")
+        # generate native code data
+        if self.relocs:
+            self.freeze_reloc_data(
+                "fun_data_%s" % self.escaped_name, " " + self.fun_data_attributes, text_fields
+            )
+        else:
+            print(
+                "static const byte fun_data_%s[%u] %s = {"
+                % (self.escaped_name, len(self.fun_data), self.fun_data_attributes)
+            )
+
+            i_top = len(self.fun_data)
+            i = 0
+            while i < i_top:
+                # copy machine code (max 16 bytes)
+                i16 = min(i + 16, i_top)
+                print("   ", end="")
+                for ii in range(i, i16):
+                    print(" 0x%02x," % self.fun_data[ii], end="")
+                print()
+                i = i16
+
+            print("};")
 
         prelude_ptr = None
         if self.code_kind == MP_CODE_NATIVE_PY:
@@ -1143,7 +1282,7 @@ class RawCodeNative(RawCode):
             print("#define %s &fun_data_%s_prelude[0]" % (prelude_ptr, self.escaped_name))
             print("#else")
             print(
-                "#define %s &fun_data_%s[%u]"
+                "#define %s ((const byte *)fun_data_%s + %u)"
                 % (prelude_ptr, self.escaped_name, self.prelude_offset)
             )
             print("#endif")
@@ -1265,6 +1404,9 @@ def read_raw_code(reader, parent_name, qstr_table, obj_table, segments):
         native_scope_flags = 0
         native_n_pos_args = 0
         native_type_sig = 0
+        rodata = b""
+        bss_size = 0
+        relocs = []
         if kind == MP_CODE_NATIVE_PY:
             prelude_offset = reader.read_uint()
         else:
@@ -1275,19 +1417,40 @@ def read_raw_code(reader, parent_name, qstr_table, obj_table, segments):
                 if native_scope_flags & MP_SCOPE_FLAG_VIPERRODATA:
                     rodata_size = reader.read_uint()
                 if native_scope_flags & MP_SCOPE_FLAG_VIPERBSS:
-                    reader.read_uint()  # bss_size
+                    bss_size = reader.read_uint()
                 if native_scope_flags & MP_SCOPE_FLAG_VIPERRODATA:
-                    reader.read_bytes(rodata_size)
+                    rodata = reader.read_bytes(rodata_size)
                 if native_scope_flags & MP_SCOPE_FLAG_VIPERRELOC:
+                    # Decode the relocations as done by mp_native_relocate().
+                    in_rodata = False
+                    idx = 0
                     while True:
                         op = reader.read_byte()
                         if op == 0xFF:
                             break
                         if op & 1:
-                            reader.read_uint()  # addr
+                            addr = reader.read_uint()
+                            in_rodata = bool(addr & 1)
+                            idx = addr >> 1
                         op >>= 1
-                        if op <= 5 and op & 1:
-                            reader.read_uint()  # n
+                        n = 1
+                        if op <= 5:
+                            if op & 1:
+                                n = reader.read_uint()
+                            dest = ("text", "rodata", "bss")[op >> 1]
+                        elif op == 6:
+                            dest = "qstr_table"
+                        elif op == 7:
+                            dest = "obj_table"
+                        elif op == 8:
+                            dest = "fun_table"
+                        else:
+                            raise MPYReadError(
+                                reader.filename, "relocation to mp_fun_table entry not supported"
+                            )
+                        for _ in range(n):
+                            relocs.append((in_rodata, idx, dest))
+                            idx += native_word_size() // native_reloc_unit()
             else:
                 assert kind == MP_CODE_NATIVE_ASM
                 native_n_pos_args = reader.read_uint()
@@ -1302,6 +1465,9 @@ def read_raw_code(reader, parent_name, qstr_table, obj_table, segments):
             native_scope_flags,
             native_n_pos_args,
             native_type_sig,
+            rodata,
+            bss_size,
+            relocs,
         )
 
     # Add a segment for the raw code data.
@@ -47,6 +47,7 @@ MP_NATIVE_ARCH_ARMV7EMSP = 7
 MP_NATIVE_ARCH_ARMV7EMDP = 8
 MP_NATIVE_ARCH_XTENSA = 9
 MP_NATIVE_ARCH_XTENSAWIN = 10
+MP_NATIVE_ARCH_M68K = 11
 MP_PERSISTENT_OBJ_STR = 5
 MP_SCOPE_FLAG_VIPERRELOC = 0x10
 MP_SCOPE_FLAG_VIPERRODATA = 0x20
@@ -57,6 +58,7 @@ MP_SMALL_INT_BITS = 31
 R_386_32 = 1
 R_X86_64_64 = 1
 R_XTENSA_32 = 1
+R_68K_32 = 1
 R_386_PC32 = 2
 R_X86_64_PC32 = 2
 R_ARM_ABS32 = 2
@@ -64,10 +66,18 @@ R_386_GOT32 = 3
 R_ARM_REL32 = 3
 R_386_PLT32 = 4
 R_X86_64_PLT32 = 4
+R_68K_PC32 = 4
+R_68K_PC16 = 5
 R_XTENSA_PLT = 6
+R_68K_GOT32 = 7
+R_68K_GOT16 = 8
 R_386_GOTOFF = 9
 R_386_GOTPC = 10
 R_ARM_THM_CALL = 10
+R_68K_GOT32O = 10
+R_68K_GOT16O = 11
+R_68K_PLT32 = 13
+R_68K_PLT16 = 14
 R_XTENSA_DIFF32 = 19
 R_XTENSA_SLOT0_OP = 20
 R_ARM_BASE_PREL = 25  # aka R_ARM_GOTPC
@@ -112,8 +122,26 @@ def asm_jump_xtensa(entry):
     return struct.pack("<BH", jump_op & 0xFF, jump_op >> 8)
 
 
+def asm_jump_m68k(entry):
+    # Only signed values that fit in 16 bits are supported (bra.w)
+    b_off = entry - 2
+    assert b_off >> 15 == 0 or b_off >> 15 == -1, b_off
+    return struct.pack(">HH", 0x6000, b_off & 0xFFFF)
+
+
 class ArchData:
-    def __init__(self, name, mpy_feature, word_size, arch_got, asm_jump, *, separate_rodata=False):
+    def __init__(
+        self,
+        name,
+        mpy_feature,
+        word_size,
+        arch_got,
+        asm_jump,
+        *,
+        separate_rodata=False,
+        big_endian=False,
+        reloc_unit=None,
+    ):
         self.name = name
         self.mpy_feature = mpy_feature
         self.qstr_entry_size = 2
@@ -121,6 +149,10 @@ class ArchData:
         self.arch_got = arch_got
         self.asm_jump = asm_jump
         self.separate_rodata = separate_rodata
+        self.byteorder = "big" if big_endian else "little"
+        self.struct_prefix = ">" if big_endian else "<"
+        # Granularity of the addresses of relocations in the .mpy file
+        self.reloc_unit = reloc_unit or word_size
 
 
 ARCH_DATA = {
@@ -181,6 +213,15 @@ ARCH_DATA = {
         asm_jump_xtensa,
         separate_rodata=True,
     ),
+    "m68k": ArchData(
+        "EM_68K",
+        MP_NATIVE_ARCH_M68K << 2,
+        4,
+        (R_68K_GOT32O, R_68K_GOT16O),
+        asm_jump_m68k,
+        big_endian=True,
+        reloc_unit=2,
+    ),
 }
 
 ################################################################################
@@ -322,22 +363,34 @@ class LinkEnv:
         raise LinkError("unknown symbol: {}".format(name))
 
 
+def got_entry_name(sym):
+    # Local symbols in different object files may have the same name
+    if sym.entry["st_info"]["bind"] == "STB_LOCAL":
+        return "{}:{}".format(sym.filename, sym.name)
+    return sym.name
+
+
 def build_got_generic(env):
     env.got_entries = {}
     for sec in env.sections:
         for r in sec.reloc:
             s = r.sym
             if not (
-                s.entry["st_info"]["bind"] == "STB_GLOBAL"
+                (
+                    s.entry["st_info"]["bind"] == "STB_GLOBAL"
+                    # m68k also reaches static data through the GOT
+                    or env.arch.name == "EM_68K"
+                )
                 and r["r_info_type"] in env.arch.arch_got
             ):
                 continue
             s_type = s.entry["st_info"]["type"]
             assert s_type in ("STT_NOTYPE", "STT_FUNC", "STT_OBJECT"), s_type
             assert s.name
-            if s.name in env.got_entries:
+            name = got_entry_name(s)
+            if name in env.got_entries:
                 continue
-            env.got_entries[s.name] = GOTEntry(s.name, s)
+            env.got_entries[name] = GOTEntry(name, s)
 
 
 def build_got_xtensa(env):
@@ -412,7 +465,7 @@ def populate_got(env):
         offset += env.arch.word_size
         o = env.got_section.addr + got_entry.offset
         env.full_text[o : o + env.arch.word_size] = got_entry.link_addr.to_bytes(
-            env.arch.word_size, "little"
+            env.arch.word_size, env.arch.byteorder
         )
 
     # Create a relocation for each GOT entry
@@ -466,9 +519,19 @@ def do_relocation_text(env, text_addr, r):
     except KeyError:
         r_addend = 0
 
+    if env.arch.name == "EM_68K" and r_info_type == R_68K_32:
+        # Absolute address in code, fixed up when the .mpy is loaded
+        do_relocation_data(env, text_addr, r)
+        return
+
     # Default relocation type and name for logging
     reloc_type = "le32"
     log_name = None
+    if env.arch.name == "EM_68K":
+        if r_info_type in (R_68K_PC16, R_68K_GOT16, R_68K_GOT16O, R_68K_PLT16):
+            reloc_type = "be16"
+        else:
+            reloc_type = "be32"
 
     if (
         env.arch.name == "EM_386"
@@ -477,6 +540,8 @@ def do_relocation_text(env, text_addr, r):
         and r_info_type in (R_X86_64_PC32, R_X86_64_PLT32)
         or env.arch.name == "EM_ARM"
         and r_info_type in (R_ARM_REL32, R_ARM_THM_CALL, R_ARM_THM_JUMP24)
+        or env.arch.name == "EM_68K"
+        and r_info_type in (R_68K_PC32, R_68K_PC16, R_68K_PLT32, R_68K_PLT16)
         or s_bind == "STB_LOCAL"
         and env.arch.name == "EM_XTENSA"
         and r_info_type == R_XTENSA_32  # not GOT
@@ -514,6 +579,8 @@ def do_relocation_text(env, text_addr, r):
         and r_info_type == R_386_GOTPC
         or env.arch.name == "EM_ARM"
         and r_info_type == R_ARM_BASE_PREL
+        or env.arch.name == "EM_68K"
+        and r_info_type in (R_68K_GOT32, R_68K_GOT16)
     ):
         # Relocation to GOT address itself
         assert s.name == "_GLOBAL_OFFSET_TABLE_"
@@ -529,6 +596,10 @@ def do_relocation_text(env, text_addr, r):
         # Relcation pointing to GOT
         reloc = addr = env.got_entries[s.name].offset
 
+    elif env.arch.name == "EM_68K" and r_info_type in (R_68K_GOT32O, R_68K_GOT16O):
+        # Relocation pointing to GOT, m68k specific
+        reloc = addr = env.got_entries[got_entry_name(s)].offset
+
     elif env.arch.name == "EM_X86_64" and r_info_type in (
         R_X86_64_GOTPCREL,
         R_X86_64_REX_GOTPCRELX,
@@ -575,6 +646,16 @@ def do_relocation_text(env, text_addr, r):
     if reloc_type == "le32":
         (existing,) = struct.unpack_from("<I", env.full_text, r_offset)
         struct.pack_into("<I", env.full_text, r_offset, (existing + reloc) & 0xFFFFFFFF)
+    elif reloc_type == "be32":
+        (existing,) = struct.unpack_from(">I", env.full_text, r_offset)
+        struct.pack_into(">I", env.full_text, r_offset, (existing + reloc) & 0xFFFFFFFF)
+    elif reloc_type == "be16":
+        # 16-bit displacement, from the PC or from the GOT
+        (existing,) = struct.unpack_from(">h", env.full_text, r_offset)
+        new = existing + reloc
+        if not -0x8000 <= new <= 0x7FFF:
+            raise LinkError("16-bit relocation out of range at {:08x}".format(r_offset))
+        struct.pack_into(">h", env.full_text, r_offset, new)
     elif reloc_type == "thumb_b":
         b_h, b_l = struct.unpack_from("<HH", env.full_text, r_offset)
         existing = (b_h & 0x7FF) << 12 | (b_l & 0x7FF) << 1
@@ -623,14 +704,18 @@ def do_relocation_data(env, text_addr, r):
         and r_info_type == R_ARM_ABS32
         or env.arch.name == "EM_XTENSA"
         and r_info_type == R_XTENSA_32
+        or env.arch.name == "EM_68K"
+        and r_info_type == R_68K_32
     ):
         # Relocation in data.rel.ro to internal/external symbol
         if env.arch.word_size == 4:
-            struct_type = "<I"
+            struct_type = env.arch.struct_prefix + "I"
         elif env.arch.word_size == 8:
-            struct_type = "<Q"
+            struct_type = env.arch.struct_prefix + "Q"
+        if hasattr(s, "resolved"):
+            s = s.resolved
         sec = s.section
-        assert r_offset % env.arch.word_size == 0
+        assert r_offset % env.arch.reloc_unit == 0
         addr = sec.addr + s["st_value"] + r_addend
         if s_type == "STT_SECTION":
             log_name = sec.name
@@ -864,9 +949,9 @@ class MPYOutput:
             self.write_bytes(s)
             self.write_bytes(b"\x00")
 
-    def write_reloc(self, base, offset, dest, n):
-        need_offset = not (base == self.prev_base and offset == self.prev_offset + 1)
-        self.prev_offset = offset + n - 1
+    def write_reloc(self, base, offset, dest, n, step):
+        need_offset = not (base == self.prev_base and offset == self.prev_offset + step)
+        self.prev_offset = offset + (n - 1) * step
         if dest <= 2:
             dest = (dest << 1) | (n > 1)
         else:
@@ -953,6 +1038,8 @@ def build_mpy(env, entry_offset, fmpy, native_qstr_vals):
     prev_base = None
     prev_offset = None
     prev_n = None
+    # Consecutive words are this many relocation address units apart
+    step = env.arch.word_size // env.arch.reloc_unit
     for base, addr, kind in env.mpy_relocs:
         if isinstance(kind, str) and kind.startswith(".text"):
             kind = 0
@@ -971,20 +1058,22 @@ def build_mpy(env, entry_offset, fmpy, native_qstr_vals):
             kind = 8
         else:
             kind = 9 + kind
-        assert addr % env.arch.word_size == 0, addr
-        offset = addr // env.arch.word_size
-        if kind == prev_kind and base == prev_base and offset == prev_offset + 1:
+        assert addr % env.arch.reloc_unit == 0, addr
+        offset = addr // env.arch.reloc_unit
+        if kind == prev_kind and base == prev_base and offset == prev_offset + step:
             prev_n += 1
-            prev_offset += 1
+            prev_offset += step
         else:
             if prev_kind is not None:
-                out.write_reloc(prev_base, prev_offset - prev_n + 1, prev_kind, prev_n)
+                out.write_reloc(
+                    prev_base, prev_offset - (prev_n - 1) * step, prev_kind, prev_n, step
+                )
             prev_kind = kind
             prev_base = base
             prev_offset = offset
             prev_n = 1
     if prev_kind is not None:
-        out.write_reloc(prev_base, prev_offset - prev_n + 1, prev_kind, prev_n)
+        out.write_reloc(prev_base, prev_offset - (prev_n - 1) * step, prev_kind, prev_n, step)
 
     # MPY: sentinel for end of relocations
     out.write_bytes(b"\xff")